@@ -0,0 +1,68 @@
+/**
+ * Describes the occurrence counters shared by the CPER aggregators.
+ **/
+
+#include <json.h>
+#include "../edk/Cper.h"
+#include "../cper-utils.h"
+#include "agg-counters.h"
+
+//Outputs the timestamp of the record behind the given view as seconds since the Unix epoch.
+//Returns 1 if the record carries a valid timestamp, 0 otherwise.
+int agg_record_epoch(const cper_record_view *view, INT64 *epoch)
+{
+	const EFI_ERROR_TIME_STAMP *record_time =
+		cper_record_view_timestamp(view);
+	if (record_time == NULL) {
+		return 0;
+	}
+	EFI_ERROR_TIME_STAMP time = *record_time;
+	*epoch = timestamp_to_epoch(&time);
+	return 1;
+}
+
+//Adds a single occurrence with the given section severity and (optional) timestamp.
+void agg_counters_add(AGG_COUNTERS *counters, UINT32 severity,
+		      const INT64 *timestamp)
+{
+	counters->Count++;
+	if (severity < 4) {
+		counters->SeverityCounts[severity]++;
+	}
+	if (timestamp != NULL) {
+		if (!counters->TimestampValid ||
+		    *timestamp < counters->FirstTimestamp) {
+			counters->FirstTimestamp = *timestamp;
+		}
+		if (!counters->TimestampValid ||
+		    *timestamp > counters->LastTimestamp) {
+			counters->LastTimestamp = *timestamp;
+		}
+		counters->TimestampValid = 1;
+	}
+}
+
+//Adds the counters to the given JSON entry as "count", "severities" and, where known,
+//"firstTimestampEpoch"/"lastTimestampEpoch".
+void agg_counters_to_ir(const AGG_COUNTERS *counters, json_object *entry)
+{
+	json_object_object_add(entry, "count",
+			       json_object_new_uint64(counters->Count));
+	json_object *severities = json_object_new_object();
+	const char *severity_names[4] = { "recoverable", "fatal", "corrected",
+					  "informational" };
+	for (int i = 0; i < 4; i++) {
+		json_object_object_add(
+			severities, severity_names[i],
+			json_object_new_uint64(counters->SeverityCounts[i]));
+	}
+	json_object_object_add(entry, "severities", severities);
+	if (counters->TimestampValid) {
+		json_object_object_add(
+			entry, "firstTimestampEpoch",
+			json_object_new_int64(counters->FirstTimestamp));
+		json_object_object_add(
+			entry, "lastTimestampEpoch",
+			json_object_new_int64(counters->LastTimestamp));
+	}
+}
@@ -0,0 +1,30 @@
+#ifndef CPER_AGG_COUNTERS_H
+#define CPER_AGG_COUNTERS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <json.h>
+#include "../cper-view.h"
+
+//Occurrence counters kept by each aggregator entry: a total, a count per section severity and
+//the first/last record timestamp seen (as seconds since the Unix epoch).
+typedef struct {
+	UINT64 Count;
+	UINT64 SeverityCounts[4];
+	INT64 FirstTimestamp;
+	INT64 LastTimestamp;
+	UINT64 TimestampValid;
+} AGG_COUNTERS;
+
+int agg_record_epoch(const cper_record_view *view, INT64 *epoch);
+void agg_counters_add(AGG_COUNTERS *counters, UINT32 severity,
+		      const INT64 *timestamp);
+void agg_counters_to_ir(const AGG_COUNTERS *counters, json_object *entry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * Describes a small open addressing hash table used by the CPER aggregators.
+ * Each slot holds the key hash (zero marks an empty slot), the key and then the value.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "agg-table.h"
+
+//Minimum table capacity. Capacities are always a power of two.
+#define AGG_TABLE_MIN_CAPACITY 16
+
+//Private pre-definitions.
+static UINT64 agg_table_hash(const void *key, size_t len);
+static size_t agg_table_key_offset(void);
+static size_t agg_table_value_offset(const agg_table *table);
+static UINT8 *agg_table_probe(const agg_table *table, UINT64 hash,
+			      const void *key);
+static int agg_table_grow(agg_table *table);
+
+//Initialises an empty table for the given key and value sizes, with room for at least "capacity" entries.
+//Returns 1 on success, 0 on allocation failure.
+int agg_table_init(agg_table *table, size_t key_size, size_t value_size,
+		   size_t capacity)
+{
+	size_t slots = AGG_TABLE_MIN_CAPACITY;
+	while (slots / 4 * 3 < capacity) {
+		slots *= 2;
+	}
+
+	table->key_size = key_size;
+	table->value_size = value_size;
+	table->slot_size = agg_table_key_offset() + ((key_size + 7) & ~7) +
+			   ((value_size + 7) & ~7);
+	table->capacity = slots;
+	table->count = 0;
+	table->slots = calloc(slots, table->slot_size);
+	if (table->slots == NULL) {
+		printf("Failed to allocate aggregation table.\n");
+		table->capacity = 0;
+		return 0;
+	}
+	return 1;
+}
+
+//Frees all memory held by the table.
+void agg_table_free(agg_table *table)
+{
+	free(table->slots);
+	table->slots = NULL;
+	table->capacity = 0;
+	table->count = 0;
+}
+
+//Removes all entries from the table, keeping its current capacity.
+void agg_table_clear(agg_table *table)
+{
+	if (table->slots != NULL) {
+		memset(table->slots, 0, table->capacity * table->slot_size);
+	}
+	table->count = 0;
+}
+
+//Returns the value stored for the given key, or NULL if there is none.
+void *agg_table_find(const agg_table *table, const void *key)
+{
+	if (table->slots == NULL) {
+		return NULL;
+	}
+	UINT64 hash = agg_table_hash(key, table->key_size);
+	UINT8 *slot = agg_table_probe(table, hash, key);
+	if (*(UINT64 *)slot == 0) {
+		return NULL;
+	}
+	return slot + agg_table_value_offset(table);
+}
+
+//Returns the value stored for the given key, inserting a zeroed value if there is none.
+//"inserted" (if provided) is set to whether a new entry was created. Returns NULL on allocation failure.
+void *agg_table_insert(agg_table *table, const void *key, int *inserted)
+{
+	if (inserted != NULL) {
+		*inserted = 0;
+	}
+	if (table->slots == NULL) {
+		return NULL;
+	}
+
+	UINT64 hash = agg_table_hash(key, table->key_size);
+	UINT8 *slot = agg_table_probe(table, hash, key);
+	if (*(UINT64 *)slot != 0) {
+		return slot + agg_table_value_offset(table);
+	}
+
+	//New entry, grow first if this would take the table above 3/4 load.
+	if ((table->count + 1) > table->capacity / 4 * 3) {
+		if (!agg_table_grow(table)) {
+			return NULL;
+		}
+		slot = agg_table_probe(table, hash, key);
+	}
+	*(UINT64 *)slot = hash;
+	memcpy(slot + agg_table_key_offset(), key, table->key_size);
+	table->count++;
+	if (inserted != NULL) {
+		*inserted = 1;
+	}
+	return slot + agg_table_value_offset(table);
+}
+
+//Iterates over the entries in the table. "iterator" should start at zero.
+//Returns the next entry's value and outputs its key, or returns NULL once all entries are visited.
+void *agg_table_next(const agg_table *table, size_t *iterator,
+		     const void **key)
+{
+	while (*iterator < table->capacity) {
+		UINT8 *slot = table->slots + *iterator * table->slot_size;
+		(*iterator)++;
+		if (*(UINT64 *)slot != 0) {
+			if (key != NULL) {
+				*key = slot + agg_table_key_offset();
+			}
+			return slot + agg_table_value_offset(table);
+		}
+	}
+	return NULL;
+}
+
+//FNV-1a over the key bytes. Zero is reserved for empty slots, so the low bit is always set.
+static UINT64 agg_table_hash(const void *key, size_t len)
+{
+	const UINT8 *bytes = (const UINT8 *)key;
+	UINT64 hash = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash | 1;
+}
+
+static size_t agg_table_key_offset(void)
+{
+	return sizeof(UINT64);
+}
+
+static size_t agg_table_value_offset(const agg_table *table)
+{
+	return agg_table_key_offset() + ((table->key_size + 7) & ~7);
+}
+
+//Returns the slot holding the given key, or the empty slot it would be inserted into.
+static UINT8 *agg_table_probe(const agg_table *table, UINT64 hash,
+			      const void *key)
+{
+	size_t mask = table->capacity - 1;
+	size_t index = (size_t)(hash ^ (hash >> 32)) & mask;
+	for (;;) {
+		UINT8 *slot = table->slots + index * table->slot_size;
+		UINT64 slot_hash = *(UINT64 *)slot;
+		if (slot_hash == 0 ||
+		    (slot_hash == hash &&
+		     memcmp(slot + agg_table_key_offset(), key,
+			    table->key_size) == 0)) {
+			return slot;
+		}
+		index = (index + 1) & mask;
+	}
+}
+
+//Doubles the table capacity, rehashing all entries. Returns 0 on allocation failure.
+static int agg_table_grow(agg_table *table)
+{
+	agg_table grown = *table;
+	grown.capacity = table->capacity * 2;
+	grown.slots = calloc(grown.capacity, grown.slot_size);
+	if (grown.slots == NULL) {
+		printf("Failed to grow aggregation table to %zu slots.\n",
+		       grown.capacity);
+		return 0;
+	}
+
+	for (size_t i = 0; i < table->capacity; i++) {
+		UINT8 *slot = table->slots + i * table->slot_size;
+		UINT64 hash = *(UINT64 *)slot;
+		if (hash == 0) {
+			continue;
+		}
+		UINT8 *target = agg_table_probe(
+			&grown, hash, slot + agg_table_key_offset());
+		memcpy(target, slot, table->slot_size);
+	}
+
+	free(table->slots);
+	table->slots = grown.slots;
+	table->capacity = grown.capacity;
+	return 1;
+}
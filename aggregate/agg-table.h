@@ -0,0 +1,35 @@
+#ifndef CPER_AGG_TABLE_H
+#define CPER_AGG_TABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "../edk/BaseTypes.h"
+
+//Open addressing hash table mapping fixed size keys to fixed size values, shared by the aggregators.
+//Keys are compared bytewise, so any padding within a key must be zeroed before use.
+typedef struct {
+	UINT8 *slots;
+	size_t key_size;
+	size_t value_size;
+	size_t slot_size;
+	size_t capacity;
+	size_t count;
+} agg_table;
+
+int agg_table_init(agg_table *table, size_t key_size, size_t value_size,
+		   size_t capacity);
+void agg_table_free(agg_table *table);
+void agg_table_clear(agg_table *table);
+void *agg_table_find(const agg_table *table, const void *key);
+void *agg_table_insert(agg_table *table, const void *key, int *inserted);
+void *agg_table_next(const agg_table *table, size_t *iterator,
+		     const void **key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
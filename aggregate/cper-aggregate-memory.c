@@ -0,0 +1,309 @@
+/**
+ * Describes a streaming aggregator for Platform Memory and Platform Memory 2 CPER sections.
+ * Sections are read directly from binary records through the record view, so no per-section
+ * IR is created. Only the aggregated counters are converted to JSON, on request.
+ **/
+
+#include <string.h>
+#include <json.h>
+#include "../edk/Cper.h"
+#include "agg-counters.h"
+#include "cper-aggregate-memory.h"
+
+//Bits within MEMORY_AGGREGATE_KEY.Valid, marking which location fields were provided.
+#define MEMORY_KEY_NODE_VALID	0x01
+#define MEMORY_KEY_CARD_VALID	0x02
+#define MEMORY_KEY_MODULE_VALID 0x04
+#define MEMORY_KEY_BANK_VALID	0x08
+#define MEMORY_KEY_DEVICE_VALID 0x10
+#define MEMORY_KEY_ROW_VALID	0x20
+#define MEMORY_KEY_COLUMN_VALID 0x40
+#define MEMORY_KEY_PAGE_VALID	0x80
+
+//Physical addresses are grouped by 4KiB page.
+#define MEMORY_PAGE_SHIFT 12
+
+//Aggregation key for a single memory location. Must contain no padding.
+typedef struct {
+	UINT64 Page;
+	UINT32 Device;
+	UINT32 Row;
+	UINT32 Column;
+	UINT16 Node;
+	UINT16 Card;
+	UINT16 Module;
+	UINT16 Bank;
+	UINT32 Valid;
+} MEMORY_AGGREGATE_KEY;
+
+//Private pre-definitions.
+static void memory_key_from_section(MEMORY_AGGREGATE_KEY *key,
+				    const EFI_PLATFORM_MEMORY_ERROR_DATA *memory);
+static void
+memory2_key_from_section(MEMORY_AGGREGATE_KEY *key,
+			 const EFI_PLATFORM_MEMORY2_ERROR_DATA *memory);
+static void memory_aggregate(cper_memory_aggregator *aggregator,
+			     const MEMORY_AGGREGATE_KEY *key, UINT32 severity,
+			     const INT64 *timestamp);
+static json_object *memory_key_to_ir(const MEMORY_AGGREGATE_KEY *key,
+				     const AGG_COUNTERS *value);
+
+//Initialises an empty aggregator. When max_entries is non-zero, sections for new locations beyond
+//that many entries are counted as dropped rather than aggregated.
+//Returns 1 on success, 0 on allocation failure.
+int cper_memory_aggregator_init(cper_memory_aggregator *aggregator,
+				size_t max_entries)
+{
+	aggregator->max_entries = max_entries;
+	aggregator->total_sections = 0;
+	aggregator->dropped_sections = 0;
+	return agg_table_init(&aggregator->table, sizeof(MEMORY_AGGREGATE_KEY),
+			      sizeof(AGG_COUNTERS), 0);
+}
+
+//Frees all memory held by the aggregator.
+void cper_memory_aggregator_free(cper_memory_aggregator *aggregator)
+{
+	agg_table_free(&aggregator->table);
+}
+
+//Discards all aggregated counters, keeping allocated capacity.
+void cper_memory_aggregator_reset(cper_memory_aggregator *aggregator)
+{
+	agg_table_clear(&aggregator->table);
+	aggregator->total_sections = 0;
+	aggregator->dropped_sections = 0;
+}
+
+//Aggregates all memory sections within the record behind the given view.
+//Returns the number of memory sections consumed.
+int cper_memory_aggregator_add_view(cper_memory_aggregator *aggregator,
+				    const cper_record_view *view)
+{
+	//Record timestamp, if present.
+	INT64 epoch = 0;
+	INT64 *timestamp = agg_record_epoch(view, &epoch) ? &epoch : NULL;
+
+	int consumed = 0;
+	UINT16 section_count = cper_record_view_section_count(view);
+	for (UINT16 i = 0; i < section_count; i++) {
+		MEMORY_AGGREGATE_KEY key;
+		const EFI_PLATFORM_MEMORY_ERROR_DATA *memory =
+			cper_record_view_memory(view, i);
+		const EFI_PLATFORM_MEMORY2_ERROR_DATA *memory2 = NULL;
+		if (memory != NULL) {
+			memory_key_from_section(&key, memory);
+		} else if ((memory2 = cper_record_view_memory2(view, i)) !=
+			   NULL) {
+			memory2_key_from_section(&key, memory2);
+		} else {
+			continue;
+		}
+
+		memory_aggregate(aggregator, &key,
+				 cper_record_view_section_severity(view, i),
+				 timestamp);
+		consumed++;
+	}
+
+	return consumed;
+}
+
+//Aggregates all memory sections within the given binary CPER record.
+//Returns the number of memory sections consumed, or -1 if the buffer is not a valid record.
+int cper_memory_aggregator_add_record(cper_memory_aggregator *aggregator,
+				      const void *record, size_t size)
+{
+	cper_record_view view;
+	if (!cper_record_view_init(&view, record, size)) {
+		return -1;
+	}
+	return cper_memory_aggregator_add_view(aggregator, &view);
+}
+
+//Converts a snapshot of the aggregator's current counters into JSON.
+json_object *
+cper_memory_aggregator_to_ir(const cper_memory_aggregator *aggregator)
+{
+	json_object *snapshot = json_object_new_object();
+	json_object_object_add(
+		snapshot, "totalSections",
+		json_object_new_uint64(aggregator->total_sections));
+	json_object_object_add(
+		snapshot, "droppedSections",
+		json_object_new_uint64(aggregator->dropped_sections));
+
+	json_object *entries = json_object_new_array();
+	size_t iterator = 0;
+	const void *key;
+	const AGG_COUNTERS *value;
+	while ((value = agg_table_next(&aggregator->table, &iterator, &key)) !=
+	       NULL) {
+		json_object_array_add(
+			entries,
+			memory_key_to_ir((const MEMORY_AGGREGATE_KEY *)key,
+					 value));
+	}
+	json_object_object_add(snapshot, "entries", entries);
+
+	return snapshot;
+}
+
+//Builds an aggregation key from a Platform Memory section.
+static void memory_key_from_section(MEMORY_AGGREGATE_KEY *key,
+				    const EFI_PLATFORM_MEMORY_ERROR_DATA *memory)
+{
+	memset(key, 0, sizeof(MEMORY_AGGREGATE_KEY));
+	UINT64 valid = memory->ValidFields;
+	if (valid & 0x2) {
+		key->Page = memory->PhysicalAddress >> MEMORY_PAGE_SHIFT;
+		key->Valid |= MEMORY_KEY_PAGE_VALID;
+	}
+	if (valid & 0x8) {
+		key->Node = memory->Node;
+		key->Valid |= MEMORY_KEY_NODE_VALID;
+	}
+	if (valid & 0x10) {
+		key->Card = memory->Card;
+		key->Valid |= MEMORY_KEY_CARD_VALID;
+	}
+	if (valid & 0x20) {
+		key->Module = memory->ModuleRank;
+		key->Valid |= MEMORY_KEY_MODULE_VALID;
+	}
+	//Bank is either a plain bank, or a bank group/address pair.
+	if (valid & (0x40 | 0x80000 | 0x100000)) {
+		key->Bank = memory->Bank;
+		key->Valid |= MEMORY_KEY_BANK_VALID;
+	}
+	if (valid & 0x80) {
+		key->Device = memory->Device;
+		key->Valid |= MEMORY_KEY_DEVICE_VALID;
+	}
+	if (valid & 0x100) {
+		key->Row = memory->Row;
+		//Row bits 16 & 17 are carried in the extended field.
+		if (valid & 0x40000) {
+			key->Row |= (UINT32)(memory->Extended & 0x3) << 16;
+		}
+		key->Valid |= MEMORY_KEY_ROW_VALID;
+	}
+	if (valid & 0x200) {
+		key->Column = memory->Column;
+		key->Valid |= MEMORY_KEY_COLUMN_VALID;
+	}
+}
+
+//Builds an aggregation key from a Platform Memory 2 section.
+static void
+memory2_key_from_section(MEMORY_AGGREGATE_KEY *key,
+			 const EFI_PLATFORM_MEMORY2_ERROR_DATA *memory)
+{
+	memset(key, 0, sizeof(MEMORY_AGGREGATE_KEY));
+	UINT64 valid = memory->ValidFields;
+	if (valid & 0x2) {
+		key->Page = memory->PhysicalAddress >> MEMORY_PAGE_SHIFT;
+		key->Valid |= MEMORY_KEY_PAGE_VALID;
+	}
+	if (valid & 0x8) {
+		key->Node = memory->Node;
+		key->Valid |= MEMORY_KEY_NODE_VALID;
+	}
+	if (valid & 0x10) {
+		key->Card = memory->Card;
+		key->Valid |= MEMORY_KEY_CARD_VALID;
+	}
+	if (valid & 0x20) {
+		key->Module = memory->Module;
+		key->Valid |= MEMORY_KEY_MODULE_VALID;
+	}
+	//Bank is either a plain bank, or a bank group/address pair.
+	if (valid & (0x40 | 0x100000 | 0x200000)) {
+		key->Bank = memory->Bank;
+		key->Valid |= MEMORY_KEY_BANK_VALID;
+	}
+	if (valid & 0x80) {
+		key->Device = memory->Device;
+		key->Valid |= MEMORY_KEY_DEVICE_VALID;
+	}
+	if (valid & 0x100) {
+		key->Row = memory->Row;
+		key->Valid |= MEMORY_KEY_ROW_VALID;
+	}
+	if (valid & 0x200) {
+		key->Column = memory->Column;
+		key->Valid |= MEMORY_KEY_COLUMN_VALID;
+	}
+}
+
+//Adds a single section to the counters for the given key.
+static void memory_aggregate(cper_memory_aggregator *aggregator,
+			     const MEMORY_AGGREGATE_KEY *key, UINT32 severity,
+			     const INT64 *timestamp)
+{
+	aggregator->total_sections++;
+
+	//Existing locations are always updated, new ones only while there is room.
+	AGG_COUNTERS *value = agg_table_find(&aggregator->table, key);
+	if (value == NULL) {
+		if (aggregator->max_entries != 0 &&
+		    aggregator->table.count >= aggregator->max_entries) {
+			aggregator->dropped_sections++;
+			return;
+		}
+		value = agg_table_insert(&aggregator->table, key, NULL);
+		if (value == NULL) {
+			aggregator->dropped_sections++;
+			return;
+		}
+	}
+
+	agg_counters_add(value, severity, timestamp);
+}
+
+//Converts a single aggregated memory location into JSON.
+static json_object *memory_key_to_ir(const MEMORY_AGGREGATE_KEY *key,
+				     const AGG_COUNTERS *value)
+{
+	json_object *entry = json_object_new_object();
+
+	//Location, only including fields that were provided.
+	if (key->Valid & MEMORY_KEY_NODE_VALID) {
+		json_object_object_add(entry, "node",
+				       json_object_new_uint64(key->Node));
+	}
+	if (key->Valid & MEMORY_KEY_CARD_VALID) {
+		json_object_object_add(entry, "card",
+				       json_object_new_uint64(key->Card));
+	}
+	if (key->Valid & MEMORY_KEY_MODULE_VALID) {
+		json_object_object_add(entry, "module",
+				       json_object_new_uint64(key->Module));
+	}
+	if (key->Valid & MEMORY_KEY_BANK_VALID) {
+		json_object_object_add(entry, "bank",
+				       json_object_new_uint64(key->Bank));
+	}
+	if (key->Valid & MEMORY_KEY_DEVICE_VALID) {
+		json_object_object_add(entry, "device",
+				       json_object_new_uint64(key->Device));
+	}
+	if (key->Valid & MEMORY_KEY_ROW_VALID) {
+		json_object_object_add(entry, "row",
+				       json_object_new_uint64(key->Row));
+	}
+	if (key->Valid & MEMORY_KEY_COLUMN_VALID) {
+		json_object_object_add(entry, "column",
+				       json_object_new_uint64(key->Column));
+	}
+	if (key->Valid & MEMORY_KEY_PAGE_VALID) {
+		json_object_object_add(
+			entry, "physicalPageAddress",
+			json_object_new_uint64(key->Page << MEMORY_PAGE_SHIFT));
+	}
+
+	//Counters.
+	agg_counters_to_ir(value, entry);
+
+	return entry;
+}
@@ -0,0 +1,37 @@
+#ifndef CPER_AGGREGATE_MEMORY_H
+#define CPER_AGGREGATE_MEMORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <json.h>
+#include "../cper-view.h"
+#include "agg-table.h"
+
+//Streaming aggregator over Platform Memory and Platform Memory 2 sections.
+//Sections are keyed on node/card/module/bank/device/row/column and physical page, and each key
+//keeps a count, first/last timestamp and severity mix.
+typedef struct {
+	agg_table table;
+	size_t max_entries;
+	UINT64 total_sections;
+	UINT64 dropped_sections;
+} cper_memory_aggregator;
+
+int cper_memory_aggregator_init(cper_memory_aggregator *aggregator,
+				size_t max_entries);
+void cper_memory_aggregator_free(cper_memory_aggregator *aggregator);
+void cper_memory_aggregator_reset(cper_memory_aggregator *aggregator);
+int cper_memory_aggregator_add_view(cper_memory_aggregator *aggregator,
+				    const cper_record_view *view);
+int cper_memory_aggregator_add_record(cper_memory_aggregator *aggregator,
+				      const void *record, size_t size);
+json_object *
+cper_memory_aggregator_to_ir(const cper_memory_aggregator *aggregator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
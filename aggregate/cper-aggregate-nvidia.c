@@ -0,0 +1,180 @@
+/**
+ * Describes a streaming aggregator for NVIDIA CPER sections.
+ * Sections are read directly from binary records through the record view, so no per-section
+ * IR (or register array) is created.
+ **/
+
+#include <string.h>
+#include <json.h>
+#include "../edk/Cper.h"
+#include "agg-counters.h"
+#include "cper-aggregate-nvidia.h"
+
+//Aggregation key for a single NVIDIA error source. Must contain no padding.
+typedef struct {
+	CHAR8 Signature[16];
+	UINT16 ErrorType;
+	UINT16 ErrorInstance;
+	UINT8 Socket;
+	UINT8 Reserved[3];
+} NVIDIA_AGGREGATE_KEY;
+
+//Private pre-definitions.
+static void nvidia_aggregate(cper_nvidia_aggregator *aggregator,
+			     const NVIDIA_AGGREGATE_KEY *key, UINT32 severity,
+			     const INT64 *timestamp);
+static json_object *nvidia_key_to_ir(const NVIDIA_AGGREGATE_KEY *key,
+				     const AGG_COUNTERS *value);
+
+//Initialises an empty aggregator. When max_entries is non-zero, sections for new error sources
+//beyond that many entries are counted as dropped rather than aggregated.
+//Returns 1 on success, 0 on allocation failure.
+int cper_nvidia_aggregator_init(cper_nvidia_aggregator *aggregator,
+				size_t max_entries)
+{
+	aggregator->max_entries = max_entries;
+	aggregator->total_sections = 0;
+	aggregator->dropped_sections = 0;
+	return agg_table_init(&aggregator->table, sizeof(NVIDIA_AGGREGATE_KEY),
+			      sizeof(AGG_COUNTERS), 0);
+}
+
+//Frees all memory held by the aggregator.
+void cper_nvidia_aggregator_free(cper_nvidia_aggregator *aggregator)
+{
+	agg_table_free(&aggregator->table);
+}
+
+//Discards all aggregated counters, keeping allocated capacity.
+void cper_nvidia_aggregator_reset(cper_nvidia_aggregator *aggregator)
+{
+	agg_table_clear(&aggregator->table);
+	aggregator->total_sections = 0;
+	aggregator->dropped_sections = 0;
+}
+
+//Aggregates all NVIDIA sections within the record behind the given view.
+//Returns the number of NVIDIA sections consumed.
+int cper_nvidia_aggregator_add_view(cper_nvidia_aggregator *aggregator,
+				    const cper_record_view *view)
+{
+	//Record timestamp, if present.
+	INT64 epoch = 0;
+	INT64 *timestamp = agg_record_epoch(view, &epoch) ? &epoch : NULL;
+
+	int consumed = 0;
+	UINT16 section_count = cper_record_view_section_count(view);
+	for (UINT16 i = 0; i < section_count; i++) {
+		const EFI_NVIDIA_ERROR_DATA *nvidia =
+			cper_record_view_nvidia(view, i);
+		if (nvidia == NULL) {
+			continue;
+		}
+
+		//Signatures are NUL padded, so only the bytes up to the terminator are kept.
+		NVIDIA_AGGREGATE_KEY key;
+		memset(&key, 0, sizeof(key));
+		memcpy(key.Signature, nvidia->Signature,
+		       strnlen(nvidia->Signature, sizeof(key.Signature)));
+		key.ErrorType = nvidia->ErrorType;
+		key.ErrorInstance = nvidia->ErrorInstance;
+		key.Socket = nvidia->Socket;
+
+		nvidia_aggregate(aggregator, &key,
+				 cper_record_view_section_severity(view, i),
+				 timestamp);
+		consumed++;
+	}
+
+	return consumed;
+}
+
+//Aggregates all NVIDIA sections within the given binary CPER record.
+//Returns the number of NVIDIA sections consumed, or -1 if the buffer is not a valid record.
+int cper_nvidia_aggregator_add_record(cper_nvidia_aggregator *aggregator,
+				      const void *record, size_t size)
+{
+	cper_record_view view;
+	if (!cper_record_view_init(&view, record, size)) {
+		return -1;
+	}
+	return cper_nvidia_aggregator_add_view(aggregator, &view);
+}
+
+//Converts a snapshot of the aggregator's current counters into JSON.
+json_object *
+cper_nvidia_aggregator_to_ir(const cper_nvidia_aggregator *aggregator)
+{
+	json_object *snapshot = json_object_new_object();
+	json_object_object_add(
+		snapshot, "totalSections",
+		json_object_new_uint64(aggregator->total_sections));
+	json_object_object_add(
+		snapshot, "droppedSections",
+		json_object_new_uint64(aggregator->dropped_sections));
+
+	json_object *entries = json_object_new_array();
+	size_t iterator = 0;
+	const void *key;
+	const AGG_COUNTERS *value;
+	while ((value = agg_table_next(&aggregator->table, &iterator, &key)) !=
+	       NULL) {
+		json_object_array_add(
+			entries,
+			nvidia_key_to_ir((const NVIDIA_AGGREGATE_KEY *)key,
+					 value));
+	}
+	json_object_object_add(snapshot, "entries", entries);
+
+	return snapshot;
+}
+
+//Adds a single section to the counters for the given key.
+static void nvidia_aggregate(cper_nvidia_aggregator *aggregator,
+			     const NVIDIA_AGGREGATE_KEY *key, UINT32 severity,
+			     const INT64 *timestamp)
+{
+	aggregator->total_sections++;
+
+	//Existing error sources are always updated, new ones only while there is room.
+	AGG_COUNTERS *value = agg_table_find(&aggregator->table, key);
+	if (value == NULL) {
+		if (aggregator->max_entries != 0 &&
+		    aggregator->table.count >= aggregator->max_entries) {
+			aggregator->dropped_sections++;
+			return;
+		}
+		value = agg_table_insert(&aggregator->table, key, NULL);
+		if (value == NULL) {
+			aggregator->dropped_sections++;
+			return;
+		}
+	}
+
+	agg_counters_add(value, severity, timestamp);
+}
+
+//Converts a single aggregated NVIDIA error source into JSON.
+static json_object *nvidia_key_to_ir(const NVIDIA_AGGREGATE_KEY *key,
+				     const AGG_COUNTERS *value)
+{
+	json_object *entry = json_object_new_object();
+
+	//Error source.
+	json_object_object_add(
+		entry, "signature",
+		json_object_new_string_len(
+			key->Signature,
+			strnlen(key->Signature, sizeof(key->Signature))));
+	json_object_object_add(entry, "socket",
+			       json_object_new_uint64(key->Socket));
+	json_object_object_add(entry, "errorType",
+			       json_object_new_uint64(key->ErrorType));
+	json_object_object_add(entry, "errorInstance",
+			       json_object_new_uint64(key->ErrorInstance));
+
+	//Counters.
+	agg_counters_to_ir(value, entry);
+
+	return entry;
+}
@@ -0,0 +1,37 @@
+#ifndef CPER_AGGREGATE_NVIDIA_H
+#define CPER_AGGREGATE_NVIDIA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <json.h>
+#include "../cper-view.h"
+#include "agg-table.h"
+
+//Streaming aggregator over NVIDIA sections, for storm counting.
+//Sections are keyed on signature, socket, error type and error instance, and each key keeps a
+//count, first/last timestamp and severity mix.
+typedef struct {
+	agg_table table;
+	size_t max_entries;
+	UINT64 total_sections;
+	UINT64 dropped_sections;
+} cper_nvidia_aggregator;
+
+int cper_nvidia_aggregator_init(cper_nvidia_aggregator *aggregator,
+				size_t max_entries);
+void cper_nvidia_aggregator_free(cper_nvidia_aggregator *aggregator);
+void cper_nvidia_aggregator_reset(cper_nvidia_aggregator *aggregator);
+int cper_nvidia_aggregator_add_view(cper_nvidia_aggregator *aggregator,
+				    const cper_record_view *view);
+int cper_nvidia_aggregator_add_record(cper_nvidia_aggregator *aggregator,
+				      const void *record, size_t size);
+json_object *
+cper_nvidia_aggregator_to_ir(const cper_nvidia_aggregator *aggregator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
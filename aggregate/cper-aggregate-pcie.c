@@ -0,0 +1,370 @@
+/**
+ * Describes a streaming aggregator for PCIe, PCI/PCI-X Bus and PCI/PCI-X Device CPER sections.
+ * Sections are read directly from binary records through the record view, and the AER status
+ * registers are decoded from the raw capability structure rather than via IR.
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <json.h>
+#include "../edk/Cper.h"
+#include "../sections/cper-section-pci-dev.h"
+#include "agg-counters.h"
+#include "cper-aggregate-pcie.h"
+
+//AER uncorrectable and correctable error status bit names, per the PCI Express Base Specification.
+//Reserved bits are NULL.
+const char *const PCIE_AER_UNCORRECTABLE_ERROR_NAMES[32] = {
+	NULL, NULL, NULL, NULL, "Data Link Protocol Error",
+	"Surprise Down Error", NULL, NULL, NULL, NULL, NULL, NULL,
+	"Poisoned TLP Received", "Flow Control Protocol Error",
+	"Completion Timeout", "Completer Abort", "Unexpected Completion",
+	"Receiver Overflow", "Malformed TLP", "ECRC Error",
+	"Unsupported Request Error", "ACS Violation",
+	"Uncorrectable Internal Error", "MC Blocked TLP",
+	"AtomicOp Egress Blocked", "TLP Prefix Blocked Error",
+	"Poisoned TLP Egress Blocked", "DMWr Request Egress Blocked",
+	"IDE Check Failed", "Misrouted IDE TLP", "PCRC Check Failed",
+	"TLP Translation Egress Blocked"
+};
+const char *const PCIE_AER_CORRECTABLE_ERROR_NAMES[32] = {
+	"Receiver Error", NULL, NULL, NULL, NULL, NULL, "Bad TLP", "Bad DLLP",
+	"REPLAY_NUM Rollover", NULL, NULL, NULL, "Replay Timer Timeout",
+	"Advisory Non-Fatal Error", "Corrected Internal Error",
+	"Header Log Overflow", NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+	NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+};
+
+//Register offsets within the AER extended capability structure.
+#define PCIE_AER_UNCORRECTABLE_STATUS_OFFSET   0x04
+#define PCIE_AER_UNCORRECTABLE_MASK_OFFSET     0x08
+#define PCIE_AER_UNCORRECTABLE_SEVERITY_OFFSET 0x0C
+#define PCIE_AER_CORRECTABLE_STATUS_OFFSET     0x10
+#define PCIE_AER_CORRECTABLE_MASK_OFFSET       0x14
+#define PCIE_AER_CAPABILITIES_CONTROL_OFFSET   0x18
+
+//Bits within PCIE_AGGREGATE_KEY.Valid, marking which address fields were provided.
+#define PCIE_KEY_BUS_VALID    0x01
+#define PCIE_KEY_DEVICE_VALID 0x02
+
+//Aggregation key for a single PCI function. Must contain no padding.
+typedef struct {
+	UINT16 Segment;
+	UINT8 Bus;
+	UINT8 Device;
+	UINT8 Function;
+	UINT8 Valid;
+	UINT8 Reserved[2];
+} PCIE_AGGREGATE_KEY;
+
+//Counters kept for each PCI function.
+typedef struct {
+	AGG_COUNTERS Counters;
+	UINT64 AerSections;
+	UINT64 UncorrectableCounts[32];
+	UINT64 CorrectableCounts[32];
+	UINT32 LastUncorrectableMask;
+	UINT32 LastUncorrectableSeverity;
+	UINT32 LastCorrectableMask;
+	UINT32 Reserved;
+} PCIE_AGGREGATE_VALUE;
+
+//Private pre-definitions.
+static UINT32 pcie_aer_register(const EFI_PCIE_ERROR_DATA *pcie,
+				size_t offset);
+static PCIE_AGGREGATE_VALUE *pcie_aggregate(cper_pcie_aggregator *aggregator,
+					    const PCIE_AGGREGATE_KEY *key,
+					    UINT32 severity,
+					    const INT64 *timestamp);
+static void pcie_aggregate_aer(PCIE_AGGREGATE_VALUE *value,
+			       const cper_pcie_aer *aer);
+static json_object *pcie_key_to_ir(const PCIE_AGGREGATE_KEY *key,
+				   const PCIE_AGGREGATE_VALUE *value);
+static json_object *pcie_status_counts_to_ir(const UINT64 *counts,
+					      const char *const *names);
+
+//Decodes the AER status, mask and severity registers from a PCIe section.
+//Returns 1 if the section carries valid AER information, 0 otherwise.
+int cper_pcie_aer_decode(const EFI_PCIE_ERROR_DATA *pcie, cper_pcie_aer *aer)
+{
+	if (!(pcie->ValidFields & 0x80)) {
+		return 0;
+	}
+
+	aer->uncorrectable_status = pcie_aer_register(
+		pcie, PCIE_AER_UNCORRECTABLE_STATUS_OFFSET);
+	aer->uncorrectable_mask =
+		pcie_aer_register(pcie, PCIE_AER_UNCORRECTABLE_MASK_OFFSET);
+	aer->uncorrectable_severity = pcie_aer_register(
+		pcie, PCIE_AER_UNCORRECTABLE_SEVERITY_OFFSET);
+	aer->correctable_status =
+		pcie_aer_register(pcie, PCIE_AER_CORRECTABLE_STATUS_OFFSET);
+	aer->correctable_mask =
+		pcie_aer_register(pcie, PCIE_AER_CORRECTABLE_MASK_OFFSET);
+	aer->capabilities_control = pcie_aer_register(
+		pcie, PCIE_AER_CAPABILITIES_CONTROL_OFFSET);
+	return 1;
+}
+
+//Initialises an empty aggregator. When max_entries is non-zero, sections for new functions beyond
+//that many entries are counted as dropped rather than aggregated.
+//Returns 1 on success, 0 on allocation failure.
+int cper_pcie_aggregator_init(cper_pcie_aggregator *aggregator,
+			      size_t max_entries)
+{
+	aggregator->max_entries = max_entries;
+	aggregator->total_sections = 0;
+	aggregator->dropped_sections = 0;
+	return agg_table_init(&aggregator->table, sizeof(PCIE_AGGREGATE_KEY),
+			      sizeof(PCIE_AGGREGATE_VALUE), 0);
+}
+
+//Frees all memory held by the aggregator.
+void cper_pcie_aggregator_free(cper_pcie_aggregator *aggregator)
+{
+	agg_table_free(&aggregator->table);
+}
+
+//Discards all aggregated counters, keeping allocated capacity.
+void cper_pcie_aggregator_reset(cper_pcie_aggregator *aggregator)
+{
+	agg_table_clear(&aggregator->table);
+	aggregator->total_sections = 0;
+	aggregator->dropped_sections = 0;
+}
+
+//Aggregates all PCIe, PCI/PCI-X Bus and PCI/PCI-X Device sections within the record behind the
+//given view. Returns the number of sections consumed.
+int cper_pcie_aggregator_add_view(cper_pcie_aggregator *aggregator,
+				  const cper_record_view *view)
+{
+	//Record timestamp, if present.
+	INT64 epoch = 0;
+	INT64 *timestamp = agg_record_epoch(view, &epoch) ? &epoch : NULL;
+
+	int consumed = 0;
+	UINT16 section_count = cper_record_view_section_count(view);
+	for (UINT16 i = 0; i < section_count; i++) {
+		PCIE_AGGREGATE_KEY key;
+		memset(&key, 0, sizeof(PCIE_AGGREGATE_KEY));
+		UINT32 severity = cper_record_view_section_severity(view, i);
+
+		const EFI_PCIE_ERROR_DATA *pcie =
+			cper_record_view_pcie(view, i);
+		const EFI_PCI_PCIX_BUS_ERROR_DATA *pci_bus = NULL;
+		const EFI_PCI_PCIX_DEVICE_ERROR_DATA *pci_dev = NULL;
+		if (pcie != NULL) {
+			cper_view_bdf bdf;
+			if (cper_record_view_pcie_bdf(view, i, &bdf)) {
+				key.Segment = bdf.segment;
+				key.Bus = bdf.bus;
+				key.Device = bdf.device;
+				key.Function = bdf.function;
+				key.Valid = PCIE_KEY_BUS_VALID |
+					    PCIE_KEY_DEVICE_VALID;
+			}
+			PCIE_AGGREGATE_VALUE *value = pcie_aggregate(
+				aggregator, &key, severity, timestamp);
+			cper_pcie_aer aer;
+			if (value != NULL && cper_pcie_aer_decode(pcie, &aer)) {
+				pcie_aggregate_aer(value, &aer);
+			}
+		} else if ((pci_bus = cper_record_view_pci_bus(view, i)) !=
+			   NULL) {
+			//Bus sections only identify the segment and bus.
+			if (pci_bus->ValidFields & 0x4) {
+				key.Segment = pci_bus->BusId >> 8;
+				key.Bus = pci_bus->BusId & 0xFF;
+				key.Valid = PCIE_KEY_BUS_VALID;
+			}
+			pcie_aggregate(aggregator, &key, severity, timestamp);
+		} else if ((pci_dev = cper_record_view_pci_dev(view, i)) !=
+			   NULL) {
+			if (pci_dev->ValidFields & 0x2) {
+				key.Segment = pci_dev->IdInfo.SegmentNumber;
+				key.Bus = pci_dev->IdInfo.BusNumber;
+				key.Device = pci_dev->IdInfo.DeviceNumber;
+				key.Function = pci_dev->IdInfo.FunctionNumber;
+				key.Valid = PCIE_KEY_BUS_VALID |
+					    PCIE_KEY_DEVICE_VALID;
+			}
+			pcie_aggregate(aggregator, &key, severity, timestamp);
+		} else {
+			continue;
+		}
+		consumed++;
+	}
+
+	return consumed;
+}
+
+//Aggregates all PCIe, PCI/PCI-X Bus and PCI/PCI-X Device sections within the given binary CPER
+//record. Returns the number of sections consumed, or -1 if the buffer is not a valid record.
+int cper_pcie_aggregator_add_record(cper_pcie_aggregator *aggregator,
+				    const void *record, size_t size)
+{
+	cper_record_view view;
+	if (!cper_record_view_init(&view, record, size)) {
+		return -1;
+	}
+	return cper_pcie_aggregator_add_view(aggregator, &view);
+}
+
+//Converts a snapshot of the aggregator's current counters into JSON.
+json_object *cper_pcie_aggregator_to_ir(const cper_pcie_aggregator *aggregator)
+{
+	json_object *snapshot = json_object_new_object();
+	json_object_object_add(
+		snapshot, "totalSections",
+		json_object_new_uint64(aggregator->total_sections));
+	json_object_object_add(
+		snapshot, "droppedSections",
+		json_object_new_uint64(aggregator->dropped_sections));
+
+	json_object *entries = json_object_new_array();
+	size_t iterator = 0;
+	const void *key;
+	const PCIE_AGGREGATE_VALUE *value;
+	while ((value = agg_table_next(&aggregator->table, &iterator, &key)) !=
+	       NULL) {
+		json_object_array_add(
+			entries,
+			pcie_key_to_ir((const PCIE_AGGREGATE_KEY *)key, value));
+	}
+	json_object_object_add(snapshot, "entries", entries);
+
+	return snapshot;
+}
+
+//Reads a single 32-bit register from the AER capability structure at the given byte offset.
+static UINT32 pcie_aer_register(const EFI_PCIE_ERROR_DATA *pcie,
+				size_t offset)
+{
+	UINT32 reg;
+	memcpy(&reg, pcie->AerInfo.PcieAer + offset, sizeof(UINT32));
+	return reg;
+}
+
+//Adds a single section to the counters for the given key.
+//Returns the entry's value, or NULL if the section was dropped.
+static PCIE_AGGREGATE_VALUE *pcie_aggregate(cper_pcie_aggregator *aggregator,
+					    const PCIE_AGGREGATE_KEY *key,
+					    UINT32 severity,
+					    const INT64 *timestamp)
+{
+	aggregator->total_sections++;
+
+	//Existing functions are always updated, new ones only while there is room.
+	PCIE_AGGREGATE_VALUE *value = agg_table_find(&aggregator->table, key);
+	if (value == NULL) {
+		if (aggregator->max_entries != 0 &&
+		    aggregator->table.count >= aggregator->max_entries) {
+			aggregator->dropped_sections++;
+			return NULL;
+		}
+		value = agg_table_insert(&aggregator->table, key, NULL);
+		if (value == NULL) {
+			aggregator->dropped_sections++;
+			return NULL;
+		}
+	}
+
+	agg_counters_add(&value->Counters, severity, timestamp);
+	return value;
+}
+
+//Adds the status bits of a decoded AER structure to the per-bit counters.
+static void pcie_aggregate_aer(PCIE_AGGREGATE_VALUE *value,
+			       const cper_pcie_aer *aer)
+{
+	value->AerSections++;
+	for (int i = 0; i < 32; i++) {
+		if (aer->uncorrectable_status & (1U << i)) {
+			value->UncorrectableCounts[i]++;
+		}
+		if (aer->correctable_status & (1U << i)) {
+			value->CorrectableCounts[i]++;
+		}
+	}
+	value->LastUncorrectableMask = aer->uncorrectable_mask;
+	value->LastUncorrectableSeverity = aer->uncorrectable_severity;
+	value->LastCorrectableMask = aer->correctable_mask;
+}
+
+//Converts a single aggregated PCI function into JSON.
+static json_object *pcie_key_to_ir(const PCIE_AGGREGATE_KEY *key,
+				   const PCIE_AGGREGATE_VALUE *value)
+{
+	json_object *entry = json_object_new_object();
+
+	//Address, only including fields that were provided.
+	if (key->Valid & PCIE_KEY_BUS_VALID) {
+		json_object_object_add(entry, "segment",
+				       json_object_new_uint64(key->Segment));
+		json_object_object_add(entry, "bus",
+				       json_object_new_uint64(key->Bus));
+	}
+	if (key->Valid & PCIE_KEY_DEVICE_VALID) {
+		json_object_object_add(entry, "device",
+				       json_object_new_uint64(key->Device));
+		json_object_object_add(entry, "function",
+				       json_object_new_uint64(key->Function));
+	}
+
+	//Counters.
+	agg_counters_to_ir(&value->Counters, entry);
+
+	//AER status bit counters and the most recent mask/severity registers.
+	if (value->AerSections > 0) {
+		json_object *aer = json_object_new_object();
+		json_object_object_add(
+			aer, "sections",
+			json_object_new_uint64(value->AerSections));
+		json_object_object_add(
+			aer, "uncorrectableErrors",
+			pcie_status_counts_to_ir(
+				value->UncorrectableCounts,
+				PCIE_AER_UNCORRECTABLE_ERROR_NAMES));
+		json_object_object_add(
+			aer, "correctableErrors",
+			pcie_status_counts_to_ir(
+				value->CorrectableCounts,
+				PCIE_AER_CORRECTABLE_ERROR_NAMES));
+		json_object_object_add(
+			aer, "lastUncorrectableMask",
+			json_object_new_uint64(value->LastUncorrectableMask));
+		json_object_object_add(
+			aer, "lastUncorrectableSeverity",
+			json_object_new_uint64(
+				value->LastUncorrectableSeverity));
+		json_object_object_add(
+			aer, "lastCorrectableMask",
+			json_object_new_uint64(value->LastCorrectableMask));
+		json_object_object_add(entry, "aer", aer);
+	}
+
+	return entry;
+}
+
+//Converts the non-zero per-bit counters of a status register into a JSON array of
+//{ "bit", "name", "count" } objects. Reserved bits are named "Reserved".
+static json_object *pcie_status_counts_to_ir(const UINT64 *counts,
+					      const char *const *names)
+{
+	json_object *bits = json_object_new_array();
+	for (int i = 0; i < 32; i++) {
+		if (counts[i] == 0) {
+			continue;
+		}
+		json_object *bit = json_object_new_object();
+		json_object_object_add(bit, "bit", json_object_new_int(i));
+		json_object_object_add(
+			bit, "name",
+			json_object_new_string(names[i] == NULL ? "Reserved" :
+								  names[i]));
+		json_object_object_add(bit, "count",
+				       json_object_new_uint64(counts[i]));
+		json_object_array_add(bits, bit);
+	}
+	return bits;
+}
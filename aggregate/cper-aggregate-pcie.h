@@ -0,0 +1,52 @@
+#ifndef CPER_AGGREGATE_PCIE_H
+#define CPER_AGGREGATE_PCIE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <json.h>
+#include "../cper-view.h"
+#include "agg-table.h"
+
+extern const char *const PCIE_AER_UNCORRECTABLE_ERROR_NAMES[32];
+extern const char *const PCIE_AER_CORRECTABLE_ERROR_NAMES[32];
+
+//Status, mask and severity registers decoded from the AER extended capability structure
+//carried in a PCIe section.
+typedef struct {
+	UINT32 uncorrectable_status;
+	UINT32 uncorrectable_mask;
+	UINT32 uncorrectable_severity;
+	UINT32 correctable_status;
+	UINT32 correctable_mask;
+	UINT32 capabilities_control;
+} cper_pcie_aer;
+
+int cper_pcie_aer_decode(const EFI_PCIE_ERROR_DATA *pcie, cper_pcie_aer *aer);
+
+//Streaming aggregator over PCIe, PCI/PCI-X Bus and PCI/PCI-X Device sections.
+//Sections are keyed on segment/bus/device/function, and each key keeps a count, first/last
+//timestamp, severity mix and a count per AER correctable and uncorrectable status bit.
+typedef struct {
+	agg_table table;
+	size_t max_entries;
+	UINT64 total_sections;
+	UINT64 dropped_sections;
+} cper_pcie_aggregator;
+
+int cper_pcie_aggregator_init(cper_pcie_aggregator *aggregator,
+			      size_t max_entries);
+void cper_pcie_aggregator_free(cper_pcie_aggregator *aggregator);
+void cper_pcie_aggregator_reset(cper_pcie_aggregator *aggregator);
+int cper_pcie_aggregator_add_view(cper_pcie_aggregator *aggregator,
+				  const cper_record_view *view);
+int cper_pcie_aggregator_add_record(cper_pcie_aggregator *aggregator,
+				    const void *record, size_t size);
+json_object *cper_pcie_aggregator_to_ir(const cper_pcie_aggregator *aggregator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,298 @@
+/**
+ * Describes storm suppression for CPER records at ingest. Each key (notification type, section
+ * type and FRU ID of the record's primary section) has a token bucket, and records arriving
+ * without a token are counted rather than decoded. Suppressed counts are reported periodically
+ * as a synthetic summary record.
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <json.h>
+#include "../edk/Cper.h"
+#include "../cper-parse.h"
+#include "../cper-utils.h"
+#include "cper-suppress.h"
+
+//Tokens are kept in thousandths, so partial refills between records are not lost.
+#define SUPPRESS_TOKEN_SCALE 1000
+
+//Suppression key. Must contain no padding. Once the table is full, new keys share the all zero key.
+typedef struct {
+	EFI_GUID NotificationType;
+	EFI_GUID SectionType;
+	EFI_GUID FruId;
+} SUPPRESS_KEY;
+
+//Token bucket and suppressed counts for a single key.
+typedef struct {
+	UINT64 Tokens;
+	UINT64 UpdatedMs;
+	UINT64 Suppressed;
+	UINT64 TotalSuppressed;
+} SUPPRESS_BUCKET;
+
+//Private pre-definitions.
+static int suppress_bypass(const cper_record_view *view);
+static void suppress_key_from_view(SUPPRESS_KEY *key,
+				   const cper_record_view *view);
+static SUPPRESS_BUCKET *suppress_bucket(cper_suppressor *suppressor,
+					const SUPPRESS_KEY *key,
+					UINT64 now_ms);
+static void suppress_refill(const cper_suppress_policy *policy,
+			    SUPPRESS_BUCKET *bucket, UINT64 now_ms);
+static json_object *suppress_guid_to_ir(const EFI_GUID *guid);
+
+//Initialises a suppressor with the given policy. When max_entries is non-zero, the table is sized
+//up front and keys beyond that many share a single overflow bucket, so memory use stays fixed.
+//Returns 1 on success, 0 on allocation failure.
+int cper_suppressor_init(cper_suppressor *suppressor,
+			 const cper_suppress_policy *policy,
+			 size_t max_entries)
+{
+	suppressor->policy = *policy;
+	suppressor->max_entries = max_entries;
+	suppressor->last_summary_ms = 0;
+	suppressor->decoded_records = 0;
+	suppressor->bypassed_records = 0;
+	suppressor->suppressed_records = 0;
+	suppressor->unsummarised_records = 0;
+	return agg_table_init(&suppressor->table, sizeof(SUPPRESS_KEY),
+			      sizeof(SUPPRESS_BUCKET), max_entries);
+}
+
+//Frees all memory held by the suppressor.
+void cper_suppressor_free(cper_suppressor *suppressor)
+{
+	agg_table_free(&suppressor->table);
+}
+
+//Decides whether the given binary CPER record should be decoded at the given time (in
+//milliseconds, from any monotonic clock), consuming a token from its key's bucket if so.
+//Returns one of the CPER_SUPPRESS_* outcomes; suppressed records are counted against their key.
+int cper_suppressor_check(cper_suppressor *suppressor, const void *record,
+			  size_t size, UINT64 now_ms)
+{
+	cper_record_view view;
+	if (!cper_record_view_init(&view, record, size)) {
+		return CPER_SUPPRESS_INVALID;
+	}
+	if (suppress_bypass(&view)) {
+		suppressor->bypassed_records++;
+		return CPER_SUPPRESS_BYPASS;
+	}
+
+	SUPPRESS_KEY key;
+	suppress_key_from_view(&key, &view);
+	SUPPRESS_BUCKET *bucket = suppress_bucket(suppressor, &key, now_ms);
+	if (bucket == NULL) {
+		//Without a bucket, fail open rather than lose the record.
+		suppressor->decoded_records++;
+		return CPER_SUPPRESS_DECODE;
+	}
+
+	suppress_refill(&suppressor->policy, bucket, now_ms);
+	if (bucket->Tokens >= SUPPRESS_TOKEN_SCALE) {
+		bucket->Tokens -= SUPPRESS_TOKEN_SCALE;
+		suppressor->decoded_records++;
+		return CPER_SUPPRESS_DECODE;
+	}
+
+	bucket->Suppressed++;
+	bucket->TotalSuppressed++;
+	suppressor->suppressed_records++;
+	suppressor->unsummarised_records++;
+	return CPER_SUPPRESS_SUPPRESSED;
+}
+
+//Converts the given binary CPER record into IR if the policy allows it.
+//Returns NULL if the record was suppressed (and counted) or is not a valid record.
+json_object *cper_suppressor_to_ir(cper_suppressor *suppressor,
+				   const void *record, size_t size,
+				   UINT64 now_ms)
+{
+	int outcome = cper_suppressor_check(suppressor, record, size, now_ms);
+	if (outcome != CPER_SUPPRESS_DECODE &&
+	    outcome != CPER_SUPPRESS_BYPASS) {
+		return NULL;
+	}
+
+	FILE *stream = fmemopen((void *)record, size, "r");
+	if (stream == NULL) {
+		printf("Failed to open record stream.\n");
+		return NULL;
+	}
+	json_object *ir = cper_to_ir(stream);
+	fclose(stream);
+	return ir;
+}
+
+//Builds a synthetic report of the records suppressed since the last summary, per key, and starts
+//a new summary period. Returns NULL if nothing was suppressed.
+json_object *cper_suppressor_summary(cper_suppressor *suppressor,
+				     UINT64 now_ms)
+{
+	suppressor->last_summary_ms = now_ms;
+	if (suppressor->unsummarised_records == 0) {
+		return NULL;
+	}
+
+	json_object *summary = json_object_new_object();
+	json_object_object_add(summary, "type",
+			       json_object_new_string("suppressionSummary"));
+	json_object_object_add(
+		summary, "suppressedRecords",
+		json_object_new_uint64(suppressor->unsummarised_records));
+	json_object_object_add(
+		summary, "totalSuppressedRecords",
+		json_object_new_uint64(suppressor->suppressed_records));
+
+	json_object *entries = json_object_new_array();
+	size_t iterator = 0;
+	const void *key_ptr;
+	SUPPRESS_BUCKET *bucket;
+	while ((bucket = agg_table_next(&suppressor->table, &iterator,
+					&key_ptr)) != NULL) {
+		if (bucket->Suppressed == 0) {
+			continue;
+		}
+		const SUPPRESS_KEY *key = (const SUPPRESS_KEY *)key_ptr;
+		json_object *entry = json_object_new_object();
+		json_object_object_add(
+			entry, "notificationType",
+			suppress_guid_to_ir(&key->NotificationType));
+		json_object_object_add(entry, "sectionType",
+				       suppress_guid_to_ir(&key->SectionType));
+		json_object_object_add(entry, "fruID",
+				       suppress_guid_to_ir(&key->FruId));
+		json_object_object_add(
+			entry, "suppressed",
+			json_object_new_uint64(bucket->Suppressed));
+		json_object_array_add(entries, entry);
+		bucket->Suppressed = 0;
+	}
+	json_object_object_add(summary, "entries", entries);
+
+	suppressor->unsummarised_records = 0;
+	return summary;
+}
+
+//Returns a summary if the policy's summary interval has elapsed and records were suppressed,
+//or NULL otherwise.
+json_object *cper_suppressor_poll(cper_suppressor *suppressor, UINT64 now_ms)
+{
+	if (now_ms - suppressor->last_summary_ms <
+	    (UINT64)suppressor->policy.summary_interval * 1000) {
+		return NULL;
+	}
+	return cper_suppressor_summary(suppressor, now_ms);
+}
+
+//Returns whether the record must always be decoded, having a fatal or recoverable header or
+//section severity.
+static int suppress_bypass(const cper_record_view *view)
+{
+	UINT32 severity = cper_record_view_severity(view);
+	if (severity == EFI_GENERIC_ERROR_RECOVERABLE ||
+	    severity == EFI_GENERIC_ERROR_FATAL) {
+		return 1;
+	}
+	UINT16 section_count = cper_record_view_section_count(view);
+	for (UINT16 i = 0; i < section_count; i++) {
+		severity = cper_record_view_section_severity(view, i);
+		if (severity == EFI_GENERIC_ERROR_RECOVERABLE ||
+		    severity == EFI_GENERIC_ERROR_FATAL) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//Builds a suppression key from the record's notification type and its primary section (or the
+//first section, if none is marked primary).
+static void suppress_key_from_view(SUPPRESS_KEY *key,
+				   const cper_record_view *view)
+{
+	memset(key, 0, sizeof(SUPPRESS_KEY));
+	const EFI_GUID *notification_type =
+		cper_record_view_notification_type(view);
+	if (notification_type != NULL) {
+		key->NotificationType = *notification_type;
+	}
+
+	const EFI_ERROR_SECTION_DESCRIPTOR *primary =
+		cper_record_view_descriptor(view, 0);
+	UINT16 section_count = cper_record_view_section_count(view);
+	for (UINT16 i = 0; i < section_count; i++) {
+		const EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+			cper_record_view_descriptor(view, i);
+		if (descriptor != NULL && (descriptor->SectionFlags & 0x1)) {
+			primary = descriptor;
+			break;
+		}
+	}
+	if (primary == NULL) {
+		return;
+	}
+	key->SectionType = primary->SectionType;
+	if (primary->SecValidMask & 0x1) {
+		key->FruId = primary->FruId;
+	}
+}
+
+//Returns the token bucket for the given key, creating a full bucket for new keys.
+//Once the table holds max_entries keys, new keys share the all zero overflow key.
+static SUPPRESS_BUCKET *suppress_bucket(cper_suppressor *suppressor,
+					const SUPPRESS_KEY *key,
+					UINT64 now_ms)
+{
+	SUPPRESS_BUCKET *bucket = agg_table_find(&suppressor->table, key);
+	if (bucket != NULL) {
+		return bucket;
+	}
+
+	SUPPRESS_KEY overflow;
+	if (suppressor->max_entries != 0 &&
+	    suppressor->table.count + 1 >= suppressor->max_entries) {
+		memset(&overflow, 0, sizeof(overflow));
+		key = &overflow;
+	}
+
+	int inserted = 0;
+	bucket = agg_table_insert(&suppressor->table, key, &inserted);
+	if (bucket != NULL && inserted) {
+		bucket->Tokens = (UINT64)suppressor->policy.burst *
+				 SUPPRESS_TOKEN_SCALE;
+		bucket->UpdatedMs = now_ms;
+	}
+	return bucket;
+}
+
+//Adds the tokens accrued since the bucket was last updated, up to the burst size.
+static void suppress_refill(const cper_suppress_policy *policy,
+			    SUPPRESS_BUCKET *bucket, UINT64 now_ms)
+{
+	if (now_ms <= bucket->UpdatedMs) {
+		return;
+	}
+	//Rates are per second and tokens are in thousandths, so each millisecond adds "rate".
+	UINT64 limit = (UINT64)policy->burst * SUPPRESS_TOKEN_SCALE;
+	UINT64 elapsed = now_ms - bucket->UpdatedMs;
+	UINT64 added = elapsed * policy->rate;
+	if (policy->rate != 0 && added / policy->rate != elapsed) {
+		added = limit;
+	}
+	if (limit - bucket->Tokens < added) {
+		bucket->Tokens = limit;
+	} else {
+		bucket->Tokens += added;
+	}
+	bucket->UpdatedMs = now_ms;
+}
+
+static json_object *suppress_guid_to_ir(const EFI_GUID *guid)
+{
+	char guid_string[GUID_STRING_LENGTH];
+	EFI_GUID copy = *guid;
+	guid_to_string(guid_string, &copy);
+	return json_object_new_string(guid_string);
+}
@@ -0,0 +1,57 @@
+#ifndef CPER_SUPPRESS_H
+#define CPER_SUPPRESS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <json.h>
+#include "../cper-view.h"
+#include "agg-table.h"
+
+//Outcomes of cper_suppressor_check().
+#define CPER_SUPPRESS_DECODE	 0
+#define CPER_SUPPRESS_BYPASS	 1
+#define CPER_SUPPRESS_SUPPRESSED 2
+#define CPER_SUPPRESS_INVALID	 3
+
+//Token bucket policy applied per key. Each key may decode "burst" records at once, refilled at
+//"rate" records per second. Suppressed counts are summarised every "summary_interval" seconds.
+typedef struct {
+	UINT32 rate;
+	UINT32 burst;
+	UINT32 summary_interval;
+} cper_suppress_policy;
+
+//Storm suppression in front of cper_to_ir(), keyed on notification type, section type and FRU ID.
+//Records over their key's budget are only counted, by peeking at the header and descriptors.
+//Records with a fatal or recoverable header or section severity are always decoded.
+typedef struct {
+	agg_table table;
+	cper_suppress_policy policy;
+	size_t max_entries;
+	UINT64 last_summary_ms;
+	UINT64 decoded_records;
+	UINT64 bypassed_records;
+	UINT64 suppressed_records;
+	UINT64 unsummarised_records;
+} cper_suppressor;
+
+int cper_suppressor_init(cper_suppressor *suppressor,
+			 const cper_suppress_policy *policy,
+			 size_t max_entries);
+void cper_suppressor_free(cper_suppressor *suppressor);
+int cper_suppressor_check(cper_suppressor *suppressor, const void *record,
+			  size_t size, UINT64 now_ms);
+json_object *cper_suppressor_to_ir(cper_suppressor *suppressor,
+				   const void *record, size_t size,
+				   UINT64 now_ms);
+json_object *cper_suppressor_summary(cper_suppressor *suppressor,
+				     UINT64 now_ms);
+json_object *cper_suppressor_poll(cper_suppressor *suppressor, UINT64 now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,293 @@
+/**
+ * Describes a streaming sliding window threshold engine for CPER sections, for predictive
+ * failure detection ("N corrected errors in T seconds") per FRU.
+ * Each rule's window is split into CPER_THRESHOLD_BUCKETS buckets of equal width (at least one
+ * second), so counts expire at bucket rather than second granularity.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <json.h>
+#include "../edk/Cper.h"
+#include "../cper-utils.h"
+#include "agg-counters.h"
+#include "cper-threshold.h"
+
+//Threshold key for a single FRU, section type, severity and rule. Must contain no padding.
+typedef struct {
+	EFI_GUID FruId;
+	EFI_GUID SectionType;
+	UINT32 Severity;
+	UINT32 Rule;
+} THRESHOLD_KEY;
+
+//Sliding window for a single key. "Head" is the index of the newest bucket.
+typedef struct {
+	UINT32 Counts[CPER_THRESHOLD_BUCKETS];
+	INT64 Head;
+	UINT32 Total;
+	UINT32 Crossed;
+} THRESHOLD_WINDOW;
+
+//Private pre-definitions.
+static int
+threshold_rule_matches(const cper_threshold_rule *rule,
+		       const EFI_ERROR_SECTION_DESCRIPTOR *descriptor);
+static int threshold_add(cper_threshold_engine *engine, size_t rule,
+			 const EFI_ERROR_SECTION_DESCRIPTOR *descriptor,
+			 INT64 timestamp);
+static void threshold_window_add(THRESHOLD_WINDOW *window, INT64 bucket,
+				 int inserted);
+
+//Initialises an engine for the given rules, which are copied. When max_entries is non-zero, the
+//table is sized up front and sections for new keys beyond that many entries are dropped, so
+//memory use stays fixed. The callback (if provided) is called for every threshold crossing.
+//Returns 1 on success, 0 on allocation failure.
+int cper_threshold_engine_init(cper_threshold_engine *engine,
+			       const cper_threshold_rule *rules,
+			       size_t rule_count, size_t max_entries,
+			       cper_threshold_callback callback, void *context)
+{
+	engine->rule_count = rule_count;
+	engine->max_entries = max_entries;
+	engine->now = 0;
+	engine->dropped_sections = 0;
+	engine->callback = callback;
+	engine->context = context;
+	//One extra byte, so that an empty rule set still allocates.
+	engine->rules = malloc(rule_count * sizeof(cper_threshold_rule) + 1);
+	if (engine->rules == NULL) {
+		printf("Failed to allocate threshold rules.\n");
+		return 0;
+	}
+	memcpy(engine->rules, rules, rule_count * sizeof(cper_threshold_rule));
+
+	if (!agg_table_init(&engine->table, sizeof(THRESHOLD_KEY),
+			    sizeof(THRESHOLD_WINDOW), max_entries)) {
+		free(engine->rules);
+		engine->rules = NULL;
+		return 0;
+	}
+	return 1;
+}
+
+//Frees all memory held by the engine.
+void cper_threshold_engine_free(cper_threshold_engine *engine)
+{
+	agg_table_free(&engine->table);
+	free(engine->rules);
+	engine->rules = NULL;
+}
+
+//Discards all window counts, keeping the rules and allocated capacity.
+void cper_threshold_engine_reset(cper_threshold_engine *engine)
+{
+	agg_table_clear(&engine->table);
+	engine->now = 0;
+	engine->dropped_sections = 0;
+}
+
+//Adds all sections within the record behind the given view to the matching rules' windows.
+//Records without a timestamp are counted at the latest timestamp seen so far.
+//Returns the number of threshold crossings emitted.
+int cper_threshold_engine_add_view(cper_threshold_engine *engine,
+				   const cper_record_view *view)
+{
+	INT64 epoch = 0;
+	if (agg_record_epoch(view, &epoch)) {
+		if (epoch > engine->now) {
+			engine->now = epoch;
+		}
+	} else {
+		epoch = engine->now;
+	}
+
+	int events = 0;
+	UINT16 section_count = cper_record_view_section_count(view);
+	for (UINT16 i = 0; i < section_count; i++) {
+		const EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+			cper_record_view_descriptor(view, i);
+		if (descriptor == NULL) {
+			break;
+		}
+		for (size_t rule = 0; rule < engine->rule_count; rule++) {
+			if (threshold_rule_matches(&engine->rules[rule],
+						   descriptor)) {
+				events += threshold_add(engine, rule,
+							descriptor, epoch);
+			}
+		}
+	}
+
+	return events;
+}
+
+//Adds all sections within the given binary CPER record to the matching rules' windows.
+//Returns the number of threshold crossings emitted, or -1 if the buffer is not a valid record.
+int cper_threshold_engine_add_record(cper_threshold_engine *engine,
+				     const void *record, size_t size)
+{
+	cper_record_view view;
+	if (!cper_record_view_init(&view, record, size)) {
+		return -1;
+	}
+	return cper_threshold_engine_add_view(engine, &view);
+}
+
+//Converts a threshold crossing event into JSON.
+json_object *cper_threshold_event_to_ir(const cper_threshold_event *event)
+{
+	json_object *event_ir = json_object_new_object();
+	json_object_object_add(event_ir, "rule",
+			       json_object_new_uint64(event->rule));
+
+	char guid_string[GUID_STRING_LENGTH];
+	EFI_GUID guid = event->fru_id;
+	guid_to_string(guid_string, &guid);
+	json_object_object_add(event_ir, "fruID",
+			       json_object_new_string(guid_string));
+	json_object_object_add(
+		event_ir, "fruText",
+		json_object_new_string_len(
+			event->fru_string,
+			strnlen(event->fru_string, sizeof(event->fru_string))));
+
+	guid = event->section_type;
+	guid_to_string(guid_string, &guid);
+	json_object_object_add(event_ir, "sectionType",
+			       json_object_new_string(guid_string));
+
+	json_object *severity = json_object_new_object();
+	json_object_object_add(severity, "code",
+			       json_object_new_uint64(event->severity));
+	json_object_object_add(
+		severity, "name",
+		json_object_new_string(severity_to_string(event->severity)));
+	json_object_object_add(event_ir, "severity", severity);
+
+	json_object_object_add(event_ir, "count",
+			       json_object_new_uint64(event->count));
+	json_object_object_add(event_ir, "timestampEpoch",
+			       json_object_new_int64(event->timestamp));
+	return event_ir;
+}
+
+//Returns whether the section behind the given descriptor is counted by the given rule.
+static int
+threshold_rule_matches(const cper_threshold_rule *rule,
+		       const EFI_ERROR_SECTION_DESCRIPTOR *descriptor)
+{
+	if (descriptor->Severity != rule->severity) {
+		return 0;
+	}
+	EFI_GUID any = { 0 };
+	EFI_GUID rule_type = rule->section_type;
+	EFI_GUID section_type = descriptor->SectionType;
+	return guid_equal(&rule_type, &any) ||
+	       guid_equal(&rule_type, &section_type);
+}
+
+//Counts a single section against a single rule, emitting an event if this crosses the threshold.
+//Returns 1 if an event was emitted, 0 otherwise.
+static int threshold_add(cper_threshold_engine *engine, size_t rule,
+			 const EFI_ERROR_SECTION_DESCRIPTOR *descriptor,
+			 INT64 timestamp)
+{
+	const cper_threshold_rule *threshold = &engine->rules[rule];
+
+	//Sections without a valid FRU ID all share the zero FRU ID.
+	THRESHOLD_KEY key;
+	memset(&key, 0, sizeof(key));
+	if (descriptor->SecValidMask & 0x1) {
+		key.FruId = descriptor->FruId;
+	}
+	key.SectionType = descriptor->SectionType;
+	key.Severity = descriptor->Severity;
+	key.Rule = (UINT32)rule;
+
+	//Existing keys are always updated, new ones only while there is room.
+	int inserted = 0;
+	THRESHOLD_WINDOW *window = agg_table_find(&engine->table, &key);
+	if (window == NULL) {
+		if (engine->max_entries != 0 &&
+		    engine->table.count >= engine->max_entries) {
+			engine->dropped_sections++;
+			return 0;
+		}
+		window = agg_table_insert(&engine->table, &key, &inserted);
+		if (window == NULL) {
+			engine->dropped_sections++;
+			return 0;
+		}
+	}
+
+	//Timestamps before the epoch are counted as the epoch.
+	if (timestamp < 0) {
+		timestamp = 0;
+	}
+	UINT32 width = (threshold->window + CPER_THRESHOLD_BUCKETS - 1) /
+		       CPER_THRESHOLD_BUCKETS;
+	if (width == 0) {
+		width = 1;
+	}
+	threshold_window_add(window, timestamp / width, inserted);
+
+	//Only the first crossing is emitted, until the count falls back below the threshold.
+	if (window->Total < threshold->threshold) {
+		window->Crossed = 0;
+		return 0;
+	}
+	if (window->Crossed) {
+		return 0;
+	}
+	window->Crossed = 1;
+
+	if (engine->callback != NULL) {
+		cper_threshold_event event;
+		memset(&event, 0, sizeof(event));
+		event.rule = rule;
+		event.fru_id = key.FruId;
+		if (descriptor->SecValidMask & 0x2) {
+			memcpy(event.fru_string, descriptor->FruString,
+			       sizeof(event.fru_string));
+		}
+		event.section_type = key.SectionType;
+		event.severity = key.Severity;
+		event.count = window->Total;
+		event.timestamp = timestamp;
+		engine->callback(&event, engine->context);
+	}
+	return 1;
+}
+
+//Adds a single occurrence in the given bucket, first expiring buckets that have left the window.
+//Occurrences older than the whole window are ignored.
+static void threshold_window_add(THRESHOLD_WINDOW *window, INT64 bucket,
+				 int inserted)
+{
+	if (inserted) {
+		window->Head = bucket;
+	}
+
+	if (bucket > window->Head) {
+		if (bucket - window->Head >= CPER_THRESHOLD_BUCKETS) {
+			memset(window->Counts, 0, sizeof(window->Counts));
+			window->Total = 0;
+		} else {
+			for (INT64 i = window->Head + 1; i <= bucket; i++) {
+				UINT32 *count =
+					&window->Counts[i %
+							CPER_THRESHOLD_BUCKETS];
+				window->Total -= *count;
+				*count = 0;
+			}
+		}
+		window->Head = bucket;
+	} else if (window->Head - bucket >= CPER_THRESHOLD_BUCKETS) {
+		return;
+	}
+
+	window->Counts[bucket % CPER_THRESHOLD_BUCKETS]++;
+	window->Total++;
+}
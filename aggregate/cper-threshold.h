@@ -0,0 +1,68 @@
+#ifndef CPER_THRESHOLD_H
+#define CPER_THRESHOLD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <json.h>
+#include "../cper-view.h"
+#include "agg-table.h"
+
+//Number of buckets each rule's sliding window is divided into.
+#define CPER_THRESHOLD_BUCKETS 16
+
+//A single threshold rule: "threshold" sections of the given type and severity for one FRU within
+//"window" seconds. An all zero section type matches sections of any type.
+typedef struct {
+	EFI_GUID section_type;
+	UINT32 severity;
+	UINT32 threshold;
+	UINT32 window;
+} cper_threshold_rule;
+
+//Emitted when a FRU's count within a rule's window reaches the rule's threshold.
+typedef struct {
+	size_t rule;
+	EFI_GUID fru_id;
+	CHAR8 fru_string[20];
+	EFI_GUID section_type;
+	UINT32 severity;
+	UINT32 count;
+	INT64 timestamp;
+} cper_threshold_event;
+
+typedef void (*cper_threshold_callback)(const cper_threshold_event *event,
+					void *context);
+
+//Streaming sliding window threshold engine, keyed on FRU ID, section type and severity.
+//Sections are read directly from binary records through the record view, and each key keeps a
+//fixed size ring of per-bucket counts, so corrected errors never crossing a threshold create no IR.
+typedef struct {
+	agg_table table;
+	cper_threshold_rule *rules;
+	size_t rule_count;
+	size_t max_entries;
+	INT64 now;
+	UINT64 dropped_sections;
+	cper_threshold_callback callback;
+	void *context;
+} cper_threshold_engine;
+
+int cper_threshold_engine_init(cper_threshold_engine *engine,
+			       const cper_threshold_rule *rules,
+			       size_t rule_count, size_t max_entries,
+			       cper_threshold_callback callback, void *context);
+void cper_threshold_engine_free(cper_threshold_engine *engine);
+void cper_threshold_engine_reset(cper_threshold_engine *engine);
+int cper_threshold_engine_add_view(cper_threshold_engine *engine,
+				   const cper_record_view *view);
+int cper_threshold_engine_add_record(cper_threshold_engine *engine,
+				     const void *record, size_t size);
+json_object *cper_threshold_event_to_ir(const cper_threshold_event *event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
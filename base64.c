@@ -1,6 +1,8 @@
 #include "base64.h"
 #include "edk/BaseTypes.h"
+#include "cper-metrics-internal.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -24,18 +26,20 @@ CHAR8 *base64_encode(const UINT8 *src, INT32 len, INT32 *out_len)
 		return NULL;
 	}
 
-	// 3 byte blocks to 4 byte blocks plus up to 2 bytes of padding
-	*out_len = 4 * ((len + 2) / 3);
-
-	// Handle overflows
-	if (*out_len < len) {
+	// Handle overflows, before computing the output length can overflow itself
+	if (len < 0 || len > INT32_MAX / 4 * 3 - 2) {
+		*out_len = 0;
 		return NULL;
 	}
 
+	// 3 byte blocks to 4 byte blocks plus up to 2 bytes of padding
+	*out_len = 4 * ((len + 2) / 3);
+
 	out = malloc(*out_len);
 	if (out == NULL) {
 		return NULL;
 	}
+	cper_metrics_record_base64(len);
 
 	src_end = src + len;
 	in_pos = src;
@@ -109,6 +113,7 @@ UINT8 *base64_decode(const CHAR8 *src, INT32 len, INT32 *out_len)
 	if (out == NULL) {
 		return NULL;
 	}
+	cper_metrics_record_base64(len);
 
 	block_index = 0;
 	for (src_index = 0; src_index < len; src_index++) {
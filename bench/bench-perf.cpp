@@ -0,0 +1,113 @@
+/**
+ * Hardware performance counters for the benchmark suite, using Linux perf_event_open(). Counts are
+ * reported per record alongside wall clock time, as they are far less affected by a noisy host.
+ **/
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "../edk/BaseTypes.h"
+#include "bench-perf.hpp"
+
+//A single hardware event, and the name of the benchmark counter it is reported as.
+typedef struct {
+	const char *Name;
+	UINT32 Type;
+	UINT64 Config;
+} bench_perf_event;
+
+#define BENCH_PERF_CACHE_READ_MISS(cache)                                  \
+	((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) |                    \
+	 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const bench_perf_event bench_perf_events[BENCH_PERF_EVENTS_LEN] = {
+	{ "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+	{ "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+	{ "branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+	{ "L1d-misses", PERF_TYPE_HW_CACHE,
+	  BENCH_PERF_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D) },
+	{ "LLC-misses", PERF_TYPE_HW_CACHE,
+	  BENCH_PERF_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL) },
+};
+
+//Opens the hardware counters for the calling thread, disabled.
+//A warning is printed the first time that no counter could be opened.
+static void bench_perf_open(bench_perf_counters *counters)
+{
+	static int warned = 0;
+	int opened = 0;
+	for (int i = 0; i < BENCH_PERF_EVENTS_LEN; i++) {
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = bench_perf_events[i].Type;
+		attr.config = bench_perf_events[i].Config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+				   PERF_FORMAT_TOTAL_TIME_RUNNING;
+		counters->fds[i] =
+			syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		opened += counters->fds[i] >= 0;
+	}
+
+	if (opened == 0 && !warned) {
+		fprintf(stderr,
+			"Hardware performance counters are unavailable, only timings will be reported.\n");
+		warned = 1;
+	}
+}
+
+//Opens and enables the hardware counters for the calling thread.
+void bench_perf_start(bench_perf_counters *counters)
+{
+	bench_perf_open(counters);
+	for (int i = 0; i < BENCH_PERF_EVENTS_LEN; i++) {
+		if (counters->fds[i] >= 0) {
+			ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+//Disables and closes the opened counters, reporting each as a per iteration (record) average.
+//Counts are scaled up where the kernel multiplexed the counter with other events.
+void bench_perf_stop(bench_perf_counters *counters, benchmark::State &state)
+{
+	for (int i = 0; i < BENCH_PERF_EVENTS_LEN; i++) {
+		if (counters->fds[i] >= 0) {
+			ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+
+	double values[BENCH_PERF_EVENTS_LEN];
+	for (int i = 0; i < BENCH_PERF_EVENTS_LEN; i++) {
+		//Value, time enabled and time running.
+		UINT64 read_values[3];
+		values[i] = -1;
+		if (counters->fds[i] < 0 ||
+		    read(counters->fds[i], read_values, sizeof(read_values)) !=
+			    sizeof(read_values) ||
+		    read_values[2] == 0) {
+			continue;
+		}
+		values[i] = (double)read_values[0] * read_values[1] /
+			    read_values[2];
+		state.counters[bench_perf_events[i].Name] = benchmark::Counter(
+			values[i], benchmark::Counter::kAvgIterations);
+	}
+
+	//Instructions per cycle, when both were counted.
+	if (values[0] > 0 && values[1] >= 0) {
+		state.counters["IPC"] = values[1] / values[0];
+	}
+
+	for (int i = 0; i < BENCH_PERF_EVENTS_LEN; i++) {
+		if (counters->fds[i] >= 0) {
+			close(counters->fds[i]);
+		}
+	}
+}
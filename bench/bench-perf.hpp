@@ -0,0 +1,19 @@
+#ifndef CPER_BENCH_PERF_H
+#define CPER_BENCH_PERF_H
+
+#include <benchmark/benchmark.h>
+
+//Number of hardware events counted around each benchmark.
+#define BENCH_PERF_EVENTS_LEN 5
+
+//Per-thread hardware performance counters (perf_event_open). Events that cannot be opened, because
+//the host has no PMU or perf_event_paranoid forbids it, are left with a file descriptor of -1 and
+//are not reported.
+typedef struct {
+	int fds[BENCH_PERF_EVENTS_LEN];
+} bench_perf_counters;
+
+void bench_perf_start(bench_perf_counters *counters);
+void bench_perf_stop(bench_perf_counters *counters, benchmark::State &state);
+
+#endif
@@ -0,0 +1,327 @@
+/**
+ * Google Benchmark suite for libcper. Measures decoding, encoding and validation of a record for
+ * every generator section type, along with the base64, GUID and timestamp utilities. All inputs come
+ * from the generator at fixed seeds, so results are comparable between runs and between versions.
+ * Record benchmarks also report hardware performance counters per record, where available.
+ **/
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <json.h>
+#include "../cper-parse.h"
+#include "../edk/Cper.h"
+#include "../cper-utils.h"
+#include "../base64.h"
+#include "../json-schema.h"
+#include "../generator/cper-generate.h"
+#include "../generator/cper-generate-ir.h"
+#include "../generator/sections/gen-section.h"
+#include "bench-perf.hpp"
+
+//Seed that every generated input is derived from.
+#define BENCH_SEED 0x6c69626370657221ULL
+
+//Generates a record holding a single section of the given type, as a full record or in single
+//section form.
+static std::string bench_record(const char *type, int single_section)
+{
+	cper_generator_context context;
+	cper_generator_seed(&context, BENCH_SEED);
+	char *buf = NULL;
+	size_t size = 0;
+	FILE *stream = open_memstream(&buf, &size);
+	if (single_section) {
+		generate_single_section_record_with_context(
+			&context, const_cast<char *>(type), stream);
+	} else {
+		char *types[1] = { const_cast<char *>(type) };
+		generate_cper_record_with_context(&context, types, 1, stream);
+	}
+	fclose(stream);
+	std::string record(buf, size);
+	free(buf);
+	return record;
+}
+
+//Decodes a record to CPER-JSON.
+static json_object *bench_decode(std::string &record, int single_section)
+{
+	FILE *stream = fmemopen(record.data(), record.size(), "r");
+	json_object *ir = single_section ? cper_single_section_to_ir(stream) :
+					   cper_to_ir(stream);
+	fclose(stream);
+	return ir;
+}
+
+//Reports the records and bytes processed by a benchmark.
+static void bench_set_processed(benchmark::State &state, size_t bytes)
+{
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+static void BM_CperToIR(benchmark::State &state, const char *type)
+{
+	std::string record = bench_record(type, 0);
+	bench_perf_counters counters;
+	bench_perf_start(&counters);
+	for (auto _ : state) {
+		json_object *ir = bench_decode(record, 0);
+		benchmark::DoNotOptimize(ir);
+		json_object_put(ir);
+	}
+	bench_perf_stop(&counters, state);
+	bench_set_processed(state, record.size());
+}
+
+static void BM_CperSingleSectionToIR(benchmark::State &state,
+				     const char *type)
+{
+	std::string record = bench_record(type, 1);
+	bench_perf_counters counters;
+	bench_perf_start(&counters);
+	for (auto _ : state) {
+		json_object *ir = bench_decode(record, 1);
+		benchmark::DoNotOptimize(ir);
+		json_object_put(ir);
+	}
+	bench_perf_stop(&counters, state);
+	bench_set_processed(state, record.size());
+}
+
+static void BM_IRToCper(benchmark::State &state, const char *type)
+{
+	std::string record = bench_record(type, 0);
+	json_object *ir = bench_decode(record, 0);
+	if (ir == NULL) {
+		state.SkipWithError("Generated record failed to decode.");
+		return;
+	}
+
+	//Encode over the same buffer each iteration, so only the first allocates.
+	char *buf = NULL;
+	size_t size = 0;
+	FILE *stream = open_memstream(&buf, &size);
+	bench_perf_counters counters;
+	bench_perf_start(&counters);
+	for (auto _ : state) {
+		fseek(stream, 0, SEEK_SET);
+		ir_to_cper(ir, stream);
+		fflush(stream);
+	}
+	bench_perf_stop(&counters, state);
+	fclose(stream);
+	free(buf);
+	json_object_put(ir);
+	bench_set_processed(state, record.size());
+}
+
+//Returns the path of the given schema file, relative to the directory of the specification.
+static std::string bench_spec_path(const std::string &file)
+{
+	std::string spec = LIBCPER_JSON_SPEC;
+	return spec.substr(0, spec.find_last_of('/') + 1) + file;
+}
+
+//A part of a record's IR, and the schema file that describes it.
+typedef struct {
+	std::string schema;
+	json_object *ir;
+} bench_schema_part;
+
+//Lists the header, section descriptors and sections of a record's IR with their own schemas. The
+//root schema's branches are external references that the validator does not follow, so the root
+//schema cannot be used to validate a record.
+static std::vector<bench_schema_part> bench_schema_parts(json_object *ir)
+{
+	std::vector<bench_schema_part> parts;
+	parts.push_back({ bench_spec_path("cper-json-header.json"),
+			  json_object_object_get(ir, "header") });
+	json_object *descriptors =
+		json_object_object_get(ir, "sectionDescriptors");
+	json_object *sections = json_object_object_get(ir, "sections");
+	for (size_t i = 0; i < json_object_array_length(descriptors); i++) {
+		json_object *descriptor =
+			json_object_array_get_idx(descriptors, i);
+		parts.push_back(
+			{ bench_spec_path("cper-json-section-descriptor.json"),
+			  descriptor });
+
+		EFI_GUID type;
+		string_to_guid(&type,
+			       json_object_get_string(json_object_object_get(
+				       json_object_object_get(descriptor,
+							      "sectionType"),
+				       "data")));
+		parts.push_back({ bench_spec_path(
+					  std::string("sections/") +
+					  cper_ir_generator_section_schema(
+						  &type)),
+				  json_object_array_get_idx(sections, i) });
+	}
+	return parts;
+}
+
+static void BM_ValidateSchema(benchmark::State &state, const char *type)
+{
+	std::string record = bench_record(type, 0);
+	json_object *ir = bench_decode(record, 0);
+	if (ir == NULL) {
+		state.SkipWithError("Generated record failed to decode.");
+		return;
+	}
+
+	//Only time validation of records that validate, so no run stops early on an error.
+	std::vector<bench_schema_part> parts = bench_schema_parts(ir);
+	char error_message[JSON_ERROR_MSG_MAX_LEN] = { 0 };
+	for (const bench_schema_part &part : parts) {
+		if (validate_schema_from_file(part.schema.c_str(), part.ir,
+					      error_message) != 1) {
+			state.SkipWithError(error_message);
+			json_object_put(ir);
+			return;
+		}
+	}
+
+	bench_perf_counters counters;
+	bench_perf_start(&counters);
+	for (auto _ : state) {
+		for (const bench_schema_part &part : parts) {
+			int valid = validate_schema_from_file(
+				part.schema.c_str(), part.ir, error_message);
+			benchmark::DoNotOptimize(valid);
+		}
+	}
+	bench_perf_stop(&counters, state);
+	json_object_put(ir);
+	bench_set_processed(state, record.size());
+}
+
+//Generates bytes to encode of the given length, repeating the bytes of a generated record.
+static std::vector<UINT8> bench_bytes(size_t len)
+{
+	std::string record = bench_record("arm", 0);
+	std::vector<UINT8> bytes(len);
+	for (size_t i = 0; i < len; i++) {
+		bytes[i] = record[i % record.size()];
+	}
+	return bytes;
+}
+
+static void BM_Base64Encode(benchmark::State &state)
+{
+	std::vector<UINT8> bytes = bench_bytes(state.range(0));
+	for (auto _ : state) {
+		INT32 encoded_len = 0;
+		CHAR8 *encoded =
+			base64_encode(bytes.data(), bytes.size(), &encoded_len);
+		benchmark::DoNotOptimize(encoded);
+		free(encoded);
+	}
+	bench_set_processed(state, bytes.size());
+}
+BENCHMARK(BM_Base64Encode)->Range(64, 64 << 10);
+
+static void BM_Base64Decode(benchmark::State &state)
+{
+	std::vector<UINT8> bytes = bench_bytes(state.range(0));
+	INT32 encoded_len = 0;
+	CHAR8 *encoded =
+		base64_encode(bytes.data(), bytes.size(), &encoded_len);
+	for (auto _ : state) {
+		INT32 decoded_len = 0;
+		UINT8 *decoded = base64_decode(encoded, encoded_len,
+					       &decoded_len);
+		benchmark::DoNotOptimize(decoded);
+		free(decoded);
+	}
+	free(encoded);
+	bench_set_processed(state, encoded_len);
+}
+BENCHMARK(BM_Base64Decode)->Range(64, 64 << 10);
+
+static void BM_GuidToString(benchmark::State &state)
+{
+	char out[GUID_STRING_LENGTH];
+	for (auto _ : state) {
+		guid_to_string(out, generator_definitions[0].Guid);
+		benchmark::DoNotOptimize(out);
+	}
+	bench_set_processed(state, sizeof(EFI_GUID));
+}
+BENCHMARK(BM_GuidToString);
+
+//Takes the timestamp of a generated record, which is always valid.
+static EFI_ERROR_TIME_STAMP bench_timestamp(void)
+{
+	std::string record = bench_record("memory", 0);
+	EFI_COMMON_ERROR_RECORD_HEADER *header =
+		(EFI_COMMON_ERROR_RECORD_HEADER *)record.data();
+	return header->TimeStamp;
+}
+
+static void BM_TimestampToString(benchmark::State &state)
+{
+	EFI_ERROR_TIME_STAMP timestamp = bench_timestamp();
+	char out[TIMESTAMP_LENGTH];
+	for (auto _ : state) {
+		timestamp_to_string(out, &timestamp);
+		benchmark::DoNotOptimize(out);
+	}
+	bench_set_processed(state, sizeof(EFI_ERROR_TIME_STAMP));
+}
+BENCHMARK(BM_TimestampToString);
+
+static void BM_StringToTimestamp(benchmark::State &state)
+{
+	EFI_ERROR_TIME_STAMP timestamp = bench_timestamp();
+	char string[TIMESTAMP_LENGTH];
+	timestamp_to_string(string, &timestamp);
+	for (auto _ : state) {
+		string_to_timestamp(&timestamp, string);
+		benchmark::DoNotOptimize(timestamp);
+	}
+	bench_set_processed(state, sizeof(EFI_ERROR_TIME_STAMP));
+}
+BENCHMARK(BM_StringToTimestamp);
+
+static void BM_TimestampToEpoch(benchmark::State &state)
+{
+	EFI_ERROR_TIME_STAMP timestamp = bench_timestamp();
+	for (auto _ : state) {
+		INT64 epoch = timestamp_to_epoch(&timestamp);
+		benchmark::DoNotOptimize(epoch);
+	}
+	bench_set_processed(state, sizeof(EFI_ERROR_TIME_STAMP));
+}
+BENCHMARK(BM_TimestampToEpoch);
+
+int main(int argc, char **argv)
+{
+	//Register the per section type benchmarks, named after the generator's section names.
+	for (size_t i = 0; i < generator_definitions_len; i++) {
+		const char *type = generator_definitions[i].ShortName;
+		std::string name(type);
+		benchmark::RegisterBenchmark(("BM_CperToIR/" + name).c_str(),
+					     BM_CperToIR, type);
+		benchmark::RegisterBenchmark(
+			("BM_CperSingleSectionToIR/" + name).c_str(),
+			BM_CperSingleSectionToIR, type);
+		benchmark::RegisterBenchmark(("BM_IRToCper/" + name).c_str(),
+					     BM_IRToCper, type);
+		benchmark::RegisterBenchmark(
+			("BM_ValidateSchema/" + name).c_str(),
+			BM_ValidateSchema, type);
+	}
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+		return 1;
+	}
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
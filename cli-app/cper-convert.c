@@ -56,6 +56,14 @@ int main(int argc, char *argv[])
 		} else if (strcmp(argv[i], "--debug") == 0) {
 			//Debug output on.
 			debug = 1;
+		} else if (strcmp(argv[i], "--compact") == 0) {
+			//Compact JSON output.
+			cper_ir_set_flags(cper_ir_get_flags() |
+					  CPER_IR_FLAG_COMPACT);
+		} else if (strcmp(argv[i], "--packed-registers") == 0) {
+			//Register arrays as plain integer arrays.
+			cper_ir_set_flags(cper_ir_get_flags() |
+					  CPER_IR_FLAG_PACKED_REGISTERS);
 		} else {
 			printf("Unrecognised argument '%s'. See 'cper-convert --help' for command information.\n",
 			       argv[i]);
@@ -162,6 +170,11 @@ void json_to_cper(char *in_file, char *out_file, char *specification_file,
 			validate_schema_debug_enable();
 		}
 
+		//Compact IR is validated against the compact profile of the specification.
+		if (cper_ir_get_flags() & CPER_IR_FLAG_COMPACT) {
+			validate_schema_compact_enable();
+		}
+
 		//Attempt to verify with the the specification.
 		char *error_message = malloc(JSON_ERROR_MSG_MAX_LEN);
 		int success = validate_schema_from_file(specification_file, ir,
@@ -204,13 +217,15 @@ void json_to_cper(char *in_file, char *out_file, char *specification_file,
 //Command for printing help information.
 void print_help(void)
 {
-	printf(":: to-json cper.file [--out file.name]\n");
+	printf(":: to-json cper.file [--out file.name] [--compact] [--packed-registers]\n");
 	printf("\tConverts the provided CPER log file into JSON, by default writing to stdout. If '--out' is specified,\n");
 	printf("\tThe outputted JSON will be written to the provided file name instead.\n");
-	printf("\n:: to-json-section cper.section.file [--out file.name]\n");
+	printf("\tIf '--compact' is set, validation bits, flags, enumerated values and revisions are output as raw integers.\n");
+	printf("\tIf '--packed-registers' is set, ARM and IA32/x64 register arrays are output as arrays of integers in register order.\n");
+	printf("\n:: to-json-section cper.section.file [--out file.name] [--compact] [--packed-registers]\n");
 	printf("\tConverts the provided single CPER section descriptor & section file into JSON, by default writing to stdout.\n");
 	printf("\tOtherwise behaves the same as 'to-json'.\n");
-	printf("\n:: to-cper cper.json --out file.name [--no-validate] [--debug] [--specification some/spec/path.json]\n");
+	printf("\n:: to-cper cper.json --out file.name [--no-validate] [--debug] [--compact] [--specification some/spec/path.json]\n");
 	printf("\tConverts the provided CPER-JSON JSON file into CPER binary. An output file must be specified with '--out'.\n");
 	printf("\tWill automatically detect whether the JSON passed is a single section, or a whole file,\n");
 	printf("\tand output binary accordingly.\n\n");
@@ -219,6 +234,7 @@ void print_help(void)
 	printf("\tIf the '--no-validate' argument is set, then the provided JSON will not be validated. Be warned, this may cause\n");
 	printf("\tpremature exit/unexpected behaviour in CPER output.\n\n");
 	printf("\tIf '--debug' is set, then debug output for JSON specification parsing will be printed to stdout.\n");
+	printf("\tIf '--compact' is set, then the JSON is validated against the compact profile of the specification.\n");
 	printf("\n:: --help\n");
 	printf("\tDisplays help information to the console.\n");
 }
@@ -0,0 +1,423 @@
+/**
+ * A user-space application for deduplicating archives of concatenated binary CPER records.
+ * Each distinct record (by content, ignoring RecordID, TimeStamp and PersistenceInfo) is stored
+ * once, followed by a list of (record, timestamp, record ID) occurrences in archive order.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "../edk/Cper.h"
+#include "../cper-view.h"
+
+//Deduplicated archive signature ("CPDD") and format version.
+#define DEDUP_SIGNATURE 0x44445043
+#define DEDUP_VERSION	1
+
+#pragma pack(push, 1)
+//Deduplicated archive header, followed by "RecordCount" distinct records (each self-delimiting
+//through its header's RecordLength) and then "OccurrenceCount" occurrences.
+typedef struct {
+	UINT32 Signature;
+	UINT16 Version;
+	UINT16 Reserved;
+	UINT32 RecordCount;
+	UINT32 Reserved2;
+	UINT64 OccurrenceCount;
+} DEDUP_HEADER;
+
+//A single occurrence of a distinct record. PersistenceInfo is not kept, and is restored from the
+//stored record.
+typedef struct {
+	UINT32 Record;
+	UINT32 Reserved;
+	EFI_ERROR_TIME_STAMP TimeStamp;
+	UINT64 RecordID;
+} DEDUP_OCCURRENCE;
+#pragma pack(pop)
+
+//A distinct record within the loaded archive.
+typedef struct {
+	const UINT8 *data;
+	UINT32 length;
+	UINT64 hash;
+} DEDUP_RECORD;
+
+//Distinct records, with an open addressing index of their positions (plus one, zero is empty).
+typedef struct {
+	DEDUP_RECORD *records;
+	UINT32 count;
+	UINT32 capacity;
+	UINT32 *index;
+	size_t index_size;
+} DEDUP_SET;
+
+int pack_archive(char *in_file, char *out_file);
+int unpack_archive(char *in_file, char *out_file);
+void print_help(void);
+UINT8 *read_file(const char *file_name, size_t *size);
+UINT32 next_record_length(const UINT8 *data, size_t remaining);
+int records_equal(const DEDUP_RECORD *a, const DEDUP_RECORD *b);
+long dedup_set_add(DEDUP_SET *set, const DEDUP_RECORD *record);
+
+int main(int argc, char *argv[])
+{
+	//Print help if requested.
+	if (argc == 2 && strcmp(argv[1], "--help") == 0) {
+		print_help();
+		return 0;
+	}
+
+	//Ensure the command, input file and output file are present.
+	if (argc != 5 || strcmp(argv[3], "--out") != 0) {
+		printf("Invalid arguments. See 'cper-dedup --help' for command information.\n");
+		return -1;
+	}
+
+	//Run the requested command.
+	if (strcmp(argv[1], "pack") == 0) {
+		return pack_archive(argv[2], argv[4]);
+	}
+	if (strcmp(argv[1], "unpack") == 0) {
+		return unpack_archive(argv[2], argv[4]);
+	}
+	printf("Unrecognised argument '%s'. See 'cper-dedup --help' for command information.\n",
+	       argv[1]);
+	return -1;
+}
+
+//Command for packing an archive of concatenated CPER records into a deduplicated archive.
+int pack_archive(char *in_file, char *out_file)
+{
+	size_t size;
+	UINT8 *archive = read_file(in_file, &size);
+	if (archive == NULL) {
+		return -1;
+	}
+
+	DEDUP_SET set;
+	memset(&set, 0, sizeof(set));
+	DEDUP_OCCURRENCE *occurrences = NULL;
+	size_t occurrence_count = 0;
+	size_t occurrence_capacity = 0;
+	int result = -1;
+
+	size_t offset = 0;
+	while (offset < size) {
+		UINT32 length =
+			next_record_length(archive + offset, size - offset);
+		if (length == 0) {
+			printf("Invalid CPER record at offset %zu, not packing.\n",
+			       offset);
+			goto cleanup;
+		}
+
+		DEDUP_RECORD record;
+		record.data = archive + offset;
+		record.length = length;
+		cper_record_hash(record.data, length, &record.hash);
+		long distinct = dedup_set_add(&set, &record);
+		if (distinct < 0) {
+			goto cleanup;
+		}
+
+		//Record the occurrence.
+		if (occurrence_count == occurrence_capacity) {
+			occurrence_capacity =
+				occurrence_capacity ? occurrence_capacity * 2 :
+						      64;
+			size_t grown_size =
+				occurrence_capacity * sizeof(DEDUP_OCCURRENCE);
+			DEDUP_OCCURRENCE *grown =
+				realloc(occurrences, grown_size);
+			if (grown == NULL) {
+				printf("Failed to allocate occurrence list.\n");
+				goto cleanup;
+			}
+			occurrences = grown;
+		}
+		const EFI_COMMON_ERROR_RECORD_HEADER *header =
+			(const EFI_COMMON_ERROR_RECORD_HEADER *)record.data;
+		DEDUP_OCCURRENCE *occurrence = &occurrences[occurrence_count++];
+		memset(occurrence, 0, sizeof(DEDUP_OCCURRENCE));
+		occurrence->Record = (UINT32)distinct;
+		occurrence->TimeStamp = header->TimeStamp;
+		occurrence->RecordID = header->RecordID;
+
+		offset += length;
+	}
+
+	//Write out the header, distinct records and occurrences.
+	FILE *out = fopen(out_file, "w");
+	if (out == NULL) {
+		printf("Could not open output file '%s', file handle returned null.\n",
+		       out_file);
+		goto cleanup;
+	}
+	DEDUP_HEADER header;
+	memset(&header, 0, sizeof(header));
+	header.Signature = DEDUP_SIGNATURE;
+	header.Version = DEDUP_VERSION;
+	header.RecordCount = set.count;
+	header.OccurrenceCount = occurrence_count;
+	fwrite(&header, sizeof(header), 1, out);
+	size_t packed_size = sizeof(header);
+	for (UINT32 i = 0; i < set.count; i++) {
+		fwrite(set.records[i].data, set.records[i].length, 1, out);
+		packed_size += set.records[i].length;
+	}
+	if (occurrence_count > 0) {
+		fwrite(occurrences, sizeof(DEDUP_OCCURRENCE), occurrence_count,
+		       out);
+	}
+	packed_size += occurrence_count * sizeof(DEDUP_OCCURRENCE);
+
+	//A partially written archive is removed rather than left behind.
+	int write_failed = ferror(out);
+	if (fclose(out) != 0 || write_failed) {
+		printf("Failed to write output file '%s'.\n", out_file);
+		remove(out_file);
+		goto cleanup;
+	}
+
+	printf("Packed %zu records (%u distinct) from %zu to %zu bytes.\n",
+	       occurrence_count, set.count, offset, packed_size);
+	result = 0;
+
+cleanup:
+	free(occurrences);
+	free(set.records);
+	free(set.index);
+	free(archive);
+	return result;
+}
+
+//Command for restoring an archive of concatenated CPER records from a deduplicated archive.
+int unpack_archive(char *in_file, char *out_file)
+{
+	size_t size;
+	UINT8 *packed = read_file(in_file, &size);
+	if (packed == NULL) {
+		return -1;
+	}
+
+	int result = -1;
+	const UINT8 **records = NULL;
+	DEDUP_HEADER header;
+	if (size < sizeof(header)) {
+		printf("Invalid deduplicated archive: too short.\n");
+		goto cleanup;
+	}
+	memcpy(&header, packed, sizeof(header));
+	if (header.Signature != DEDUP_SIGNATURE ||
+	    header.Version != DEDUP_VERSION) {
+		printf("Invalid deduplicated archive: incorrect signature or version.\n");
+		goto cleanup;
+	}
+
+	//Locate the distinct records. Each is at least a record header long, which bounds the count
+	//by the file size before anything is allocated.
+	size_t record_count = header.RecordCount;
+	if (record_count > (size - sizeof(header)) /
+				   sizeof(EFI_COMMON_ERROR_RECORD_HEADER)) {
+		printf("Invalid deduplicated archive: %zu records cannot fit in %zu bytes.\n",
+		       record_count, size);
+		goto cleanup;
+	}
+	if (record_count >= SIZE_MAX / sizeof(UINT8 *)) {
+		printf("Invalid deduplicated archive: too many records.\n");
+		goto cleanup;
+	}
+	records = malloc((record_count + 1) * sizeof(UINT8 *));
+	if (records == NULL) {
+		printf("Failed to allocate record list.\n");
+		goto cleanup;
+	}
+	size_t offset = sizeof(header);
+	for (UINT32 i = 0; i < header.RecordCount; i++) {
+		UINT32 length =
+			next_record_length(packed + offset, size - offset);
+		if (length == 0) {
+			printf("Invalid deduplicated archive: record %u is not a valid CPER record.\n",
+			       i);
+			goto cleanup;
+		}
+		records[i] = packed + offset;
+		offset += length;
+	}
+	if ((size - offset) / sizeof(DEDUP_OCCURRENCE) <
+	    header.OccurrenceCount) {
+		printf("Invalid deduplicated archive: occurrence list is truncated.\n");
+		goto cleanup;
+	}
+
+	//Write out each occurrence with its own timestamp and record ID.
+	FILE *out = fopen(out_file, "w");
+	if (out == NULL) {
+		printf("Could not open output file '%s', file handle returned null.\n",
+		       out_file);
+		goto cleanup;
+	}
+	for (UINT64 i = 0; i < header.OccurrenceCount; i++) {
+		DEDUP_OCCURRENCE occurrence;
+		memcpy(&occurrence,
+		       packed + offset + i * sizeof(DEDUP_OCCURRENCE),
+		       sizeof(occurrence));
+		if (occurrence.Record >= header.RecordCount) {
+			printf("Invalid deduplicated archive: occurrence %llu refers to missing record %u.\n",
+			       (unsigned long long)i, occurrence.Record);
+			fclose(out);
+			remove(out_file);
+			goto cleanup;
+		}
+
+		EFI_COMMON_ERROR_RECORD_HEADER record_header;
+		memcpy(&record_header, records[occurrence.Record],
+		       sizeof(record_header));
+		record_header.TimeStamp = occurrence.TimeStamp;
+		record_header.RecordID = occurrence.RecordID;
+		fwrite(&record_header, sizeof(record_header), 1, out);
+		fwrite(records[occurrence.Record] + sizeof(record_header),
+		       record_header.RecordLength - sizeof(record_header), 1,
+		       out);
+	}
+	int write_failed = ferror(out);
+	if (fclose(out) != 0 || write_failed) {
+		printf("Failed to write output file '%s'.\n", out_file);
+		remove(out_file);
+		goto cleanup;
+	}
+
+	printf("Unpacked %llu records from %u distinct records.\n",
+	       (unsigned long long)header.OccurrenceCount, header.RecordCount);
+	result = 0;
+
+cleanup:
+	free(records);
+	free(packed);
+	return result;
+}
+
+//Command for printing help information.
+void print_help(void)
+{
+	printf(":: pack archive.file --out packed.file\n");
+	printf("\tDeduplicates the provided archive of concatenated CPER records. Each distinct record is stored once,\n");
+	printf("\tcompared by content ignoring the record ID, timestamp and persistence information, followed by the\n");
+	printf("\ttimestamp and record ID of every occurrence in archive order.\n");
+	printf("\n:: unpack packed.file --out archive.file\n");
+	printf("\tRestores the archive of concatenated CPER records from a deduplicated archive. Persistence information\n");
+	printf("\tis taken from the first occurrence of each distinct record.\n");
+	printf("\n:: --help\n");
+	printf("\tDisplays help information to the console.\n");
+}
+
+//Reads the whole of the given file into memory. Returns NULL on failure.
+UINT8 *read_file(const char *file_name, size_t *size)
+{
+	FILE *file = fopen(file_name, "r");
+	if (file == NULL) {
+		printf("Could not open provided file '%s', file handle returned null.\n",
+		       file_name);
+		return NULL;
+	}
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	UINT8 *data = malloc(length > 0 ? length : 1);
+	if (data == NULL ||
+	    (length > 0 && fread(data, length, 1, file) != 1)) {
+		printf("Failed to read file '%s'.\n", file_name);
+		free(data);
+		fclose(file);
+		return NULL;
+	}
+	fclose(file);
+	*size = length;
+	return data;
+}
+
+//Returns the length of the CPER record at the start of the given data, or 0 if there is no
+//valid record there.
+UINT32 next_record_length(const UINT8 *data, size_t remaining)
+{
+	cper_record_view view;
+	if (!cper_record_view_init(&view, data, remaining)) {
+		return 0;
+	}
+	UINT32 length = cper_record_view_header(&view)->RecordLength;
+	if (length < sizeof(EFI_COMMON_ERROR_RECORD_HEADER) ||
+	    length > remaining) {
+		return 0;
+	}
+	return length;
+}
+
+//Returns whether two records have the same content, ignoring RecordID, TimeStamp and PersistenceInfo.
+int records_equal(const DEDUP_RECORD *a, const DEDUP_RECORD *b)
+{
+	if (a->hash != b->hash || a->length != b->length) {
+		return 0;
+	}
+	EFI_COMMON_ERROR_RECORD_HEADER header_a;
+	EFI_COMMON_ERROR_RECORD_HEADER header_b;
+	memcpy(&header_a, a->data, sizeof(header_a));
+	memcpy(&header_b, b->data, sizeof(header_b));
+	header_b.TimeStamp = header_a.TimeStamp;
+	header_b.RecordID = header_a.RecordID;
+	header_b.PersistenceInfo = header_a.PersistenceInfo;
+	return memcmp(&header_a, &header_b, sizeof(header_a)) == 0 &&
+	       memcmp(a->data + sizeof(header_a), b->data + sizeof(header_b),
+		      a->length - sizeof(header_a)) == 0;
+}
+
+//Adds a record to the set if no record with the same content is present.
+//Returns the index of the distinct record, or -1 on allocation failure.
+long dedup_set_add(DEDUP_SET *set, const DEDUP_RECORD *record)
+{
+	//Keep the index at most half full, rebuilding it as it grows.
+	if ((set->count + 1) * 2 > set->index_size) {
+		size_t index_size = set->index_size ? set->index_size * 2 : 256;
+		UINT32 *index = calloc(index_size, sizeof(UINT32));
+		if (index == NULL) {
+			printf("Failed to allocate record index.\n");
+			return -1;
+		}
+		for (UINT32 i = 0; i < set->count; i++) {
+			size_t slot = set->records[i].hash & (index_size - 1);
+			while (index[slot] != 0) {
+				slot = (slot + 1) & (index_size - 1);
+			}
+			index[slot] = i + 1;
+		}
+		free(set->index);
+		set->index = index;
+		set->index_size = index_size;
+	}
+
+	size_t slot = record->hash & (set->index_size - 1);
+	while (set->index[slot] != 0) {
+		UINT32 existing = set->index[slot] - 1;
+		if (records_equal(&set->records[existing], record)) {
+			return existing;
+		}
+		slot = (slot + 1) & (set->index_size - 1);
+	}
+
+	if (set->count == set->capacity) {
+		UINT32 capacity = set->capacity ? set->capacity * 2 : 64;
+		DEDUP_RECORD *records =
+			realloc(set->records, capacity * sizeof(DEDUP_RECORD));
+		if (records == NULL) {
+			printf("Failed to allocate record list.\n");
+			return -1;
+		}
+		set->records = records;
+		set->capacity = capacity;
+	}
+	set->records[set->count] = *record;
+	set->index[slot] = ++set->count;
+	return set->count - 1;
+}
@@ -0,0 +1,256 @@
+/**
+ * A user-space application for measuring the worst case decode latency and memory use of a single
+ * CPER record. Each adversarial record shape from the generator is decoded in its own child process,
+ * so that peak memory is measured per shape and a decoder crash is reported rather than fatal.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <json.h>
+#include "../cper-parse.h"
+#include "../generator/cper-generate.h"
+#include "../generator/cper-generate-adversarial.h"
+
+//Results of decoding a single shape, passed from the child process to the parent.
+typedef struct {
+	size_t bytes;
+	int rejected;
+	double min_ms;
+	double mean_ms;
+	double max_ms;
+	long start_rss_kib;
+	long peak_rss_kib;
+} WORST_CASE_RESULT;
+
+typedef struct {
+	int iterations;
+	unsigned int timeout;
+	UINT64 seed;
+} WORST_CASE_OPTIONS;
+
+void print_help(void);
+int shape_known(const char *name);
+int measure_shape(const cper_adversarial_shape *shape,
+		  const WORST_CASE_OPTIONS *options);
+void decode_shape(const cper_adversarial_shape *shape,
+		  const WORST_CASE_OPTIONS *options, WORST_CASE_RESULT *result);
+long peak_rss_kib(void);
+
+int main(int argc, char *argv[])
+{
+	//Print help if requested.
+	if (argc == 2 && strcmp(argv[1], "--help") == 0) {
+		print_help();
+		return 0;
+	}
+
+	//Parse the command line arguments.
+	WORST_CASE_OPTIONS options = { 5, 60, 0 };
+	const char **shapes = calloc(argc, sizeof(char *));
+	int num_shapes = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--iterations") == 0 && i < argc - 1) {
+			options.iterations = atoi(argv[i + 1]);
+			i++;
+		} else if (strcmp(argv[i], "--timeout") == 0 && i < argc - 1) {
+			options.timeout = atoi(argv[i + 1]);
+			i++;
+		} else if (strcmp(argv[i], "--seed") == 0 && i < argc - 1) {
+			options.seed = strtoull(argv[i + 1], NULL, 0);
+			i++;
+		} else if (strcmp(argv[i], "--shape") == 0 && i < argc - 1) {
+			if (!shape_known(argv[i + 1])) {
+				printf("Undefined adversarial shape '%s'. See 'cper-worst-case --help' for command information.\n",
+				       argv[i + 1]);
+				free(shapes);
+				return -1;
+			}
+			shapes[num_shapes++] = argv[i + 1];
+			i++;
+		} else {
+			printf("Unrecognised argument '%s'. See 'cper-worst-case --help' for command information.\n",
+			       argv[i]);
+			free(shapes);
+			return -1;
+		}
+	}
+	if (options.iterations < 1) {
+		printf("Invalid argument. '--iterations' must be at least 1.\n");
+		free(shapes);
+		return -1;
+	}
+
+	//Measure the requested shapes, or all shapes if none were given.
+	printf("%-24s %10s %-20s %10s %10s %10s %12s %12s\n", "shape", "bytes",
+	       "status", "min ms", "mean ms", "max ms", "peak KiB",
+	       "growth KiB");
+	int result = 0;
+	for (size_t i = 0; i < cper_adversarial_shapes_len; i++) {
+		const char *name = cper_adversarial_shapes[i].Name;
+		int requested = num_shapes == 0;
+		for (int j = 0; j < num_shapes; j++) {
+			requested |= strcmp(shapes[j], name) == 0;
+		}
+		if (requested &&
+		    !measure_shape(&cper_adversarial_shapes[i], &options)) {
+			result = 1;
+		}
+	}
+
+	free(shapes);
+	return result;
+}
+
+//Returns whether the given name is one of the generator's adversarial shapes.
+int shape_known(const char *name)
+{
+	int known = 0;
+	for (size_t i = 0; i < cper_adversarial_shapes_len; i++) {
+		known |= strcmp(name, cper_adversarial_shapes[i].Name) == 0;
+	}
+	return known;
+}
+
+//Generates and decodes a single shape in a child process, printing the results.
+//Returns 1 if the shape decoded or was rejected cleanly, 0 if the decoder crashed or timed out.
+int measure_shape(const cper_adversarial_shape *shape,
+		  const WORST_CASE_OPTIONS *options)
+{
+	int fds[2];
+	if (pipe(fds) != 0) {
+		printf("Failed to create a pipe for shape '%s'.\n", shape->Name);
+		return 0;
+	}
+
+	fflush(stdout);
+	pid_t pid = fork();
+	if (pid < 0) {
+		printf("Failed to fork for shape '%s'.\n", shape->Name);
+		close(fds[0]);
+		close(fds[1]);
+		return 0;
+	}
+	if (pid == 0) {
+		//The decoder reports errors on stdout, which would interleave with the results.
+		close(fds[0]);
+		if (freopen("/dev/null", "w", stdout) == NULL) {
+			_exit(1);
+		}
+		alarm(options->timeout);
+
+		WORST_CASE_RESULT result;
+		decode_shape(shape, options, &result);
+		ssize_t written = write(fds[1], &result, sizeof(result));
+		_exit(written == sizeof(result) ? 0 : 1);
+	}
+
+	//Collect the results, if the child survived to send them.
+	close(fds[1]);
+	WORST_CASE_RESULT result;
+	ssize_t received = read(fds[0], &result, sizeof(result));
+	close(fds[0]);
+	int status = 0;
+	waitpid(pid, &status, 0);
+
+	if (received == sizeof(result)) {
+		printf("%-24s %10zu %-20s %10.3f %10.3f %10.3f %12ld %12ld\n",
+		       shape->Name, result.bytes,
+		       result.rejected ? "rejected" : "decoded", result.min_ms,
+		       result.mean_ms, result.max_ms, result.peak_rss_kib,
+		       result.peak_rss_kib - result.start_rss_kib);
+		return 1;
+	}
+
+	char failure[32];
+	if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM) {
+		snprintf(failure, sizeof(failure), "timed out");
+	} else if (WIFSIGNALED(status)) {
+		snprintf(failure, sizeof(failure), "crashed (signal %d)",
+			 WTERMSIG(status));
+	} else {
+		snprintf(failure, sizeof(failure), "failed (exit %d)",
+			 WEXITSTATUS(status));
+	}
+	printf("%-24s %10s %-20s %10s %10s %10s %12s %12s\n", shape->Name, "-",
+	       failure, "-", "-", "-", "-", "-");
+	return 0;
+}
+
+//Generates a record of the given shape, then times decoding it the requested number of times.
+void decode_shape(const cper_adversarial_shape *shape,
+		  const WORST_CASE_OPTIONS *options, WORST_CASE_RESULT *result)
+{
+	memset(result, 0, sizeof(WORST_CASE_RESULT));
+
+	//Generate the record.
+	char *record = NULL;
+	size_t size = 0;
+	FILE *stream = open_memstream(&record, &size);
+	cper_generator_context context;
+	cper_generator_seed(&context, options->seed);
+	shape->Generate(&context, stream);
+	fclose(stream);
+	result->bytes = size;
+	result->start_rss_kib = peak_rss_kib();
+
+	//Decode, timing each iteration.
+	double total_ms = 0;
+	for (int i = 0; i < options->iterations; i++) {
+		struct timespec start;
+		struct timespec end;
+		FILE *record_stream = fmemopen(record, size, "r");
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		json_object *ir = cper_to_ir(record_stream);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		fclose(record_stream);
+		result->rejected |= ir == NULL;
+		json_object_put(ir);
+
+		double ms = (end.tv_sec - start.tv_sec) * 1e3 +
+			    (end.tv_nsec - start.tv_nsec) / 1e6;
+		if (i == 0 || ms < result->min_ms) {
+			result->min_ms = ms;
+		}
+		if (ms > result->max_ms) {
+			result->max_ms = ms;
+		}
+		total_ms += ms;
+	}
+	result->mean_ms = total_ms / options->iterations;
+	result->peak_rss_kib = peak_rss_kib();
+	free(record);
+}
+
+//Returns the peak resident set size of this process so far, in KiB.
+long peak_rss_kib(void)
+{
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+	return usage.ru_maxrss;
+}
+
+//Prints command help for this application.
+void print_help(void)
+{
+	printf(":: [--shape shape] ... [--iterations N] [--seed S] [--timeout seconds]\n");
+	printf("\tGenerates a record of each adversarial shape, or only the given shapes, and decodes it N times (default 5)\n");
+	printf("\twith cper_to_ir(), reporting the record size, the minimum, mean and maximum decode latency, the peak\n");
+	printf("\tresident set size and its growth while decoding. Each shape runs in its own process, so a decoder crash\n");
+	printf("\tor a decode exceeding the timeout (default 60 seconds) is reported against the shape. Records that the\n");
+	printf("\tdecoder refused are reported as 'rejected'. The exit code is non-zero if any shape crashed or timed out.\n\n");
+	printf("\tValid shapes are the following:\n");
+	for (size_t i = 0; i < cper_adversarial_shapes_len; i++) {
+		printf("\t\t- %s: %s\n", cper_adversarial_shapes[i].Name,
+		       cper_adversarial_shapes[i].Description);
+	}
+	printf("\n:: --help\n");
+	printf("\tDisplays help information to the console.\n");
+}
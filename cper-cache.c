@@ -0,0 +1,320 @@
+/**
+ * Describes an optional LRU cache of decoded CPER sections. During error storms firmware often
+ * repeats byte-identical sections, differing only in the record header, so a copy of the cached
+ * section IR is returned instead of decoding the section again. Copying is much cheaper than
+ * decoding, and keeps each record's IR its own.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <json.h>
+#include "edk/Cper.h"
+#include "cper-parse.h"
+#include "cper-utils.h"
+#include "cper-cache.h"
+
+//Marks the end of an LRU list or hash chain.
+#define CACHE_NONE 0xFFFFFFFF
+
+//A single cached section. Entries are linked into the LRU list (most recent first) and into
+//their hash bucket's chain by index.
+typedef struct {
+	UINT64 hash;
+	EFI_GUID type;
+	UINT32 flags;
+	UINT32 length;
+	UINT8 *bytes;
+	json_object *ir;
+	UINT32 prev;
+	UINT32 next;
+	UINT32 chain;
+} CACHE_ENTRY;
+
+typedef struct {
+	CACHE_ENTRY *entries;
+	UINT32 *buckets;
+	UINT32 bucket_mask;
+	UINT32 capacity;
+	UINT32 count;
+	UINT32 head;
+	UINT32 tail;
+	UINT64 hits;
+	UINT64 misses;
+	UINT64 evictions;
+} CACHE;
+
+//The global section cache, guarded by cache_lock. Disabled while "entries" is NULL.
+static CACHE cper_section_cache;
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+//Private pre-definitions.
+static UINT64 cache_hash(const EFI_GUID *type, UINT32 flags,
+			 const void *section, UINT32 length);
+static CACHE_ENTRY *cache_find(UINT64 hash, const EFI_GUID *type,
+			       UINT32 flags, const void *section,
+			       UINT32 length);
+static void cache_unlink(UINT32 index);
+static void cache_push_front(UINT32 index);
+static void cache_unchain(UINT32 index);
+static void cache_clear(void);
+
+//Enables the section cache with room for the given number of sections, discarding any existing
+//contents. A capacity of zero disables the cache.
+//Returns 1 on success, 0 on allocation failure (leaving the cache disabled).
+int cper_section_cache_enable(size_t capacity)
+{
+	pthread_mutex_lock(&cache_lock);
+	cache_clear();
+	if (capacity == 0) {
+		pthread_mutex_unlock(&cache_lock);
+		return 1;
+	}
+	if (capacity >= CACHE_NONE / 2) {
+		printf("Section cache capacity %zu is too large.\n", capacity);
+		pthread_mutex_unlock(&cache_lock);
+		return 0;
+	}
+
+	//At least two buckets per entry, keeping chains short.
+	UINT32 buckets = 1;
+	while (buckets < capacity * 2) {
+		buckets *= 2;
+	}
+
+	CACHE *cache = &cper_section_cache;
+	cache->entries = calloc(capacity, sizeof(CACHE_ENTRY));
+	cache->buckets = malloc(buckets * sizeof(UINT32));
+	if (cache->entries == NULL || cache->buckets == NULL) {
+		printf("Failed to allocate section cache.\n");
+		free(cache->entries);
+		free(cache->buckets);
+		memset(cache, 0, sizeof(CACHE));
+		pthread_mutex_unlock(&cache_lock);
+		return 0;
+	}
+	memset(cache->buckets, 0xFF, buckets * sizeof(UINT32));
+	cache->bucket_mask = buckets - 1;
+	cache->capacity = (UINT32)capacity;
+	cache->head = CACHE_NONE;
+	cache->tail = CACHE_NONE;
+	pthread_mutex_unlock(&cache_lock);
+	return 1;
+}
+
+//Disables the section cache, releasing all cached sections and resetting the counters.
+void cper_section_cache_disable(void)
+{
+	pthread_mutex_lock(&cache_lock);
+	cache_clear();
+	pthread_mutex_unlock(&cache_lock);
+}
+
+//Outputs the current cache counters.
+void cper_section_cache_get_stats(cper_section_cache_stats *stats)
+{
+	pthread_mutex_lock(&cache_lock);
+	const CACHE *cache = &cper_section_cache;
+	stats->hits = cache->hits;
+	stats->misses = cache->misses;
+	stats->evictions = cache->evictions;
+	stats->entries = cache->count;
+	stats->capacity = cache->capacity;
+	pthread_mutex_unlock(&cache_lock);
+}
+
+//Returns a copy of the cached IR for the given section, owned by the caller, or NULL if it is not
+//cached (or the cache is disabled).
+json_object *cper_section_cache_lookup(const EFI_GUID *type,
+				       const void *section, UINT32 length)
+{
+	UINT32 flags = cper_ir_get_flags();
+	UINT64 hash = cache_hash(type, flags, section, length);
+	pthread_mutex_lock(&cache_lock);
+	CACHE *cache = &cper_section_cache;
+	if (cache->entries == NULL) {
+		pthread_mutex_unlock(&cache_lock);
+		return NULL;
+	}
+
+	CACHE_ENTRY *entry = cache_find(hash, type, flags, section, length);
+	if (entry == NULL) {
+		cache->misses++;
+		pthread_mutex_unlock(&cache_lock);
+		return NULL;
+	}
+
+	cache->hits++;
+	UINT32 index = (UINT32)(entry - cache->entries);
+	if (cache->head != index) {
+		cache_unlink(index);
+		cache_push_front(index);
+	}
+
+	//Copy while locked, so the entry cannot be evicted mid-copy.
+	json_object *ir = cper_ir_copy(entry->ir);
+	pthread_mutex_unlock(&cache_lock);
+	return ir;
+}
+
+//Caches a copy of the IR for the given section, evicting the least recently used section if the
+//cache is full. The given IR stays owned by the caller.
+void cper_section_cache_insert(const EFI_GUID *type, const void *section,
+			       UINT32 length, json_object *ir)
+{
+	if (ir == NULL) {
+		return;
+	}
+	UINT32 flags = cper_ir_get_flags();
+	UINT64 hash = cache_hash(type, flags, section, length);
+	pthread_mutex_lock(&cache_lock);
+	CACHE *cache = &cper_section_cache;
+	if (cache->entries == NULL ||
+	    cache_find(hash, type, flags, section, length) != NULL) {
+		pthread_mutex_unlock(&cache_lock);
+		return;
+	}
+
+	UINT8 *bytes = malloc(length + 1);
+	json_object *copy = cper_ir_copy(ir);
+	if (bytes == NULL || copy == NULL) {
+		free(bytes);
+		json_object_put(copy);
+		pthread_mutex_unlock(&cache_lock);
+		return;
+	}
+	memcpy(bytes, section, length);
+
+	//Reuse the least recently used entry when full, otherwise take the next free one.
+	UINT32 index;
+	if (cache->count == cache->capacity) {
+		index = cache->tail;
+		cache_unlink(index);
+		cache_unchain(index);
+		free(cache->entries[index].bytes);
+		json_object_put(cache->entries[index].ir);
+		cache->evictions++;
+	} else {
+		index = cache->count++;
+	}
+
+	CACHE_ENTRY *entry = &cache->entries[index];
+	entry->hash = hash;
+	entry->type = *type;
+	entry->flags = flags;
+	entry->length = length;
+	entry->bytes = bytes;
+	entry->ir = copy;
+
+	UINT32 *bucket = &cache->buckets[hash & cache->bucket_mask];
+	entry->chain = *bucket;
+	*bucket = index;
+	cache_push_front(index);
+	pthread_mutex_unlock(&cache_lock);
+}
+
+//Releases all cached sections and resets the counters, leaving the cache disabled. Called with
+//cache_lock held.
+static void cache_clear(void)
+{
+	CACHE *cache = &cper_section_cache;
+	for (UINT32 i = 0; i < cache->count; i++) {
+		free(cache->entries[i].bytes);
+		json_object_put(cache->entries[i].ir);
+	}
+	free(cache->entries);
+	free(cache->buckets);
+	memset(cache, 0, sizeof(CACHE));
+}
+
+//Hashes a section, eight bytes at a time (a multiply/rotate mix in the style of wyhash).
+static UINT64 cache_hash(const EFI_GUID *type, UINT32 flags,
+			 const void *section, UINT32 length)
+{
+	const UINT64 prime = 0x9E3779B97F4A7C15ULL;
+	UINT64 hash = (length ^ ((UINT64)flags << 32)) * prime;
+
+	UINT64 words[2];
+	memcpy(words, type, sizeof(EFI_GUID));
+	hash = (hash ^ words[0]) * prime;
+	hash = (hash ^ (hash >> 29) ^ words[1]) * prime;
+
+	const UINT8 *bytes = (const UINT8 *)section;
+	UINT32 i = 0;
+	for (; i + 8 <= length; i += 8) {
+		UINT64 word;
+		memcpy(&word, bytes + i, sizeof(word));
+		hash = (hash ^ word) * prime;
+		hash ^= hash >> 32;
+	}
+	UINT64 tail = 0;
+	memcpy(&tail, bytes + i, length - i);
+	hash = (hash ^ tail) * prime;
+	hash ^= hash >> 29;
+	return hash;
+}
+
+//Returns the cached entry exactly matching the given section, or NULL if there is none.
+static CACHE_ENTRY *cache_find(UINT64 hash, const EFI_GUID *type,
+			       UINT32 flags, const void *section,
+			       UINT32 length)
+{
+	CACHE *cache = &cper_section_cache;
+	UINT32 index = cache->buckets[hash & cache->bucket_mask];
+	while (index != CACHE_NONE) {
+		CACHE_ENTRY *entry = &cache->entries[index];
+		if (entry->hash == hash && entry->flags == flags &&
+		    entry->length == length &&
+		    memcmp(&entry->type, type, sizeof(EFI_GUID)) == 0 &&
+		    memcmp(entry->bytes, section, length) == 0) {
+			return entry;
+		}
+		index = entry->chain;
+	}
+	return NULL;
+}
+
+//Removes an entry from the LRU list.
+static void cache_unlink(UINT32 index)
+{
+	CACHE *cache = &cper_section_cache;
+	CACHE_ENTRY *entry = &cache->entries[index];
+	if (entry->prev != CACHE_NONE) {
+		cache->entries[entry->prev].next = entry->next;
+	} else {
+		cache->head = entry->next;
+	}
+	if (entry->next != CACHE_NONE) {
+		cache->entries[entry->next].prev = entry->prev;
+	} else {
+		cache->tail = entry->prev;
+	}
+}
+
+//Adds an entry to the front (most recently used end) of the LRU list.
+static void cache_push_front(UINT32 index)
+{
+	CACHE *cache = &cper_section_cache;
+	CACHE_ENTRY *entry = &cache->entries[index];
+	entry->prev = CACHE_NONE;
+	entry->next = cache->head;
+	if (cache->head != CACHE_NONE) {
+		cache->entries[cache->head].prev = index;
+	} else {
+		cache->tail = index;
+	}
+	cache->head = index;
+}
+
+//Removes an entry from its hash bucket's chain.
+static void cache_unchain(UINT32 index)
+{
+	CACHE *cache = &cper_section_cache;
+	UINT64 hash = cache->entries[index].hash;
+	UINT32 *link = &cache->buckets[hash & cache->bucket_mask];
+	while (*link != index) {
+		link = &cache->entries[*link].chain;
+	}
+	*link = cache->entries[index].chain;
+}
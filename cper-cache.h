@@ -0,0 +1,38 @@
+#ifndef CPER_CACHE_H
+#define CPER_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <json.h>
+#include "edk/Cper.h"
+
+//Counters kept by the section decode cache.
+typedef struct {
+	UINT64 hits;
+	UINT64 misses;
+	UINT64 evictions;
+	size_t entries;
+	size_t capacity;
+} cper_section_cache_stats;
+
+//Optional LRU cache of decoded section IR, keyed on the section type, section bytes and current IR
+//flags. The cache holds its own copy of each section's IR and returns a deep copy on every hit, so
+//records never share IR and may be freely modified. The cache is shared by all threads, and every
+//function here takes a lock.
+int cper_section_cache_enable(size_t capacity);
+void cper_section_cache_disable(void);
+void cper_section_cache_get_stats(cper_section_cache_stats *stats);
+
+json_object *cper_section_cache_lookup(const EFI_GUID *type,
+				       const void *section, UINT32 length);
+void cper_section_cache_insert(const EFI_GUID *type, const void *section,
+			       UINT32 length, json_object *ir);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
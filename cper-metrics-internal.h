@@ -0,0 +1,26 @@
+#ifndef CPER_METRICS_INTERNAL_H
+#define CPER_METRICS_INTERNAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "cper-metrics.h"
+
+//Recording functions, called by the library itself and not installed. Sections are identified by
+//their index into section_definitions, with section_definitions_len for sections of unknown type.
+UINT64 cper_metrics_now(void);
+void cper_metrics_record_decoded(void);
+void cper_metrics_record_encoded(size_t bytes);
+void cper_metrics_record_bytes_in(size_t bytes);
+void cper_metrics_record_failure(cper_metrics_failure failure);
+void cper_metrics_record_section_decoded(size_t definition, UINT64 ns);
+void cper_metrics_record_section_encoded(size_t definition);
+void cper_metrics_record_base64(size_t bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
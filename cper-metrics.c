@@ -0,0 +1,285 @@
+/**
+ * Runtime metrics for decoding and encoding CPER records. Each thread counts into its own block of
+ * counters without locking, and snapshots sum the blocks of all threads. Blocks of threads that have
+ * exited are folded into a set of retired totals, so no counts are lost.
+ **/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+#include "cper-metrics-internal.h"
+#include "sections/cper-section.h"
+
+//Section types counted separately. Any beyond this share the last slot.
+#define METRICS_SECTION_SLOTS 32
+
+//Layout of a thread's counters: record level counters, then failures, then a fixed size block of
+//counters for each section type.
+#define METRICS_RECORDS_DECODED	  0
+#define METRICS_RECORDS_ENCODED	  1
+#define METRICS_BYTES_IN	  2
+#define METRICS_BYTES_OUT	  3
+#define METRICS_UNKNOWN_DECODED	  4
+#define METRICS_UNKNOWN_ENCODED	  5
+#define METRICS_BASE64_BYTES	  6
+#define METRICS_FAILURES	  7
+#define METRICS_SECTIONS \
+	(METRICS_FAILURES + CPER_METRICS_FAILURE_COUNT)
+#define METRICS_SECTION_DECODED	  0
+#define METRICS_SECTION_ENCODED	  1
+#define METRICS_SECTION_DECODE_NS 2
+#define METRICS_SECTION_LATENCY	  3
+#define METRICS_SECTION_LEN \
+	(METRICS_SECTION_LATENCY + CPER_METRICS_LATENCY_BUCKETS)
+#define METRICS_LEN \
+	(METRICS_SECTIONS + METRICS_SECTION_SLOTS * METRICS_SECTION_LEN)
+
+//Counters of a single thread. Only the owning thread writes them, so relaxed atomic loads and stores
+//are enough for snapshots to read whole values, and no read-modify-write is needed.
+typedef struct cper_thread_metrics {
+	_Atomic UINT64 values[METRICS_LEN];
+	struct cper_thread_metrics *next;
+	int registered;
+} cper_thread_metrics;
+
+static _Thread_local cper_thread_metrics thread_metrics;
+static cper_thread_metrics *metrics_threads = NULL;
+static UINT64 metrics_retired[METRICS_LEN];
+static pthread_mutex_t metrics_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t metrics_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t metrics_key;
+
+static const char *const metrics_failure_names[CPER_METRICS_FAILURE_COUNT] = {
+	"short_header", "bad_signature", "short_descriptor", "short_section",
+	"section_decode"
+};
+
+//Folds the counters of an exiting thread into the retired totals.
+static void metrics_thread_exit(void *arg)
+{
+	cper_thread_metrics *metrics = (cper_thread_metrics *)arg;
+	pthread_mutex_lock(&metrics_lock);
+	for (size_t i = 0; i < METRICS_LEN; i++) {
+		metrics_retired[i] += atomic_load_explicit(
+			&metrics->values[i], memory_order_relaxed);
+		atomic_store_explicit(&metrics->values[i], 0,
+				      memory_order_relaxed);
+	}
+	for (cper_thread_metrics **link = &metrics_threads; *link != NULL;
+	     link = &(*link)->next) {
+		if (*link == metrics) {
+			*link = metrics->next;
+			break;
+		}
+	}
+	metrics->registered = 0;
+	pthread_mutex_unlock(&metrics_lock);
+}
+
+static void metrics_key_create(void)
+{
+	pthread_key_create(&metrics_key, metrics_thread_exit);
+}
+
+//Adds to one of the calling thread's counters, registering the thread on first use.
+static void metrics_add(size_t index, UINT64 value)
+{
+	cper_thread_metrics *metrics = &thread_metrics;
+	if (!metrics->registered) {
+		pthread_once(&metrics_key_once, metrics_key_create);
+		pthread_mutex_lock(&metrics_lock);
+		metrics->next = metrics_threads;
+		metrics_threads = metrics;
+		metrics->registered = 1;
+		pthread_mutex_unlock(&metrics_lock);
+		pthread_setspecific(metrics_key, metrics);
+	}
+
+	UINT64 current = atomic_load_explicit(&metrics->values[index],
+					      memory_order_relaxed);
+	atomic_store_explicit(&metrics->values[index], current + value,
+			      memory_order_relaxed);
+}
+
+//Returns the index of the first counter for the given section definition.
+static size_t metrics_section(size_t definition)
+{
+	size_t slot = definition < METRICS_SECTION_SLOTS ?
+			      definition :
+			      METRICS_SECTION_SLOTS - 1;
+	return METRICS_SECTIONS + slot * METRICS_SECTION_LEN;
+}
+
+//Returns the latency histogram bucket for the given duration.
+static size_t metrics_latency_bucket(UINT64 ns)
+{
+	size_t bucket = 0;
+	while (bucket < CPER_METRICS_LATENCY_BUCKETS - 1 &&
+	       ns >= cper_metrics_latency_bound(bucket)) {
+		bucket++;
+	}
+	return bucket;
+}
+
+//Returns the exclusive upper bound of the given latency bucket in nanoseconds. The last bucket is
+//unbounded, and returns UINT64_MAX.
+UINT64 cper_metrics_latency_bound(size_t bucket)
+{
+	if (bucket >= CPER_METRICS_LATENCY_BUCKETS - 1) {
+		return UINT64_MAX;
+	}
+	return (UINT64)1024 << bucket;
+}
+
+//Returns a short name for the given failure reason, suitable for use as a metric label.
+const char *cper_metrics_failure_name(cper_metrics_failure failure)
+{
+	if (failure >= CPER_METRICS_FAILURE_COUNT) {
+		return NULL;
+	}
+	return metrics_failure_names[failure];
+}
+
+//Takes a snapshot of the metrics summed over all threads, past and present.
+//Returns 1 on success, 0 if the section counters could not be allocated.
+int cper_metrics_snapshot(cper_metrics *metrics)
+{
+	metrics->sections_len = section_definitions_len + 1;
+	metrics->sections =
+		calloc(metrics->sections_len, sizeof(cper_section_metrics));
+	if (metrics->sections == NULL) {
+		return 0;
+	}
+
+	//Sum the counters of all threads.
+	UINT64 values[METRICS_LEN];
+	pthread_mutex_lock(&metrics_lock);
+	for (size_t i = 0; i < METRICS_LEN; i++) {
+		values[i] = metrics_retired[i];
+	}
+	for (cper_thread_metrics *thread = metrics_threads; thread != NULL;
+	     thread = thread->next) {
+		for (size_t i = 0; i < METRICS_LEN; i++) {
+			values[i] += atomic_load_explicit(
+				&thread->values[i], memory_order_relaxed);
+		}
+	}
+	pthread_mutex_unlock(&metrics_lock);
+
+	metrics->records_decoded = values[METRICS_RECORDS_DECODED];
+	metrics->records_encoded = values[METRICS_RECORDS_ENCODED];
+	metrics->bytes_in = values[METRICS_BYTES_IN];
+	metrics->bytes_out = values[METRICS_BYTES_OUT];
+	metrics->unknown_sections_decoded = values[METRICS_UNKNOWN_DECODED];
+	metrics->unknown_sections_encoded = values[METRICS_UNKNOWN_ENCODED];
+	metrics->base64_bytes = values[METRICS_BASE64_BYTES];
+	for (size_t i = 0; i < CPER_METRICS_FAILURE_COUNT; i++) {
+		metrics->failures[i] = values[METRICS_FAILURES + i];
+	}
+
+	//Section counters, with unknown sections last.
+	for (size_t i = 0; i < metrics->sections_len; i++) {
+		cper_section_metrics *section = &metrics->sections[i];
+		if (i < section_definitions_len) {
+			section->guid = section_definitions[i].Guid;
+			section->name = section_definitions[i].ReadableName;
+		} else {
+			section->guid = NULL;
+			section->name = "Unknown";
+		}
+
+		UINT64 *counters = &values[metrics_section(i)];
+		section->decoded = counters[METRICS_SECTION_DECODED];
+		section->encoded = counters[METRICS_SECTION_ENCODED];
+		section->decode_ns = counters[METRICS_SECTION_DECODE_NS];
+		for (size_t j = 0; j < CPER_METRICS_LATENCY_BUCKETS; j++) {
+			section->decode_latency[j] =
+				counters[METRICS_SECTION_LATENCY + j];
+		}
+	}
+
+	return 1;
+}
+
+//Zeroes the metrics of all threads, past and present. Counts made by other threads while the reset
+//is in progress may survive it.
+void cper_metrics_reset(void)
+{
+	pthread_mutex_lock(&metrics_lock);
+	for (size_t i = 0; i < METRICS_LEN; i++) {
+		metrics_retired[i] = 0;
+	}
+	for (cper_thread_metrics *thread = metrics_threads; thread != NULL;
+	     thread = thread->next) {
+		for (size_t i = 0; i < METRICS_LEN; i++) {
+			atomic_store_explicit(&thread->values[i], 0,
+					      memory_order_relaxed);
+		}
+	}
+	pthread_mutex_unlock(&metrics_lock);
+}
+
+//Frees the resources held by a metrics snapshot.
+void cper_metrics_free(cper_metrics *metrics)
+{
+	free(metrics->sections);
+	metrics->sections = NULL;
+	metrics->sections_len = 0;
+}
+
+//Returns the current time in nanoseconds, for timing section decodes.
+UINT64 cper_metrics_now(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (UINT64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+void cper_metrics_record_decoded(void)
+{
+	metrics_add(METRICS_RECORDS_DECODED, 1);
+}
+
+void cper_metrics_record_encoded(size_t bytes)
+{
+	metrics_add(METRICS_RECORDS_ENCODED, 1);
+	metrics_add(METRICS_BYTES_OUT, bytes);
+}
+
+void cper_metrics_record_bytes_in(size_t bytes)
+{
+	metrics_add(METRICS_BYTES_IN, bytes);
+}
+
+void cper_metrics_record_failure(cper_metrics_failure failure)
+{
+	metrics_add(METRICS_FAILURES + failure, 1);
+}
+
+void cper_metrics_record_section_decoded(size_t definition, UINT64 ns)
+{
+	size_t section = metrics_section(definition);
+	metrics_add(section + METRICS_SECTION_DECODED, 1);
+	metrics_add(section + METRICS_SECTION_DECODE_NS, ns);
+	metrics_add(section + METRICS_SECTION_LATENCY +
+			    metrics_latency_bucket(ns),
+		    1);
+	if (definition >= section_definitions_len) {
+		metrics_add(METRICS_UNKNOWN_DECODED, 1);
+	}
+}
+
+void cper_metrics_record_section_encoded(size_t definition)
+{
+	metrics_add(metrics_section(definition) + METRICS_SECTION_ENCODED, 1);
+	if (definition >= section_definitions_len) {
+		metrics_add(METRICS_UNKNOWN_ENCODED, 1);
+	}
+}
+
+void cper_metrics_record_base64(size_t bytes)
+{
+	metrics_add(METRICS_BASE64_BYTES, bytes);
+}
@@ -0,0 +1,61 @@
+#ifndef CPER_METRICS_H
+#define CPER_METRICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "edk/Cper.h"
+
+//Number of buckets in each section type's decode latency histogram. Bucket 0 counts decodes under
+//1024ns, and each following bucket doubles the bound, with the last bucket unbounded.
+#define CPER_METRICS_LATENCY_BUCKETS 16
+
+//Reasons a record or section failed to decode.
+typedef enum {
+	CPER_METRICS_FAILURE_SHORT_HEADER,
+	CPER_METRICS_FAILURE_BAD_SIGNATURE,
+	CPER_METRICS_FAILURE_SHORT_DESCRIPTOR,
+	CPER_METRICS_FAILURE_SHORT_SECTION,
+	CPER_METRICS_FAILURE_SECTION_DECODE,
+	CPER_METRICS_FAILURE_COUNT
+} cper_metrics_failure;
+
+//Counters for a single section type. Sections of unknown type are counted under a NULL GUID.
+typedef struct {
+	const EFI_GUID *guid;
+	const char *name;
+	UINT64 decoded;
+	UINT64 encoded;
+	UINT64 decode_ns;
+	UINT64 decode_latency[CPER_METRICS_LATENCY_BUCKETS];
+} cper_section_metrics;
+
+//Counters kept over all decodes and encodes in the process, since it started.
+typedef struct {
+	UINT64 records_decoded;
+	UINT64 records_encoded;
+	UINT64 bytes_in;
+	UINT64 bytes_out;
+	UINT64 unknown_sections_decoded;
+	UINT64 unknown_sections_encoded;
+	UINT64 failures[CPER_METRICS_FAILURE_COUNT];
+	UINT64 base64_bytes;
+	size_t sections_len;
+	cper_section_metrics *sections;
+} cper_metrics;
+
+//Metrics are counted per thread without locking, and summed over all threads by a snapshot.
+//Snapshots must be freed with cper_metrics_free().
+int cper_metrics_snapshot(cper_metrics *metrics);
+void cper_metrics_free(cper_metrics *metrics);
+void cper_metrics_reset(void);
+UINT64 cper_metrics_latency_bound(size_t bucket);
+const char *cper_metrics_failure_name(cper_metrics_failure failure);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
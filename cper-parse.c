@@ -8,13 +8,30 @@
 #include <stdio.h>
 #include <string.h>
 #include <json.h>
-#include "base64.h"
 #include "edk/Cper.h"
 #include "cper-parse.h"
 #include "cper-parse-str.h"
 #include "cper-utils.h"
+#include "cper-cache.h"
+#include "cper-metrics-internal.h"
 #include "sections/cper-section.h"
 
+const char *const CPER_HEADER_VALID_BITFIELD_NAMES[3] = {
+	"platformIDValid", "timestampValid", "partitionIDValid"
+};
+const char *const CPER_SECTION_DESCRIPTOR_VALID_BITFIELD_NAMES[2] = {
+	"fruIDValid", "fruStringValid"
+};
+const char *const CPER_SECTION_DESCRIPTOR_FLAGS_BITFIELD_NAMES[8] = {
+	"primary", "containmentWarning", "reset", "errorThresholdExceeded",
+	"resourceNotAccessible", "latentError", "propagated", "overflow"
+};
+const int CPER_HEADER_FLAG_TYPES_KEYS[3] = { 1, 2, 4 };
+const char *const CPER_HEADER_FLAG_TYPES_VALUES[3] = {
+	"HW_ERROR_FLAGS_RECOVERED", "HW_ERROR_FLAGS_PREVERR",
+	"HW_ERROR_FLAGS_SIMULATED"
+};
+
 //Private pre-definitions.
 json_object *cper_header_to_ir(EFI_COMMON_ERROR_RECORD_HEADER *header);
 json_object *
@@ -22,6 +39,41 @@ cper_section_descriptor_to_ir(EFI_ERROR_SECTION_DESCRIPTOR *section_descriptor);
 json_object *cper_section_to_ir(FILE *handle, long base_pos,
 				EFI_ERROR_SECTION_DESCRIPTOR *descriptor);
 
+//Flags controlling IR output, held per thread.
+static _Thread_local unsigned int cper_ir_flags = 0;
+
+//Sets/gets the flags controlling the form of IR output for the calling thread.
+void cper_ir_set_flags(unsigned int flags)
+{
+	cper_ir_flags = flags;
+}
+unsigned int cper_ir_get_flags(void)
+{
+	return cper_ir_flags;
+}
+
+//Converts a CPER log file to IR with the given flags, leaving the calling thread's flags unchanged.
+json_object *cper_to_ir_ex(FILE *cper_file, unsigned int flags)
+{
+	unsigned int saved = cper_ir_flags;
+	cper_ir_flags = flags;
+	json_object *ir = cper_to_ir(cper_file);
+	cper_ir_flags = saved;
+	return ir;
+}
+
+//Converts a single CPER section to IR with the given flags, leaving the calling thread's flags
+//unchanged.
+json_object *cper_single_section_to_ir_ex(FILE *cper_section_file,
+					  unsigned int flags)
+{
+	unsigned int saved = cper_ir_flags;
+	cper_ir_flags = flags;
+	json_object *ir = cper_single_section_to_ir(cper_section_file);
+	cper_ir_flags = saved;
+	return ir;
+}
+
 //Reads a CPER log file at the given file location, and returns an intermediate
 //JSON representation of this CPER record.
 json_object *cper_to_ir(FILE *cper_file)
@@ -34,16 +86,19 @@ json_object *cper_to_ir(FILE *cper_file)
 	if (fread(&header, sizeof(EFI_COMMON_ERROR_RECORD_HEADER), 1,
 		  cper_file) != 1) {
 		printf("Invalid CPER file: Invalid length (log too short).\n");
+		cper_metrics_record_failure(CPER_METRICS_FAILURE_SHORT_HEADER);
 		return NULL;
 	}
 
 	//Check if the header contains the magic bytes ("CPER").
 	if (header.SignatureStart != EFI_ERROR_RECORD_SIGNATURE_START) {
 		printf("Invalid CPER file: Invalid header (incorrect signature).\n");
+		cper_metrics_record_failure(CPER_METRICS_FAILURE_BAD_SIGNATURE);
 		return NULL;
 	}
 
 	//Create the header JSON object from the read bytes.
+	cper_metrics_record_bytes_in(sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
 	json_object *header_ir = cper_header_to_ir(&header);
 
 	//Read the appropriate number of section descriptors & sections, and convert them into IR format.
@@ -57,12 +112,16 @@ json_object *cper_to_ir(FILE *cper_file)
 			  cper_file) != 1) {
 			printf("Invalid number of section headers: Header states %d sections, could not read section %d.\n",
 			       header.SectionCount, i + 1);
+			cper_metrics_record_failure(
+				CPER_METRICS_FAILURE_SHORT_DESCRIPTOR);
 			// Free json objects
 			json_object_put(sections_ir);
 			json_object_put(section_descriptors_ir);
 			json_object_put(header_ir);
 			return NULL;
 		}
+		cper_metrics_record_bytes_in(
+			sizeof(EFI_ERROR_SECTION_DESCRIPTOR));
 		json_object_array_add(
 			section_descriptors_ir,
 			cper_section_descriptor_to_ir(&section_descriptor));
@@ -79,6 +138,7 @@ json_object *cper_to_ir(FILE *cper_file)
 	json_object_object_add(parent, "sectionDescriptors",
 			       section_descriptors_ir);
 	json_object_object_add(parent, "sections", sections_ir);
+	cper_metrics_record_decoded();
 
 	return parent;
 }
@@ -138,6 +198,12 @@ json_object *cper_header_to_ir(EFI_COMMON_ERROR_RECORD_HEADER *header)
 		json_object_object_add(
 			header_ir, "timestamp",
 			json_object_new_string(timestamp_string));
+		if (cper_ir_flags & CPER_IR_FLAG_TIMESTAMP_EPOCH) {
+			json_object_object_add(
+				header_ir, "timestampEpoch",
+				json_object_new_int64(
+					timestamp_to_epoch(&header->TimeStamp)));
+		}
 		json_object_object_add(
 			header_ir, "timestampIsPrecise",
 			json_object_new_boolean(header->TimeStamp.Flag));
@@ -333,43 +399,61 @@ json_object *cper_section_to_ir(FILE *handle, long base_pos,
 	if (fread(section, descriptor->SectionLength, 1, handle) != 1) {
 		printf("Section read failed: Could not read %u bytes from global offset %d.\n",
 		       descriptor->SectionLength, descriptor->SectionOffset);
+		cper_metrics_record_failure(CPER_METRICS_FAILURE_SHORT_SECTION);
 		free(section);
 		return NULL;
 	}
+	cper_metrics_record_bytes_in(descriptor->SectionLength);
 
 	//Seek back to our original position.
 	fseek(handle, position, SEEK_SET);
 
-	//Parse section to IR based on GUID.
-	json_object *result = NULL;
-	int section_converted = 0;
+	//Find the section definition for this GUID, if any.
+	UINT64 start = cper_metrics_now();
+	size_t definition = section_definitions_len;
 	for (size_t i = 0; i < section_definitions_len; i++) {
 		if (guid_equal(section_definitions[i].Guid,
 			       &descriptor->SectionType) &&
 		    section_definitions[i].ToIR != NULL) {
-			result = section_definitions[i].ToIR(section);
-			section_converted = 1;
+			definition = i;
 			break;
 		}
 	}
 
-	//Was it an unknown GUID/failed read?
-	if (!section_converted) {
-		//Output the data as formatted base64.
+	//Identical sections are decoded once while the section cache is enabled.
+	json_object *result = cper_section_cache_lookup(
+		&descriptor->SectionType, section, descriptor->SectionLength);
+	if (result != NULL) {
+		cper_metrics_record_section_decoded(
+			definition, cper_metrics_now() - start);
+		free(section);
+		return result;
+	}
+
+	//Parse section to IR based on GUID.
+	if (definition < section_definitions_len) {
+		result = section_definitions[definition].ToIR(section);
+		if (result == NULL) {
+			cper_metrics_record_failure(
+				CPER_METRICS_FAILURE_SECTION_DECODE);
+		}
+	} else {
+		//Unknown GUID, so output the data as formatted base64.
 		result = json_object_new_object();
 
-		int32_t encoded_len = 0;
-		char *encoded = base64_encode(
-			section, descriptor->SectionLength, &encoded_len);
-		if (encoded == NULL) {
-			printf("Failed to allocate encode output buffer. \n");
-		} else {
-			json_object_object_add(result, "data",
-					       json_object_new_string_len(
-						       encoded, encoded_len));
-			free(encoded);
+		json_object *data =
+			base64_blob_to_ir(section, descriptor->SectionLength);
+		if (data != NULL) {
+			json_object_object_add(result, "data", data);
 		}
 	}
+	if (result != NULL) {
+		cper_section_cache_insert(&descriptor->SectionType, section,
+					  descriptor->SectionLength, result);
+		cper_metrics_record_section_decoded(
+			definition, cper_metrics_now() - start);
+	}
+
 	//Free section memory, return result.
 	free(section);
 	return result;
@@ -388,8 +472,11 @@ json_object *cper_single_section_to_ir(FILE *cper_section_file)
 	if (fread(&section_descriptor, sizeof(EFI_ERROR_SECTION_DESCRIPTOR), 1,
 		  cper_section_file) != 1) {
 		printf("Failed to read section descriptor for CPER single section (fread() returned an unexpected value).\n");
+		cper_metrics_record_failure(
+			CPER_METRICS_FAILURE_SHORT_DESCRIPTOR);
 		return NULL;
 	}
+	cper_metrics_record_bytes_in(sizeof(EFI_ERROR_SECTION_DESCRIPTOR));
 
 	//Convert the section descriptor to IR.
 	json_object *section_descriptor_ir =
@@ -400,6 +487,7 @@ json_object *cper_single_section_to_ir(FILE *cper_section_file)
 	json_object *section_ir = cper_section_to_ir(
 		cper_section_file, base_pos, &section_descriptor);
 	json_object_object_add(ir, "section", section_ir);
+	cper_metrics_record_decoded();
 
 	return ir;
 }
@@ -7,37 +7,41 @@ extern "C" {
 
 #include <json.h>
 
-#define CPER_HEADER_VALID_BITFIELD_NAMES                                       \
-	(const char *[])                                                       \
-	{                                                                      \
-		"platformIDValid", "timestampValid", "partitionIDValid"        \
-	}
-#define CPER_SECTION_DESCRIPTOR_VALID_BITFIELD_NAMES                           \
-	(const char *[])                                                       \
-	{                                                                      \
-		"fruIDValid", "fruStringValid"                                 \
-	}
-#define CPER_SECTION_DESCRIPTOR_FLAGS_BITFIELD_NAMES                           \
-	(const char *[])                                                       \
-	{                                                                      \
-		"primary", "containmentWarning", "reset",                      \
-			"errorThresholdExceeded", "resourceNotAccessible",     \
-			"latentError", "propagated", "overflow"                \
-	}
-#define CPER_HEADER_FLAG_TYPES_KEYS                                            \
-	(int[])                                                                \
-	{                                                                      \
-		1, 2, 4                                                        \
-	}
-#define CPER_HEADER_FLAG_TYPES_VALUES                                          \
-	(const char *[])                                                       \
-	{                                                                      \
-		"HW_ERROR_FLAGS_RECOVERED", "HW_ERROR_FLAGS_PREVERR",          \
-			"HW_ERROR_FLAGS_SIMULATED"                             \
-	}
+extern const char *const CPER_HEADER_VALID_BITFIELD_NAMES[3];
+extern const char *const CPER_SECTION_DESCRIPTOR_VALID_BITFIELD_NAMES[2];
+extern const char *const CPER_SECTION_DESCRIPTOR_FLAGS_BITFIELD_NAMES[8];
+extern const int CPER_HEADER_FLAG_TYPES_KEYS[3];
+extern const char *const CPER_HEADER_FLAG_TYPES_VALUES[3];
+
+//Flags controlling the shape of the CPER-JSON IR produced by the parser. Flags are held per thread,
+//and the _ex conversion functions take them per call instead.
+//CPER_IR_FLAG_LAZY_BASE64: Variable length opaque payloads are kept as raw bytes and only
+//base64 encoded when the IR is serialised. This flag is opt-in and NOT safe for generic IR
+//consumers: json_object_get_string() on such a node returns an empty string, and json-c offers no
+//way to encode it on access. Only serialise the IR or pass it to ir_to_cper(), or first call
+//cper_ir_materialise() to replace every lazy payload with its base64 string.
+#define CPER_IR_FLAG_LAZY_BASE64 0x1
+//CPER_IR_FLAG_TIMESTAMP_EPOCH: Record headers with a timestamp additionally carry "timestampEpoch",
+//the timestamp as integer seconds since 1970-01-01T00:00:00 with no timezone adjustment.
+#define CPER_IR_FLAG_TIMESTAMP_EPOCH 0x2
+//CPER_IR_FLAG_COMPACT: Validation bits, flags, enumerated values and revisions are output as their
+//raw integer values rather than objects of named booleans or value/name pairs.
+#define CPER_IR_FLAG_COMPACT 0x4
+//CPER_IR_FLAG_PACKED_REGISTERS: ARM and IA32/x64 register context arrays are output as a plain array
+//of integers in register order. The register names for each context type are published once in the
+//"$defs" of the matching section schema rather than repeated in every record. NVIDIA registers are
+//output as a flat array of alternating address and value.
+#define CPER_IR_FLAG_PACKED_REGISTERS 0x8
+
+void cper_ir_set_flags(unsigned int flags);
+unsigned int cper_ir_get_flags(void);
+void cper_ir_materialise(json_object *ir);
 
 json_object *cper_to_ir(FILE *cper_file);
 json_object *cper_single_section_to_ir(FILE *cper_section_file);
+json_object *cper_to_ir_ex(FILE *cper_file, unsigned int flags);
+json_object *cper_single_section_to_ir_ex(FILE *cper_section_file,
+					  unsigned int flags);
 void ir_to_cper(json_object *ir, FILE *out);
 void ir_single_section_to_cper(json_object *ir, FILE *out);
 
@@ -5,10 +5,22 @@
  **/
 
 #include <stdio.h>
+#include <string.h>
 #include <json.h>
+#include <printbuf.h>
+#include "base64.h"
 #include "edk/Cper.h"
+#include "cper-parse.h"
 #include "cper-utils.h"
 
+//Raw bytes of a base64 IR string whose encoding is deferred until serialisation.
+#define LAZY_BASE64_BLOB_SIGNATURE SIGNATURE_32('B', '6', '4', 'L')
+typedef struct {
+	UINT32 Signature;
+	INT32 Length;
+	UINT8 Data[];
+} LAZY_BASE64_BLOB;
+
 //The available severity types for CPER.
 const char *CPER_SEVERITY_TYPES[4] = { "Recoverable", "Fatal", "Corrected",
 				       "Informational" };
@@ -77,11 +89,22 @@ void ir_generic_error_status_to_cper(
 }
 
 //Converts a single uniform struct of UINT64s into intermediate JSON IR format, given names for each field in byte order.
-json_object *uniform_struct64_to_ir(UINT64 *start, int len, const char *names[])
+//With CPER_IR_FLAG_PACKED_REGISTERS set, the fields are instead output as an array of integers in name order.
+json_object *uniform_struct64_to_ir(UINT64 *start, int len,
+				    const char *const names[])
 {
-	json_object *result = json_object_new_object();
-
 	UINT64 *cur = start;
+	if (cper_ir_get_flags() & CPER_IR_FLAG_PACKED_REGISTERS) {
+		json_object *result = json_object_new_array();
+		for (int i = 0; i < len; i++) {
+			json_object_array_add(result,
+					      json_object_new_uint64(*cur));
+			cur++;
+		}
+		return result;
+	}
+
+	json_object *result = json_object_new_object();
 	for (int i = 0; i < len; i++) {
 		json_object_object_add(result, names[i],
 				       json_object_new_uint64(*cur));
@@ -92,11 +115,22 @@ json_object *uniform_struct64_to_ir(UINT64 *start, int len, const char *names[])
 }
 
 //Converts a single uniform struct of UINT32s into intermediate JSON IR format, given names for each field in byte order.
-json_object *uniform_struct_to_ir(UINT32 *start, int len, const char *names[])
+//With CPER_IR_FLAG_PACKED_REGISTERS set, the fields are instead output as an array of integers in name order.
+json_object *uniform_struct_to_ir(UINT32 *start, int len,
+				  const char *const names[])
 {
-	json_object *result = json_object_new_object();
-
 	UINT32 *cur = start;
+	if (cper_ir_get_flags() & CPER_IR_FLAG_PACKED_REGISTERS) {
+		json_object *result = json_object_new_array();
+		for (int i = 0; i < len; i++) {
+			json_object_array_add(result,
+					      json_object_new_uint64(*cur));
+			cur++;
+		}
+		return result;
+	}
+
+	json_object *result = json_object_new_object();
 	for (int i = 0; i < len; i++) {
 		json_object_object_add(result, names[i],
 				       json_object_new_uint64(*cur));
@@ -106,45 +140,69 @@ json_object *uniform_struct_to_ir(UINT32 *start, int len, const char *names[])
 	return result;
 }
 
-//Converts a single object containing UINT32s into a uniform struct.
+//Returns the value of a single field from either a named or packed uniform struct IR.
+static UINT64 uniform_struct_field(json_object *ir, int index,
+				   const char *const names[])
+{
+	if (json_object_is_type(ir, json_type_array)) {
+		return json_object_get_uint64(
+			json_object_array_get_idx(ir, index));
+	}
+	return json_object_get_uint64(json_object_object_get(ir, names[index]));
+}
+
+//Converts a single object or packed array containing UINT64s into a uniform struct.
 void ir_to_uniform_struct64(json_object *ir, UINT64 *start, int len,
-			    const char *names[])
+			    const char *const names[])
 {
 	UINT64 *cur = start;
 	for (int i = 0; i < len; i++) {
-		*cur = json_object_get_uint64(
-			json_object_object_get(ir, names[i]));
+		*cur = uniform_struct_field(ir, i, names);
 		cur++;
 	}
 }
 
-//Converts a single object containing UINT32s into a uniform struct.
+//Converts a single object or packed array containing UINT32s into a uniform struct.
 void ir_to_uniform_struct(json_object *ir, UINT32 *start, int len,
-			  const char *names[])
+			  const char *const names[])
 {
 	UINT32 *cur = start;
 	for (int i = 0; i < len; i++) {
-		*cur = (UINT32)json_object_get_uint64(
-			json_object_object_get(ir, names[i]));
+		*cur = (UINT32)uniform_struct_field(ir, i, names);
 		cur++;
 	}
 }
 
+//Returns the index of the given value within a readable pair key table, or -1 if not present.
+//Most tables are dense (keys[i] == i), so those resolve without a scan.
+static int readable_pair_index(UINT64 value, int len, const int keys[])
+{
+	if (value < (UINT64)len && (UINT64)keys[value] == value) {
+		return (int)value;
+	}
+	for (int i = 0; i < len; i++) {
+		if ((UINT64)keys[i] == value) {
+			return i;
+		}
+	}
+	return -1;
+}
+
 //Converts a single integer value to an object containing a value, and a readable name if possible.
 json_object *integer_to_readable_pair(UINT64 value, int len, const int keys[],
-				      const char *values[],
+				      const char *const values[],
 				      const char *default_value)
 {
+	if (cper_ir_get_flags() & CPER_IR_FLAG_COMPACT) {
+		return json_object_new_uint64(value);
+	}
+
 	json_object *result = json_object_new_object();
 	json_object_object_add(result, "value", json_object_new_uint64(value));
 
 	//Search for human readable name, add.
-	const char *name = default_value;
-	for (int i = 0; i < len; i++) {
-		if ((UINT64)keys[i] == value) {
-			name = values[i];
-		}
-	}
+	int index = readable_pair_index(value, len, keys);
+	const char *name = index >= 0 ? values[index] : default_value;
 
 	json_object_object_add(result, "name", json_object_new_string(name));
 	return result;
@@ -153,22 +211,25 @@ json_object *integer_to_readable_pair(UINT64 value, int len, const int keys[],
 //Converts a single integer value to an object containing a value, readable name and description if possible.
 json_object *integer_to_readable_pair_with_desc(int value, int len,
 						const int keys[],
-						const char *values[],
-						const char *descriptions[],
+						const char *const values[],
+						const char *const descriptions[],
 						const char *default_value)
 {
+	if (cper_ir_get_flags() & CPER_IR_FLAG_COMPACT) {
+		return json_object_new_int(value);
+	}
+
 	json_object *result = json_object_new_object();
 	json_object_object_add(result, "value", json_object_new_int(value));
 
 	//Search for human readable name, add.
 	const char *name = default_value;
-	for (int i = 0; i < len; i++) {
-		if (keys[i] == value) {
-			name = values[i];
-			json_object_object_add(
-				result, "description",
-				json_object_new_string(descriptions[i]));
-		}
+	int index = readable_pair_index((UINT64)value, len, keys);
+	if (index >= 0) {
+		name = values[index];
+		json_object_object_add(
+			result, "description",
+			json_object_new_string(descriptions[index]));
 	}
 
 	json_object_object_add(result, "name", json_object_new_string(name));
@@ -176,16 +237,30 @@ json_object *integer_to_readable_pair_with_desc(int value, int len,
 }
 
 //Returns a single UINT64 value from the given readable pair object.
-//Assumes the integer value is held in the "value" field.
+//Assumes the integer value is held in the "value" field, or is the pair itself if compact.
 UINT64 readable_pair_to_integer(json_object *pair)
 {
+	if (json_object_is_type(pair, json_type_int)) {
+		return json_object_get_uint64(pair);
+	}
 	return json_object_get_uint64(json_object_object_get(pair, "value"));
 }
 
+//Returns a mask covering the lowest "num_fields" bits.
+static UINT64 bitfield_mask(int num_fields)
+{
+	return num_fields >= 64 ? ~0ULL : (1ULL << num_fields) - 1;
+}
+
 //Converts the given 64 bit bitfield to IR, assuming bit 0 starts on the left.
 json_object *bitfield_to_ir(UINT64 bitfield, int num_fields,
-			    const char *names[])
+			    const char *const names[])
 {
+	if (cper_ir_get_flags() & CPER_IR_FLAG_COMPACT) {
+		return json_object_new_uint64(bitfield &
+					      bitfield_mask(num_fields));
+	}
+
 	json_object *result = json_object_new_object();
 	for (int i = 0; i < num_fields; i++) {
 		json_object_object_add(result, names[i],
@@ -197,8 +272,13 @@ json_object *bitfield_to_ir(UINT64 bitfield, int num_fields,
 }
 
 //Converts the given IR bitfield into a standard UINT64 bitfield, with fields beginning from bit 0.
-UINT64 ir_to_bitfield(json_object *ir, int num_fields, const char *names[])
+UINT64 ir_to_bitfield(json_object *ir, int num_fields,
+		      const char *const names[])
 {
+	if (json_object_is_type(ir, json_type_int)) {
+		return json_object_get_uint64(ir) & bitfield_mask(num_fields);
+	}
+
 	UINT64 result = 0x0;
 	for (int i = 0; i < num_fields; i++) {
 		if (json_object_get_boolean(
@@ -221,9 +301,199 @@ json_object *uint64_array_to_ir_array(UINT64 *array, int len)
 	return array_ir;
 }
 
+//Returns the lazy base64 blob held by the given IR string, or NULL if the string is a regular one.
+static LAZY_BASE64_BLOB *lazy_base64_blob(json_object *blob)
+{
+	if (!json_object_is_type(blob, json_type_string)) {
+		return NULL;
+	}
+	LAZY_BASE64_BLOB *lazy = json_object_get_userdata(blob);
+	if (lazy == NULL || lazy->Signature != LAZY_BASE64_BLOB_SIGNATURE) {
+		return NULL;
+	}
+	return lazy;
+}
+
+//json-c serialiser for lazy base64 blobs, encoding the held bytes as a JSON string.
+static int lazy_base64_to_json_string(json_object *jso, struct printbuf *pb,
+				      int level, int flags)
+{
+	(void)level;
+	LAZY_BASE64_BLOB *lazy = lazy_base64_blob(jso);
+	INT32 encoded_len = 0;
+	CHAR8 *encoded = base64_encode(lazy->Data, lazy->Length, &encoded_len);
+	if (encoded == NULL) {
+		printf("Failed to allocate encode output buffer. \n");
+		return -1;
+	}
+
+	//'/' is the only base64 character json-c escapes, so match its output for plain strings.
+	printbuf_memappend(pb, "\"", 1);
+	const CHAR8 *start = encoded;
+	for (INT32 i = 0; i < encoded_len; i++) {
+		if (encoded[i] == '/' &&
+		    !(flags & JSON_C_TO_STRING_NOSLASHESCAPE)) {
+			printbuf_memappend(pb, start, encoded + i - start);
+			printbuf_memappend(pb, "\\/", 2);
+			start = encoded + i + 1;
+		}
+	}
+	printbuf_memappend(pb, start, encoded + encoded_len - start);
+	printbuf_memappend(pb, "\"", 1);
+
+	free(encoded);
+	return 0;
+}
+
+//Frees the bytes held by a lazy base64 blob.
+static void lazy_base64_free(json_object *jso, void *userdata)
+{
+	(void)jso;
+	free(userdata);
+}
+
+//Converts the given binary data into a base64 JSON IR string.
+//If lazy encoding is enabled via. CPER_IR_FLAG_LAZY_BASE64, the data is copied and only
+//encoded when the IR is serialised.
+json_object *base64_blob_to_ir(const UINT8 *data, INT32 len)
+{
+	if (cper_ir_get_flags() & CPER_IR_FLAG_LAZY_BASE64) {
+		LAZY_BASE64_BLOB *lazy =
+			malloc(sizeof(LAZY_BASE64_BLOB) + (len > 0 ? len : 0));
+		if (lazy == NULL) {
+			printf("Failed to allocate lazy base64 buffer. \n");
+			return NULL;
+		}
+		lazy->Signature = LAZY_BASE64_BLOB_SIGNATURE;
+		lazy->Length = len;
+		memcpy(lazy->Data, data, len);
+
+		json_object *blob = json_object_new_string_len("", 0);
+		json_object_set_serializer(blob, lazy_base64_to_json_string,
+					   lazy, lazy_base64_free);
+		return blob;
+	}
+
+	INT32 encoded_len = 0;
+	CHAR8 *encoded = base64_encode(data, len, &encoded_len);
+	if (encoded == NULL) {
+		printf("Failed to allocate encode output buffer. \n");
+		return NULL;
+	}
+	json_object *blob = json_object_new_string_len(encoded, encoded_len);
+	free(encoded);
+	return blob;
+}
+
+//Replaces every lazy base64 payload in the given IR with its base64 string, so that the IR can be
+//read with json_object_get_string() like IR output without CPER_IR_FLAG_LAZY_BASE64.
+void cper_ir_materialise(json_object *ir)
+{
+	if (json_object_is_type(ir, json_type_object)) {
+		json_object_object_foreach(ir, key, value)
+		{
+			(void)key;
+			cper_ir_materialise(value);
+		}
+		return;
+	}
+	if (json_object_is_type(ir, json_type_array)) {
+		size_t len = json_object_array_length(ir);
+		for (size_t i = 0; i < len; i++) {
+			cper_ir_materialise(json_object_array_get_idx(ir, i));
+		}
+		return;
+	}
+
+	LAZY_BASE64_BLOB *lazy = lazy_base64_blob(ir);
+	if (lazy == NULL) {
+		return;
+	}
+	INT32 encoded_len = 0;
+	CHAR8 *encoded = base64_encode(lazy->Data, lazy->Length, &encoded_len);
+	if (encoded == NULL) {
+		printf("Failed to allocate encode output buffer. \n");
+		return;
+	}
+
+	//Resetting the serialiser frees the held bytes.
+	json_object_set_serializer(ir, NULL, NULL, NULL);
+	json_object_set_string_len(ir, (const char *)encoded, encoded_len);
+	free(encoded);
+}
+
+//json-c shallow copy function for IR, which copies the bytes held by lazy base64 blobs. json-c
+//cannot copy the serialiser data of such nodes itself.
+static int ir_shallow_copy(json_object *src, json_object *parent,
+			   const char *key, size_t index, json_object **dst)
+{
+	LAZY_BASE64_BLOB *lazy = lazy_base64_blob(src);
+	if (lazy == NULL) {
+		return json_c_shallow_copy_default(src, parent, key, index,
+						   dst);
+	}
+
+	size_t size = sizeof(LAZY_BASE64_BLOB) +
+		      (lazy->Length > 0 ? lazy->Length : 0);
+	LAZY_BASE64_BLOB *copy = malloc(size);
+	if (copy == NULL) {
+		printf("Failed to allocate lazy base64 buffer. \n");
+		return -1;
+	}
+	memcpy(copy, lazy, size);
+	*dst = json_object_new_string_len("", 0);
+	json_object_set_serializer(*dst, lazy_base64_to_json_string, copy,
+				   lazy_base64_free);
+
+	//The serialiser data has been copied too.
+	return 2;
+}
+
+//Returns an unshared deep copy of the given IR, including any lazy base64 payloads, or NULL on
+//failure.
+json_object *cper_ir_copy(json_object *ir)
+{
+	json_object *copy = NULL;
+	if (json_object_deep_copy(ir, &copy, ir_shallow_copy) < 0) {
+		printf("Failed to copy IR.\n");
+		json_object_put(copy);
+		return NULL;
+	}
+	return copy;
+}
+
+//Converts the given base64 JSON IR string (lazy or otherwise) back into binary data.
+//Caller is responsible for freeing the returned buffer.
+UINT8 *ir_to_base64_blob(json_object *blob, INT32 *out_len)
+{
+	LAZY_BASE64_BLOB *lazy = lazy_base64_blob(blob);
+	if (lazy != NULL) {
+		UINT8 *decoded = malloc(lazy->Length > 0 ? lazy->Length : 1);
+		if (decoded == NULL) {
+			printf("Failed to allocate decode output buffer. \n");
+			return NULL;
+		}
+		memcpy(decoded, lazy->Data, lazy->Length);
+		*out_len = lazy->Length;
+		return decoded;
+	}
+
+	UINT8 *decoded = base64_decode(json_object_get_string(blob),
+				       json_object_get_string_len(blob),
+				       out_len);
+	if (decoded == NULL) {
+		printf("Failed to allocate decode output buffer. \n");
+	}
+	return decoded;
+}
+
 //Converts a single UINT16 revision number into JSON IR representation.
 json_object *revision_to_ir(UINT16 revision)
 {
+	if (cper_ir_get_flags() & CPER_IR_FLAG_COMPACT) {
+		return json_object_new_int(revision);
+	}
+
 	json_object *revision_info = json_object_new_object();
 	json_object_object_add(revision_info, "major",
 			       json_object_new_int(revision >> 8));
@@ -232,26 +502,73 @@ json_object *revision_to_ir(UINT16 revision)
 	return revision_info;
 }
 
+//Converts a single JSON IR revision (compact or otherwise) back into a UINT16 revision number.
+UINT16 ir_to_revision(json_object *revision)
+{
+	if (json_object_is_type(revision, json_type_int)) {
+		return (UINT16)json_object_get_int(revision);
+	}
+	int minor =
+		json_object_get_int(json_object_object_get(revision, "minor"));
+	int major =
+		json_object_get_int(json_object_object_get(revision, "major"));
+	return minor + (major << 8);
+}
+
 //Returns the appropriate string for the given integer severity.
 const char *severity_to_string(UINT32 severity)
 {
 	return severity < 4 ? CPER_SEVERITY_TYPES[severity] : "Unknown";
 }
 
+//Writes the given BCD byte as two decimal digits, returning a pointer past the last digit.
+//Out of range values are truncated to their last two digits.
+static char *bcd_to_string(char *out, UINT8 bcd)
+{
+	int value = bcd_to_int(bcd) % 100;
+	out[0] = '0' + value / 10;
+	out[1] = '0' + value % 10;
+	return out + 2;
+}
+
+//Reads between one and "max_digits" decimal digits from the given string, advancing it.
+//Returns zero if no digits are present, one otherwise.
+static int string_to_decimal(const char **str, int max_digits, int *out)
+{
+	int value = 0;
+	int i = 0;
+	for (; i < max_digits && (*str)[i] >= '0' && (*str)[i] <= '9'; i++) {
+		value = value * 10 + ((*str)[i] - '0');
+	}
+	if (i == 0) {
+		return 0;
+	}
+	*str += i;
+	*out = value;
+	return 1;
+}
+
 //Converts a single EFI timestamp to string, at the given output.
 //Output must be at least TIMESTAMP_LENGTH bytes long.
 void timestamp_to_string(char *out, EFI_ERROR_TIME_STAMP *timestamp)
 {
-	sprintf(out, "%02hhu%02hhu-%02hhu-%02hhuT%02hhu:%02hhu:%02hhu.000",
-		bcd_to_int(timestamp->Century) %
-			100,			   //Cannot go to three digits.
-		bcd_to_int(timestamp->Year) % 100, //Cannot go to three digits.
-		bcd_to_int(timestamp->Month), bcd_to_int(timestamp->Day),
-		bcd_to_int(timestamp->Hours), bcd_to_int(timestamp->Minutes),
-		bcd_to_int(timestamp->Seconds));
+	out = bcd_to_string(out, timestamp->Century);
+	out = bcd_to_string(out, timestamp->Year);
+	*out++ = '-';
+	out = bcd_to_string(out, timestamp->Month);
+	*out++ = '-';
+	out = bcd_to_string(out, timestamp->Day);
+	*out++ = 'T';
+	out = bcd_to_string(out, timestamp->Hours);
+	*out++ = ':';
+	out = bcd_to_string(out, timestamp->Minutes);
+	*out++ = ':';
+	out = bcd_to_string(out, timestamp->Seconds);
+	memcpy(out, ".000", 5);
 }
 
 //Converts a single timestamp string to an EFI timestamp.
+//The output is left untouched if the string is not a well formed timestamp.
 void string_to_timestamp(EFI_ERROR_TIME_STAMP *out, const char *timestamp)
 {
 	//Ignore invalid timestamps.
@@ -259,30 +576,118 @@ void string_to_timestamp(EFI_ERROR_TIME_STAMP *out, const char *timestamp)
 		return;
 	}
 
-	sscanf(timestamp, "%2hhu%2hhu-%hhu-%hhuT%hhu:%hhu:%hhu.000",
-	       &out->Century, &out->Year, &out->Month, &out->Day, &out->Hours,
-	       &out->Minutes, &out->Seconds);
+	int century;
+	int year;
+	int month;
+	int day;
+	int hours;
+	int minutes;
+	int seconds;
+	const char *cur = timestamp;
+	if (!string_to_decimal(&cur, 2, &century) || cur != timestamp + 2 ||
+	    !string_to_decimal(&cur, 2, &year) || cur != timestamp + 4 ||
+	    *cur++ != '-' || !string_to_decimal(&cur, 2, &month) ||
+	    *cur++ != '-' || !string_to_decimal(&cur, 2, &day) ||
+	    *cur++ != 'T' || !string_to_decimal(&cur, 2, &hours) ||
+	    *cur++ != ':' || !string_to_decimal(&cur, 2, &minutes) ||
+	    *cur++ != ':' || !string_to_decimal(&cur, 2, &seconds)) {
+		return;
+	}
 
 	//Convert back to BCD.
-	out->Century = int_to_bcd(out->Century);
-	out->Year = int_to_bcd(out->Year);
-	out->Month = int_to_bcd(out->Month);
-	out->Day = int_to_bcd(out->Day);
-	out->Hours = int_to_bcd(out->Hours);
-	out->Minutes = int_to_bcd(out->Minutes);
-	out->Seconds = int_to_bcd(out->Seconds);
+	out->Century = int_to_bcd(century);
+	out->Year = int_to_bcd(year);
+	out->Month = int_to_bcd(month);
+	out->Day = int_to_bcd(day);
+	out->Hours = int_to_bcd(hours);
+	out->Minutes = int_to_bcd(minutes);
+	out->Seconds = int_to_bcd(seconds);
+}
+
+//Converts a single EFI timestamp into seconds since 1970-01-01T00:00:00.
+//The timestamp is taken as-is with no timezone adjustment, so is only meaningful for ordering
+//and bucketing records from the same platform.
+INT64 timestamp_to_epoch(EFI_ERROR_TIME_STAMP *timestamp)
+{
+	INT64 year = bcd_to_int(timestamp->Century) * 100 +
+		     bcd_to_int(timestamp->Year);
+	INT64 month = bcd_to_int(timestamp->Month);
+	INT64 day = bcd_to_int(timestamp->Day);
+
+	//Count days in the proleptic Gregorian calendar, treating March as the first month so that
+	//leap days fall at the end of the year.
+	if (month <= 2) {
+		year--;
+	}
+	INT64 era = (year >= 0 ? year : year - 399) / 400;
+	INT64 year_of_era = year - era * 400;
+	INT64 day_of_year =
+		(153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	INT64 day_of_era = year_of_era * 365 + year_of_era / 4 -
+			   year_of_era / 100 + day_of_year;
+	INT64 days = era * 146097 + day_of_era - 719468;
+
+	return days * 86400 + bcd_to_int(timestamp->Hours) * 3600 +
+	       bcd_to_int(timestamp->Minutes) * 60 +
+	       bcd_to_int(timestamp->Seconds);
+}
+
+//Lowercase hex digits, indexed by nibble.
+static const char HEX_DIGITS[16] = { '0', '1', '2', '3', '4', '5', '6', '7',
+				     '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+
+//Writes the lowest "digits" nibbles of the given value as zero padded lowercase hex.
+//Returns a pointer to the character after the last digit written.
+static char *hex_to_string(char *out, UINT64 value, int digits)
+{
+	for (int i = digits - 1; i >= 0; i--) {
+		out[i] = HEX_DIGITS[value & 0xF];
+		value >>= 4;
+	}
+	return out + digits;
+}
+
+//Reads exactly "digits" hex characters (either case) from the given string, advancing it.
+//Returns zero if a non-hex character is encountered, one otherwise.
+static int string_to_hex(const char **str, int digits, UINT64 *out)
+{
+	UINT64 value = 0;
+	for (int i = 0; i < digits; i++) {
+		char c = (*str)[i];
+		UINT64 nibble;
+		if (c >= '0' && c <= '9') {
+			nibble = c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			nibble = c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			nibble = c - 'A' + 10;
+		} else {
+			return 0;
+		}
+		value = (value << 4) | nibble;
+	}
+	*str += digits;
+	*out = value;
+	return 1;
 }
 
 //Helper function to convert an EDK EFI GUID into a string for intermediate use.
 void guid_to_string(char *out, EFI_GUID *guid)
 {
-	sprintf(out, "%08x-%04x-%04x-%02x%02x%02x%02x%02x%02x%02x%02x",
-		guid->Data1, guid->Data2, guid->Data3, guid->Data4[0],
-		guid->Data4[1], guid->Data4[2], guid->Data4[3], guid->Data4[4],
-		guid->Data4[5], guid->Data4[6], guid->Data4[7]);
+	out = hex_to_string(out, guid->Data1, 8);
+	*out++ = '-';
+	out = hex_to_string(out, guid->Data2, 4);
+	*out++ = '-';
+	out = hex_to_string(out, guid->Data3, 4);
+	*out++ = '-';
+	for (int i = 0; i < 8; i++) {
+		out = hex_to_string(out, guid->Data4[i], 2);
+	}
+	*out = '\0';
 }
 
 //Helper function to convert a string into an EDK EFI GUID.
+//The output is left untouched if the string is not a well formed GUID.
 void string_to_guid(EFI_GUID *out, const char *guid)
 {
 	//Ignore invalid GUIDs.
@@ -290,11 +695,30 @@ void string_to_guid(EFI_GUID *out, const char *guid)
 		return;
 	}
 
-	sscanf(guid,
-	       "%08x-%04hx-%04hx-%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",
-	       &out->Data1, &out->Data2, &out->Data3, out->Data4,
-	       out->Data4 + 1, out->Data4 + 2, out->Data4 + 3, out->Data4 + 4,
-	       out->Data4 + 5, out->Data4 + 6, out->Data4 + 7);
+	UINT64 data1;
+	UINT64 data2;
+	UINT64 data3;
+	UINT64 data4[8];
+	if (!string_to_hex(&guid, 8, &data1) || *guid++ != '-' ||
+	    !string_to_hex(&guid, 4, &data2) || *guid++ != '-' ||
+	    !string_to_hex(&guid, 4, &data3) || *guid++ != '-') {
+		return;
+	}
+	for (int i = 0; i < 8; i++) {
+		if (!string_to_hex(&guid, 2, &data4[i])) {
+			return;
+		}
+	}
+	if (*guid != '\0') {
+		return;
+	}
+
+	out->Data1 = (UINT32)data1;
+	out->Data2 = (UINT16)data2;
+	out->Data3 = (UINT16)data3;
+	for (int i = 0; i < 8; i++) {
+		out->Data4[i] = (UINT8)data4[i];
+	}
 }
 
 //Returns one if two EFI GUIDs are equal, zero otherwise.
@@ -0,0 +1,569 @@
+/**
+ * Describes a zero allocation, read-only view over CPER records held in memory.
+ * Intended for consumers that filter on a handful of fields before (or instead of) a full
+ * conversion to CPER-JSON IR.
+ **/
+
+#include <string.h>
+#include "edk/Cper.h"
+#include "cper-view.h"
+#include "sections/cper-section-arm.h"
+#include "sections/cper-section-pci-dev.h"
+#include "sections/cper-section-ccix-per.h"
+#include "sections/cper-section-cxl-protocol.h"
+#include "sections/cper-section-cxl-component.h"
+
+//Private pre-definitions.
+static int view_guid_equal(const EFI_GUID *a, const EFI_GUID *b);
+static const void *view_section_of_type(const cper_record_view *view,
+					UINT16 index, const EFI_GUID *type,
+					size_t min_size);
+
+//Initialises a view over the CPER record contained in the given buffer.
+//Returns 1 if the buffer holds a record header with the "CPER" signature and all of its section
+//descriptors, 0 otherwise. Section bodies are bounds checked lazily, when accessed.
+int cper_record_view_init(cper_record_view *view, const void *data,
+			  size_t size)
+{
+	view->data = NULL;
+	view->size = 0;
+	if (data == NULL || size < sizeof(EFI_COMMON_ERROR_RECORD_HEADER)) {
+		return 0;
+	}
+
+	const EFI_COMMON_ERROR_RECORD_HEADER *header =
+		(const EFI_COMMON_ERROR_RECORD_HEADER *)data;
+	if (header->SignatureStart != EFI_ERROR_RECORD_SIGNATURE_START) {
+		return 0;
+	}
+	if ((size - sizeof(EFI_COMMON_ERROR_RECORD_HEADER)) /
+		    sizeof(EFI_ERROR_SECTION_DESCRIPTOR) <
+	    header->SectionCount) {
+		return 0;
+	}
+
+	view->data = (const UINT8 *)data;
+	view->size = size;
+	return 1;
+}
+
+/*
+* Record header.
+*/
+
+//Returns the record header. Only valid on an initialised view.
+const EFI_COMMON_ERROR_RECORD_HEADER *
+cper_record_view_header(const cper_record_view *view)
+{
+	return (const EFI_COMMON_ERROR_RECORD_HEADER *)view->data;
+}
+
+UINT16 cper_record_view_revision(const cper_record_view *view)
+{
+	return cper_record_view_header(view)->Revision;
+}
+
+UINT32 cper_record_view_severity(const cper_record_view *view)
+{
+	return cper_record_view_header(view)->ErrorSeverity;
+}
+
+UINT16 cper_record_view_section_count(const cper_record_view *view)
+{
+	return cper_record_view_header(view)->SectionCount;
+}
+
+UINT64 cper_record_view_record_id(const cper_record_view *view)
+{
+	return cper_record_view_header(view)->RecordID;
+}
+
+UINT32 cper_record_view_flags(const cper_record_view *view)
+{
+	return cper_record_view_header(view)->Flags;
+}
+
+const EFI_GUID *cper_record_view_notification_type(const cper_record_view *view)
+{
+	return &cper_record_view_header(view)->NotificationType;
+}
+
+const EFI_GUID *cper_record_view_creator_id(const cper_record_view *view)
+{
+	return &cper_record_view_header(view)->CreatorID;
+}
+
+//Returns the platform ID, or NULL if it is not marked valid.
+const EFI_GUID *cper_record_view_platform_id(const cper_record_view *view)
+{
+	const EFI_COMMON_ERROR_RECORD_HEADER *header =
+		cper_record_view_header(view);
+	if (!(header->ValidationBits & 0x1)) {
+		return NULL;
+	}
+	return &header->PlatformID;
+}
+
+//Returns the partition ID, or NULL if it is not marked valid.
+const EFI_GUID *cper_record_view_partition_id(const cper_record_view *view)
+{
+	const EFI_COMMON_ERROR_RECORD_HEADER *header =
+		cper_record_view_header(view);
+	if (!(header->ValidationBits & 0x4)) {
+		return NULL;
+	}
+	return &header->PartitionID;
+}
+
+//Returns the record timestamp, or NULL if it is not marked valid.
+const EFI_ERROR_TIME_STAMP *
+cper_record_view_timestamp(const cper_record_view *view)
+{
+	const EFI_COMMON_ERROR_RECORD_HEADER *header =
+		cper_record_view_header(view);
+	if (!(header->ValidationBits & 0x2)) {
+		return NULL;
+	}
+	return &header->TimeStamp;
+}
+
+/*
+* Section descriptors.
+*/
+
+//Returns the section descriptor at the given index, or NULL if the index is out of range.
+const EFI_ERROR_SECTION_DESCRIPTOR *
+cper_record_view_descriptor(const cper_record_view *view, UINT16 index)
+{
+	if (index >= cper_record_view_section_count(view)) {
+		return NULL;
+	}
+	return (const EFI_ERROR_SECTION_DESCRIPTOR
+			*)(view->data +
+			   sizeof(EFI_COMMON_ERROR_RECORD_HEADER)) +
+	       index;
+}
+
+//Returns the section type GUID at the given index, or NULL if the index is out of range.
+const EFI_GUID *cper_record_view_section_type(const cper_record_view *view,
+					      UINT16 index)
+{
+	const EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		cper_record_view_descriptor(view, index);
+	return descriptor != NULL ? &descriptor->SectionType : NULL;
+}
+
+//Returns the severity of the section at the given index, or 0xFFFFFFFF if the index is out of range.
+UINT32 cper_record_view_section_severity(const cper_record_view *view,
+					 UINT16 index)
+{
+	const EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		cper_record_view_descriptor(view, index);
+	return descriptor != NULL ? descriptor->Severity : 0xFFFFFFFF;
+}
+
+//Returns the FRU ID of the section at the given index, or NULL if it is not present or not marked valid.
+const EFI_GUID *cper_record_view_fru_id(const cper_record_view *view,
+					UINT16 index)
+{
+	const EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		cper_record_view_descriptor(view, index);
+	if (descriptor == NULL || !(descriptor->SecValidMask & 0x1)) {
+		return NULL;
+	}
+	return &descriptor->FruId;
+}
+
+//Returns the body of the section at the given index, or NULL if the index is out of range or the
+//section lies outside of the buffer. If provided, the section length is output to "length".
+const void *cper_record_view_section(const cper_record_view *view,
+				     UINT16 index, UINT32 *length)
+{
+	const EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		cper_record_view_descriptor(view, index);
+	if (descriptor == NULL || descriptor->SectionOffset > view->size ||
+	    descriptor->SectionLength >
+		    view->size - descriptor->SectionOffset) {
+		return NULL;
+	}
+
+	if (length != NULL) {
+		*length = descriptor->SectionLength;
+	}
+	return view->data + descriptor->SectionOffset;
+}
+
+/*
+* Typed section bodies.
+*/
+
+const EFI_PROCESSOR_GENERIC_ERROR_DATA *
+cper_record_view_generic(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index,
+				    &gEfiProcessorGenericErrorSectionGuid,
+				    sizeof(EFI_PROCESSOR_GENERIC_ERROR_DATA));
+}
+
+const EFI_IA32_X64_PROCESSOR_ERROR_RECORD *
+cper_record_view_ia32x64(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(
+		view, index, &gEfiIa32X64ProcessorErrorSectionGuid,
+		sizeof(EFI_IA32_X64_PROCESSOR_ERROR_RECORD));
+}
+
+const EFI_ARM_ERROR_RECORD *cper_record_view_arm(const cper_record_view *view,
+						 UINT16 index)
+{
+	return view_section_of_type(view, index,
+				    &gEfiArmProcessorErrorSectionGuid,
+				    sizeof(EFI_ARM_ERROR_RECORD));
+}
+
+const EFI_PLATFORM_MEMORY_ERROR_DATA *
+cper_record_view_memory(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index,
+				    &gEfiPlatformMemoryErrorSectionGuid,
+				    sizeof(EFI_PLATFORM_MEMORY_ERROR_DATA));
+}
+
+const EFI_PLATFORM_MEMORY2_ERROR_DATA *
+cper_record_view_memory2(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index,
+				    &gEfiPlatformMemoryError2SectionGuid,
+				    sizeof(EFI_PLATFORM_MEMORY2_ERROR_DATA));
+}
+
+const EFI_PCIE_ERROR_DATA *cper_record_view_pcie(const cper_record_view *view,
+						 UINT16 index)
+{
+	return view_section_of_type(view, index, &gEfiPcieErrorSectionGuid,
+				    sizeof(EFI_PCIE_ERROR_DATA));
+}
+
+const EFI_FIRMWARE_ERROR_DATA *
+cper_record_view_firmware(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index, &gEfiFirmwareErrorSectionGuid,
+				    sizeof(EFI_FIRMWARE_ERROR_DATA));
+}
+
+const EFI_PCI_PCIX_BUS_ERROR_DATA *
+cper_record_view_pci_bus(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index, &gEfiPciBusErrorSectionGuid,
+				    sizeof(EFI_PCI_PCIX_BUS_ERROR_DATA));
+}
+
+const EFI_PCI_PCIX_DEVICE_ERROR_DATA *
+cper_record_view_pci_dev(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index, &gEfiPciDevErrorSectionGuid,
+				    sizeof(EFI_PCI_PCIX_DEVICE_ERROR_DATA));
+}
+
+const EFI_DMAR_GENERIC_ERROR_DATA *
+cper_record_view_dmar_generic(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index,
+				    &gEfiDMArGenericErrorSectionGuid,
+				    sizeof(EFI_DMAR_GENERIC_ERROR_DATA));
+}
+
+const EFI_DIRECTED_IO_DMAR_ERROR_DATA *
+cper_record_view_dmar_vtd(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index,
+				    &gEfiDirectedIoDMArErrorSectionGuid,
+				    sizeof(EFI_DIRECTED_IO_DMAR_ERROR_DATA));
+}
+
+const EFI_IOMMU_DMAR_ERROR_DATA *
+cper_record_view_dmar_iommu(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index,
+				    &gEfiIommuDMArErrorSectionGuid,
+				    sizeof(EFI_IOMMU_DMAR_ERROR_DATA));
+}
+
+const EFI_CCIX_PER_LOG_DATA *
+cper_record_view_ccix_per(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index,
+				    &gEfiCcixPerLogErrorSectionGuid,
+				    sizeof(EFI_CCIX_PER_LOG_DATA));
+}
+
+const EFI_CXL_PROTOCOL_ERROR_DATA *
+cper_record_view_cxl_protocol(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index,
+				    &gEfiCxlProtocolErrorSectionGuid,
+				    sizeof(EFI_CXL_PROTOCOL_ERROR_DATA));
+}
+
+//Returns the common event header of any CXL component event section.
+const EFI_CXL_COMPONENT_EVENT_HEADER *
+cper_record_view_cxl_component(const cper_record_view *view, UINT16 index)
+{
+	const EFI_GUID *component_types[6] = {
+		&gEfiCxlGeneralMediaErrorSectionGuid,
+		&gEfiCxlDramEventErrorSectionGuid,
+		&gEfiCxlMemoryModuleErrorSectionGuid,
+		&gEfiCxlPhysicalSwitchErrorSectionGuid,
+		&gEfiCxlVirtualSwitchErrorSectionGuid,
+		&gEfiCxlMldPortErrorSectionGuid
+	};
+	for (int i = 0; i < 6; i++) {
+		const void *section = view_section_of_type(
+			view, index, component_types[i],
+			sizeof(EFI_CXL_COMPONENT_EVENT_HEADER));
+		if (section != NULL) {
+			return section;
+		}
+	}
+	return NULL;
+}
+
+const EFI_NVIDIA_ERROR_DATA *
+cper_record_view_nvidia(const cper_record_view *view, UINT16 index)
+{
+	return view_section_of_type(view, index, &gEfiNvidiaErrorSectionGuid,
+				    sizeof(EFI_NVIDIA_ERROR_DATA));
+}
+
+/*
+* Common filter fields.
+*/
+
+//Outputs MPIDR_EL1 from the ARM processor section at the given index.
+int cper_record_view_arm_mpidr(const cper_record_view *view, UINT16 index,
+			       UINT64 *mpidr)
+{
+	const EFI_ARM_ERROR_RECORD *record = cper_record_view_arm(view, index);
+	if (record == NULL || !(record->ValidFields & 0x1)) {
+		return 0;
+	}
+	*mpidr = record->MPIDR_EL1;
+	return 1;
+}
+
+//Outputs the error physical address from the platform memory (or memory 2) section at the given index.
+int cper_record_view_memory_physical_address(const cper_record_view *view,
+					     UINT16 index, UINT64 *address)
+{
+	const EFI_PLATFORM_MEMORY_ERROR_DATA *memory =
+		cper_record_view_memory(view, index);
+	if (memory != NULL) {
+		if (!(memory->ValidFields & 0x2)) {
+			return 0;
+		}
+		*address = memory->PhysicalAddress;
+		return 1;
+	}
+
+	const EFI_PLATFORM_MEMORY2_ERROR_DATA *memory2 =
+		cper_record_view_memory2(view, index);
+	if (memory2 != NULL) {
+		if (!(memory2->ValidFields & 0x2)) {
+			return 0;
+		}
+		*address = memory2->PhysicalAddress;
+		return 1;
+	}
+
+	return 0;
+}
+
+//Outputs the device segment/bus/device/function from the PCIe section at the given index.
+int cper_record_view_pcie_bdf(const cper_record_view *view, UINT16 index,
+			      cper_view_bdf *bdf)
+{
+	const EFI_PCIE_ERROR_DATA *pcie = cper_record_view_pcie(view, index);
+	if (pcie == NULL || !(pcie->ValidFields & 0x8)) {
+		return 0;
+	}
+	bdf->segment = pcie->DevBridge.Segment;
+	bdf->bus = pcie->DevBridge.PrimaryOrDeviceBus;
+	bdf->device = pcie->DevBridge.Device;
+	bdf->function = pcie->DevBridge.Function;
+	return 1;
+}
+
+/*
+* NVIDIA registers.
+*/
+
+//Returns the register address/value pairs of the NVIDIA section at the given index, outputting
+//their count. Returns NULL if the section is not an NVIDIA section or its registers are truncated.
+const EFI_NVIDIA_REGISTER_DATA *
+cper_record_view_nvidia_registers(const cper_record_view *view, UINT16 index,
+				  UINT16 *count)
+{
+	const EFI_NVIDIA_ERROR_DATA *nvidia =
+		cper_record_view_nvidia(view, index);
+	if (nvidia == NULL) {
+		return NULL;
+	}
+
+	UINT32 length = 0;
+	cper_record_view_section(view, index, &length);
+	if ((length - sizeof(EFI_NVIDIA_ERROR_DATA)) /
+		    sizeof(EFI_NVIDIA_REGISTER_DATA) <
+	    nvidia->NumberRegs) {
+		return NULL;
+	}
+	*count = nvidia->NumberRegs;
+	return (const EFI_NVIDIA_REGISTER_DATA *)(nvidia + 1);
+}
+
+//Outputs the value of the first register with the given address in the NVIDIA section at the given
+//index, scanning linearly. For repeated lookups within one section, use cper_record_view_nvidia_index().
+int cper_record_view_nvidia_register(const cper_record_view *view, UINT16 index,
+				     UINT64 address, UINT64 *value)
+{
+	UINT16 count = 0;
+	const EFI_NVIDIA_REGISTER_DATA *registers =
+		cper_record_view_nvidia_registers(view, index, &count);
+	if (registers == NULL) {
+		return 0;
+	}
+	for (UINT16 i = 0; i < count; i++) {
+		if (registers[i].Address == address) {
+			*value = registers[i].Value;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//Builds an address-sorted index over the registers of the NVIDIA section at the given index.
+//Returns 1 on success, 0 if the section is not an NVIDIA section or its registers are truncated.
+int cper_record_view_nvidia_index(const cper_record_view *view, UINT16 index,
+				  cper_view_nvidia_registers *registers)
+{
+	registers->count = 0;
+	registers->registers =
+		cper_record_view_nvidia_registers(view, index,
+						  &registers->count);
+	if (registers->registers == NULL) {
+		return 0;
+	}
+
+	//Stable insertion sort of register positions by address, so duplicate addresses keep record order.
+	for (UINT16 i = 0; i < registers->count; i++) {
+		UINT64 address = registers->registers[i].Address;
+		UINT16 j = i;
+		while (j > 0 &&
+		       registers->registers[registers->order[j - 1]].Address >
+			       address) {
+			registers->order[j] = registers->order[j - 1];
+			j--;
+		}
+		registers->order[j] = i;
+	}
+	return 1;
+}
+
+//Outputs the value of the first register with the given address from an NVIDIA register index.
+//Returns 1 if the register is present, 0 otherwise.
+int cper_view_nvidia_find_register(const cper_view_nvidia_registers *registers,
+				   UINT64 address, UINT64 *value)
+{
+	//Lower bound binary search.
+	UINT16 low = 0;
+	UINT16 high = registers->count;
+	while (low < high) {
+		UINT16 mid = low + (high - low) / 2;
+		if (registers->registers[registers->order[mid]].Address <
+		    address) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	if (low == registers->count ||
+	    registers->registers[registers->order[low]].Address != address) {
+		return 0;
+	}
+	*value = registers->registers[registers->order[low]].Value;
+	return 1;
+}
+
+/*
+* Record content hashing.
+*/
+
+//Returns a stable 64-bit hash (FNV-1a) of the record's content, excluding the header fields that
+//differ between repeats of the same error: RecordID, TimeStamp and PersistenceInfo.
+//The hash covers the header and everything up to the header's record length (or the end of
+//the buffer, if the record length is not within it).
+UINT64 cper_record_view_hash(const cper_record_view *view)
+{
+	EFI_COMMON_ERROR_RECORD_HEADER header = *cper_record_view_header(view);
+	memset(&header.TimeStamp, 0, sizeof(header.TimeStamp));
+	header.RecordID = 0;
+	header.PersistenceInfo = 0;
+
+	size_t length = view->size;
+	if (header.RecordLength >= sizeof(EFI_COMMON_ERROR_RECORD_HEADER) &&
+	    header.RecordLength < length) {
+		length = header.RecordLength;
+	}
+
+	UINT64 hash = 0xcbf29ce484222325ULL;
+	const UINT8 *bytes = (const UINT8 *)&header;
+	for (size_t i = 0; i < length; i++) {
+		if (i == sizeof(EFI_COMMON_ERROR_RECORD_HEADER)) {
+			bytes = view->data;
+		}
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+//Outputs the content hash of the CPER record in the given buffer (see cper_record_view_hash()).
+//Returns 1 on success, 0 if the buffer is not a valid record.
+int cper_record_hash(const void *record, size_t size, UINT64 *hash)
+{
+	cper_record_view view;
+	if (!cper_record_view_init(&view, record, size)) {
+		return 0;
+	}
+	*hash = cper_record_view_hash(&view);
+	return 1;
+}
+
+/*
+* Private helpers.
+*/
+
+//Compares two GUIDs without requiring writable pointers.
+static int view_guid_equal(const EFI_GUID *a, const EFI_GUID *b)
+{
+	return memcmp(a, b, sizeof(EFI_GUID)) == 0;
+}
+
+//Returns the body of the section at the given index if it has the given type and is at least
+//"min_size" bytes long, otherwise NULL.
+static const void *view_section_of_type(const cper_record_view *view,
+					UINT16 index, const EFI_GUID *type,
+					size_t min_size)
+{
+	const EFI_GUID *section_type =
+		cper_record_view_section_type(view, index);
+	if (section_type == NULL || !view_guid_equal(section_type, type)) {
+		return NULL;
+	}
+
+	UINT32 length = 0;
+	const void *section = cper_record_view_section(view, index, &length);
+	if (section == NULL || length < min_size) {
+		return NULL;
+	}
+	return section;
+}
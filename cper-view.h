@@ -0,0 +1,135 @@
+#ifndef CPER_VIEW_H
+#define CPER_VIEW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include "edk/Cper.h"
+
+//Section bodies defined by the section headers, which also pull in json-c. Only pointers to these are
+//used here, so consumers include the matching section header only to read their fields.
+typedef struct EFI_ARM_ERROR_RECORD EFI_ARM_ERROR_RECORD;
+typedef struct EFI_CCIX_PER_LOG_DATA EFI_CCIX_PER_LOG_DATA;
+typedef struct EFI_CXL_COMPONENT_EVENT_HEADER EFI_CXL_COMPONENT_EVENT_HEADER;
+typedef struct EFI_CXL_PROTOCOL_ERROR_DATA EFI_CXL_PROTOCOL_ERROR_DATA;
+typedef struct EFI_PCI_PCIX_DEVICE_ERROR_DATA EFI_PCI_PCIX_DEVICE_ERROR_DATA;
+
+//A read-only view over a single CPER record held in memory.
+//All accessors are bounds checked against the underlying buffer, and nothing is allocated or copied.
+//Pointers returned by accessors point into the original buffer, which must outlive the view.
+typedef struct {
+	const UINT8 *data;
+	size_t size;
+} cper_record_view;
+
+//PCI segment/bus/device/function address, as used by the PCIe accessors.
+typedef struct {
+	UINT16 segment;
+	UINT8 bus;
+	UINT8 device;
+	UINT8 function;
+} cper_view_bdf;
+
+//Index over the registers of an NVIDIA section, sorted by address for O(log n) lookup.
+//Holds no allocations; "registers" points into the viewed buffer.
+typedef struct {
+	const EFI_NVIDIA_REGISTER_DATA *registers;
+	UINT16 count;
+	UINT8 order[255];
+} cper_view_nvidia_registers;
+
+int cper_record_view_init(cper_record_view *view, const void *data,
+			  size_t size);
+
+//Record header.
+const EFI_COMMON_ERROR_RECORD_HEADER *
+cper_record_view_header(const cper_record_view *view);
+UINT16 cper_record_view_revision(const cper_record_view *view);
+UINT32 cper_record_view_severity(const cper_record_view *view);
+UINT16 cper_record_view_section_count(const cper_record_view *view);
+UINT64 cper_record_view_record_id(const cper_record_view *view);
+UINT32 cper_record_view_flags(const cper_record_view *view);
+const EFI_GUID *cper_record_view_notification_type(const cper_record_view *view);
+const EFI_GUID *cper_record_view_creator_id(const cper_record_view *view);
+const EFI_GUID *cper_record_view_platform_id(const cper_record_view *view);
+const EFI_GUID *cper_record_view_partition_id(const cper_record_view *view);
+const EFI_ERROR_TIME_STAMP *
+cper_record_view_timestamp(const cper_record_view *view);
+
+//Section descriptors.
+const EFI_ERROR_SECTION_DESCRIPTOR *
+cper_record_view_descriptor(const cper_record_view *view, UINT16 index);
+const EFI_GUID *cper_record_view_section_type(const cper_record_view *view,
+					      UINT16 index);
+UINT32 cper_record_view_section_severity(const cper_record_view *view,
+					 UINT16 index);
+const EFI_GUID *cper_record_view_fru_id(const cper_record_view *view,
+					UINT16 index);
+const void *cper_record_view_section(const cper_record_view *view,
+				     UINT16 index, UINT32 *length);
+
+//Typed section bodies. Each returns NULL if the section is of a different type or is truncated.
+const EFI_PROCESSOR_GENERIC_ERROR_DATA *
+cper_record_view_generic(const cper_record_view *view, UINT16 index);
+const EFI_IA32_X64_PROCESSOR_ERROR_RECORD *
+cper_record_view_ia32x64(const cper_record_view *view, UINT16 index);
+const EFI_ARM_ERROR_RECORD *cper_record_view_arm(const cper_record_view *view,
+						 UINT16 index);
+const EFI_PLATFORM_MEMORY_ERROR_DATA *
+cper_record_view_memory(const cper_record_view *view, UINT16 index);
+const EFI_PLATFORM_MEMORY2_ERROR_DATA *
+cper_record_view_memory2(const cper_record_view *view, UINT16 index);
+const EFI_PCIE_ERROR_DATA *cper_record_view_pcie(const cper_record_view *view,
+						 UINT16 index);
+const EFI_FIRMWARE_ERROR_DATA *
+cper_record_view_firmware(const cper_record_view *view, UINT16 index);
+const EFI_PCI_PCIX_BUS_ERROR_DATA *
+cper_record_view_pci_bus(const cper_record_view *view, UINT16 index);
+const EFI_PCI_PCIX_DEVICE_ERROR_DATA *
+cper_record_view_pci_dev(const cper_record_view *view, UINT16 index);
+const EFI_DMAR_GENERIC_ERROR_DATA *
+cper_record_view_dmar_generic(const cper_record_view *view, UINT16 index);
+const EFI_DIRECTED_IO_DMAR_ERROR_DATA *
+cper_record_view_dmar_vtd(const cper_record_view *view, UINT16 index);
+const EFI_IOMMU_DMAR_ERROR_DATA *
+cper_record_view_dmar_iommu(const cper_record_view *view, UINT16 index);
+const EFI_CCIX_PER_LOG_DATA *
+cper_record_view_ccix_per(const cper_record_view *view, UINT16 index);
+const EFI_CXL_PROTOCOL_ERROR_DATA *
+cper_record_view_cxl_protocol(const cper_record_view *view, UINT16 index);
+const EFI_CXL_COMPONENT_EVENT_HEADER *
+cper_record_view_cxl_component(const cper_record_view *view, UINT16 index);
+const EFI_NVIDIA_ERROR_DATA *
+cper_record_view_nvidia(const cper_record_view *view, UINT16 index);
+
+//Common filter fields. Each returns 1 and sets the output if the field is present and valid, 0 otherwise.
+int cper_record_view_arm_mpidr(const cper_record_view *view, UINT16 index,
+			       UINT64 *mpidr);
+int cper_record_view_memory_physical_address(const cper_record_view *view,
+					     UINT16 index, UINT64 *address);
+int cper_record_view_pcie_bdf(const cper_record_view *view, UINT16 index,
+			      cper_view_bdf *bdf);
+
+//NVIDIA register address/value pairs.
+const EFI_NVIDIA_REGISTER_DATA *
+cper_record_view_nvidia_registers(const cper_record_view *view, UINT16 index,
+				  UINT16 *count);
+int cper_record_view_nvidia_register(const cper_record_view *view, UINT16 index,
+				     UINT64 address, UINT64 *value);
+int cper_record_view_nvidia_index(const cper_record_view *view, UINT16 index,
+				  cper_view_nvidia_registers *registers);
+int cper_view_nvidia_find_register(const cper_view_nvidia_registers *registers,
+				   UINT64 address, UINT64 *value);
+
+//Record content hashing.
+UINT64 cper_record_view_hash(const cper_record_view *view);
+int cper_record_hash(const void *record, size_t size, UINT64 *hash);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -15,6 +15,32 @@
  **/
 #include "Cper.h"
 
+//CPER generic error codes.
+const int CPER_GENERIC_ERROR_TYPES_KEYS[18] = { 1, 16, 4, 5, 6, 7, 8, 9, 17, 18,
+						19, 20, 21, 22, 23, 24, 25,
+						26 };
+const char *const CPER_GENERIC_ERROR_TYPES_VALUES[18] = {
+	"ERR_INTERNAL", "ERR_BUS", "ERR_MEM", "ERR_TLB", "ERR_CACHE",
+	"ERR_FUNCTION", "ERR_SELFTEST", "ERR_FLOW", "ERR_MAP", "ERR_IMPROPER",
+	"ERR_UNIMPL", "ERR_LOL", "ERR_RESPONSE", "ERR_PARITY", "ERR_PROTOCOL",
+	"ERR_ERROR", "ERR_TIMEOUT", "ERR_POISONED"
+};
+const char *const CPER_GENERIC_ERROR_TYPES_DESCRIPTIONS[18] = {
+	"Error detected internal to the component.",
+	"Error detected in the bus.", "Storage error in memory (DRAM).",
+	"Storage error in TLB.", "Storage error in cache.",
+	"Error in one or more functional units.", "Component failed self test.",
+	"Overflow or underflow of internal queue.",
+	"Virtual address not found on IO-TLB or IO-PDIR.",
+	"Improper access error.",
+	"Access to a memory address which is not mapped to any component.",
+	"Loss of Lockstep error.", "Response not associated with a request.",
+	"Bus parity error (must also set the A, C, or D bits).",
+	"Detection of a protocol error.", "Detection of a PATH_ERROR.",
+	"Bus operation timeout.",
+	"A read was issued to data that has been poisoned."
+};
+
 //Event notification type GUIDs.
 EFI_GUID gEfiEventNotificationTypeCmcGuid = { 0x2DCE8BB1,
 					      0xBDD7,
@@ -848,42 +848,9 @@ typedef struct {
 ///
 /// CPER Generic Error Codes
 ///
-#define CPER_GENERIC_ERROR_TYPES_KEYS                                          \
-	(int[])                                                                \
-	{                                                                      \
-		1, 16, 4, 5, 6, 7, 8, 9, 17, 18, 19, 20, 21, 22, 23, 24, 25,   \
-			26                                                     \
-	}
-#define CPER_GENERIC_ERROR_TYPES_VALUES                                        \
-	(const char *[])                                                       \
-	{                                                                      \
-		"ERR_INTERNAL", "ERR_BUS", "ERR_MEM", "ERR_TLB", "ERR_CACHE",  \
-			"ERR_FUNCTION", "ERR_SELFTEST", "ERR_FLOW", "ERR_MAP", \
-			"ERR_IMPROPER", "ERR_UNIMPL", "ERR_LOL",               \
-			"ERR_RESPONSE", "ERR_PARITY", "ERR_PROTOCOL",          \
-			"ERR_ERROR", "ERR_TIMEOUT", "ERR_POISONED"             \
-	}
-#define CPER_GENERIC_ERROR_TYPES_DESCRIPTIONS                                               \
-	(const char *[])                                                                    \
-	{                                                                                   \
-		"Error detected internal to the component.",                                \
-			"Error detected in the bus.",                                       \
-			"Storage error in memory (DRAM).",                                  \
-			"Storage error in TLB.", "Storage error in cache.",                 \
-			"Error in one or more functional units.",                           \
-			"Component failed self test.",                                      \
-			"Overflow or underflow of internal queue.",                         \
-			"Virtual address not found on IO-TLB or IO-PDIR.",                  \
-			"Improper access error.",                                           \
-			"Access to a memory address which is not mapped to any component.", \
-			"Loss of Lockstep error.",                                          \
-			"Response not associated with a request.",                          \
-			"Bus parity error (must also set the A, C, or D bits).",            \
-			"Detection of a protocol error.",                                   \
-			"Detection of a PATH_ERROR.",                                       \
-			"Bus operation timeout.",                                           \
-			"A read was issued to data that has been poisoned."                 \
-	}
+extern const int CPER_GENERIC_ERROR_TYPES_KEYS[18];
+extern const char *const CPER_GENERIC_ERROR_TYPES_VALUES[18];
+extern const char *const CPER_GENERIC_ERROR_TYPES_DESCRIPTIONS[18];
 
 ///
 /// Error Type
@@ -1402,6 +1369,14 @@ typedef struct {
 	UINT64 InstanceBase;
 } EFI_NVIDIA_ERROR_DATA;
 
+///
+/// NVIDIA Error Record Register, "NumberRegs" of which follow the NVIDIA Error Record Section
+///
+typedef struct {
+	UINT64 Address;
+	UINT64 Value;
+} EFI_NVIDIA_REGISTER_DATA;
+
 extern EFI_GUID gEfiNvidiaErrorSectionGuid;
 #pragma pack(pop)
 
@@ -0,0 +1,297 @@
+/**
+ * Describes functions for generating adversarial CPER records: records that are shaped to be as
+ * expensive as possible to decode, or that are inconsistent in ways a decoder must survive. These are
+ * used to find the worst case decode latency and memory use of a single record.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../edk/Cper.h"
+#include "gen-utils.h"
+#include "sections/gen-section.h"
+#include "cper-generate-adversarial.h"
+
+//The largest section count, and number of ARM error/context structures, that a record can declare.
+#define ADVERSARIAL_MAX_COUNT 0xFFFF
+
+//A section length that is near to, but does not reach, 4GiB.
+#define ADVERSARIAL_HUGE_LENGTH 0xFFFFFFF0
+
+//Number of overlapping section descriptors, and the spread of their offsets.
+#define ADVERSARIAL_OVERLAPS	  64
+#define ADVERSARIAL_OVERLAP_SPAN 8
+
+//Sizes of the fixed ARM processor error section header and error information structures, and
+//the offset of the register array size within a context information structure.
+#define ADVERSARIAL_ARM_HEADER_SIZE	   40
+#define ADVERSARIAL_ARM_ERROR_INFO_SIZE	   32
+#define ADVERSARIAL_ARM_REGISTER_SIZE_OFFSET 4
+
+//Private pre-definitions.
+static void adversarial_max_sections(cper_generator_context *context,
+				     FILE *out);
+static void adversarial_truncated_descriptors(cper_generator_context *context,
+					      FILE *out);
+static void adversarial_huge_section_length(cper_generator_context *context,
+					    FILE *out);
+static void adversarial_overlapping_sections(cper_generator_context *context,
+					     FILE *out);
+static void adversarial_arm_max_info(cper_generator_context *context,
+				     FILE *out);
+static void adversarial_arm_truncated_context(cper_generator_context *context,
+					      FILE *out);
+static void adversarial_write_header(UINT16 section_count,
+				     size_t record_length,
+				     cper_generator_context *context,
+				     FILE *out);
+static void adversarial_write_descriptor(char *type, size_t offset,
+					 size_t length,
+					 cper_generator_context *context,
+					 FILE *out);
+static UINT8 *adversarial_arm_header(cper_generator_context *context);
+
+const cper_adversarial_shape cper_adversarial_shapes[] = {
+	{ "max-sections",
+	  "65535 section descriptors, each with its own memory section.",
+	  adversarial_max_sections },
+	{ "truncated-descriptors",
+	  "A section count of 65535, with only one section descriptor present.",
+	  adversarial_truncated_descriptors },
+	{ "huge-section-length",
+	  "A section descriptor declaring a section length near 4GiB.",
+	  adversarial_huge_section_length },
+	{ "overlapping-sections",
+	  "64 ARM section descriptors at overlapping, misaligned offsets into one section.",
+	  adversarial_overlapping_sections },
+	{ "arm-max-info",
+	  "An ARM section with 65535 error and 65535 context information structures.",
+	  adversarial_arm_max_info },
+	{ "arm-truncated-context",
+	  "An ARM section declaring 65535 context structures, with one present declaring a 4GiB register array.",
+	  adversarial_arm_truncated_context },
+};
+const size_t cper_adversarial_shapes_len =
+	sizeof(cper_adversarial_shapes) / sizeof(cper_adversarial_shape);
+
+//Generates a record of the given adversarial shape, outputting to the given stream.
+//Returns 1 on success, 0 if the shape is undefined.
+int generate_adversarial_record(cper_generator_context *context,
+				const char *shape, FILE *out)
+{
+	for (size_t i = 0; i < cper_adversarial_shapes_len; i++) {
+		if (strcmp(shape, cper_adversarial_shapes[i].Name) == 0) {
+			cper_adversarial_shapes[i].Generate(context, out);
+			return 1;
+		}
+	}
+
+	printf("Undefined adversarial shape '%s'. See 'cper-generate --help' for command information.\n",
+	       shape);
+	return 0;
+}
+
+//The most sections a record can declare, all present and decodable.
+static void adversarial_max_sections(cper_generator_context *context,
+				     FILE *out)
+{
+	void *section = NULL;
+	size_t section_len = generate_section(&section, "memory", context);
+	size_t sections_offset =
+		sizeof(EFI_COMMON_ERROR_RECORD_HEADER) +
+		ADVERSARIAL_MAX_COUNT * sizeof(EFI_ERROR_SECTION_DESCRIPTOR);
+
+	adversarial_write_header(ADVERSARIAL_MAX_COUNT,
+				 sections_offset +
+					 ADVERSARIAL_MAX_COUNT * section_len,
+				 context, out);
+	for (size_t i = 0; i < ADVERSARIAL_MAX_COUNT; i++) {
+		adversarial_write_descriptor("memory",
+					     sections_offset + i * section_len,
+					     section_len, context, out);
+	}
+	for (size_t i = 0; i < ADVERSARIAL_MAX_COUNT; i++) {
+		fwrite(section, section_len, 1, out);
+	}
+	fflush(out);
+	free(section);
+}
+
+//The most sections a record can declare, with only the first present.
+static void adversarial_truncated_descriptors(cper_generator_context *context,
+					      FILE *out)
+{
+	void *section = NULL;
+	size_t section_len = generate_section(&section, "memory", context);
+	size_t sections_offset = sizeof(EFI_COMMON_ERROR_RECORD_HEADER) +
+				 sizeof(EFI_ERROR_SECTION_DESCRIPTOR);
+
+	adversarial_write_header(ADVERSARIAL_MAX_COUNT,
+				 sections_offset + section_len, context, out);
+	adversarial_write_descriptor("memory", sections_offset, section_len,
+				     context, out);
+	fwrite(section, section_len, 1, out);
+	fflush(out);
+	free(section);
+}
+
+//A single section, whose descriptor declares a length near 4GiB.
+static void adversarial_huge_section_length(cper_generator_context *context,
+					    FILE *out)
+{
+	void *section = NULL;
+	size_t section_len = generate_section(&section, "memory", context);
+	size_t sections_offset = sizeof(EFI_COMMON_ERROR_RECORD_HEADER) +
+				 sizeof(EFI_ERROR_SECTION_DESCRIPTOR);
+
+	adversarial_write_header(1, sections_offset + section_len, context,
+				 out);
+	adversarial_write_descriptor("memory", sections_offset,
+				     ADVERSARIAL_HUGE_LENGTH, context, out);
+	fwrite(section, section_len, 1, out);
+	fflush(out);
+	free(section);
+}
+
+//Many descriptors sharing one ARM section at misaligned offsets, so that most decode the bytes of
+//another structure as an ARM section header.
+static void adversarial_overlapping_sections(cper_generator_context *context,
+					     FILE *out)
+{
+	void *section = NULL;
+	size_t section_len = generate_section(&section, "arm", context);
+	size_t sections_offset =
+		sizeof(EFI_COMMON_ERROR_RECORD_HEADER) +
+		ADVERSARIAL_OVERLAPS * sizeof(EFI_ERROR_SECTION_DESCRIPTOR);
+
+	adversarial_write_header(ADVERSARIAL_OVERLAPS,
+				 sections_offset + section_len, context, out);
+	for (size_t i = 0; i < ADVERSARIAL_OVERLAPS; i++) {
+		size_t skew = i % ADVERSARIAL_OVERLAP_SPAN;
+		adversarial_write_descriptor("arm", sections_offset + skew,
+					     section_len - skew, context, out);
+	}
+	fwrite(section, section_len, 1, out);
+	fflush(out);
+	free(section);
+}
+
+//An ARM section with the most error and context information structures it can declare, all present.
+static void adversarial_arm_max_info(cper_generator_context *context,
+				     FILE *out)
+{
+	//Generate the structures.
+	void **error_info = malloc(ADVERSARIAL_MAX_COUNT * sizeof(void *));
+	void **context_info = malloc(ADVERSARIAL_MAX_COUNT * sizeof(void *));
+	size_t *context_lengths =
+		malloc(ADVERSARIAL_MAX_COUNT * sizeof(size_t));
+	size_t section_len = ADVERSARIAL_ARM_HEADER_SIZE +
+			     ADVERSARIAL_MAX_COUNT *
+				     ADVERSARIAL_ARM_ERROR_INFO_SIZE;
+	for (size_t i = 0; i < ADVERSARIAL_MAX_COUNT; i++) {
+		error_info[i] = generate_arm_error_info(context);
+		context_lengths[i] =
+			generate_arm_context_info(&context_info[i], context);
+		section_len += context_lengths[i];
+	}
+
+	//Set the structure counts and length in the section header.
+	UINT8 *arm = adversarial_arm_header(context);
+	UINT16 *info_nums = (UINT16 *)(arm + 4);
+	info_nums[0] = ADVERSARIAL_MAX_COUNT;
+	info_nums[1] = ADVERSARIAL_MAX_COUNT;
+	*(UINT32 *)(arm + 8) = section_len;
+
+	//Write out the record.
+	size_t sections_offset = sizeof(EFI_COMMON_ERROR_RECORD_HEADER) +
+				 sizeof(EFI_ERROR_SECTION_DESCRIPTOR);
+	adversarial_write_header(1, sections_offset + section_len, context,
+				 out);
+	adversarial_write_descriptor("arm", sections_offset, section_len,
+				     context, out);
+	fwrite(arm, ADVERSARIAL_ARM_HEADER_SIZE, 1, out);
+	for (size_t i = 0; i < ADVERSARIAL_MAX_COUNT; i++) {
+		fwrite(error_info[i], ADVERSARIAL_ARM_ERROR_INFO_SIZE, 1, out);
+	}
+	for (size_t i = 0; i < ADVERSARIAL_MAX_COUNT; i++) {
+		fwrite(context_info[i], context_lengths[i], 1, out);
+	}
+	fflush(out);
+
+	//Free all resources.
+	for (size_t i = 0; i < ADVERSARIAL_MAX_COUNT; i++) {
+		gen_free(error_info[i]);
+		gen_free(context_info[i]);
+	}
+	free(error_info);
+	free(context_info);
+	free(context_lengths);
+	free(arm);
+}
+
+//An ARM section declaring the most context information structures it can, with only one present.
+//That structure declares a register array running far beyond the end of the section.
+static void adversarial_arm_truncated_context(cper_generator_context *context,
+					      FILE *out)
+{
+	void *context_info = NULL;
+	size_t context_len = generate_arm_context_info(&context_info, context);
+	UINT32 register_size = ADVERSARIAL_HUGE_LENGTH;
+	memcpy((UINT8 *)context_info + ADVERSARIAL_ARM_REGISTER_SIZE_OFFSET,
+	       &register_size, sizeof(register_size));
+	size_t section_len = ADVERSARIAL_ARM_HEADER_SIZE + context_len;
+
+	UINT8 *arm = adversarial_arm_header(context);
+	UINT16 *info_nums = (UINT16 *)(arm + 4);
+	info_nums[0] = 0;
+	info_nums[1] = ADVERSARIAL_MAX_COUNT;
+	*(UINT32 *)(arm + 8) = section_len;
+
+	size_t sections_offset = sizeof(EFI_COMMON_ERROR_RECORD_HEADER) +
+				 sizeof(EFI_ERROR_SECTION_DESCRIPTOR);
+	adversarial_write_header(1, sections_offset + section_len, context,
+				 out);
+	adversarial_write_descriptor("arm", sections_offset, section_len,
+				     context, out);
+	fwrite(arm, ADVERSARIAL_ARM_HEADER_SIZE, 1, out);
+	fwrite(context_info, context_len, 1, out);
+	fflush(out);
+
+	gen_free(context_info);
+	free(arm);
+}
+
+//Writes a record header with the given section count and record length.
+static void adversarial_write_header(UINT16 section_count,
+				     size_t record_length,
+				     cper_generator_context *context,
+				     FILE *out)
+{
+	EFI_COMMON_ERROR_RECORD_HEADER header;
+	fill_record_header(&header, section_count, context);
+	header.RecordLength = (UINT32)record_length;
+	fwrite(&header, sizeof(header), 1, out);
+}
+
+//Writes a section descriptor for the given section type, offset and length.
+static void adversarial_write_descriptor(char *type, size_t offset,
+					 size_t length,
+					 cper_generator_context *context,
+					 FILE *out)
+{
+	EFI_ERROR_SECTION_DESCRIPTOR descriptor;
+	fill_section_descriptor(&descriptor, type, &length, 0, 1, context);
+	descriptor.SectionOffset = (UINT32)offset;
+	fwrite(&descriptor, sizeof(descriptor), 1, out);
+}
+
+//Generates a valid ARM section header, taken from a generated ARM section.
+static UINT8 *adversarial_arm_header(cper_generator_context *context)
+{
+	void *section = NULL;
+	generate_section(&section, "arm", context);
+	UINT8 *header = malloc(ADVERSARIAL_ARM_HEADER_SIZE);
+	memcpy(header, section, ADVERSARIAL_ARM_HEADER_SIZE);
+	free(section);
+	return header;
+}
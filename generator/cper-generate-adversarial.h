@@ -0,0 +1,28 @@
+#ifndef CPER_GENERATE_ADVERSARIAL_H
+#define CPER_GENERATE_ADVERSARIAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include "cper-generate.h"
+
+//A single adversarial record shape, built to find the worst case decode time and memory of a record.
+typedef struct {
+	const char *Name;
+	const char *Description;
+	void (*Generate)(cper_generator_context *, FILE *);
+} cper_adversarial_shape;
+
+extern const cper_adversarial_shape cper_adversarial_shapes[];
+extern const size_t cper_adversarial_shapes_len;
+
+int generate_adversarial_record(cper_generator_context *context,
+				const char *shape, FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -7,11 +7,94 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "../edk/Cper.h"
 #include "cper-generate.h"
+#include "cper-generate-adversarial.h"
+#include "cper-generate-ir.h"
+#include "cper-generate-profile.h"
+#include "gen-utils.h"
 #include "sections/gen-section.h"
 
+//Records generated by each thread per batch, before the batch is written out in order.
+#define GEN_BATCH_PER_THREAD 256
+
+//Upper bounds on generation parameters.
+#define GEN_MAX_THREADS		   256
+#define GEN_MAX_SECTIONS_PER_RECORD 64
+
+//Size of the buffer profile records are first generated into. Larger records are regenerated into
+//an allocation of the required size.
+#define GEN_RECORD_BUF_SIZE 0x10000
+
+//A single weighted choice, of either a section type name or a section count.
+typedef struct {
+	char *name;
+	UINT32 value;
+	UINT32 weight;
+} GEN_WEIGHTED;
+
+//A weighted distribution, parsed from "choice:weight,choice:weight,...".
+typedef struct {
+	GEN_WEIGHTED *entries;
+	size_t len;
+	UINT32 total;
+} GEN_DISTRIBUTION;
+
+typedef struct {
+	char *out_file;
+	char *single_section;
+	char **sections;
+	UINT16 num_sections;
+	UINT64 count;
+	UINT64 seed;
+	int seeded;
+	int threads;
+	UINT64 shard_records;
+	GEN_DISTRIBUTION mix;
+	GEN_DISTRIBUTION mix_sections;
+	cper_generator_profile profile;
+	int has_profile;
+	char *specification_file;
+	cper_ir_generator ir_generator;
+	int ir;
+	char *adversarial;
+} GEN_OPTIONS;
+
+//A contiguous range of records generated by one thread into memory.
+typedef struct {
+	const GEN_OPTIONS *options;
+	UINT64 first;
+	UINT64 count;
+	char *buf;
+	size_t size;
+	size_t *ends;
+	int failed;
+} GEN_WORKER;
+
+//Output file state, moving to the next shard as each fills.
+typedef struct {
+	const GEN_OPTIONS *options;
+	FILE *file;
+	UINT64 shard;
+	UINT64 shard_count;
+} GEN_OUTPUT;
+
 void print_help();
+int section_type_known(const char *name);
+int parse_distribution(GEN_DISTRIBUTION *distribution, char *spec,
+		       int section_names);
+const GEN_WEIGHTED *pick_weighted(const GEN_DISTRIBUTION *distribution,
+				  cper_generator_context *context);
+int generate_indexed_record(const GEN_OPTIONS *options, UINT64 index,
+			    FILE *out);
+int generate_seeded_indexed_record(const GEN_OPTIONS *options,
+				   cper_generator_context *context, FILE *out);
+void *generate_worker(void *arg);
+int write_record(GEN_OUTPUT *output, const char *record, size_t size);
+int generate_corpus(const GEN_OPTIONS *options);
 
 int main(int argc, char *argv[])
 {
@@ -22,85 +105,522 @@ int main(int argc, char *argv[])
 	}
 
 	//Parse the command line arguments.
-	char *out_file = NULL;
-	char *single_section = NULL;
-	char **sections = NULL;
-	UINT16 num_sections = 0;
+	GEN_OPTIONS options;
+	memset(&options, 0, sizeof(options));
+	options.count = 1;
+	options.threads = 1;
+	int result = -1;
 	for (int i = 1; i < argc; i++) {
 		if (strcmp(argv[i], "--out") == 0 && i < argc - 1) {
-			out_file = argv[i + 1];
+			options.out_file = argv[i + 1];
 			i++;
 		} else if (strcmp(argv[i], "--single-section") == 0 &&
 			   i < argc - 1) {
-			single_section = argv[i + 1];
+			if (!section_type_known(argv[i + 1])) {
+				printf("Undefined section type '%s'. See 'cper-generate --help' for command information.\n",
+				       argv[i + 1]);
+				goto cleanup;
+			}
+			options.single_section = argv[i + 1];
+			i++;
+		} else if (strcmp(argv[i], "--count") == 0 && i < argc - 1) {
+			options.count = strtoull(argv[i + 1], NULL, 0);
+			i++;
+		} else if (strcmp(argv[i], "--seed") == 0 && i < argc - 1) {
+			options.seed = strtoull(argv[i + 1], NULL, 0);
+			options.seeded = 1;
+			i++;
+		} else if (strcmp(argv[i], "--threads") == 0 && i < argc - 1) {
+			options.threads = atoi(argv[i + 1]);
+			i++;
+		} else if (strcmp(argv[i], "--shard-records") == 0 &&
+			   i < argc - 1) {
+			options.shard_records = strtoull(argv[i + 1], NULL, 0);
+			i++;
+		} else if (strcmp(argv[i], "--mix") == 0 && i < argc - 1) {
+			if (!parse_distribution(&options.mix, argv[i + 1], 1)) {
+				goto cleanup;
+			}
+			i++;
+		} else if (strcmp(argv[i], "--mix-sections") == 0 &&
+			   i < argc - 1) {
+			if (!parse_distribution(&options.mix_sections,
+						argv[i + 1], 0)) {
+				goto cleanup;
+			}
+			i++;
+		} else if (strcmp(argv[i], "--profile") == 0 && i < argc - 1) {
+			if (options.has_profile ||
+			    !cper_generator_profile_from_file(&options.profile,
+							      argv[i + 1])) {
+				printf("Invalid profile '%s'. For command information, refer to 'cper-generate --help'.\n",
+				       argv[i + 1]);
+				goto cleanup;
+			}
+			options.has_profile = 1;
+			i++;
+		} else if (strcmp(argv[i], "--adversarial") == 0 &&
+			   i < argc - 1) {
+			options.adversarial = argv[i + 1];
+			i++;
+		} else if (strcmp(argv[i], "--ir") == 0) {
+			options.ir = 1;
+		} else if (strcmp(argv[i], "--specification") == 0 &&
+			   i < argc - 1) {
+			options.specification_file = argv[i + 1];
 			i++;
 		} else if (strcmp(argv[i], "--sections") == 0 && i < argc - 1) {
 			//All arguments after this must be section names.
-			num_sections = argc - i - 1;
-			sections = malloc(sizeof(char *) * num_sections);
+			options.num_sections = argc - i - 1;
+			options.sections =
+				malloc(sizeof(char *) * options.num_sections);
 			i++;
 
 			for (int j = i; j < argc; j++) {
-				sections[j - i] = argv[j];
+				if (!section_type_known(argv[j])) {
+					printf("Undefined section type '%s'. See 'cper-generate --help' for command information.\n",
+					       argv[j]);
+					goto cleanup;
+				}
+				options.sections[j - i] = argv[j];
 			}
 			break;
 		} else {
 			printf("Unrecognised argument '%s'. For command information, refer to 'cper-generate --help'.\n",
 			       argv[i]);
-			return -1;
+			goto cleanup;
 		}
 	}
 
 	//If no output file passed as argument, exit.
-	if (out_file == NULL) {
+	if (options.out_file == NULL) {
 		printf("No output file provided. For command information, refer to 'cper-generate --help'.\n");
-		if (sections) {
-			free(sections);
+		goto cleanup;
+	}
+
+	//Exactly one of the section sources must be given.
+	int sources = (options.single_section != NULL) +
+		      (options.sections != NULL) + (options.mix.len > 0) +
+		      options.has_profile + options.ir +
+		      (options.adversarial != NULL);
+	if (sources != 1) {
+		printf("Invalid argument. Exactly one of '--sections', '--single-section', '--mix', '--profile', '--ir' and '--adversarial' must be set. For command information, refer to 'cper-generate --help'.\n");
+		goto cleanup;
+	}
+	if (options.adversarial != NULL) {
+		int shape_found = 0;
+		for (size_t i = 0; i < cper_adversarial_shapes_len; i++) {
+			const char *name = cper_adversarial_shapes[i].Name;
+			shape_found |= strcmp(options.adversarial, name) == 0;
 		}
-		return -1;
+		if (!shape_found) {
+			printf("Undefined adversarial shape '%s'. See 'cper-generate --help' for command information.\n",
+			       options.adversarial);
+			goto cleanup;
+		}
+	}
+	if (options.mix_sections.len > 0 && options.mix.len == 0) {
+		printf("Invalid argument. '--mix-sections' requires '--mix'. For command information, refer to 'cper-generate --help'.\n");
+		goto cleanup;
+	}
+	if (options.count == 0 || options.threads < 1 ||
+	    options.threads > GEN_MAX_THREADS) {
+		printf("Invalid argument. '--count' must be at least 1, and '--threads' between 1 and %d.\n",
+		       GEN_MAX_THREADS);
+		goto cleanup;
 	}
 
-	//Open a file handle to write output.
-	FILE *cper_file = fopen(out_file, "w");
-	if (cper_file == NULL) {
-		printf("Could not get a handle for output file '%s', file handle returned null.\n",
-		       out_file);
-		if (sections) {
-			free(sections);
+	//CPER-JSON documents are generated from the specification.
+	if (options.ir) {
+		if (options.specification_file == NULL) {
+			options.specification_file = LIBCPER_JSON_SPEC;
 		}
-		return -1;
+		if (!cper_ir_generator_init(&options.ir_generator,
+					    options.specification_file)) {
+			options.ir = 0;
+			goto cleanup;
+		}
+	}
+
+	//Without a seed, generate a different corpus on each run.
+	if (!options.seeded) {
+		options.seed = (UINT64)time(NULL) ^ ((UINT64)getpid() << 32);
+	}
+
+	result = generate_corpus(&options);
+	if (result == 0 && options.count > 1) {
+		printf("Generated %llu records with seed %llu.\n",
+		       (unsigned long long)options.count,
+		       (unsigned long long)options.seed);
+	}
+
+cleanup:
+	//Free remaining resources.
+	free(options.sections);
+	free(options.mix.entries);
+	free(options.mix_sections.entries);
+	cper_generator_profile_free(&options.profile);
+	if (options.ir) {
+		cper_ir_generator_free(&options.ir_generator);
+	}
+	return result;
+}
+
+//Returns whether the given name is a section type the generator can produce.
+int section_type_known(const char *name)
+{
+	int known = strcmp(name, "unknown") == 0;
+	for (size_t i = 0; i < generator_definitions_len; i++) {
+		known |= strcmp(name, generator_definitions[i].ShortName) == 0;
+	}
+	return known;
+}
+
+//Parses a weighted distribution of the form "choice:weight,choice:weight,...". Choices are section
+//type names if "section_names" is set, and section counts otherwise. A missing weight counts as one.
+//Returns 1 on success, 0 on an invalid distribution.
+int parse_distribution(GEN_DISTRIBUTION *distribution, char *spec,
+		       int section_names)
+{
+	free(distribution->entries);
+	memset(distribution, 0, sizeof(GEN_DISTRIBUTION));
+
+	//Count the entries to allocate.
+	size_t len = 1;
+	for (char *c = spec; *c != '\0'; c++) {
+		len += *c == ',';
+	}
+	distribution->entries = calloc(len, sizeof(GEN_WEIGHTED));
+	if (distribution->entries == NULL) {
+		printf("Failed to allocate distribution.\n");
+		return 0;
+	}
+
+	char *saveptr = NULL;
+	for (char *entry = strtok_r(spec, ",", &saveptr); entry != NULL;
+	     entry = strtok_r(NULL, ",", &saveptr)) {
+		GEN_WEIGHTED *weighted =
+			&distribution->entries[distribution->len];
+		char *weight = strchr(entry, ':');
+		if (weight != NULL) {
+			*weight = '\0';
+			weighted->weight = strtoul(weight + 1, NULL, 0);
+		} else {
+			weighted->weight = 1;
+		}
+
+		if (section_names) {
+			if (!section_type_known(entry)) {
+				printf("Undefined section type '%s' in mix. See 'cper-generate --help' for command information.\n",
+				       entry);
+				return 0;
+			}
+			weighted->name = entry;
+		} else {
+			weighted->value = strtoul(entry, NULL, 0);
+			if (weighted->value < 1 ||
+			    weighted->value > GEN_MAX_SECTIONS_PER_RECORD) {
+				printf("Invalid section count '%s' in mix, must be between 1 and %d.\n",
+				       entry, GEN_MAX_SECTIONS_PER_RECORD);
+				return 0;
+			}
+		}
+
+		distribution->total += weighted->weight;
+		distribution->len++;
+	}
+
+	if (distribution->total == 0) {
+		printf("Invalid distribution, weights must not all be zero.\n");
+		return 0;
+	}
+	return 1;
+}
+
+//Picks a weighted choice from the given distribution.
+const GEN_WEIGHTED *pick_weighted(const GEN_DISTRIBUTION *distribution,
+				  cper_generator_context *context)
+{
+	UINT32 pick = gen_rand(context) % distribution->total;
+	for (size_t i = 0; i < distribution->len; i++) {
+		if (pick < distribution->entries[i].weight) {
+			return &distribution->entries[i];
+		}
+		pick -= distribution->entries[i].weight;
 	}
+	return &distribution->entries[distribution->len - 1];
+}
 
-	//Which type are we generating?
-	if (single_section != NULL && sections == NULL) {
-		generate_single_section_record(single_section, cper_file);
-	} else if (sections != NULL && single_section == NULL) {
-		generate_cper_record(sections, num_sections, cper_file);
+//Generates the record at the given index within the corpus. Each record has its own context,
+//seeded from the corpus seed and the index, so the corpus does not depend on the thread count.
+int generate_indexed_record(const GEN_OPTIONS *options, UINT64 index,
+			    FILE *out)
+{
+	long start = ftell(out);
+	if (options->has_profile) {
+		char record[GEN_RECORD_BUF_SIZE];
+		size_t len = generate_profile_record_buf(
+			&options->profile, options->seed, index, record,
+			sizeof(record));
+		if (len <= sizeof(record)) {
+			fwrite(record, len, 1, out);
+		} else {
+			//The record depends only on its index, so can be regenerated at full size.
+			char *large = malloc(len);
+			if (large == NULL) {
+				printf("Failed to allocate %zu bytes for record %llu.\n",
+				       len, (unsigned long long)index);
+				return 0;
+			}
+			len = generate_profile_record_buf(&options->profile,
+							  options->seed, index,
+							  large, len);
+			fwrite(large, len, 1, out);
+			free(large);
+		}
 	} else {
-		//Invalid arguments.
-		printf("Invalid argument. Either both '--sections' and '--single-section' were set, or neither. For command information, refer to 'cper-generate --help'.\n");
-		if (sections) {
-			free(sections);
+		cper_generator_context context;
+		cper_generator_seed(&context,
+				    options->seed ^
+					    (index * 0xD1342543DE82EF95ULL));
+		if (!generate_seeded_indexed_record(options, &context, out)) {
+			printf("Failed to generate record %llu.\n",
+			       (unsigned long long)index);
+			return 0;
 		}
+	}
+
+	//A record that wrote nothing is a failure, not an empty record.
+	if (fflush(out) != 0 || ftell(out) <= start) {
+		printf("Failed to generate record %llu.\n",
+		       (unsigned long long)index);
+		return 0;
+	}
+	return 1;
+}
+
+//Generates a single non-profile record from an already seeded context.
+//Returns 1 on success, 0 on failure.
+int generate_seeded_indexed_record(const GEN_OPTIONS *options,
+				   cper_generator_context *context, FILE *out)
+{
+	if (options->adversarial != NULL) {
+		return generate_adversarial_record(context,
+						   options->adversarial, out);
+	} else if (options->ir) {
+		//One CPER-JSON document per line.
+		json_object *ir = cper_ir_generator_generate(
+			&options->ir_generator, context);
+		if (ir == NULL) {
+			return 0;
+		}
+		fprintf(out, "%s\n",
+			json_object_to_json_string_ext(ir,
+						       JSON_C_TO_STRING_PLAIN));
+		json_object_put(ir);
+	} else if (options->single_section != NULL) {
+		generate_single_section_record_with_context(
+			context, options->single_section, out);
+	} else if (options->mix.len > 0) {
+		UINT16 num_sections = 1;
+		if (options->mix_sections.len > 0) {
+			num_sections =
+				pick_weighted(&options->mix_sections, context)
+					->value;
+		}
+		char *types[GEN_MAX_SECTIONS_PER_RECORD];
+		for (UINT16 i = 0; i < num_sections; i++) {
+			types[i] = pick_weighted(&options->mix, context)->name;
+		}
+		generate_cper_record_with_context(context, types, num_sections,
+						  out);
+	} else {
+		generate_cper_record_with_context(context, options->sections,
+						  options->num_sections, out);
+	}
+	return 1;
+}
+
+//Generates a worker's range of records into memory, noting where each record ends.
+//Sets the worker's "failed" flag if the records could not be generated.
+void *generate_worker(void *arg)
+{
+	GEN_WORKER *worker = (GEN_WORKER *)arg;
+	FILE *stream = open_memstream(&worker->buf, &worker->size);
+	if (stream == NULL) {
+		printf("Failed to open memory stream for generated records.\n");
+		worker->buf = NULL;
+		worker->failed = 1;
+		return NULL;
+	}
+	for (UINT64 i = 0; i < worker->count; i++) {
+		if (!generate_indexed_record(worker->options, worker->first + i,
+					     stream)) {
+			worker->failed = 1;
+			break;
+		}
+		worker->ends[i] = worker->size;
+	}
+	fclose(stream);
+	return NULL;
+}
+
+//Writes a single record to the output, starting a new shard file when the current one is full.
+//Returns 1 on success, 0 if an output file could not be opened.
+int write_record(GEN_OUTPUT *output, const char *record, size_t size)
+{
+	const GEN_OPTIONS *options = output->options;
+	if (output->file != NULL && options->shard_records != 0 &&
+	    output->shard_count == options->shard_records) {
+		fclose(output->file);
+		output->file = NULL;
+		output->shard++;
+	}
+
+	if (output->file == NULL) {
+		char shard_file[4096];
+		const char *file_name = options->out_file;
+		if (options->shard_records != 0) {
+			snprintf(shard_file, sizeof(shard_file), "%s.%05llu",
+				 options->out_file,
+				 (unsigned long long)output->shard);
+			file_name = shard_file;
+		}
+		output->file = fopen(file_name, "w");
+		if (output->file == NULL) {
+			printf("Could not get a handle for output file '%s', file handle returned null.\n",
+			       file_name);
+			return 0;
+		}
+		output->shard_count = 0;
+	}
+
+	fwrite(record, size, 1, output->file);
+	output->shard_count++;
+	return 1;
+}
+
+//Generates all requested records in batches, across the requested number of threads, writing each
+//batch out in record order. Returns 0 on success, -1 on failure.
+int generate_corpus(const GEN_OPTIONS *options)
+{
+	int threads = options->threads;
+	if ((UINT64)threads > options->count) {
+		threads = (int)options->count;
+	}
+	GEN_WORKER workers[GEN_MAX_THREADS];
+	pthread_t thread_ids[GEN_MAX_THREADS];
+	int started[GEN_MAX_THREADS];
+	size_t *ends = malloc(sizeof(size_t) * threads * GEN_BATCH_PER_THREAD);
+	if (ends == NULL) {
+		printf("Failed to allocate generation batch.\n");
 		return -1;
 	}
 
-	//Close & free remaining resources.
-	fclose(cper_file);
-	if (sections != NULL) {
-		free(sections);
+	GEN_OUTPUT output;
+	memset(&output, 0, sizeof(output));
+	output.options = options;
+	int result = 0;
+	UINT64 batch_size = (UINT64)threads * GEN_BATCH_PER_THREAD;
+	for (UINT64 first = 0; first < options->count && result == 0;
+	     first += batch_size) {
+		//Split the batch between the workers.
+		UINT64 remaining = options->count - first;
+		UINT64 batch = remaining < batch_size ? remaining : batch_size;
+		UINT64 per_worker = (batch + threads - 1) / threads;
+		for (int t = 0; t < threads; t++) {
+			GEN_WORKER *worker = &workers[t];
+			memset(worker, 0, sizeof(GEN_WORKER));
+			worker->options = options;
+			worker->first = first + t * per_worker;
+			worker->ends = ends + t * GEN_BATCH_PER_THREAD;
+			if ((UINT64)t * per_worker < batch) {
+				worker->count = batch - t * per_worker;
+				if (worker->count > per_worker) {
+					worker->count = per_worker;
+				}
+			}
+		}
+
+		//Generate, on the calling thread if only one is requested.
+		if (threads == 1) {
+			generate_worker(&workers[0]);
+		} else {
+			//Workers that fail to start run on the calling thread instead.
+			for (int t = 0; t < threads; t++) {
+				started[t] = pthread_create(&thread_ids[t],
+							    NULL,
+							    generate_worker,
+							    &workers[t]) == 0;
+				if (!started[t]) {
+					generate_worker(&workers[t]);
+				}
+			}
+			for (int t = 0; t < threads; t++) {
+				if (started[t]) {
+					pthread_join(thread_ids[t], NULL);
+				}
+			}
+		}
+
+		//Write out in record order, unless any worker failed.
+		for (int t = 0; t < threads; t++) {
+			if (workers[t].failed) {
+				result = -1;
+			}
+		}
+		for (int t = 0; t < threads; t++) {
+			GEN_WORKER *worker = &workers[t];
+			size_t start = 0;
+			for (UINT64 i = 0; i < worker->count && result == 0;
+			     i++) {
+				if (!write_record(&output, worker->buf + start,
+						  worker->ends[i] - start)) {
+					result = -1;
+				}
+				start = worker->ends[i];
+			}
+			free(worker->buf);
+		}
 	}
+
+	if (output.file != NULL) {
+		fclose(output.file);
+	}
+	free(ends);
+	return result;
 }
 
 //Prints command help for this CPER generator.
 void print_help()
 {
-	printf(":: --out cper.file [--sections section1 ...] [--single-section sectiontype]\n");
+	printf(":: --out cper.file [--count N] [--seed S] [--threads T] [--shard-records M]\n");
+	printf("\t[--sections section1 ... | --single-section sectiontype | --mix section:weight,... [--mix-sections count:weight,...] |\n");
+	printf("\t --profile profile.json | --ir [--specification cper-json.json] | --adversarial shape]\n");
 	printf("\tGenerates a pseudo-random CPER file with the provided section types and outputs to the given file name.\n\n");
 	printf("\tWhen the '--sections' flag is set, all following arguments are section names, and a full CPER log is generated\n");
-	printf("\tcontaining the given sections.\n");
+	printf("\tcontaining the given sections. '--sections' must therefore be the last flag.\n");
 	printf("\tWhen the '--single-section' flag is set, the next argument is the single section that should be generated, and\n");
-	printf("\ta single section (no header, only a section descriptor & section) CPER file is generated.\n\n");
+	printf("\ta single section (no header, only a section descriptor & section) CPER file is generated.\n");
+	printf("\tWhen the '--mix' flag is set, each record's section types are picked from the given weighted section types,\n");
+	printf("\tfor example 'memory:70,pcie:20,nvidia:10'. The number of sections per record is one, or is picked from the\n");
+	printf("\tweighted section counts given with '--mix-sections', for example '1:80,2:15,4:5'.\n");
+	printf("\tWhen the '--profile' flag is set, records follow the given JSON workload profile, which sets section type\n");
+	printf("\tand count weights, severity weights, ARM context count and vendor blob size weights, the number of distinct\n");
+	printf("\tFRUs and the rate of duplicate records.\n");
+	printf("\tWhen the '--ir' flag is set, random CPER-JSON documents are generated directly from the CPER-JSON specification,\n");
+	printf("\tor the schema given with '--specification', one document per line.\n");
+	printf("\tWhen the '--adversarial' flag is set, records of the given shape are generated, for worst case decode\n");
+	printf("\ttesting. Valid shapes are the following:\n");
+	for (size_t i = 0; i < cper_adversarial_shapes_len; i++) {
+		printf("\t\t- %s: %s\n", cper_adversarial_shapes[i].Name,
+		       cper_adversarial_shapes[i].Description);
+	}
+	printf("\n");
+	printf("\t'--count' generates N records, concatenated into the output file. With '--shard-records', records are\n");
+	printf("\tinstead split into files of at most M records each, named 'cper.file.00000', 'cper.file.00001' and so on.\n");
+	printf("\t'--seed' makes the output reproducible: the same seed and arguments always generate the same records,\n");
+	printf("\tregardless of '--threads', which sets the number of threads generating records in parallel.\n\n");
 	printf("\tValid section type names are the following:\n");
 	for (size_t i = 0; i < generator_definitions_len; i++) {
 		printf("\t\t- %s\n", generator_definitions[i].ShortName);
@@ -0,0 +1,609 @@
+/**
+ * Describes functions for generating pseudo-random CPER-JSON documents directly from the CPER-JSON
+ * schema, without generating and decoding binary records. Documents honour the schema's types,
+ * required fields, oneOf/anyOf options, enums, integer minimums/maximums and array lengths. Each
+ * section is generated from a section schema picked first, and its descriptor given that section
+ * type, so documents encode through the matching section converter.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libgen.h>
+#include <json.h>
+#include "../edk/Cper.h"
+#include "../cper-utils.h"
+#include "../sections/cper-section.h"
+#include "gen-utils.h"
+#include "cper-generate-ir.h"
+
+//Limit on schema nesting, guarding against cyclic references.
+#define IR_GEN_MAX_DEPTH 64
+
+//Upper bound on the length of arrays with no maximum length.
+#define IR_GEN_MAX_ARRAY_LEN 4
+
+//Upper bound on the length of generated strings.
+#define IR_GEN_MAX_STRING_LEN 16
+
+//The only string pattern used by the schema, for GUIDs. Other patterns are not supported.
+#define IR_GEN_GUID_PATTERN                                                    \
+	"^[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{16}$"
+
+//Section schemas of the CPER-JSON specification, by file name, and the section type each describes.
+//The unknown section schema describes sections of any other type, given a random section type.
+typedef struct {
+	const char *Schema;
+	EFI_GUID *Guid;
+} IR_GEN_SECTION_SCHEMA;
+
+static const IR_GEN_SECTION_SCHEMA ir_gen_section_schemas[] = {
+	{ "cper-generic-processor.json", &gEfiProcessorGenericErrorSectionGuid },
+	{ "cper-ia32x64-processor.json", &gEfiIa32X64ProcessorErrorSectionGuid },
+	{ "cper-arm-processor.json", &gEfiArmProcessorErrorSectionGuid },
+	{ "cper-memory.json", &gEfiPlatformMemoryErrorSectionGuid },
+	{ "cper-memory2.json", &gEfiPlatformMemoryError2SectionGuid },
+	{ "cper-pcie.json", &gEfiPcieErrorSectionGuid },
+	{ "cper-pci-bus.json", &gEfiPciBusErrorSectionGuid },
+	{ "cper-pci-component.json", &gEfiPciDevErrorSectionGuid },
+	{ "cper-firmware.json", &gEfiFirmwareErrorSectionGuid },
+	{ "cper-generic-dmar.json", &gEfiDMArGenericErrorSectionGuid },
+	{ "cper-vtd-dmar.json", &gEfiDirectedIoDMArErrorSectionGuid },
+	{ "cper-iommu-dmar.json", &gEfiIommuDMArErrorSectionGuid },
+	{ "cper-ccix-per.json", &gEfiCcixPerLogErrorSectionGuid },
+	{ "cper-cxl-protocol.json", &gEfiCxlProtocolErrorSectionGuid },
+	{ "cper-cxl-component.json", &gEfiCxlPhysicalSwitchErrorSectionGuid },
+	{ "cper-nvidia.json", &gEfiNvidiaErrorSectionGuid },
+	{ "cper-unknown.json", NULL },
+};
+#define IR_GEN_SECTION_SCHEMAS_LEN                                             \
+	(sizeof(ir_gen_section_schemas) / sizeof(IR_GEN_SECTION_SCHEMA))
+
+//The other section types described by the CXL component schema, which is only ever generated as a
+//physical switch section.
+static EFI_GUID *const ir_gen_cxl_component_guids[] = {
+	&gEfiCxlGeneralMediaErrorSectionGuid,
+	&gEfiCxlDramEventErrorSectionGuid,
+	&gEfiCxlMemoryModuleErrorSectionGuid,
+	&gEfiCxlVirtualSwitchErrorSectionGuid,
+	&gEfiCxlMldPortErrorSectionGuid,
+};
+#define IR_GEN_CXL_COMPONENT_GUIDS_LEN                                         \
+	(sizeof(ir_gen_cxl_component_guids) / sizeof(EFI_GUID *))
+
+//The section schemas loaded by a generator.
+typedef struct {
+	json_object *schemas[IR_GEN_SECTION_SCHEMAS_LEN];
+	const IR_GEN_SECTION_SCHEMA *types[IR_GEN_SECTION_SCHEMAS_LEN];
+	size_t len;
+} ir_section_schemas;
+
+//Private pre-definitions.
+static int ir_load_refs(cper_ir_generator *generator, const char *directory,
+			json_object *schema);
+static json_object *ir_resolve_local_ref(json_object *document,
+					 const char *ref_path);
+static json_object *ir_schema_get(json_object *schema, json_object *ref,
+				  const char *key);
+static int ir_is_required(json_object *required, const char *key);
+static json_object *ir_generate_value(const cper_ir_generator *generator,
+				      json_object *document,
+				      json_object *schema,
+				      cper_generator_context *context,
+				      int depth);
+static json_object *ir_generate_object(const cper_ir_generator *generator,
+				       json_object *document,
+				       json_object *schema, json_object *ref,
+				       cper_generator_context *context,
+				       int depth);
+static json_object *ir_generate_array(const cper_ir_generator *generator,
+				      json_object *document,
+				      json_object *schema, json_object *ref,
+				      cper_generator_context *context,
+				      int depth);
+static json_object *ir_generate_integer(json_object *schema, json_object *ref,
+					cper_generator_context *context);
+static json_object *ir_generate_string(json_object *schema, json_object *ref,
+				       cper_generator_context *context);
+static void ir_find_section_schemas(const cper_ir_generator *generator,
+				    ir_section_schemas *found);
+static json_object *ir_generate_section(const cper_ir_generator *generator,
+					const ir_section_schemas *schemas,
+					json_object *descriptor,
+					cper_generator_context *context);
+static void ir_generate_sections(const cper_ir_generator *generator,
+				 json_object *ir,
+				 cper_generator_context *context);
+
+//Loads the given root schema file, and every schema it references.
+//Returns 1 on success, 0 if a schema could not be loaded.
+int cper_ir_generator_init(cper_ir_generator *generator,
+			   const char *schema_file)
+{
+	generator->refs = json_object_new_object();
+	generator->root = json_object_from_file(schema_file);
+	if (generator->root == NULL) {
+		printf("Failed to load schema from file '%s'.\n", schema_file);
+		cper_ir_generator_free(generator);
+		return 0;
+	}
+
+	//References are relative to the directory of the root schema.
+	char *schema_file_copy = strdup(schema_file);
+	int result = ir_load_refs(generator, dirname(schema_file_copy),
+				  generator->root);
+	free(schema_file_copy);
+	if (!result) {
+		cper_ir_generator_free(generator);
+	}
+	return result;
+}
+
+//Frees all schemas held by the generator.
+void cper_ir_generator_free(cper_ir_generator *generator)
+{
+	json_object_put(generator->root);
+	json_object_put(generator->refs);
+	generator->root = NULL;
+	generator->refs = NULL;
+}
+
+//Generates a single pseudo-random CPER-JSON document from the generator's schema.
+//Returns NULL if the schema could not be followed.
+json_object *cper_ir_generator_generate(const cper_ir_generator *generator,
+					cper_generator_context *context)
+{
+	json_object *ir = ir_generate_value(generator, generator->root,
+					    generator->root, context, 0);
+	if (ir != NULL) {
+		ir_generate_sections(generator, ir, context);
+	}
+	return ir;
+}
+
+//Returns the file name of the section schema, in the "sections" directory of the specification,
+//that describes the IR of sections of the given type. Types without a section converter are
+//decoded as unknown sections, so are described by the unknown section schema.
+const char *cper_ir_generator_section_schema(const EFI_GUID *type)
+{
+	for (size_t i = 0; i < IR_GEN_SECTION_SCHEMAS_LEN; i++) {
+		if (ir_gen_section_schemas[i].Guid != NULL &&
+		    guid_equal(ir_gen_section_schemas[i].Guid,
+			       (EFI_GUID *)type)) {
+			return ir_gen_section_schemas[i].Schema;
+		}
+	}
+	for (size_t i = 0; i < IR_GEN_CXL_COMPONENT_GUIDS_LEN; i++) {
+		if (guid_equal(ir_gen_cxl_component_guids[i],
+			       (EFI_GUID *)type)) {
+			return "cper-cxl-component.json";
+		}
+	}
+	return "cper-unknown.json";
+}
+
+//Loads every schema referenced from within the given schema, recursively, into the generator.
+//Returns 1 on success, 0 if a referenced schema could not be loaded.
+static int ir_load_refs(cper_ir_generator *generator, const char *directory,
+			json_object *schema)
+{
+	if (json_object_is_type(schema, json_type_array)) {
+		size_t len = json_object_array_length(schema);
+		for (size_t i = 0; i < len; i++) {
+			if (!ir_load_refs(generator, directory,
+					  json_object_array_get_idx(schema,
+								    i))) {
+				return 0;
+			}
+		}
+		return 1;
+	}
+	if (!json_object_is_type(schema, json_type_object)) {
+		return 1;
+	}
+
+	json_object_object_foreach(schema, key, value)
+	{
+		if (strcmp(key, "$ref") != 0 ||
+		    !json_object_is_type(value, json_type_string)) {
+			if (!ir_load_refs(generator, directory, value)) {
+				return 0;
+			}
+			continue;
+		}
+
+		//Load each referenced schema once. References within a schema, such as
+		//"#/$defs/name", are resolved as documents are generated.
+		const char *ref_path = json_object_get_string(value);
+		if (ref_path[0] == '#' ||
+		    json_object_object_get(generator->refs, ref_path) != NULL) {
+			continue;
+		}
+		char path[4096];
+		snprintf(path, sizeof(path), "%s/%s", directory, ref_path);
+		json_object *ref = json_object_from_file(path);
+		if (ref == NULL) {
+			printf("Failed to open referenced schema file '%s'.\n",
+			       path);
+			return 0;
+		}
+		json_object_object_add(generator->refs, ref_path, ref);
+		if (!ir_load_refs(generator, directory, ref)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+//Resolves a reference within a schema document, such as "#/$defs/name".
+//Returns NULL if the reference does not resolve.
+static json_object *ir_resolve_local_ref(json_object *document,
+					 const char *ref_path)
+{
+	json_object *result = document;
+	const char *pos = ref_path + 1;
+	char key[256];
+	while (result != NULL && *pos == '/') {
+		pos++;
+		size_t len = strcspn(pos, "/");
+		if (len >= sizeof(key)) {
+			return NULL;
+		}
+		memcpy(key, pos, len);
+		key[len] = '\0';
+		result = json_object_object_get(result, key);
+		pos += len;
+	}
+	return *pos == '\0' ? result : NULL;
+}
+
+//Returns a keyword from the given schema, or from the schema it references if not present.
+static json_object *ir_schema_get(json_object *schema, json_object *ref,
+				  const char *key)
+{
+	json_object *value = json_object_object_get(schema, key);
+	if (value == NULL && ref != NULL) {
+		value = json_object_object_get(ref, key);
+	}
+	return value;
+}
+
+//Returns whether the given property is within the given "required" array.
+static int ir_is_required(json_object *required, const char *key)
+{
+	if (!json_object_is_type(required, json_type_array)) {
+		return 0;
+	}
+	size_t len = json_object_array_length(required);
+	for (size_t i = 0; i < len; i++) {
+		json_object *field = json_object_array_get_idx(required, i);
+		if (strcmp(key, json_object_get_string(field)) == 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//Generates a single value satisfying the given schema, which is within the given schema document.
+static json_object *ir_generate_value(const cper_ir_generator *generator,
+				      json_object *document,
+				      json_object *schema,
+				      cper_generator_context *context,
+				      int depth)
+{
+	if (depth > IR_GEN_MAX_DEPTH ||
+	    !json_object_is_type(schema, json_type_object)) {
+		return NULL;
+	}
+
+	//Referenced schemas supply any keywords not present locally. Anything nested within a
+	//schema referencing another document is taken to be within that document.
+	json_object *ref = NULL;
+	json_object *ref_path = json_object_object_get(schema, "$ref");
+	if (ref_path != NULL) {
+		const char *path = json_object_get_string(ref_path);
+		if (path[0] == '#') {
+			ref = ir_resolve_local_ref(document, path);
+		} else {
+			ref = json_object_object_get(generator->refs, path);
+			document = ref;
+		}
+	}
+
+	//Values from an enum, or one of the oneOf options.
+	json_object *values = ir_schema_get(schema, ref, "enum");
+	if (json_object_is_type(values, json_type_array) &&
+	    json_object_array_length(values) > 0) {
+		json_object *value = json_object_array_get_idx(
+			values, gen_rand(context) %
+					json_object_array_length(values));
+		return json_object_get(value);
+	}
+	json_object *one_of = ir_schema_get(schema, ref, "oneOf");
+	if (one_of == NULL) {
+		one_of = ir_schema_get(schema, ref, "anyOf");
+	}
+	if (json_object_is_type(one_of, json_type_array) &&
+	    json_object_array_length(one_of) > 0) {
+		json_object *option = json_object_array_get_idx(
+			one_of,
+			gen_rand(context) % json_object_array_length(one_of));
+		return ir_generate_value(generator, document, option, context,
+					 depth + 1);
+	}
+
+	//Pick one of the allowed types.
+	json_object *types = ir_schema_get(schema, ref, "type");
+	const char *type = NULL;
+	if (json_object_is_type(types, json_type_array) &&
+	    json_object_array_length(types) > 0) {
+		type = json_object_get_string(json_object_array_get_idx(
+			types, gen_rand(context) %
+				       json_object_array_length(types)));
+	} else if (json_object_is_type(types, json_type_string)) {
+		type = json_object_get_string(types);
+	} else if (ref != NULL) {
+		return ir_generate_value(generator, document, ref, context,
+					 depth + 1);
+	} else {
+		return NULL;
+	}
+
+	if (strcmp(type, "object") == 0) {
+		return ir_generate_object(generator, document, schema, ref,
+					  context, depth);
+	}
+	if (strcmp(type, "array") == 0) {
+		return ir_generate_array(generator, document, schema, ref,
+					 context, depth);
+	}
+	if (strcmp(type, "integer") == 0) {
+		return ir_generate_integer(schema, ref, context);
+	}
+	if (strcmp(type, "string") == 0) {
+		return ir_generate_string(schema, ref, context);
+	}
+	if (strcmp(type, "boolean") == 0) {
+		return json_object_new_boolean(gen_rand(context) % 2);
+	}
+	if (strcmp(type, "double") == 0 || strcmp(type, "number") == 0) {
+		return json_object_new_double((double)gen_rand(context) /
+					      (1 << 16));
+	}
+	return NULL;
+}
+
+//Generates an object with all required properties, and a random subset of the optional ones.
+static json_object *ir_generate_object(const cper_ir_generator *generator,
+				       json_object *document,
+				       json_object *schema, json_object *ref,
+				       cper_generator_context *context,
+				       int depth)
+{
+	json_object *object = json_object_new_object();
+	json_object *properties = ir_schema_get(schema, ref, "properties");
+	json_object *required = ir_schema_get(schema, ref, "required");
+	if (!json_object_is_type(properties, json_type_object)) {
+		return object;
+	}
+
+	json_object_object_foreach(properties, key, property)
+	{
+		if (!ir_is_required(required, key) && gen_rand(context) % 2) {
+			continue;
+		}
+
+		json_object *value = ir_generate_value(
+			generator, document, property, context, depth + 1);
+		if (value != NULL) {
+			json_object_object_add(object, key, value);
+		}
+	}
+	return object;
+}
+
+//Generates an array within the schema's length bounds, following any per-position item schemas.
+static json_object *ir_generate_array(const cper_ir_generator *generator,
+				      json_object *document,
+				      json_object *schema, json_object *ref,
+				      cper_generator_context *context,
+				      int depth)
+{
+	json_object *prefix_items = ir_schema_get(schema, ref, "prefixItems");
+	json_object *items = ir_schema_get(schema, ref, "items");
+	json_object *min_items = ir_schema_get(schema, ref, "minItems");
+	json_object *max_items = ir_schema_get(schema, ref, "maxItems");
+	size_t prefix_len =
+		json_object_is_type(prefix_items, json_type_array) ?
+			json_object_array_length(prefix_items) :
+			0;
+
+	//Length within bounds, covering at least the per-position items.
+	size_t min_len = min_items != NULL ? json_object_get_int(min_items) : 0;
+	size_t max_len = max_items != NULL ?
+				 (size_t)json_object_get_int(max_items) :
+				 min_len + IR_GEN_MAX_ARRAY_LEN;
+	if (max_len < min_len) {
+		max_len = min_len;
+	}
+	size_t len = min_len + gen_rand(context) % (max_len - min_len + 1);
+
+	json_object *array = json_object_new_array();
+	for (size_t i = 0; i < len; i++) {
+		json_object *item_schema =
+			i < prefix_len ?
+				json_object_array_get_idx(prefix_items, i) :
+				items;
+		json_object *item = ir_generate_value(
+			generator, document, item_schema, context, depth + 1);
+		if (item == NULL) {
+			item = json_object_new_uint64(gen_rand64(context));
+		}
+		json_object_array_add(array, item);
+	}
+	return array;
+}
+
+//Generates an integer within the schema's bounds. Unbounded integers vary in magnitude, so both
+//small and large values are common.
+static json_object *ir_generate_integer(json_object *schema, json_object *ref,
+					cper_generator_context *context)
+{
+	json_object *minimum = ir_schema_get(schema, ref, "minimum");
+	json_object *maximum = ir_schema_get(schema, ref, "maximum");
+	UINT64 min = minimum != NULL ? (UINT64)json_object_get_int64(minimum) :
+				       0;
+	UINT64 value = gen_rand64(context) >> (gen_rand(context) % 64);
+	if (maximum != NULL) {
+		UINT64 max = (UINT64)json_object_get_int64(maximum);
+		if (max < min) {
+			max = min;
+		}
+		value = min + value % (max - min + 1);
+	} else if (value < min) {
+		value = min;
+	}
+	return json_object_new_uint64(value);
+}
+
+//Generates a string, in GUID form if the schema requires it.
+static json_object *ir_generate_string(json_object *schema, json_object *ref,
+				       cper_generator_context *context)
+{
+	json_object *pattern = ir_schema_get(schema, ref, "pattern");
+	char string[IR_GEN_MAX_STRING_LEN + 24];
+	if (pattern != NULL &&
+	    strcmp(json_object_get_string(pattern), IR_GEN_GUID_PATTERN) ==
+		    0) {
+		UINT64 low = gen_rand64(context);
+		UINT64 high = gen_rand64(context);
+		snprintf(string, sizeof(string), "%08x-%04x-%04x-%016llx",
+			 (UINT32)high, (UINT32)(high >> 32) & 0xFFFF,
+			 (UINT32)(high >> 48), (unsigned long long)low);
+		return json_object_new_string(string);
+	}
+
+	static const char characters[] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789 ";
+	int len = gen_rand(context) % (IR_GEN_MAX_STRING_LEN + 1);
+	for (int i = 0; i < len; i++) {
+		string[i] = characters[gen_rand(context) %
+				       (sizeof(characters) - 1)];
+	}
+	string[len] = '\0';
+	return json_object_new_string(string);
+}
+
+//Finds the section schemas among those loaded by the generator, by file name.
+static void ir_find_section_schemas(const cper_ir_generator *generator,
+				    ir_section_schemas *found)
+{
+	found->len = 0;
+	json_object_object_foreach(generator->refs, ref_path, ref)
+	{
+		const char *file_name = strrchr(ref_path, '/');
+		file_name = file_name != NULL ? file_name + 1 : ref_path;
+		for (size_t i = 0; i < IR_GEN_SECTION_SCHEMAS_LEN; i++) {
+			const IR_GEN_SECTION_SCHEMA *type =
+				&ir_gen_section_schemas[i];
+			if (strcmp(file_name, type->Schema) == 0) {
+				found->schemas[found->len] = ref;
+				found->types[found->len] = type;
+				found->len++;
+				break;
+			}
+		}
+	}
+}
+
+//Generates a section from a randomly picked section schema, setting the section type of the given
+//descriptor to match.
+static json_object *ir_generate_section(const cper_ir_generator *generator,
+					const ir_section_schemas *schemas,
+					json_object *descriptor,
+					cper_generator_context *context)
+{
+	size_t pick = gen_rand(context) % schemas->len;
+	json_object *schema = schemas->schemas[pick];
+	json_object *section =
+		ir_generate_value(generator, schema, schema, context, 1);
+
+	//Sections of unknown type are given a random section type.
+	EFI_GUID guid;
+	const char *readable_name = "Unknown";
+	if (schemas->types[pick]->Guid != NULL) {
+		guid = *schemas->types[pick]->Guid;
+		for (size_t i = 0; i < section_definitions_len; i++) {
+			if (guid_equal(section_definitions[i].Guid, &guid)) {
+				readable_name =
+					section_definitions[i].ReadableName;
+				break;
+			}
+		}
+	} else {
+		UINT64 random[2] = { gen_rand64(context), gen_rand64(context) };
+		memcpy(&guid, random, sizeof(EFI_GUID));
+	}
+
+	char guid_string[GUID_STRING_LENGTH];
+	guid_to_string(guid_string, &guid);
+	json_object *section_type = json_object_new_object();
+	json_object_object_add(section_type, "data",
+			       json_object_new_string(guid_string));
+	json_object_object_add(section_type, "type",
+			       json_object_new_string(readable_name));
+	json_object_object_add(descriptor, "sectionType", section_type);
+	return section;
+}
+
+//Regenerates the sections of a full or single section log document, each from a section schema
+//picked first, so that section descriptors and the header's section count match the sections.
+static void ir_generate_sections(const cper_ir_generator *generator,
+				 json_object *ir,
+				 cper_generator_context *context)
+{
+	ir_section_schemas schemas;
+	ir_find_section_schemas(generator, &schemas);
+	if (schemas.len == 0) {
+		return;
+	}
+
+	//Single section logs.
+	json_object *header = json_object_object_get(ir, "header");
+	json_object *descriptor = json_object_object_get(ir, "sectionDescriptor");
+	if (json_object_is_type(descriptor, json_type_object)) {
+		json_object *section = ir_generate_section(generator, &schemas,
+							   descriptor, context);
+		if (section != NULL) {
+			json_object_object_add(ir, "section", section);
+		}
+		if (json_object_is_type(header, json_type_object)) {
+			json_object_object_add(header, "sectionCount",
+					       json_object_new_uint64(1));
+		}
+		return;
+	}
+
+	//Full logs, with one section per descriptor.
+	json_object *descriptors =
+		json_object_object_get(ir, "sectionDescriptors");
+	if (!json_object_is_type(descriptors, json_type_array)) {
+		return;
+	}
+	size_t len = json_object_array_length(descriptors);
+	json_object *sections = json_object_new_array();
+	for (size_t i = 0; i < len; i++) {
+		json_object *section = ir_generate_section(
+			generator, &schemas,
+			json_object_array_get_idx(descriptors, i), context);
+		if (section == NULL) {
+			section = json_object_new_object();
+		}
+		json_object_array_add(sections, section);
+	}
+	json_object_object_add(ir, "sections", sections);
+	if (json_object_is_type(header, json_type_object)) {
+		json_object_object_add(header, "sectionCount",
+				       json_object_new_uint64(len));
+	}
+}
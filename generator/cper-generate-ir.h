@@ -0,0 +1,29 @@
+#ifndef CPER_GENERATE_IR_H
+#define CPER_GENERATE_IR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <json.h>
+#include "cper-generate.h"
+
+//A loaded CPER-JSON schema, with every schema it references, that random IR documents are
+//generated from. Read only once initialised, so may be shared between threads.
+typedef struct {
+	json_object *root;
+	json_object *refs;
+} cper_ir_generator;
+
+int cper_ir_generator_init(cper_ir_generator *generator,
+			   const char *schema_file);
+void cper_ir_generator_free(cper_ir_generator *generator);
+json_object *cper_ir_generator_generate(const cper_ir_generator *generator,
+					cper_generator_context *context);
+const char *cper_ir_generator_section_schema(const EFI_GUID *type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
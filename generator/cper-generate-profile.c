@@ -0,0 +1,368 @@
+/**
+ * Describes workload profiles for the CPER generator. A profile shapes generated records to resemble
+ * production traffic: a weighted mix of section types and section counts, a skewed severity
+ * distribution, a bounded set of FRUs, a rate of repeated records, and weighted ARM context counts
+ * and vendor blob sizes.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <json.h>
+#include "../edk/Cper.h"
+#include "gen-utils.h"
+#include "sections/gen-section.h"
+#include "cper-generate.h"
+#include "cper-generate-profile.h"
+
+//Section severity names within a profile, indexed by CPER severity value.
+static const char *PROFILE_SEVERITY_NAMES[4] = { "recoverable", "fatal",
+						 "corrected", "informational" };
+
+//Rank of each CPER severity value, higher being more severe.
+static const int PROFILE_SEVERITY_RANKS[4] = { 2, 3, 1, 0 };
+
+//Private pre-definitions.
+static int profile_weight_from_ir(json_object *value, UINT32 *weight);
+static int profile_distribution_from_ir(json_object *ir, const char *name,
+					UINT32 min, UINT32 max, size_t capacity,
+					UINT32 *values, UINT32 *weights,
+					size_t *len);
+static int profile_section_type_known(const char *name);
+static void profile_seed_index(cper_generator_context *context, UINT64 seed,
+			       UINT64 index);
+static size_t profile_generate_record(const cper_generator_profile *profile,
+				      cper_generator_context *context,
+				      void *buf, size_t size);
+static void profile_shape_record(const cper_generator_profile *profile,
+				 cper_generator_context *context,
+				 UINT8 *record);
+
+//Loads a workload profile from its JSON representation.
+//Returns 1 on success, 0 if the profile is invalid.
+int cper_generator_profile_from_ir(cper_generator_profile *profile,
+				   json_object *ir)
+{
+	memset(profile, 0, sizeof(cper_generator_profile));
+
+	//Section types, the only required field.
+	json_object *sections = json_object_object_get(ir, "sections");
+	if (sections == NULL ||
+	    !json_object_is_type(sections, json_type_object)) {
+		printf("Invalid profile, 'sections' must be an object of section type weights.\n");
+		return 0;
+	}
+	UINT32 total = 0;
+	json_object_object_foreach(sections, type, type_weight)
+	{
+		size_t i = profile->num_section_types;
+		if (i == CPER_PROFILE_MAX_SECTION_TYPES ||
+		    !profile_section_type_known(type) ||
+		    !profile_weight_from_ir(
+			    type_weight, &profile->section_type_weights[i])) {
+			printf("Invalid profile section type '%s'.\n", type);
+			goto fail;
+		}
+		profile->section_types[i] = strdup(type);
+		profile->num_section_types++;
+		total += profile->section_type_weights[i];
+	}
+	if (total == 0) {
+		printf("Invalid profile, section type weights must not all be zero.\n");
+		goto fail;
+	}
+
+	//Number of sections per record (one if not given), ARM context counts and vendor blob sizes.
+	if (!profile_distribution_from_ir(
+		    ir, "sectionCounts", 1, CPER_PROFILE_MAX_SECTIONS_PER_REC,
+		    CPER_PROFILE_MAX_SECTION_COUNTS, profile->section_counts,
+		    profile->section_count_weights,
+		    &profile->num_section_counts) ||
+	    !profile_distribution_from_ir(
+		    ir, "armContextCounts", 1, CPER_PROFILE_MAX_ARM_CONTEXTS,
+		    CPER_PROFILE_MAX_DISTRIBUTION, profile->arm_context_counts,
+		    profile->arm_context_count_weights,
+		    &profile->num_arm_context_counts) ||
+	    !profile_distribution_from_ir(
+		    ir, "vendorBlobSizes", 1, CPER_PROFILE_MAX_VENDOR_BLOB,
+		    CPER_PROFILE_MAX_DISTRIBUTION, profile->vendor_blob_sizes,
+		    profile->vendor_blob_size_weights,
+		    &profile->num_vendor_blob_sizes)) {
+		goto fail;
+	}
+
+	//Section severities, random if not given.
+	json_object *severities = json_object_object_get(ir, "severities");
+	if (severities != NULL) {
+		if (!json_object_is_type(severities, json_type_object)) {
+			printf("Invalid profile, 'severities' must be an object of severity weights.\n");
+			goto fail;
+		}
+		json_object_object_foreach(severities, severity,
+					   severity_weight)
+		{
+			int found = 0;
+			for (int i = 0; i < 4; i++) {
+				if (strcmp(severity,
+					   PROFILE_SEVERITY_NAMES[i]) == 0) {
+					found = profile_weight_from_ir(
+						severity_weight,
+						&profile->severity_weights[i]);
+				}
+			}
+			if (!found) {
+				printf("Invalid profile severity '%s'.\n",
+				       severity);
+				goto fail;
+			}
+		}
+	}
+
+	//FRU cardinality and duplicate rate.
+	json_object *fru_count = json_object_object_get(ir, "fruCount");
+	if (fru_count != NULL &&
+	    !profile_weight_from_ir(fru_count, &profile->fru_count)) {
+		printf("Invalid profile, 'fruCount' must be a non-negative integer.\n");
+		goto fail;
+	}
+	json_object *duplicate_rate =
+		json_object_object_get(ir, "duplicateRate");
+	if (duplicate_rate != NULL) {
+		double rate = json_object_get_double(duplicate_rate);
+		if (rate < 0 || rate > 1) {
+			printf("Invalid profile, 'duplicateRate' must be between 0 and 1.\n");
+			goto fail;
+		}
+		profile->duplicate_ppm = (UINT32)(rate * 1000000);
+	}
+
+	return 1;
+
+fail:
+	cper_generator_profile_free(profile);
+	return 0;
+}
+
+//Loads a workload profile from the given JSON file.
+//Returns 1 on success, 0 if the file could not be read or the profile is invalid.
+int cper_generator_profile_from_file(cper_generator_profile *profile,
+				     const char *path)
+{
+	json_object *ir = json_object_from_file(path);
+	if (ir == NULL) {
+		printf("Could not read profile file '%s'.\n", path);
+		return 0;
+	}
+	int result = cper_generator_profile_from_ir(profile, ir);
+	json_object_put(ir);
+	return result;
+}
+
+//Frees all memory held by a workload profile.
+void cper_generator_profile_free(cper_generator_profile *profile)
+{
+	for (size_t i = 0; i < profile->num_section_types; i++) {
+		free(profile->section_types[i]);
+	}
+	memset(profile, 0, sizeof(cper_generator_profile));
+}
+
+//Generates the record at the given index of the workload described by the profile into the given
+//buffer. Each record depends only on the seed and its index, so workloads can be generated in any
+//order or across threads. Duplicate records repeat the content of an earlier record, with a new
+//record ID and timestamp.
+//Returns as generate_cper_record_buf(), the length of the record, which did not fit if greater than
+//the given size, or zero on error.
+size_t generate_profile_record_buf(const cper_generator_profile *profile,
+				   UINT64 seed, UINT64 index, void *buf,
+				   size_t size)
+{
+	cper_generator_context context;
+	profile_seed_index(&context, seed, index);
+
+	//Follow the chain of duplicates back to an original record.
+	UINT64 original = index;
+	cper_generator_context original_context = context;
+	while (original > 0 && profile->duplicate_ppm > 0 &&
+	       gen_rand64(&original_context) % 1000000 <
+		       profile->duplicate_ppm) {
+		original = gen_rand64(&original_context) % original;
+		profile_seed_index(&original_context, seed, original);
+	}
+
+	size_t len =
+		profile_generate_record(profile, &original_context, buf, size);
+	if (len == 0 || len > size || original == index) {
+		return len;
+	}
+
+	//Duplicates are new occurrences of the same error.
+	EFI_COMMON_ERROR_RECORD_HEADER *header =
+		(EFI_COMMON_ERROR_RECORD_HEADER *)buf;
+	header->RecordID = gen_rand64(&context);
+	generate_timestamp(&header->TimeStamp, &context);
+	return len;
+}
+
+//Reads a single non-negative 32 bit integer from the given JSON value.
+//Returns 1 on success, 0 if the value is invalid.
+static int profile_weight_from_ir(json_object *value, UINT32 *weight)
+{
+	if (!json_object_is_type(value, json_type_int)) {
+		return 0;
+	}
+	INT64 integer = json_object_get_int64(value);
+	if (integer < 0 || integer > 0xFFFFFFFF) {
+		return 0;
+	}
+	*weight = (UINT32)integer;
+	return 1;
+}
+
+//Reads an optional weighted distribution of integers between min and max from the named field of a
+//profile, as an object mapping each value to its weight.
+//Returns 1 on success or if the field is not given, 0 if the distribution is invalid.
+static int profile_distribution_from_ir(json_object *ir, const char *name,
+					UINT32 min, UINT32 max, size_t capacity,
+					UINT32 *values, UINT32 *weights,
+					size_t *len)
+{
+	json_object *distribution = json_object_object_get(ir, name);
+	if (distribution == NULL) {
+		return 1;
+	}
+	if (!json_object_is_type(distribution, json_type_object)) {
+		printf("Invalid profile, '%s' must be an object of weights.\n",
+		       name);
+		return 0;
+	}
+
+	UINT64 total = 0;
+	json_object_object_foreach(distribution, key, weight)
+	{
+		char *end;
+		unsigned long value = strtoul(key, &end, 10);
+		if (*len == capacity || end == key || *end != '\0' ||
+		    value < min || value > max ||
+		    !profile_weight_from_ir(weight, &weights[*len])) {
+			printf("Invalid profile '%s' entry '%s'.\n", name, key);
+			return 0;
+		}
+		values[*len] = (UINT32)value;
+		total += weights[*len];
+		(*len)++;
+	}
+	if (total == 0) {
+		printf("Invalid profile, '%s' weights must not all be zero.\n",
+		       name);
+		return 0;
+	}
+	return 1;
+}
+
+//Returns whether the given name is a section type the generator can generate.
+static int profile_section_type_known(const char *name)
+{
+	if (strcmp(name, "unknown") == 0) {
+		return 1;
+	}
+	for (size_t i = 0; i < generator_definitions_len; i++) {
+		if (strcmp(name, generator_definitions[i].ShortName) == 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//Seeds the context for the record at the given index of a workload.
+static void profile_seed_index(cper_generator_context *context, UINT64 seed,
+			       UINT64 index)
+{
+	cper_generator_seed(context, seed ^ (index * 0xD1342543DE82EF95ULL));
+}
+
+//Generates a single record from the profile and the given context into the given buffer.
+static size_t profile_generate_record(const cper_generator_profile *profile,
+				      cper_generator_context *context,
+				      void *buf, size_t size)
+{
+	//Pick the record's sections.
+	UINT16 num_sections = 1;
+	if (profile->num_section_counts > 0) {
+		num_sections = profile->section_counts[gen_pick(
+			profile->section_count_weights,
+			profile->num_section_counts, context)];
+	}
+	char *types[CPER_PROFILE_MAX_SECTIONS_PER_REC];
+	for (UINT16 i = 0; i < num_sections; i++) {
+		types[i] = profile->section_types[gen_pick(
+			profile->section_type_weights,
+			profile->num_section_types, context)];
+	}
+
+	//Section generators follow the profile's ARM context counts and vendor blob sizes.
+	gen_shape shape = {
+		{ profile->arm_context_counts,
+		  profile->arm_context_count_weights,
+		  profile->num_arm_context_counts },
+		{ profile->vendor_blob_sizes, profile->vendor_blob_size_weights,
+		  profile->num_vendor_blob_sizes }
+	};
+	const gen_shape *previous = gen_shape_get();
+	gen_shape_set(&shape);
+	size_t len = generate_cper_record_buf(context, types, num_sections,
+					      buf, size);
+	gen_shape_set(previous);
+	if (len != 0 && len <= size) {
+		profile_shape_record(profile, context, (UINT8 *)buf);
+	}
+	return len;
+}
+
+//Applies the profile's severity distribution and FRU set to a generated record.
+static void profile_shape_record(const cper_generator_profile *profile,
+				 cper_generator_context *context,
+				 UINT8 *record)
+{
+	EFI_COMMON_ERROR_RECORD_HEADER *header =
+		(EFI_COMMON_ERROR_RECORD_HEADER *)record;
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptors =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(header + 1);
+	int severities = profile->severity_weights[0] ||
+			 profile->severity_weights[1] ||
+			 profile->severity_weights[2] ||
+			 profile->severity_weights[3];
+
+	UINT32 worst = EFI_GENERIC_ERROR_INFO;
+	for (UINT16 i = 0; i < header->SectionCount; i++) {
+		EFI_ERROR_SECTION_DESCRIPTOR *descriptor = &descriptors[i];
+		if (severities) {
+			descriptor->Severity = gen_pick(
+				profile->severity_weights, 4, context);
+			if (PROFILE_SEVERITY_RANKS[descriptor->Severity] >
+			    PROFILE_SEVERITY_RANKS[worst]) {
+				worst = descriptor->Severity;
+			}
+		}
+
+		//FRUs are identified by a GUID and name derived from their index.
+		if (profile->fru_count > 0) {
+			UINT64 fru = gen_rand64(context) % profile->fru_count;
+			cper_generator_context fru_context;
+			cper_generator_seed(&fru_context, fru);
+			UINT64 fru_id[2] = { gen_rand64(&fru_context),
+					     gen_rand64(&fru_context) };
+			memcpy(&descriptor->FruId, fru_id, sizeof(EFI_GUID));
+			char fru_string[sizeof(descriptor->FruString)] = { 0 };
+			snprintf(fru_string, sizeof(fru_string), "FRU %llu",
+				 (unsigned long long)fru);
+			memcpy(descriptor->FruString, fru_string,
+			       sizeof(fru_string));
+		}
+	}
+
+	//The record is as severe as its most severe section.
+	if (severities) {
+		header->ErrorSeverity = worst;
+	}
+}
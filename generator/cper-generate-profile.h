@@ -0,0 +1,66 @@
+#ifndef CPER_GENERATE_PROFILE_H
+#define CPER_GENERATE_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <json.h>
+#include "../edk/BaseTypes.h"
+
+//Upper bounds on the choices within a workload profile.
+#define CPER_PROFILE_MAX_SECTION_TYPES	  32
+#define CPER_PROFILE_MAX_SECTION_COUNTS	  16
+#define CPER_PROFILE_MAX_SECTIONS_PER_REC 64
+#define CPER_PROFILE_MAX_DISTRIBUTION	  16
+#define CPER_PROFILE_MAX_ARM_CONTEXTS	  64
+#define CPER_PROFILE_MAX_VENDOR_BLOB	  0x100000
+
+//A workload profile, shaping generated records to resemble production traffic rather than
+//uniformly random records. Loaded from JSON, see generator/README.md for the format.
+typedef struct {
+	//Weighted section types.
+	char *section_types[CPER_PROFILE_MAX_SECTION_TYPES];
+	UINT32 section_type_weights[CPER_PROFILE_MAX_SECTION_TYPES];
+	size_t num_section_types;
+
+	//Weighted number of sections per record.
+	UINT32 section_counts[CPER_PROFILE_MAX_SECTION_COUNTS];
+	UINT32 section_count_weights[CPER_PROFILE_MAX_SECTION_COUNTS];
+	size_t num_section_counts;
+
+	//Weighted number of context structures per ARM section, or none for random counts.
+	UINT32 arm_context_counts[CPER_PROFILE_MAX_DISTRIBUTION];
+	UINT32 arm_context_count_weights[CPER_PROFILE_MAX_DISTRIBUTION];
+	size_t num_arm_context_counts;
+
+	//Weighted byte lengths of vendor blobs (ARM vendor specific info and unknown sections), or
+	//none for random lengths.
+	UINT32 vendor_blob_sizes[CPER_PROFILE_MAX_DISTRIBUTION];
+	UINT32 vendor_blob_size_weights[CPER_PROFILE_MAX_DISTRIBUTION];
+	size_t num_vendor_blob_sizes;
+
+	//Section severity weights, indexed by CPER severity value.
+	UINT32 severity_weights[4];
+
+	//Number of distinct FRUs sections are attributed to, or zero for random FRUs.
+	UINT32 fru_count;
+
+	//Parts per million of records that repeat the content of an earlier record.
+	UINT32 duplicate_ppm;
+} cper_generator_profile;
+
+int cper_generator_profile_from_ir(cper_generator_profile *profile,
+				   json_object *ir);
+int cper_generator_profile_from_file(cper_generator_profile *profile,
+				     const char *path);
+void cper_generator_profile_free(cper_generator_profile *profile);
+size_t generate_profile_record_buf(const cper_generator_profile *profile,
+				   UINT64 seed, UINT64 index, void *buf,
+				   size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -12,23 +12,30 @@
 #include "sections/gen-section.h"
 #include "cper-generate.h"
 
-EFI_ERROR_SECTION_DESCRIPTOR *generate_section_descriptor(char *type,
-							  const size_t *lengths,
-							  int index,
-							  int num_sections);
-size_t generate_section(void **location, char *type);
+EFI_ERROR_SECTION_DESCRIPTOR *
+generate_section_descriptor(char *type, const size_t *lengths, int index,
+			    int num_sections, cper_generator_context *context);
 
 //Generates a CPER record with the given section types, outputting to the given stream.
+//Uses this thread's default generator context, seeded from the current time.
 void generate_cper_record(char **types, UINT16 num_sections, FILE *out)
 {
-	//Initialise randomiser.
-	init_random();
+	generate_cper_record_with_context(gen_default_context(), types,
+					  num_sections, out);
+}
 
+//Generates a CPER record with the given section types from the given generator context,
+//outputting to the given stream.
+void generate_cper_record_with_context(cper_generator_context *context,
+				       char **types, UINT16 num_sections,
+				       FILE *out)
+{
 	//Generate the sections.
 	void *sections[num_sections];
 	size_t section_lengths[num_sections];
 	for (int i = 0; i < num_sections; i++) {
-		section_lengths[i] = generate_section(sections + i, types[i]);
+		section_lengths[i] =
+			generate_section(sections + i, types[i], context);
 		if (section_lengths[i] == 0) {
 			//Error encountered, exit.
 			printf("Error encountered generating section %d of type '%s', length returned zero.\n",
@@ -39,31 +46,15 @@ void generate_cper_record(char **types, UINT16 num_sections, FILE *out)
 
 	//Generate the header given the number of sections.
 	EFI_COMMON_ERROR_RECORD_HEADER *header =
-		(EFI_COMMON_ERROR_RECORD_HEADER *)calloc(
-			1, sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
-	header->SignatureStart = 0x52455043; //CPER
-	header->SectionCount = num_sections;
-	header->SignatureEnd = 0xFFFFFFFF;
-	header->Flags = 4; //HW_ERROR_FLAGS_SIMULATED
-	header->RecordID = (UINT64)rand();
-	header->ErrorSeverity = rand() % 4;
-
-	//Generate a valid timestamp.
-	header->TimeStamp.Century = int_to_bcd(rand() % 100);
-	header->TimeStamp.Year = int_to_bcd(rand() % 100);
-	header->TimeStamp.Month = int_to_bcd(rand() % 12 + 1);
-	header->TimeStamp.Day = int_to_bcd(rand() % 31 + 1);
-	header->TimeStamp.Hours = int_to_bcd(rand() % 24 + 1);
-	header->TimeStamp.Seconds = int_to_bcd(rand() % 60);
-
-	//Turn all validation bits on.
-	header->ValidationBits = 0x3;
+		(EFI_COMMON_ERROR_RECORD_HEADER *)malloc(
+			sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
+	fill_record_header(header, num_sections, context);
 
 	//Generate the section descriptors given the number of sections.
 	EFI_ERROR_SECTION_DESCRIPTOR *section_descriptors[num_sections];
 	for (int i = 0; i < num_sections; i++) {
 		section_descriptors[i] = generate_section_descriptor(
-			types[i], section_lengths, i, num_sections);
+			types[i], section_lengths, i, num_sections, context);
 	}
 
 	//Calculate total length of structure, set in header.
@@ -91,16 +82,124 @@ void generate_cper_record(char **types, UINT16 num_sections, FILE *out)
 	}
 }
 
+//Generates a CPER record with the given section types from the given generator context into the
+//given buffer. Offsets are computed up front from the section count, and sections are generated in
+//place after the header and descriptors, so no memory is allocated while the record fits.
+//Returns the length of the record. If this is greater than the given size, the record did not fit
+//and the buffer contents are undefined. Returns zero if a section could not be generated.
+//For the same context state, the record is identical to that of generate_cper_record_with_context().
+size_t generate_cper_record_buf(cper_generator_context *context, char **types,
+				UINT16 num_sections, void *buf, size_t size)
+{
+	UINT8 *record = (UINT8 *)buf;
+	size_t header_len = sizeof(EFI_COMMON_ERROR_RECORD_HEADER) +
+			    num_sections * sizeof(EFI_ERROR_SECTION_DESCRIPTOR);
+
+	//Section allocations are taken from the buffer, after the descriptors.
+	gen_arena arena = { NULL, 0, 0 };
+	if (size > header_len) {
+		arena.base = record + header_len;
+		arena.size = size - header_len;
+	}
+
+	//Generate the sections.
+	size_t section_lengths[num_sections];
+	size_t sections_len = 0;
+	gen_arena_set(&arena);
+	for (int i = 0; i < num_sections; i++) {
+		arena.used = sections_len;
+		void *section = NULL;
+		section_lengths[i] =
+			generate_section(&section, types[i], context);
+		if (section_lengths[i] == 0) {
+			//Error encountered, exit.
+			gen_arena_set(NULL);
+			printf("Error encountered generating section %d of type '%s', length returned zero.\n",
+			       i + 1, types[i]);
+			return 0;
+		}
+
+		//Move the section to directly follow the previous one, discarding any temporaries
+		//allocated after it. Sections that did not fit were allocated with malloc().
+		if (gen_arena_contains(&arena, section)) {
+			memmove(arena.base + sections_len, section,
+				section_lengths[i]);
+		} else {
+			if (sections_len <= arena.size &&
+			    section_lengths[i] <= arena.size - sections_len) {
+				memcpy(arena.base + sections_len, section,
+				       section_lengths[i]);
+			}
+			free(section);
+		}
+		sections_len += section_lengths[i];
+	}
+	gen_arena_set(NULL);
+
+	//If the record does not fit, only the required length is returned.
+	size_t total_len = header_len + sections_len;
+	if (total_len > size) {
+		return total_len;
+	}
+
+	//Generate the header and section descriptors in place.
+	EFI_COMMON_ERROR_RECORD_HEADER *header =
+		(EFI_COMMON_ERROR_RECORD_HEADER *)record;
+	fill_record_header(header, num_sections, context);
+	header->RecordLength = (UINT32)total_len;
+	EFI_ERROR_SECTION_DESCRIPTOR *section_descriptors =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(header + 1);
+	for (int i = 0; i < num_sections; i++) {
+		if (!fill_section_descriptor(section_descriptors + i, types[i],
+					     section_lengths, i, num_sections,
+					     context)) {
+			return 0;
+		}
+	}
+
+	return total_len;
+}
+
+//Generates a record header for a record with the given number of sections. The record length
+//is left to be set by the caller.
+void fill_record_header(EFI_COMMON_ERROR_RECORD_HEADER *header,
+			UINT16 num_sections, cper_generator_context *context)
+{
+	memset(header, 0, sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
+	header->SignatureStart = 0x52455043; //CPER
+	header->SectionCount = num_sections;
+	header->SignatureEnd = 0xFFFFFFFF;
+	header->Flags = 4; //HW_ERROR_FLAGS_SIMULATED
+	header->RecordID = (UINT64)gen_rand(context);
+	header->ErrorSeverity = gen_rand(context) % 4;
+
+	//Generate a valid timestamp.
+	generate_timestamp(&header->TimeStamp, context);
+
+	//Turn all validation bits on.
+	header->ValidationBits = 0x3;
+}
+
 //Generates a single section record for the given section, and outputs to file.
+//Uses this thread's default generator context, seeded from the current time.
 void generate_single_section_record(char *type, FILE *out)
+{
+	generate_single_section_record_with_context(gen_default_context(),
+						    type, out);
+}
+
+//Generates a single section record for the given section from the given generator context,
+//and outputs to file.
+void generate_single_section_record_with_context(
+	cper_generator_context *context, char *type, FILE *out)
 {
 	//Generate a section.
 	void *section = NULL;
-	size_t section_len = generate_section(&section, type);
+	size_t section_len = generate_section(&section, type, context);
 
 	//Generate a descriptor, correct the offset.
 	EFI_ERROR_SECTION_DESCRIPTOR *section_descriptor =
-		generate_section_descriptor(type, &section_len, 0, 1);
+		generate_section_descriptor(type, &section_len, 0, 1, context);
 	section_descriptor->SectionOffset =
 		sizeof(EFI_ERROR_SECTION_DESCRIPTOR);
 
@@ -116,14 +215,29 @@ void generate_single_section_record(char *type, FILE *out)
 }
 
 //Generates a single section descriptor for a section with the given properties.
-EFI_ERROR_SECTION_DESCRIPTOR *generate_section_descriptor(char *type,
-							  const size_t *lengths,
-							  int index,
-							  int num_sections)
+EFI_ERROR_SECTION_DESCRIPTOR *
+generate_section_descriptor(char *type, const size_t *lengths, int index,
+			    int num_sections, cper_generator_context *context)
 {
 	EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
-		(EFI_ERROR_SECTION_DESCRIPTOR *)generate_random_bytes(
+		(EFI_ERROR_SECTION_DESCRIPTOR *)malloc(
 			sizeof(EFI_ERROR_SECTION_DESCRIPTOR));
+	if (!fill_section_descriptor(descriptor, type, lengths, index,
+				     num_sections, context)) {
+		free(descriptor);
+		return NULL;
+	}
+	return descriptor;
+}
+
+//Generates a single section descriptor in place, for a section with the given properties.
+//Returns 1 on success, 0 if the section type is undefined.
+int fill_section_descriptor(EFI_ERROR_SECTION_DESCRIPTOR *descriptor,
+			    char *type, const size_t *lengths, int index,
+			    int num_sections, cper_generator_context *context)
+{
+	fill_random_bytes((UINT8 *)descriptor,
+			  sizeof(EFI_ERROR_SECTION_DESCRIPTOR), context);
 
 	//Set reserved bits to zero.
 	descriptor->Resv1 = 0;
@@ -133,7 +247,7 @@ EFI_ERROR_SECTION_DESCRIPTOR *generate_section_descriptor(char *type,
 	descriptor->SecValidMask = 0x3;
 
 	//Set severity.
-	descriptor->Severity = rand() % 4;
+	descriptor->Severity = gen_rand(context) % 4;
 
 	//Set length, offset from base record.
 	descriptor->SectionLength = (UINT32)lengths[index];
@@ -147,7 +261,7 @@ EFI_ERROR_SECTION_DESCRIPTOR *generate_section_descriptor(char *type,
 	//Ensure the FRU text is not null terminated early.
 	for (int i = 0; i < 20; i++) {
 		if (descriptor->FruString[i] == 0x0) {
-			descriptor->FruString[i] = rand() % 127 + 1;
+			descriptor->FruString[i] = gen_rand(context) % 127 + 1;
 		}
 
 		//Null terminate last byte.
@@ -182,11 +296,12 @@ EFI_ERROR_SECTION_DESCRIPTOR *generate_section_descriptor(char *type,
 		return 0;
 	}
 
-	return descriptor;
+	return 1;
 }
 
 //Generates a single CPER section given the string type.
-size_t generate_section(void **location, char *type)
+size_t generate_section(void **location, char *type,
+			cper_generator_context *context)
 {
 	//The length of the section.
 	size_t length = 0;
@@ -194,7 +309,14 @@ size_t generate_section(void **location, char *type)
 	//If the section name is "unknown", simply generate a random bytes section.
 	int section_generated = 0;
 	if (strcmp(type, "unknown") == 0) {
-		length = generate_random_section(location, rand() % 256);
+		const gen_shape *shape = gen_shape_get();
+		size_t size;
+		if (shape != NULL && shape->vendor_blob_sizes.len > 0) {
+			size = gen_sample(&shape->vendor_blob_sizes, context);
+		} else {
+			size = gen_rand(context) % 256;
+		}
+		length = generate_random_section(location, size, context);
 		section_generated = 1;
 	} else {
 		//Function defined section, switch on the type, generate accordingly.
@@ -202,7 +324,7 @@ size_t generate_section(void **location, char *type)
 			if (strcmp(type, generator_definitions[i].ShortName) ==
 			    0) {
 				length = generator_definitions[i].Generate(
-					location);
+					location, context);
 				section_generated = 1;
 				break;
 			}
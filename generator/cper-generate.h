@@ -8,8 +8,22 @@ extern "C" {
 #include <stdio.h>
 #include "../edk/BaseTypes.h"
 
+//Pseudo-random generator state (xoshiro256**). Contexts seeded with the same value generate the same
+//records, and each thread generating records should use its own context.
+typedef struct {
+	UINT64 state[4];
+} cper_generator_context;
+
+void cper_generator_seed(cper_generator_context *context, UINT64 seed);
 void generate_cper_record(char **types, UINT16 num_sections, FILE *out);
 void generate_single_section_record(char *type, FILE *out);
+void generate_cper_record_with_context(cper_generator_context *context,
+				       char **types, UINT16 num_sections,
+				       FILE *out);
+void generate_single_section_record_with_context(
+	cper_generator_context *context, char *type, FILE *out);
+size_t generate_cper_record_buf(cper_generator_context *context, char **types,
+				UINT16 num_sections, void *buf, size_t size);
 
 #ifdef __cplusplus
 }
@@ -3,32 +3,133 @@
  *
  * Author: Lawrence.Tang@arm.com
  **/
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
-#include "../edk/BaseTypes.h"
+#include "../edk/Cper.h"
 #include "gen-utils.h"
 
+const int CPER_ERROR_TYPES_KEYS[18] = { 1, 16, 4, 5, 6, 7, 8, 9, 17, 18, 19, 20,
+					21, 22, 23, 24, 25, 26 };
+
+//Arena that generator allocations on this thread are taken from, if any.
+static _Thread_local gen_arena *current_arena = NULL;
+
+//Shape that section generators on this thread follow, if any.
+static _Thread_local const gen_shape *current_shape = NULL;
+
 //Generates a random section of the given byte size, saving the result to the given location.
 //Returns the length of the section as passed in.
-size_t generate_random_section(void **location, size_t size)
+size_t generate_random_section(void **location, size_t size,
+			       cper_generator_context *context)
 {
-	*location = generate_random_bytes(size);
+	*location = generate_random_bytes(size, context);
 	return size;
 }
 
 //Generates a random byte allocation of the given size.
-UINT8 *generate_random_bytes(size_t size)
+UINT8 *generate_random_bytes(size_t size, cper_generator_context *context)
 {
-	UINT8 *bytes = malloc(size);
-	for (size_t i = 0; i < size; i++) {
-		bytes[i] = rand();
-	}
+	UINT8 *bytes = gen_alloc(size);
+	fill_random_bytes(bytes, size, context);
 	return bytes;
 }
 
+//Fills the given buffer with random bytes.
+void fill_random_bytes(UINT8 *bytes, size_t size,
+		       cper_generator_context *context)
+{
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		UINT64 value = gen_rand64(context);
+		memcpy(bytes + i, &value, sizeof(value));
+	}
+	if (i < size) {
+		UINT64 value = gen_rand64(context);
+		memcpy(bytes + i, &value, size - i);
+	}
+}
+
+//Sets the arena that generator allocations on this thread are taken from, or returns to malloc()
+//when NULL. Allocations that do not fit within the arena still fall back to malloc().
+void gen_arena_set(gen_arena *arena)
+{
+	current_arena = arena;
+}
+
+//Allocates memory for generating a section, from this thread's arena if one is set.
+//Arena allocations are 8 byte aligned, relative to the arena base.
+void *gen_alloc(size_t size)
+{
+	gen_arena *arena = current_arena;
+	if (arena != NULL) {
+		size_t start = (arena->used + 7) & ~(size_t)7;
+		if (start <= arena->size && size <= arena->size - start) {
+			arena->used = start + size;
+			return arena->base + start;
+		}
+	}
+	return malloc(size);
+}
+
+//Frees memory from gen_alloc(). Arena memory is reclaimed only when the arena is reset.
+void gen_free(void *ptr)
+{
+	if (!gen_arena_contains(current_arena, ptr)) {
+		free(ptr);
+	}
+}
+
+//Returns whether the given pointer lies within the given arena.
+int gen_arena_contains(const gen_arena *arena, const void *ptr)
+{
+	return arena != NULL && (const UINT8 *)ptr >= arena->base &&
+	       (const UINT8 *)ptr < arena->base + arena->size;
+}
+
+//Sets the shape that section generators on this thread follow, or returns to uniform choices when
+//NULL. The shape must outlive its use.
+void gen_shape_set(const gen_shape *shape)
+{
+	current_shape = shape;
+}
+
+//Returns the shape that section generators on this thread follow, or NULL if none is set.
+const gen_shape *gen_shape_get(void)
+{
+	return current_shape;
+}
+
+//Picks an index from the given weights, which must not all be zero.
+size_t gen_pick(const UINT32 *weights, size_t len,
+		cper_generator_context *context)
+{
+	UINT64 total = 0;
+	for (size_t i = 0; i < len; i++) {
+		total += weights[i];
+	}
+	UINT64 pick = gen_rand64(context) % total;
+	for (size_t i = 0; i < len; i++) {
+		if (pick < weights[i]) {
+			return i;
+		}
+		pick -= weights[i];
+	}
+	return len - 1;
+}
+
+//Draws a value from the given distribution, which must not be empty.
+UINT32 gen_sample(const gen_distribution *distribution,
+		  cper_generator_context *context)
+{
+	return distribution->values[gen_pick(distribution->weights,
+					     distribution->len, context)];
+}
+
 //Creates a valid common CPER error section, given the start of the error section.
 //Clears reserved bits.
-void create_valid_error_section(UINT8 *start)
+void create_valid_error_section(UINT8 *start, cper_generator_context *context)
 {
 	//Fix reserved bits.
 	UINT64 *error_section = (UINT64 *)start;
@@ -36,13 +137,68 @@ void create_valid_error_section(UINT8 *start)
 	*error_section &= 0x7FFFFF; //Reserved bits 23-63
 
 	//Ensure error type has a valid value.
-	*(start + 1) =
-		CPER_ERROR_TYPES_KEYS[rand() % (sizeof(CPER_ERROR_TYPES_KEYS) /
-						sizeof(int))];
+	*(start + 1) = CPER_ERROR_TYPES_KEYS[gen_rand(context) %
+					     (sizeof(CPER_ERROR_TYPES_KEYS) /
+					      sizeof(int))];
 }
 
-//Initializes the random seed for rand() using the current time.
-void init_random()
+//Generates a valid pseudo-random record timestamp.
+void generate_timestamp(EFI_ERROR_TIME_STAMP *timestamp,
+			cper_generator_context *context)
 {
-	srand((unsigned int)time(NULL));
+	timestamp->Century = int_to_bcd(gen_rand(context) % 100);
+	timestamp->Year = int_to_bcd(gen_rand(context) % 100);
+	timestamp->Month = int_to_bcd(gen_rand(context) % 12 + 1);
+	timestamp->Day = int_to_bcd(gen_rand(context) % 31 + 1);
+	timestamp->Hours = int_to_bcd(gen_rand(context) % 24 + 1);
+	timestamp->Seconds = int_to_bcd(gen_rand(context) % 60);
+}
+
+//Seeds a generator context. The four words of state are expanded from the seed with splitmix64,
+//so that any seed (including zero) gives a valid, well mixed state.
+void cper_generator_seed(cper_generator_context *context, UINT64 seed)
+{
+	for (int i = 0; i < 4; i++) {
+		seed += 0x9E3779B97F4A7C15ULL;
+		UINT64 z = seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		context->state[i] = z ^ (z >> 31);
+	}
+}
+
+//Returns the next 64 pseudo-random bits from the context (xoshiro256**).
+UINT64 gen_rand64(cper_generator_context *context)
+{
+	UINT64 *s = context->state;
+	UINT64 result = s[1] * 5;
+	result = ((result << 7) | (result >> 57)) * 9;
+	UINT64 t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+	return result;
+}
+
+//Returns a non-negative pseudo-random integer from the context, as a drop in for rand().
+int gen_rand(cper_generator_context *context)
+{
+	return (int)(gen_rand64(context) >> 33);
+}
+
+//Returns this thread's default generator context, used when no context is given. It is seeded
+//once per thread from the current time and the thread, so consecutive records differ.
+cper_generator_context *gen_default_context(void)
+{
+	static _Thread_local cper_generator_context context;
+	static _Thread_local int seeded = 0;
+	if (!seeded) {
+		UINT64 seed = (UINT64)time(NULL) ^ (UINT64)(uintptr_t)&context;
+		cper_generator_seed(&context, seed);
+		seeded = 1;
+	}
+	return &context;
 }
@@ -6,20 +6,66 @@ extern "C" {
 #endif
 
 #include <stdlib.h>
-#include "../edk/BaseTypes.h"
+#include "../edk/Cper.h"
 #include "../common-utils.h"
+#include "cper-generate.h"
 
-#define CPER_ERROR_TYPES_KEYS                                                  \
-	(int[])                                                                \
-	{                                                                      \
-		1, 16, 4, 5, 6, 7, 8, 9, 17, 18, 19, 20, 21, 22, 23, 24, 25,   \
-			26                                                     \
-	}
-
-size_t generate_random_section(void **location, size_t size);
-UINT8 *generate_random_bytes(size_t size);
-void init_random();
-void create_valid_error_section(UINT8 *start);
+extern const int CPER_ERROR_TYPES_KEYS[18];
+
+//A bump allocator over a caller provided buffer. Allocations are made from "used" onwards.
+typedef struct {
+	UINT8 *base;
+	size_t size;
+	size_t used;
+} gen_arena;
+
+void gen_arena_set(gen_arena *arena);
+int gen_arena_contains(const gen_arena *arena, const void *ptr);
+void *gen_alloc(size_t size);
+void gen_free(void *ptr);
+
+//A weighted distribution of values. Weights must not all be zero, unless the distribution is empty.
+typedef struct {
+	const UINT32 *values;
+	const UINT32 *weights;
+	size_t len;
+} gen_distribution;
+
+//Distributions replacing the uniform choices of section generators, as set by workload profiles.
+//Empty distributions keep the uniform choice.
+typedef struct {
+	gen_distribution arm_context_counts;
+	gen_distribution vendor_blob_sizes;
+} gen_shape;
+
+void gen_shape_set(const gen_shape *shape);
+const gen_shape *gen_shape_get(void);
+size_t gen_pick(const UINT32 *weights, size_t len,
+		cper_generator_context *context);
+UINT32 gen_sample(const gen_distribution *distribution,
+		  cper_generator_context *context);
+
+size_t generate_random_section(void **location, size_t size,
+			       cper_generator_context *context);
+UINT8 *generate_random_bytes(size_t size, cper_generator_context *context);
+void fill_random_bytes(UINT8 *bytes, size_t size,
+		       cper_generator_context *context);
+UINT64 gen_rand64(cper_generator_context *context);
+int gen_rand(cper_generator_context *context);
+cper_generator_context *gen_default_context(void);
+void create_valid_error_section(UINT8 *start,
+				cper_generator_context *context);
+void generate_timestamp(EFI_ERROR_TIME_STAMP *timestamp,
+			cper_generator_context *context);
+
+//Record building blocks, from cper-generate.c.
+size_t generate_section(void **location, char *type,
+			cper_generator_context *context);
+void fill_record_header(EFI_COMMON_ERROR_RECORD_HEADER *header,
+			UINT16 num_sections, cper_generator_context *context);
+int fill_section_descriptor(EFI_ERROR_SECTION_DESCRIPTOR *descriptor,
+			    char *type, const size_t *lengths, int index,
+			    int num_sections, cper_generator_context *context);
 UINT8 int_to_bcd(int value);
 
 #ifdef __cplusplus
@@ -11,31 +11,42 @@
 #include "gen-section.h"
 #define ARM_ERROR_INFO_SIZE 32
 
-void *generate_arm_error_info();
-size_t generate_arm_context_info(void **location);
-
 //Generates a single pseudo-random ARM processor section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_arm(void **location)
+size_t generate_section_arm(void **location, cper_generator_context *context)
 {
 	//Set up for generation of error/context structures.
-	UINT16 error_structure_num = rand() % 4 + 1; //Must be at least 1.
-	UINT16 context_structure_num = rand() % 3 + 1;
+	UINT16 error_structure_num = gen_rand(context) % 4 + 1; //Must be at least 1.
+	const gen_shape *shape = gen_shape_get();
+	UINT16 context_structure_num;
+	if (shape != NULL && shape->arm_context_counts.len > 0) {
+		context_structure_num =
+			gen_sample(&shape->arm_context_counts, context);
+	} else {
+		context_structure_num = gen_rand(context) % 3 + 1;
+	}
 	void *error_structures[error_structure_num];
 	void *context_structures[context_structure_num];
 	size_t context_structure_lengths[context_structure_num];
 
 	//Generate the structures.
 	for (int i = 0; i < error_structure_num; i++) {
-		error_structures[i] = generate_arm_error_info();
+		error_structures[i] = generate_arm_error_info(context);
 	}
 	for (int i = 0; i < context_structure_num; i++) {
 		context_structure_lengths[i] =
-			generate_arm_context_info(context_structures + i);
+			generate_arm_context_info(context_structures + i,
+						  context);
 	}
 
 	//Determine a random amount of vendor specific info.
-	int vendor_info_len = rand() % 16;
+	size_t vendor_info_len;
+	if (shape != NULL && shape->vendor_blob_sizes.len > 0) {
+		vendor_info_len =
+			gen_sample(&shape->vendor_blob_sizes, context);
+	} else {
+		vendor_info_len = gen_rand(context) % 16;
+	}
 
 	//Create the section as a whole.
 	size_t total_len = 40 + (error_structure_num * ARM_ERROR_INFO_SIZE);
@@ -43,7 +54,7 @@ size_t generate_section_arm(void **location)
 		total_len += context_structure_lengths[i];
 	}
 	total_len += vendor_info_len;
-	UINT8 *section = generate_random_bytes(total_len);
+	UINT8 *section = generate_random_bytes(total_len, context);
 
 	//Set header information.
 	UINT16 *info_nums = (UINT16 *)(section + 4);
@@ -53,7 +64,7 @@ size_t generate_section_arm(void **location)
 	*section_length = total_len;
 
 	//Error affinity.
-	*(section + 12) = rand() % 4;
+	*(section + 12) = gen_rand(context) % 4;
 
 	//Reserved zero bytes.
 	UINT64 *validation = (UINT64 *)section;
@@ -66,13 +77,13 @@ size_t generate_section_arm(void **location)
 	UINT8 *cur_pos = section + 40;
 	for (int i = 0; i < error_structure_num; i++) {
 		memcpy(cur_pos, error_structures[i], ARM_ERROR_INFO_SIZE);
-		free(error_structures[i]);
+		gen_free(error_structures[i]);
 		cur_pos += ARM_ERROR_INFO_SIZE;
 	}
 	for (int i = 0; i < context_structure_num; i++) {
 		memcpy(cur_pos, context_structures[i],
 		       context_structure_lengths[i]);
-		free(context_structures[i]);
+		gen_free(context_structures[i]);
 		cur_pos += context_structure_lengths[i];
 	}
 
@@ -82,16 +93,16 @@ size_t generate_section_arm(void **location)
 }
 
 //Generates a single pseudo-random ARM error info structure. Must be later freed.
-void *generate_arm_error_info()
+void *generate_arm_error_info(cper_generator_context *context)
 {
-	UINT8 *error_info = generate_random_bytes(ARM_ERROR_INFO_SIZE);
+	UINT8 *error_info = generate_random_bytes(ARM_ERROR_INFO_SIZE, context);
 
 	//Version (zero for revision of table referenced), length.
 	*error_info = 0;
 	*(error_info + 1) = ARM_ERROR_INFO_SIZE;
 
 	//Type of error.
-	UINT8 error_type = rand() % 4;
+	UINT8 error_type = gen_rand(context) % 4;
 	*(error_info + 4) = error_type;
 
 	//Reserved bits for error information.
@@ -121,10 +132,11 @@ void *generate_arm_error_info()
 }
 
 //Generates a single pseudo-random ARM context info structure. Must be later freed.
-size_t generate_arm_context_info(void **location)
+size_t generate_arm_context_info(void **location,
+				 cper_generator_context *context)
 {
 	//Initial length is 8 bytes. Add extra based on type.
-	UINT16 reg_type = rand() % 9;
+	UINT16 reg_type = gen_rand(context) % 9;
 	UINT32 reg_size = 0;
 
 	//Set register size.
@@ -173,7 +185,8 @@ size_t generate_arm_context_info(void **location)
 
 	//Create context structure randomly.
 	int total_size = 8 + reg_size;
-	UINT16 *context_info = (UINT16 *)generate_random_bytes(total_size);
+	UINT16 *context_info =
+		(UINT16 *)generate_random_bytes(total_size, context);
 
 	//Set header information.
 	*(context_info + 1) = reg_type;
@@ -11,15 +11,16 @@
 
 //Generates a single pseudo-random CCIX PER error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_ccix_per(void **location)
+size_t generate_section_ccix_per(void **location,
+				 cper_generator_context *context)
 {
 	//Create a random length for the CCIX PER log.
 	//The log attached here does not necessarily conform to the CCIX specification, and is simply random.
-	int log_len = (rand() % 5 + 1) * 32;
+	int log_len = (gen_rand(context) % 5 + 1) * 32;
 
 	//Create random bytes.
 	int size = 16 + log_len;
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set reserved areas to zero.
 	UINT32 *validation = (UINT32 *)(bytes + 4);
@@ -5,21 +5,23 @@
  **/
 
 #include <stdlib.h>
+#include <string.h>
 #include "../../edk/BaseTypes.h"
 #include "../gen-utils.h"
 #include "gen-section.h"
 
 //Generates a single pseudo-random CXL component error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_cxl_component(void **location)
+size_t generate_section_cxl_component(void **location,
+				      cper_generator_context *context)
 {
 	//Create a random length for the CXL component event log.
 	//The logs attached here do not necessarily conform to the specification, and are simply random.
-	int log_len = rand() % 64;
+	int log_len = gen_rand(context) % 64;
 
 	//Create random bytes.
 	int size = 32 + log_len;
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set reserved areas to zero.
 	UINT32 *validation = (UINT32 *)(bytes + 4);
@@ -37,3 +39,94 @@ size_t generate_section_cxl_component(void **location)
 	*location = bytes;
 	return size;
 }
+
+//Generates a single pseudo-random CXL component error section carrying a CXL 2.0 event record
+//(header plus 0x50 bytes of record data, without the event record UUID). "clear_reserved" is
+//called on the event record to zero the reserved fields of the specific record layout.
+static size_t generate_cxl_component_event(void **location,
+					   void (*clear_reserved)(UINT8 *),
+					   cper_generator_context *context)
+{
+	//Create random bytes for the section header and event record.
+	int log_len = 0x70;
+	int size = 32 + log_len;
+	UINT8 *bytes = generate_random_bytes(size, context);
+
+	//Set reserved areas to zero.
+	UINT32 *validation = (UINT32 *)(bytes + 4);
+	*validation &= 0x7;
+	*(validation + 1) = 0;
+	UINT8 *slot_number = (UINT8 *)(bytes + 21);
+	*slot_number &= ~0x7; //Device ID slot number bits 0-2.
+	*(bytes + 23) = 0;    //Device ID byte 11.
+
+	//Event record header, event record flags bits 6-23 and bytes 0x11-0x1F are reserved.
+	UINT8 *record = bytes + 32;
+	*(record + 1) &= 0x3F;
+	*(record + 2) = 0;
+	*(record + 3) = 0;
+	memset(record + 0x11, 0, 0x0F);
+	clear_reserved(record);
+
+	//Set expected values.
+	UINT32 *length = (UINT32 *)bytes;
+	*length = size;
+
+	//Set return values, exit.
+	*location = bytes;
+	return size;
+}
+
+//Zeroes the reserved fields of a General Media event record.
+static void clear_general_media_reserved(UINT8 *record)
+{
+	*(record + 0x20) &= ~0x3C; //Physical address flags bits 2-5.
+	*(record + 0x28) &= 0x7;   //Memory event descriptor bits 3-7.
+	*(record + 0x2B) &= 0xF;   //Validity flags bits 4-15.
+	*(record + 0x2C) = 0;
+	memset(record + 0x42, 0, 0x2E);
+}
+
+//Zeroes the reserved fields of a DRAM event record.
+static void clear_dram_reserved(UINT8 *record)
+{
+	*(record + 0x20) &= ~0x3C; //Physical address flags bits 2-5.
+	*(record + 0x28) &= 0x7;   //Memory event descriptor bits 3-7.
+	*(record + 0x2C) = 0;	   //Validity flags bits 8-15.
+	memset(record + 0x59, 0, 0x17);
+}
+
+//Zeroes the reserved fields of a Memory Module event record.
+static void clear_memory_module_reserved(UINT8 *record)
+{
+	*(record + 0x21) &= 0x7;  //Health status bits 3-7.
+	*(record + 0x23) &= 0x3F; //Additional status bits 6-7.
+	memset(record + 0x33, 0, 0x3D);
+}
+
+//Generates a single pseudo-random CXL General Media component error section, saving the resulting
+//address to the given location. Returns the size of the newly created section.
+size_t generate_section_cxl_general_media(void **location,
+					  cper_generator_context *context)
+{
+	return generate_cxl_component_event(
+		location, clear_general_media_reserved, context);
+}
+
+//Generates a single pseudo-random CXL DRAM component error section, saving the resulting address
+//to the given location. Returns the size of the newly created section.
+size_t generate_section_cxl_dram(void **location,
+				 cper_generator_context *context)
+{
+	return generate_cxl_component_event(location, clear_dram_reserved,
+					    context);
+}
+
+//Generates a single pseudo-random CXL Memory Module component error section, saving the resulting
+//address to the given location. Returns the size of the newly created section.
+size_t generate_section_cxl_memory_module(void **location,
+					  cper_generator_context *context)
+{
+	return generate_cxl_component_event(
+		location, clear_memory_module_reserved, context);
+}
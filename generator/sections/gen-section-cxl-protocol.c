@@ -11,19 +11,20 @@
 
 //Generates a single pseudo-random CXL protocol error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_cxl_protocol(void **location)
+size_t generate_section_cxl_protocol(void **location,
+				     cper_generator_context *context)
 {
 	//Create a random length for the CXL DVSEC and CXL error log.
 	//The logs attached here do not necessarily conform to the specification, and are simply random.
-	int dvsec_len = rand() % 64;
-	int error_log_len = rand() % 64;
+	int dvsec_len = gen_rand(context) % 64;
+	int error_log_len = gen_rand(context) % 64;
 
 	//Create random bytes.
 	int size = 116 + dvsec_len + error_log_len;
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set CXL agent type.
-	int cxl_agent_type = rand() % 2;
+	int cxl_agent_type = gen_rand(context) % 2;
 	*(bytes + 8) = cxl_agent_type;
 
 	//Set reserved areas to zero.
@@ -11,11 +11,12 @@
 
 //Generates a single pseudo-random generic DMAr error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_dmar_generic(void **location)
+size_t generate_section_dmar_generic(void **location,
+				     cper_generator_context *context)
 {
 	//Create random bytes.
 	int size = 32;
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set reserved areas to zero.
 	UINT64 *reserved = (UINT64 *)(bytes + 16);
@@ -23,10 +24,10 @@ size_t generate_section_dmar_generic(void **location)
 	*(reserved + 1) = 0;
 
 	//Set expected values.
-	*(bytes + 4) = rand() % 0xC;   //Fault reason.
-	*(bytes + 5) = rand() % 2;     //Access type.
-	*(bytes + 6) = rand() % 2;     //Address type.
-	*(bytes + 7) = rand() % 2 + 1; //Architecture type.
+	*(bytes + 4) = gen_rand(context) % 0xC;   //Fault reason.
+	*(bytes + 5) = gen_rand(context) % 2;     //Access type.
+	*(bytes + 6) = gen_rand(context) % 2;     //Address type.
+	*(bytes + 7) = gen_rand(context) % 2 + 1; //Architecture type.
 
 	//Set return values, exit.
 	*location = bytes;
@@ -35,11 +36,12 @@ size_t generate_section_dmar_generic(void **location)
 
 //Generates a single pseudo-random VT-d DMAr error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_dmar_vtd(void **location)
+size_t generate_section_dmar_vtd(void **location,
+				 cper_generator_context *context)
 {
 	//Create random bytes.
 	int size = 144;
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set reserved areas to zero.
 	for (int i = 0; i < 12; i++) {
@@ -59,11 +61,12 @@ size_t generate_section_dmar_vtd(void **location)
 
 //Generates a single pseudo-random IOMMU DMAr error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_dmar_iommu(void **location)
+size_t generate_section_dmar_iommu(void **location,
+				   cper_generator_context *context)
 {
 	//Create random bytes.
 	int size = 144;
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set reserved areas to zero.
 	for (int i = 0; i < 7; i++) {
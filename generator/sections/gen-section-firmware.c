@@ -11,11 +11,12 @@
 
 //Generates a single pseudo-random firmware error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_firmware(void **location)
+size_t generate_section_firmware(void **location,
+				 cper_generator_context *context)
 {
 	//Create random bytes.
 	int size = 32;
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set reserved areas to zero.
 	for (int i = 0; i < 6; i++) {
@@ -26,7 +27,7 @@ size_t generate_section_firmware(void **location)
 	*(bytes + 1) = 2;    //Revision, referenced version of spec is 2.
 	UINT64 *record_id = (UINT64 *)(bytes + 8);
 	*record_id = 0;	     //Record ID, should be forced to NULL.
-	*bytes = rand() % 3; //Record type.
+	*bytes = gen_rand(context) % 3; //Record type.
 
 	//Set return values, exit.
 	*location = bytes;
@@ -11,10 +11,11 @@
 
 //Generates a single pseudo-random generic processor section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_generic(void **location)
+size_t generate_section_generic(void **location,
+				cper_generator_context *context)
 {
 	//Create random bytes.
-	size_t size = generate_random_section(location, 192);
+	size_t size = generate_random_section(location, 192, context);
 
 	//Set reserved locations to zero.
 	UINT8 *start_byte = (UINT8 *)*location;
@@ -26,7 +27,7 @@ size_t generate_section_generic(void **location)
 	for (int i = 0; i < 128; i++) {
 		UINT8 *byte = start_byte + 24 + i;
 		if (*byte == 0x0) {
-			*byte = rand() % 127 + 1;
+			*byte = gen_rand(context) % 127 + 1;
 		}
 
 		//Null terminate last byte.
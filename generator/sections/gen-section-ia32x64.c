@@ -11,28 +11,30 @@
 #include "gen-section.h"
 #define IA32X64_ERROR_STRUCTURE_SIZE 64
 
-void *generate_ia32x64_error_structure();
-size_t generate_ia32x64_context_structure(void **location);
+void *generate_ia32x64_error_structure(cper_generator_context *context);
+size_t generate_ia32x64_context_structure(void **location,
+					  cper_generator_context *context);
 
 //Generates a single pseudo-random IA32/x64 section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_ia32x64(void **location)
+size_t generate_section_ia32x64(void **location,
+				cper_generator_context *context)
 {
 	//Set up for generation of error/context structures.
-	UINT16 error_structure_num = rand() % 4 + 1;
-	UINT16 context_structure_num = rand() % 4 + 1;
+	UINT16 error_structure_num = gen_rand(context) % 4 + 1;
+	UINT16 context_structure_num = gen_rand(context) % 4 + 1;
 	void *error_structures[error_structure_num];
 	void *context_structures[context_structure_num];
 	size_t context_structure_lengths[context_structure_num];
 
 	//Generate the structures.
 	for (int i = 0; i < error_structure_num; i++) {
-		error_structures[i] = generate_ia32x64_error_structure();
+		error_structures[i] = generate_ia32x64_error_structure(context);
 	}
 	for (int i = 0; i < context_structure_num; i++) {
 		context_structure_lengths[i] =
-			generate_ia32x64_context_structure(context_structures +
-							   i);
+			generate_ia32x64_context_structure(
+				context_structures + i, context);
 	}
 
 	//Create a valid IA32/x64 section.
@@ -41,7 +43,7 @@ size_t generate_section_ia32x64(void **location)
 	for (int i = 0; i < context_structure_num; i++) {
 		total_len += context_structure_lengths[i];
 	}
-	UINT8 *section = generate_random_bytes(total_len);
+	UINT8 *section = generate_random_bytes(total_len, context);
 
 	//Null extend the end of the CPUID in the header.
 	for (int i = 0; i < 16; i++) {
@@ -59,13 +61,13 @@ size_t generate_section_ia32x64(void **location)
 	for (int i = 0; i < error_structure_num; i++) {
 		memcpy(cur_pos, error_structures[i],
 		       IA32X64_ERROR_STRUCTURE_SIZE);
-		free(error_structures[i]);
+		gen_free(error_structures[i]);
 		cur_pos += IA32X64_ERROR_STRUCTURE_SIZE;
 	}
 	for (int i = 0; i < context_structure_num; i++) {
 		memcpy(cur_pos, context_structures[i],
 		       context_structure_lengths[i]);
-		free(context_structures[i]);
+		gen_free(context_structures[i]);
 		cur_pos += context_structure_lengths[i];
 	}
 
@@ -75,10 +77,10 @@ size_t generate_section_ia32x64(void **location)
 }
 
 //Generates a single IA32/x64 error structure. Must later be freed.
-void *generate_ia32x64_error_structure()
+void *generate_ia32x64_error_structure(cper_generator_context *context)
 {
 	UINT8 *error_structure =
-		generate_random_bytes(IA32X64_ERROR_STRUCTURE_SIZE);
+		generate_random_bytes(IA32X64_ERROR_STRUCTURE_SIZE, context);
 
 	//Set error structure reserved space to zero.
 	UINT64 *validation = (UINT64 *)(error_structure + 16);
@@ -87,7 +89,7 @@ void *generate_ia32x64_error_structure()
 	//Create a random type of error structure.
 	EFI_GUID *guid = (EFI_GUID *)error_structure;
 	UINT64 *check_info = (UINT64 *)(error_structure + 24);
-	int error_structure_type = rand() % 4;
+	int error_structure_type = gen_rand(context) % 4;
 	switch (error_structure_type) {
 	//Cache
 	case 0:
@@ -134,10 +136,11 @@ void *generate_ia32x64_error_structure()
 }
 
 //Generates a single IA32/x64 context structure. Must later be freed.
-size_t generate_ia32x64_context_structure(void **location)
+size_t generate_ia32x64_context_structure(void **location,
+					  cper_generator_context *context)
 {
 	//Initial length is 16 bytes. Add extra based on type.
-	int reg_type = rand() % 8;
+	int reg_type = gen_rand(context) % 8;
 	int reg_size = 0;
 
 	//Set register size.
@@ -146,12 +149,13 @@ size_t generate_ia32x64_context_structure(void **location)
 	} else if (reg_type == 3) {
 		reg_size = 244;			  //x64 registers.
 	} else {
-		reg_size = (rand() % 5 + 1) * 32; //Not table defined.
+		reg_size = (gen_rand(context) % 5 + 1) * 32; //Not table defined.
 	}
 
 	//Create structure randomly.
 	int total_size = 16 + reg_size;
-	UINT16 *context_structure = (UINT16 *)generate_random_bytes(total_size);
+	UINT16 *context_structure =
+		(UINT16 *)generate_random_bytes(total_size, context);
 
 	//If it is x64 registers, set reserved area accordingly.
 	if (reg_type == 3) {
@@ -11,11 +11,11 @@
 
 //Generates a single pseudo-random platform memory error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_memory(void **location)
+size_t generate_section_memory(void **location, cper_generator_context *context)
 {
 	//Create random bytes.
 	int size = 80;
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set reserved areas to zero.
 	UINT64 *validation = (UINT64 *)bytes;
@@ -23,10 +23,10 @@ size_t generate_section_memory(void **location)
 	*(bytes + 73) &= ~0x1C;	 //Extended bits 2-4
 
 	//Fix values that could be above range.
-	*(bytes + 72) = rand() % 16; //Memory error type
+	*(bytes + 72) = gen_rand(context) % 16; //Memory error type
 
 	//Fix error status.
-	create_valid_error_section(bytes + 8);
+	create_valid_error_section(bytes + 8, context);
 
 	//Set return values, exit.
 	*location = bytes;
@@ -35,11 +35,12 @@ size_t generate_section_memory(void **location)
 
 //Generates a single pseudo-random memory 2 error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_memory2(void **location)
+size_t generate_section_memory2(void **location,
+				cper_generator_context *context)
 {
 	//Create random bytes.
 	int size = 96;
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set reserved areas to zero.
 	UINT64 *validation = (UINT64 *)bytes;
@@ -47,11 +48,11 @@ size_t generate_section_memory2(void **location)
 	*(bytes + 63) = 0;	 //Reserved byte 63
 
 	//Fix values that could be above range.
-	*(bytes + 61) = rand() % 16; //Memory error type
-	*(bytes + 62) = rand() % 2;  //Status
+	*(bytes + 61) = gen_rand(context) % 16; //Memory error type
+	*(bytes + 62) = gen_rand(context) % 2;  //Status
 
 	//Fix error status.
-	create_valid_error_section(bytes + 8);
+	create_valid_error_section(bytes + 8, context);
 
 	//Set return values, exit.
 	*location = bytes;
@@ -12,7 +12,7 @@
 
 //Generates a single pseudo-random NVIDIA error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_nvidia(void **location)
+size_t generate_section_nvidia(void **location, cper_generator_context *context)
 {
 	const char *signatures[] = {
 		"DCC-ECC",   "DCC-COH",	      "HSS-BUSY",      "HSS-IDLE",
@@ -23,18 +23,20 @@ size_t generate_section_nvidia(void **location)
 		"MCF",	     "GPU-STATUS",    "GPU-CONTNMT",   "SMMU",
 	};
 
-	init_random();
+	//Create random bytes, with room for the register address/value pairs that follow.
+	UINT8 number_regs = gen_rand(context) % 16;
+	size_t size = sizeof(EFI_NVIDIA_ERROR_DATA) +
+		      number_regs * sizeof(EFI_NVIDIA_REGISTER_DATA);
+	UINT8 *section = generate_random_bytes(size, context);
 
-	//Create random bytes.
-	size_t size = sizeof(EFI_NVIDIA_ERROR_DATA);
-	UINT8 *section = generate_random_bytes(size);
-
-	//Reserved byte.
+	//Reserved byte, register count.
 	EFI_NVIDIA_ERROR_DATA *nvidia_error = (EFI_NVIDIA_ERROR_DATA *)section;
 	nvidia_error->Reserved = 0;
+	nvidia_error->NumberRegs = number_regs;
 
 	//Signature.
-	int idx_random = rand() % (sizeof(signatures) / sizeof(signatures[0]));
+	int idx_random = gen_rand(context) %
+			 (sizeof(signatures) / sizeof(signatures[0]));
 	strncpy(nvidia_error->Signature, signatures[idx_random],
 		sizeof(nvidia_error->Signature) - 1);
 	nvidia_error->Signature[sizeof(nvidia_error->Signature) - 1] = '\0';
@@ -11,11 +11,12 @@
 
 //Generates a single pseudo-random PCI/PCI-X bus error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_pci_bus(void **location)
+size_t generate_section_pci_bus(void **location,
+				cper_generator_context *context)
 {
 	//Create random bytes.
 	int size = 72;
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set reserved areas to zero.
 	UINT64 *validation = (UINT64 *)bytes;
@@ -27,10 +28,10 @@ size_t generate_section_pci_bus(void **location)
 
 	//Fix values that could be above range.
 	UINT16 *error_type = (UINT16 *)(bytes + 16);
-	*error_type = rand() % 8;
+	*error_type = gen_rand(context) % 8;
 
 	//Fix error status.
-	create_valid_error_section(bytes + 8);
+	create_valid_error_section(bytes + 8, context);
 
 	//Set return values, exit.
 	*location = bytes;
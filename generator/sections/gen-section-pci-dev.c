@@ -11,16 +11,17 @@
 
 //Generates a single pseudo-random PCI component error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_pci_dev(void **location)
+size_t generate_section_pci_dev(void **location,
+				cper_generator_context *context)
 {
 	//Generate how many register pairs will be attached to this section.
-	UINT32 num_memory_pairs = rand() % 4;
-	UINT32 num_io_pairs = rand() % 4;
+	UINT32 num_memory_pairs = gen_rand(context) % 4;
+	UINT32 num_io_pairs = gen_rand(context) % 4;
 	UINT32 num_registers = num_memory_pairs + num_io_pairs;
 
 	//Create random bytes.
 	int size = 40 + (num_registers * 16);
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set reserved areas to zero.
 	UINT64 *validation = (UINT64 *)bytes;
@@ -36,7 +37,7 @@ size_t generate_section_pci_dev(void **location)
 	*io_number_field = num_io_pairs;
 
 	//Fix error status.
-	create_valid_error_section(bytes + 8);
+	create_valid_error_section(bytes + 8, context);
 
 	//Set return values, exit.
 	*location = bytes;
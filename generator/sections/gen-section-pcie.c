@@ -9,19 +9,15 @@
 #include "../gen-utils.h"
 #include "gen-section.h"
 
-#define PCIE_PORT_TYPES                                                        \
-	(int[])                                                                \
-	{                                                                      \
-		0, 1, 4, 5, 6, 7, 8, 9, 10                                     \
-	}
+static const int PCIE_PORT_TYPES[9] = { 0, 1, 4, 5, 6, 7, 8, 9, 10 };
 
 //Generates a single pseudo-random PCIe error section, saving the resulting address to the given
 //location. Returns the size of the newly created section.
-size_t generate_section_pcie(void **location)
+size_t generate_section_pcie(void **location, cper_generator_context *context)
 {
 	//Create random bytes.
 	int size = 208;
-	UINT8 *bytes = generate_random_bytes(size);
+	UINT8 *bytes = generate_random_bytes(size, context);
 
 	//Set reserved areas to zero.
 	UINT64 *validation = (UINT64 *)bytes;
@@ -34,14 +30,14 @@ size_t generate_section_pcie(void **location)
 	*(bytes + 39) = 0;     //Device ID byte 15
 
 	//Set expected values.
-	int minor = rand() % 128;
-	int major = rand() % 128;
+	int minor = gen_rand(context) % 128;
+	int major = gen_rand(context) % 128;
 	*version = int_to_bcd(minor);
 	*version |= int_to_bcd(major) << 8;
 
 	//Fix values that could be above range.
 	UINT32 *port_type = (UINT32 *)(bytes + 8);
-	*port_type = PCIE_PORT_TYPES[rand() %
+	*port_type = PCIE_PORT_TYPES[gen_rand(context) %
 				     (sizeof(PCIE_PORT_TYPES) / sizeof(int))];
 
 	//Set return values, exit.
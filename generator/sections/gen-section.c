@@ -31,11 +31,11 @@ CPER_GENERATOR_DEFINITION generator_definitions[] = {
 	{ &gEfiCxlProtocolErrorSectionGuid, "cxlprotocol",
 	  generate_section_cxl_protocol },
 	{ &gEfiCxlGeneralMediaErrorSectionGuid, "cxlcomponent-media",
-	  generate_section_cxl_component },
+	  generate_section_cxl_general_media },
 	{ &gEfiCxlDramEventErrorSectionGuid, "cxlcomponent-dram",
-	  generate_section_cxl_component },
+	  generate_section_cxl_dram },
 	{ &gEfiCxlMemoryModuleErrorSectionGuid, "cxlcomponent-memory",
-	  generate_section_cxl_component },
+	  generate_section_cxl_memory_module },
 	{ &gEfiCxlPhysicalSwitchErrorSectionGuid, "cxlcomponent-pswitch",
 	  generate_section_cxl_component },
 	{ &gEfiCxlVirtualSwitchErrorSectionGuid, "cxlcomponent-vswitch",
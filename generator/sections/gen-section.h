@@ -7,30 +7,56 @@ extern "C" {
 
 #include <stdlib.h>
 #include "../../edk/Cper.h"
+#include "../cper-generate.h"
 
 //Section generator function predefinitions.
-size_t generate_section_generic(void **location);
-size_t generate_section_ia32x64(void **location);
-size_t generate_section_arm(void **location);
-size_t generate_section_memory(void **location);
-size_t generate_section_memory2(void **location);
-size_t generate_section_pcie(void **location);
-size_t generate_section_pci_bus(void **location);
-size_t generate_section_pci_dev(void **location);
-size_t generate_section_firmware(void **location);
-size_t generate_section_dmar_generic(void **location);
-size_t generate_section_dmar_vtd(void **location);
-size_t generate_section_dmar_iommu(void **location);
-size_t generate_section_ccix_per(void **location);
-size_t generate_section_cxl_protocol(void **location);
-size_t generate_section_cxl_component(void **location);
-size_t generate_section_nvidia(void **location);
+size_t generate_section_generic(void **location,
+				cper_generator_context *context);
+size_t generate_section_ia32x64(void **location,
+				cper_generator_context *context);
+size_t generate_section_arm(void **location, cper_generator_context *context);
+size_t generate_section_memory(void **location,
+			       cper_generator_context *context);
+size_t generate_section_memory2(void **location,
+				cper_generator_context *context);
+size_t generate_section_pcie(void **location, cper_generator_context *context);
+size_t generate_section_pci_bus(void **location,
+				cper_generator_context *context);
+size_t generate_section_pci_dev(void **location,
+				cper_generator_context *context);
+size_t generate_section_firmware(void **location,
+				 cper_generator_context *context);
+size_t generate_section_dmar_generic(void **location,
+				     cper_generator_context *context);
+size_t generate_section_dmar_vtd(void **location,
+				 cper_generator_context *context);
+size_t generate_section_dmar_iommu(void **location,
+				   cper_generator_context *context);
+size_t generate_section_ccix_per(void **location,
+				 cper_generator_context *context);
+size_t generate_section_cxl_protocol(void **location,
+				     cper_generator_context *context);
+size_t generate_section_cxl_component(void **location,
+				      cper_generator_context *context);
+size_t generate_section_cxl_general_media(void **location,
+					  cper_generator_context *context);
+size_t generate_section_cxl_dram(void **location,
+				 cper_generator_context *context);
+size_t generate_section_cxl_memory_module(void **location,
+					  cper_generator_context *context);
+size_t generate_section_nvidia(void **location,
+			       cper_generator_context *context);
+
+//ARM error and context information structure generators. Must be later freed with gen_free().
+void *generate_arm_error_info(cper_generator_context *context);
+size_t generate_arm_context_info(void **location,
+				 cper_generator_context *context);
 
 //Definition structure for a single CPER section generator.
 typedef struct {
 	EFI_GUID *Guid;
 	const char *ShortName;
-	size_t (*Generate)(void **);
+	size_t (*Generate)(void **, cper_generator_context *);
 } CPER_GENERATOR_DEFINITION;
 
 extern CPER_GENERATOR_DEFINITION generator_definitions[];
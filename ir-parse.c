@@ -7,10 +7,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <json.h>
-#include "base64.h"
 #include "edk/Cper.h"
 #include "cper-parse.h"
 #include "cper-utils.h"
+#include "cper-metrics-internal.h"
 #include "sections/cper-section.h"
 
 //Private pre-declarations.
@@ -20,12 +20,15 @@ void ir_section_descriptor_to_cper(json_object *section_descriptor_ir,
 				   EFI_ERROR_SECTION_DESCRIPTOR *descriptor);
 void ir_section_to_cper(json_object *section,
 			EFI_ERROR_SECTION_DESCRIPTOR *descriptor, FILE *out);
+size_t ir_bytes_written(FILE *out, long start);
 
 //Converts the given JSON IR CPER representation into CPER binary format, piped to the provided file stream.
 //This function performs no validation of the IR against the CPER-JSON specification. To ensure a safe call,
 //use validate_schema() from json-schema.h before attempting to call this function.
 void ir_to_cper(json_object *ir, FILE *out)
 {
+	long start = ftell(out);
+
 	//Create the CPER header.
 	EFI_COMMON_ERROR_RECORD_HEADER *header =
 		(EFI_COMMON_ERROR_RECORD_HEADER *)calloc(
@@ -69,6 +72,7 @@ void ir_to_cper(json_object *ir, FILE *out)
 	for (int i = 0; i < amt_descriptors; i++) {
 		free(descriptors[i]);
 	}
+	cper_metrics_record_encoded(ir_bytes_written(out, start));
 }
 
 //Converts a CPER-JSON IR header to a CPER header structure.
@@ -78,12 +82,8 @@ void ir_header_to_cper(json_object *header_ir,
 	header->SignatureStart = 0x52455043; //CPER
 
 	//Revision.
-	json_object *revision = json_object_object_get(header_ir, "revision");
-	int minor =
-		json_object_get_int(json_object_object_get(revision, "minor"));
-	int major =
-		json_object_get_int(json_object_object_get(revision, "major"));
-	header->Revision = minor + (major << 8);
+	header->Revision =
+		ir_to_revision(json_object_object_get(header_ir, "revision"));
 
 	header->SignatureEnd = 0xFFFFFFFF;
 
@@ -147,9 +147,8 @@ void ir_header_to_cper(json_object *header_ir,
 		json_object_object_get(header_ir, "persistenceInfo"));
 
 	//Flags.
-	json_object *flags = json_object_object_get(header_ir, "flags");
-	header->Flags = (UINT32)json_object_get_uint64(
-		json_object_object_get(flags, "value"));
+	header->Flags = (UINT32)readable_pair_to_integer(
+		json_object_object_get(header_ir, "flags"));
 }
 
 //Converts a single given IR section into CPER, outputting to the given stream.
@@ -163,6 +162,7 @@ void ir_section_to_cper(json_object *section,
 			       &descriptor->SectionType) &&
 		    section_definitions[i].ToCPER != NULL) {
 			section_definitions[i].ToCPER(section, out);
+			cper_metrics_record_section_encoded(i);
 			section_converted = 1;
 			break;
 		}
@@ -170,16 +170,11 @@ void ir_section_to_cper(json_object *section,
 
 	//If unknown GUID, so read as a base64 unknown section.
 	if (!section_converted) {
-		json_object *encoded = json_object_object_get(section, "data");
-
+		cper_metrics_record_section_encoded(section_definitions_len);
 		int32_t decoded_len = 0;
-
-		UINT8 *decoded = base64_decode(
-			json_object_get_string(encoded),
-			json_object_get_string_len(encoded), &decoded_len);
-		if (decoded == NULL) {
-			printf("Failed to allocate decode output buffer. \n");
-		} else {
+		UINT8 *decoded = ir_to_base64_blob(
+			json_object_object_get(section, "data"), &decoded_len);
+		if (decoded != NULL) {
 			fwrite(decoded, decoded_len, 1, out);
 			fflush(out);
 			free(decoded);
@@ -198,13 +193,8 @@ void ir_section_descriptor_to_cper(json_object *section_descriptor_ir,
 		json_object_object_get(section_descriptor_ir, "sectionLength"));
 
 	//Revision.
-	json_object *revision =
-		json_object_object_get(section_descriptor_ir, "revision");
-	int minor =
-		json_object_get_int(json_object_object_get(revision, "minor"));
-	int major =
-		json_object_get_int(json_object_object_get(revision, "major"));
-	descriptor->Revision = minor + (major << 8);
+	descriptor->Revision = ir_to_revision(
+		json_object_object_get(section_descriptor_ir, "revision"));
 
 	//Validation bits, flags.
 	descriptor->SecValidMask = ir_to_bitfield(
@@ -248,6 +238,8 @@ void ir_section_descriptor_to_cper(json_object *section_descriptor_ir,
 //Converts IR for a given single section format CPER record into CPER binary.
 void ir_single_section_to_cper(json_object *ir, FILE *out)
 {
+	long start = ftell(out);
+
 	//Create & write a section descriptor to file.
 	EFI_ERROR_SECTION_DESCRIPTOR *section_descriptor =
 		(EFI_ERROR_SECTION_DESCRIPTOR *)calloc(
@@ -265,4 +257,16 @@ void ir_single_section_to_cper(json_object *ir, FILE *out)
 
 	//Free remaining resources.
 	free(section_descriptor);
+	cper_metrics_record_encoded(ir_bytes_written(out, start));
+}
+
+//Returns the number of bytes written to the given stream since the given position.
+//Streams that cannot report a position (such as pipes) count as zero bytes.
+size_t ir_bytes_written(FILE *out, long start)
+{
+	long end = ftell(out);
+	if (start < 0 || end < start) {
+		return 0;
+	}
+	return end - start;
 }
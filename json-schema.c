@@ -17,10 +17,13 @@
 
 //Field definitions.
 int json_validator_debug = 0;
+static _Thread_local int json_validator_compact = 0;
+static _Thread_local json_object *json_validator_root = NULL;
 
 //Private pre-definitions.
 int validate_field(const char *name, json_object *schema, json_object *object,
 		   char *error_message);
+int type_matches(const char *type, json_object *object);
 int validate_integer(const char *field_name, json_object *schema,
 		     json_object *object, char *error_message);
 int validate_string(const char *field_name, json_object *schema,
@@ -29,6 +32,7 @@ int validate_object(const char *field_name, json_object *schema,
 		    json_object *object, char *error_message);
 int validate_array(const char *field_name, json_object *schema,
 		   json_object *object, char *error_message);
+json_object *resolve_local_ref(const char *ref);
 void log_validator_error(char *error_message, const char *format, ...);
 void log_validator_debug(const char *format, ...);
 void log_validator_msg(const char *format, va_list args);
@@ -97,8 +101,11 @@ int validate_schema(json_object *schema, char *schema_directory,
 		return 0;
 	}
 
-	//Parse the top level structure appropriately.
+	//Parse the top level structure appropriately, resolving local references against this schema.
+	json_object *original_root = json_validator_root;
+	json_validator_root = schema;
 	int result = validate_field("parent", schema, object, error_message);
+	json_validator_root = original_root;
 
 	//Change back to original CWD.
 	if (chdir(original_cwd)) {
@@ -129,27 +136,65 @@ int validate_field(const char *field_name, json_object *schema,
 		log_validator_debug("$ref schema detected for field '%s'.",
 				    field_name);
 
-		//Attempt to load. If loading fails, report error.
+		//References within this schema, such as "#/$defs/name", are validated against in place.
 		const char *ref_path = json_object_get_string(ref_schema);
-		json_object *tmp = json_object_from_file(ref_path);
-		if (tmp == NULL) {
-			log_validator_error(
-				error_message,
-				"Failed to open referenced schema file '%s'.",
-				ref_path);
-			return -1;
-		}
-		json_object_put(tmp);
+		if (ref_path[0] == '#') {
+			json_object *ref = resolve_local_ref(ref_path);
+			if (ref == NULL) {
+				log_validator_error(
+					error_message,
+					"Failed to resolve local reference '%s'.",
+					ref_path);
+				return -1;
+			}
+			int ref_result = validate_field(field_name, ref, object,
+							error_message);
+			if (ref_result != 1) {
+				return ref_result;
+			}
+		} else {
+			//Attempt to load. If loading fails, report error.
+			json_object *tmp = json_object_from_file(ref_path);
+			if (tmp == NULL) {
+				log_validator_error(
+					error_message,
+					"Failed to open referenced schema file '%s'.",
+					ref_path);
+				return -1;
+			}
+			json_object_put(tmp);
 
-		log_validator_debug("loaded schema path '%s' for field '%s'.",
-				    ref_path, field_name);
+			log_validator_debug(
+				"loaded schema path '%s' for field '%s'.",
+				ref_path, field_name);
+		}
 	}
 
-	//Get the schema field type.
+	//Get the schema field type. This may be a single type, or an array of allowed types.
 	json_object *desired_field_type =
 		json_object_object_get(schema, "type");
-	if (desired_field_type == NULL ||
-	    !json_object_is_type(desired_field_type, json_type_string)) {
+	int type_matched = 0;
+	if (desired_field_type != NULL &&
+	    json_object_is_type(desired_field_type, json_type_array)) {
+		int len = json_object_array_length(desired_field_type);
+		for (int i = 0; i < len && !type_matched; i++) {
+			json_object *type =
+				json_object_array_get_idx(desired_field_type, i);
+			if (!json_object_is_type(type, json_type_string)) {
+				log_validator_error(
+					error_message,
+					"Desired field type array contains a non-string type for field '%s' (schema violation).",
+					field_name);
+				return -1;
+			}
+			type_matched = type_matches(
+				json_object_get_string(type), object);
+		}
+	} else if (desired_field_type != NULL &&
+		   json_object_is_type(desired_field_type, json_type_string)) {
+		type_matched = type_matches(
+			json_object_get_string(desired_field_type), object);
+	} else {
 		log_validator_error(
 			error_message,
 			"Desired field type not provided within schema/is not a string for field '%s' (schema violation).",
@@ -157,30 +202,30 @@ int validate_field(const char *field_name, json_object *schema,
 		return -1;
 	}
 
+	//In the compact profile, fields that CPER_IR_FLAG_COMPACT outputs as raw values also accept
+	//the type given by "compactType".
+	json_object *compact_type =
+		json_object_object_get(schema, "compactType");
+	if (!type_matched && json_validator_compact && compact_type != NULL &&
+	    json_object_is_type(compact_type, json_type_string)) {
+		type_matched = type_matches(
+			json_object_get_string(compact_type), object);
+	}
+
 	//Check the field types are actually equal.
-	const char *desired_field_type_str =
-		json_object_get_string(desired_field_type);
-	if (!((!strcmp(desired_field_type_str, "object") &&
-	       json_object_is_type(object, json_type_object)) ||
-	      (!strcmp(desired_field_type_str, "array") &&
-	       json_object_is_type(object, json_type_array)) ||
-	      (!strcmp(desired_field_type_str, "integer") &&
-	       json_object_is_type(object, json_type_int)) ||
-	      (!strcmp(desired_field_type_str, "string") &&
-	       json_object_is_type(object, json_type_string)) ||
-	      (!strcmp(desired_field_type_str, "boolean") &&
-	       json_object_is_type(object, json_type_boolean)) ||
-	      (!strcmp(desired_field_type_str, "double") &&
-	       json_object_is_type(object, json_type_double)))) {
+	if (!type_matched) {
 		log_validator_error(error_message,
 				    "Field type match failed for field '%s'.",
 				    field_name);
 		return 0;
 	}
 
-	//If the schema contains a "oneOf" array, we need to validate the field against each of the
-	//possible options in turn.
+	//If the schema contains a "oneOf" or "anyOf" array, we need to validate the field against each
+	//of the possible options in turn. Both accept the first option that matches.
 	json_object *one_of = json_object_object_get(schema, "oneOf");
+	if (one_of == NULL) {
+		one_of = json_object_object_get(schema, "anyOf");
+	}
 	if (one_of != NULL && json_object_get_type(one_of) == json_type_array) {
 		log_validator_debug("oneOf options detected for field '%s'.",
 				    field_name);
@@ -245,6 +290,23 @@ int validate_field(const char *field_name, json_object *schema,
 	}
 }
 
+//Returns whether the given object is of the given schema type name.
+int type_matches(const char *type, json_object *object)
+{
+	return (!strcmp(type, "object") &&
+		json_object_is_type(object, json_type_object)) ||
+	       (!strcmp(type, "array") &&
+		json_object_is_type(object, json_type_array)) ||
+	       (!strcmp(type, "integer") &&
+		json_object_is_type(object, json_type_int)) ||
+	       (!strcmp(type, "string") &&
+		json_object_is_type(object, json_type_string)) ||
+	       (!strcmp(type, "boolean") &&
+		json_object_is_type(object, json_type_boolean)) ||
+	       (!strcmp(type, "double") &&
+		json_object_is_type(object, json_type_double));
+}
+
 //Validates a single integer value according to the given specification.
 int validate_integer(const char *field_name, json_object *schema,
 		     json_object *object, char *error_message)
@@ -393,12 +455,44 @@ int validate_object(const char *field_name, json_object *schema,
 int validate_array(const char *field_name, json_object *schema,
 		   json_object *object, char *error_message)
 {
-	//Iterate all items in the array, and validate according to the "items" schema.
+	//Check the array length is within any bounds given.
+	int array_len = json_object_array_length(object);
+	json_object *min_items = json_object_object_get(schema, "minItems");
+	json_object *max_items = json_object_object_get(schema, "maxItems");
+	if ((min_items != NULL &&
+	     array_len < json_object_get_int(min_items)) ||
+	    (max_items != NULL &&
+	     array_len > json_object_get_int(max_items))) {
+		log_validator_error(
+			error_message,
+			"Array length %d of field '%s' is out of the allowed bounds.",
+			array_len, field_name);
+		return 0;
+	}
+
+	//Validate leading items against their own "prefixItems" schema.
+	json_object *prefix_items =
+		json_object_object_get(schema, "prefixItems");
+	int prefix_len = 0;
+	if (prefix_items != NULL &&
+	    json_object_is_type(prefix_items, json_type_array)) {
+		prefix_len = json_object_array_length(prefix_items);
+		for (int i = 0; i < prefix_len && i < array_len; i++) {
+			if (!validate_field(
+				    field_name,
+				    json_object_array_get_idx(prefix_items, i),
+				    json_object_array_get_idx(object, i),
+				    error_message)) {
+				return 0;
+			}
+		}
+	}
+
+	//Iterate the remaining items in the array, and validate according to the "items" schema.
 	json_object *items_schema = json_object_object_get(schema, "items");
 	if (items_schema != NULL &&
 	    json_object_get_type(items_schema) == json_type_object) {
-		int array_len = json_object_array_length(object);
-		for (int i = 0; i < array_len; i++) {
+		for (int i = prefix_len; i < array_len; i++) {
 			if (!validate_field(field_name, items_schema,
 					    json_object_array_get_idx(object,
 								      i),
@@ -411,6 +505,38 @@ int validate_array(const char *field_name, json_object *schema,
 	return 1;
 }
 
+//Resolves a local reference such as "#/$defs/name" against the schema being validated.
+//Returns NULL if the reference does not resolve.
+json_object *resolve_local_ref(const char *ref)
+{
+	json_object *result = json_validator_root;
+	const char *pos = ref + 1;
+	char key[PATH_MAX];
+	while (result != NULL && *pos == '/') {
+		pos++;
+		size_t len = strcspn(pos, "/");
+		if (len >= sizeof(key)) {
+			return NULL;
+		}
+		memcpy(key, pos, len);
+		key[len] = '\0';
+		result = json_object_object_get(result, key);
+		pos += len;
+	}
+	return *pos == '\0' ? result : NULL;
+}
+
+//Enables/disables the compact profile for the JSON validator on the calling thread, under which
+//fields marked with "compactType" also accept the compact IR form.
+void validate_schema_compact_enable()
+{
+	json_validator_compact = 1;
+}
+void validate_schema_compact_disable()
+{
+	json_validator_compact = 0;
+}
+
 //Enables/disables debugging globally for the JSON validator.
 void validate_schema_debug_enable()
 {
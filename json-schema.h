@@ -14,6 +14,8 @@ int validate_schema(json_object *schema, char *schema_directory,
 		    json_object *object, char *error_message);
 int validate_schema_from_file(const char *schema_file, json_object *object,
 			      char *error_message);
+void validate_schema_compact_enable();
+void validate_schema_compact_disable();
 void validate_schema_debug_enable();
 void validate_schema_debug_disable();
 
@@ -7,11 +7,116 @@
 
 #include <stdio.h>
 #include <json.h>
-#include "base64.h"
 #include "../edk/Cper.h"
 #include "../cper-utils.h"
 #include "cper-section-arm.h"
 
+const char *const ARM_ERROR_VALID_BITFIELD_NAMES[4] = {
+	"mpidrValid", "errorAffinityLevelValid", "runningStateValid",
+	"vendorSpecificInfoValid"
+};
+const char *const ARM_ERROR_INFO_ENTRY_VALID_BITFIELD_NAMES[5] = {
+	"multipleErrorValid", "flagsValid", "errorInformationValid",
+	"virtualFaultAddressValid", "physicalFaultAddressValid"
+};
+const char *const ARM_ERROR_INFO_ENTRY_FLAGS_NAMES[4] = {
+	"firstErrorCaptured", "lastErrorCaptured", "propagated", "overflow"
+};
+const char *const ARM_CACHE_TLB_ERROR_VALID_BITFIELD_NAMES[7] = {
+	"transactionTypeValid", "operationValid", "levelValid",
+	"processorContextCorruptValid", "correctedValid", "precisePCValid",
+	"restartablePCValid"
+};
+const char *const ARM_BUS_ERROR_VALID_BITFIELD_NAMES[12] = {
+	"transactionTypeValid", "operationValid", "levelValid",
+	"processorContextCorruptValid", "correctedValid", "precisePCValid",
+	"restartablePCValid", "participationTypeValid", "timedOutValid",
+	"addressSpaceValid", "memoryAttributesValid", "accessModeValid"
+};
+const int ARM_ERROR_TRANSACTION_TYPES_KEYS[3] = { 0, 1, 2 };
+const char *const ARM_ERROR_TRANSACTION_TYPES_VALUES[3] = {
+	"Instruction", "Data Access", "Generic"
+};
+const int ARM_ERROR_INFO_ENTRY_INFO_TYPES_KEYS[4] = { 0, 1, 2, 3 };
+const char *const ARM_ERROR_INFO_ENTRY_INFO_TYPES_VALUES[4] = {
+	"Cache Error", "TLB Error", "Bus Error", "Micro-Architectural Error"
+};
+const int ARM_CACHE_BUS_OPERATION_TYPES_KEYS[11] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10
+};
+const char *const ARM_CACHE_BUS_OPERATION_TYPES_VALUES[11] = {
+	"Generic Error", "Generic Read", "Generic Write", "Data Read",
+	"Data Write", "Instruction Fetch", "Prefetch", "Eviction", "Snooping",
+	"Snooped", "Management"
+};
+const int ARM_TLB_OPERATION_TYPES_KEYS[9] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+const char *const ARM_TLB_OPERATION_TYPES_VALUES[9] = {
+	"Generic Error", "Generic Read", "Generic Write", "Data Read",
+	"Data Write", "Instruction Fetch", "Prefetch",
+	"Local Management Operation", "External Management Operation"
+};
+const int ARM_BUS_PARTICIPATION_TYPES_KEYS[4] = { 0, 1, 2, 3 };
+const char *const ARM_BUS_PARTICIPATION_TYPES_VALUES[4] = {
+	"Local Processor Originated Request",
+	"Local Processor Responded to Request", "Local Processor Observed",
+	"Generic"
+};
+const int ARM_BUS_ADDRESS_SPACE_TYPES_KEYS[3] = { 0, 1, 3 };
+const char *const ARM_BUS_ADDRESS_SPACE_TYPES_VALUES[3] = {
+	"External Memory Access", "Internal Memory Access",
+	"Device Memory Access"
+};
+const int ARM_PROCESSOR_INFO_REGISTER_CONTEXT_TYPES_KEYS[9] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8
+};
+const char *const ARM_PROCESSOR_INFO_REGISTER_CONTEXT_TYPES_VALUES[9] = {
+	"AArch32 General Purpose Registers", "AArch32 EL1 Context Registers",
+	"AArch32 EL2 Context Registers", "AArch32 Secure Context Registers",
+	"AArch64 General Purpose Registers", "AArch64 EL1 Context Registers",
+	"AArch64 EL2 Context Registers", "AArch64 EL3 Context Registers",
+	"Miscellaneous System Register Structure"
+};
+const char *const ARM_AARCH32_GPR_NAMES[16] = { "r0", "r1", "r2", "r3", "r4",
+						"r5", "r6", "r7", "r8", "r9",
+						"r10", "r11", "r12", "r13_sp",
+						"r14_lr", "r15_pc" };
+const char *const ARM_AARCH32_EL1_REGISTER_NAMES[24] = {
+	"dfar", "dfsr", "ifar", "isr", "mair0", "mair1", "midr", "mpidr",
+	"nmrr", "prrr", "sctlr_ns", "spsr", "spsr_abt", "spsr_fiq", "spsr_irq",
+	"spsr_svc", "spsr_und", "tpidrprw", "tpidruro", "tpidrurw", "ttbcr",
+	"ttbr0", "ttbr1", "dacr"
+};
+const char *const ARM_AARCH32_EL2_REGISTER_NAMES[16] = {
+	"elr_hyp", "hamair0", "hamair1", "hcr", "hcr2", "hdfar", "hifar",
+	"hpfar", "hsr", "htcr", "htpidr", "httbr", "spsr_hyp", "vtcr", "vttbr",
+	"dacr32_el2"
+};
+const char *const ARM_AARCH32_SECURE_REGISTER_NAMES[2] = {
+	"sctlr_s", "spsr_mon"
+};
+const char *const ARM_AARCH64_GPR_NAMES[32] = { "x0", "x1", "x2", "x3", "x4",
+						"x5", "x6", "x7", "x8", "x9",
+						"x10", "x11", "x12", "x13",
+						"x14", "x15", "x16", "x17",
+						"x18", "x19", "x20", "x21",
+						"x22", "x23", "x24", "x25",
+						"x26", "x27", "x28", "x29",
+						"x30", "sp" };
+const char *const ARM_AARCH64_EL1_REGISTER_NAMES[17] = {
+	"elr_el1", "esr_el1", "far_el1", "isr_el1", "mair_el1", "midr_el1",
+	"mpidr_el1", "sctlr_el1", "sp_el0", "sp_el1", "spsr_el1", "tcr_el1",
+	"tpidr_el0", "tpidr_el1", "tpidrro_el0", "ttbr0_el1", "ttbr1_el1"
+};
+const char *const ARM_AARCH64_EL2_REGISTER_NAMES[15] = {
+	"elr_el2", "esr_el2", "far_el2", "hacr_el2", "hcr_el2", "hpfar_el2",
+	"mair_el2", "sctlr_el2", "sp_el2", "spsr_el2", "tcr_el2", "tpidr_el2",
+	"ttbr0_el2", "vtcr_el2", "vttbr_el2"
+};
+const char *const ARM_AARCH64_EL3_REGISTER_NAMES[10] = {
+	"elr_el3", "esr_el3", "far_el3", "mair_el3", "sctlr_el3", "sp_el3",
+	"spsr_el3", "tcr_el3", "tpidr_el3", "ttbr0_el3"
+};
+
 //Private pre-definitions.
 json_object *
 cper_arm_error_info_to_ir(EFI_ARM_ERROR_INFORMATION_ENTRY *error_info);
@@ -121,16 +226,11 @@ json_object *cper_section_arm_to_ir(void *section)
 		json_object *vendor_specific = json_object_new_object();
 		size_t input_size =
 			(uint8_t *)section + record->SectionLength - cur_pos;
-		int32_t encoded_len = 0;
-		char *encoded =
-			base64_encode(cur_pos, input_size, &encoded_len);
-		if (encoded == NULL) {
+		json_object *data = base64_blob_to_ir(cur_pos, input_size);
+		if (data == NULL) {
 			return NULL;
 		}
-		json_object_object_add(vendor_specific, "data",
-				       json_object_new_string_len(encoded,
-								  encoded_len));
-		free(encoded);
+		json_object_object_add(vendor_specific, "data", data);
 
 		json_object_object_add(section_ir, "vendorSpecificInfo",
 				       vendor_specific);
@@ -380,77 +480,71 @@ cper_arm_processor_context_to_ir(EFI_ARM_CONTEXT_INFORMATION_HEADER *header,
 	switch (header->RegisterContextType) {
 	case EFI_ARM_CONTEXT_TYPE_AARCH32_GPR:
 		register_array = uniform_struct_to_ir(
-			(UINT32 *)cur_pos,
+			(UINT32 *)*cur_pos,
 			sizeof(EFI_ARM_V8_AARCH32_GPR) / sizeof(UINT32),
 			ARM_AARCH32_GPR_NAMES);
 		break;
 	case EFI_ARM_CONTEXT_TYPE_AARCH32_EL1:
 		register_array = uniform_struct_to_ir(
-			(UINT32 *)cur_pos,
+			(UINT32 *)*cur_pos,
 			sizeof(EFI_ARM_AARCH32_EL1_CONTEXT_REGISTERS) /
 				sizeof(UINT32),
 			ARM_AARCH32_EL1_REGISTER_NAMES);
 		break;
 	case EFI_ARM_CONTEXT_TYPE_AARCH32_EL2:
 		register_array = uniform_struct_to_ir(
-			(UINT32 *)cur_pos,
+			(UINT32 *)*cur_pos,
 			sizeof(EFI_ARM_AARCH32_EL2_CONTEXT_REGISTERS) /
 				sizeof(UINT32),
 			ARM_AARCH32_EL2_REGISTER_NAMES);
 		break;
 	case EFI_ARM_CONTEXT_TYPE_AARCH32_SECURE:
 		register_array = uniform_struct_to_ir(
-			(UINT32 *)cur_pos,
+			(UINT32 *)*cur_pos,
 			sizeof(EFI_ARM_AARCH32_SECURE_CONTEXT_REGISTERS) /
 				sizeof(UINT32),
 			ARM_AARCH32_SECURE_REGISTER_NAMES);
 		break;
 	case EFI_ARM_CONTEXT_TYPE_AARCH64_GPR:
 		register_array = uniform_struct64_to_ir(
-			(UINT64 *)cur_pos,
+			(UINT64 *)*cur_pos,
 			sizeof(EFI_ARM_V8_AARCH64_GPR) / sizeof(UINT64),
 			ARM_AARCH64_GPR_NAMES);
 		break;
 	case EFI_ARM_CONTEXT_TYPE_AARCH64_EL1:
 		register_array = uniform_struct64_to_ir(
-			(UINT64 *)cur_pos,
+			(UINT64 *)*cur_pos,
 			sizeof(EFI_ARM_AARCH64_EL1_CONTEXT_REGISTERS) /
 				sizeof(UINT64),
 			ARM_AARCH64_EL1_REGISTER_NAMES);
 		break;
 	case EFI_ARM_CONTEXT_TYPE_AARCH64_EL2:
 		register_array = uniform_struct64_to_ir(
-			(UINT64 *)cur_pos,
+			(UINT64 *)*cur_pos,
 			sizeof(EFI_ARM_AARCH64_EL2_CONTEXT_REGISTERS) /
 				sizeof(UINT64),
 			ARM_AARCH64_EL2_REGISTER_NAMES);
 		break;
 	case EFI_ARM_CONTEXT_TYPE_AARCH64_EL3:
 		register_array = uniform_struct64_to_ir(
-			(UINT64 *)cur_pos,
+			(UINT64 *)*cur_pos,
 			sizeof(EFI_ARM_AARCH64_EL3_CONTEXT_REGISTERS) /
 				sizeof(UINT64),
 			ARM_AARCH64_EL3_REGISTER_NAMES);
 		break;
 	case EFI_ARM_CONTEXT_TYPE_MISC:
 		register_array = cper_arm_misc_register_array_to_ir(
-			(EFI_ARM_MISC_CONTEXT_REGISTER *)cur_pos);
+			(EFI_ARM_MISC_CONTEXT_REGISTER *)*cur_pos);
 		break;
 	default:
 		//Unknown register array type, add as base64 data instead.
 		register_array = json_object_new_object();
-		int32_t encoded_len = 0;
-		char *encoded = base64_encode((UINT8 *)cur_pos,
-					      header->RegisterArraySize,
-					      &encoded_len);
-		if (encoded == NULL) {
-			printf("Failed to allocate encode output buffer. \n");
+		json_object *data = base64_blob_to_ir(
+			(UINT8 *)*cur_pos, header->RegisterArraySize);
+		if (data == NULL) {
 			return NULL;
 		}
-		json_object_object_add(register_array, "data",
-				       json_object_new_string_len(encoded,
-								  encoded_len));
-		free(encoded);
+		json_object_object_add(register_array, "data", data);
 
 		break;
 	}
@@ -543,21 +637,17 @@ void ir_section_arm_to_cper(json_object *section, FILE *out)
 	json_object *vendor_specific_info =
 		json_object_object_get(section, "vendorSpecificInfo");
 	if (vendor_specific_info != NULL) {
-		json_object *vendor_info_string =
-			json_object_object_get(vendor_specific_info, "data");
-		int vendor_specific_len =
-			json_object_get_string_len(vendor_info_string);
-
 		int32_t decoded_len = 0;
-
-		UINT8 *decoded = base64_decode(
-			json_object_get_string(vendor_info_string),
-			vendor_specific_len, &decoded_len);
+		UINT8 *decoded = ir_to_base64_blob(
+			json_object_object_get(vendor_specific_info, "data"),
+			&decoded_len);
 
 		//Write out to file.
-		fwrite(decoded, decoded_len, 1, out);
-		fflush(out);
-		free(decoded);
+		if (decoded != NULL) {
+			fwrite(decoded, decoded_len, 1, out);
+			fflush(out);
+			free(decoded);
+		}
 	}
 
 	//Free remaining resources.
@@ -897,19 +987,12 @@ void ir_arm_misc_registers_to_cper(json_object *registers, FILE *out)
 void ir_arm_unknown_register_to_cper(json_object *registers, FILE *out)
 {
 	//Get base64 represented data.
-	json_object *encoded = json_object_object_get(registers, "data");
-
 	int32_t decoded_len = 0;
-
-	UINT8 *decoded = base64_decode(json_object_get_string(encoded),
-				       json_object_get_string_len(encoded),
-				       &decoded_len);
-
-	if (decoded == NULL) {
-		printf("Failed to allocate decode output buffer. \n");
-	} else {
+	UINT8 *decoded = ir_to_base64_blob(
+		json_object_object_get(registers, "data"), &decoded_len);
+	if (decoded != NULL) {
 		//Flush out to stream.
-		fwrite(&decoded, decoded_len, 1, out);
+		fwrite(decoded, decoded_len, 1, out);
 		fflush(out);
 		free(decoded);
 	}
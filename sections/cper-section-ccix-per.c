@@ -7,11 +7,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <json.h>
-#include "base64.h"
 #include "../edk/Cper.h"
 #include "../cper-utils.h"
 #include "cper-section-ccix-per.h"
 
+const char *const CCIX_PER_ERROR_VALID_BITFIELD_NAMES[3] = {
+	"ccixSourceIDValid", "ccixPortIDValid", "ccixPERLogValid"
+};
+
 //Converts a single CCIX PER log CPER section into JSON IR.
 json_object *cper_section_ccix_per_to_ir(void *section)
 {
@@ -39,17 +42,11 @@ json_object *cper_section_ccix_per_to_ir(void *section)
 	int remaining_length =
 		ccix_error->Length - sizeof(EFI_CCIX_PER_LOG_DATA);
 	if (remaining_length > 0) {
-		int32_t encoded_len = 0;
-
-		char *encoded = base64_encode((UINT8 *)cur_pos,
-					      remaining_length, &encoded_len);
-		if (encoded == NULL) {
-			printf("Failed to allocate encode output buffer. \n");
-		} else {
+		json_object *per_log =
+			base64_blob_to_ir((UINT8 *)cur_pos, remaining_length);
+		if (per_log != NULL) {
 			json_object_object_add(section_ir, "ccixPERLog",
-					       json_object_new_string_len(
-						       encoded, encoded_len));
-			free(encoded);
+					       per_log);
 		}
 	}
 
@@ -82,15 +79,10 @@ void ir_section_ccix_per_to_cper(json_object *section, FILE *out)
 	fflush(out);
 
 	//Write CCIX PER log itself to stream.
-	json_object *encoded = json_object_object_get(section, "ccixPERLog");
 	int32_t decoded_len = 0;
-
-	UINT8 *decoded = base64_decode(json_object_get_string(encoded),
-				       json_object_get_string_len(encoded),
-				       &decoded_len);
-	if (decoded == NULL) {
-		printf("Failed to allocate decode output buffer. \n");
-	} else {
+	UINT8 *decoded = ir_to_base64_blob(
+		json_object_object_get(section, "ccixPERLog"), &decoded_len);
+	if (decoded != NULL) {
 		fwrite(decoded, decoded_len, 1, out);
 		fflush(out);
 		free(decoded);
@@ -8,16 +8,12 @@ extern "C" {
 #include <json.h>
 #include "../edk/Cper.h"
 
-#define CCIX_PER_ERROR_VALID_BITFIELD_NAMES                                    \
-	(const char *[])                                                       \
-	{                                                                      \
-		"ccixSourceIDValid", "ccixPortIDValid", "ccixPERLogValid"      \
-	}
+extern const char *const CCIX_PER_ERROR_VALID_BITFIELD_NAMES[3];
 
 ///
 /// CCIX PER Log Error Section
 ///
-typedef struct {
+typedef struct EFI_CCIX_PER_LOG_DATA {
 	UINT32 Length;
 	UINT64 ValidBits;
 	UINT8 CcixSourceId;
@@ -5,14 +5,130 @@
  * Author: Lawrence.Tang@arm.com
  **/
 #include <stdio.h>
+#include <string.h>
 #include <json.h>
-#include "base64.h"
 #include "../edk/Cper.h"
 #include "../cper-utils.h"
 #include "cper-section-cxl-component.h"
 
-//Converts a single CXL component error CPER section into JSON IR.
+const char *const CXL_COMPONENT_ERROR_VALID_BITFIELD_NAMES[3] = {
+	"deviceIDValid", "deviceSerialValid", "cxlComponentEventLogValid"
+};
+const int CXL_EVENT_RECORD_SEVERITY_KEYS[4] = { 0, 1, 2, 3 };
+const char *const CXL_EVENT_RECORD_SEVERITY_VALUES[4] = {
+	"Informational", "Warning", "Failure", "Fatal"
+};
+const char *const CXL_EVENT_RECORD_FLAGS_BITFIELD_NAMES[4] = {
+	"permanentCondition", "maintenanceNeeded", "performanceDegraded",
+	"hardwareReplacementNeeded"
+};
+const char *const CXL_PHYSICAL_ADDRESS_FLAGS_BITFIELD_NAMES[2] = {
+	"volatile", "notRepairable"
+};
+const char *const CXL_MEMORY_EVENT_DESCRIPTOR_BITFIELD_NAMES[3] = {
+	"uncorrectableEvent", "thresholdEvent", "poisonListOverflowEvent"
+};
+const int CXL_MEMORY_EVENT_TYPES_KEYS[3] = { 0, 1, 2 };
+const char *const CXL_MEMORY_EVENT_TYPES_VALUES[3] = {
+	"Media ECC Error", "Invalid Address", "Data Path Error"
+};
+const int CXL_TRANSACTION_TYPES_KEYS[7] = { 0, 1, 2, 3, 4, 5, 6 };
+const char *const CXL_TRANSACTION_TYPES_VALUES[7] = {
+	"Unknown/Unreported", "Host Read", "Host Write", "Host Scan Media",
+	"Host Inject Poison", "Internal Media Scrub",
+	"Internal Media Management"
+};
+const char *const CXL_GENERAL_MEDIA_VALID_BITFIELD_NAMES[4] = {
+	"channelValid", "rankValid", "deviceValid", "componentIdentifierValid"
+};
+const char *const CXL_DRAM_VALID_BITFIELD_NAMES[8] = {
+	"channelValid", "rankValid", "nibbleMaskValid", "bankGroupValid",
+	"bankValid", "rowValid", "columnValid", "correctionMaskValid"
+};
+const int CXL_DEVICE_EVENT_TYPES_KEYS[6] = { 0, 1, 2, 3, 4, 5 };
+const char *const CXL_DEVICE_EVENT_TYPES_VALUES[6] = {
+	"Health Status Change", "Media Status Change", "Life Used Change",
+	"Temperature Change", "Data Path Error", "LSA Error"
+};
+const char *const CXL_HEALTH_STATUS_BITFIELD_NAMES[3] = {
+	"maintenanceNeeded", "performanceDegraded", "hardwareReplacementNeeded"
+};
+const int CXL_MEDIA_STATUS_KEYS[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+const char *const CXL_MEDIA_STATUS_VALUES[10] = {
+	"Normal", "Not Ready", "Write Persistency Lost", "All Data Lost",
+	"Write Persistency Loss in Event of Power Loss",
+	"Write Persistency Loss in Event of Shutdown",
+	"Write Persistency Loss Imminent",
+	"All Data Loss in Event of Power Loss",
+	"All Data Loss in Event of Shutdown", "All Data Loss Imminent"
+};
+const int CXL_HEALTH_LEVEL_KEYS[3] = { 0, 1, 2 };
+const char *const CXL_HEALTH_LEVEL_VALUES[3] = { "Normal", "Warning",
+						 "Critical" };
+const char *const CXL_ERROR_COUNT_WARNING_BITFIELD_NAMES[2] = {
+	"correctedVolatileErrorCount", "correctedPersistentErrorCount"
+};
+
+//Event record layouts decoded into typed fields, selected by section type.
+#define CXL_EVENT_RECORD_RAW	       0
+#define CXL_EVENT_RECORD_GENERAL_MEDIA 1
+#define CXL_EVENT_RECORD_DRAM	       2
+#define CXL_EVENT_RECORD_MEMORY_MODULE 3
+
+//Private pre-definitions.
+static json_object *cxl_component_to_ir(void *section, int record_type);
+static int cxl_event_record_known(const UINT8 *record, int len,
+				  int record_type);
+static int cxl_bytes_zero(const UINT8 *bytes, size_t len);
+static UINT32 cxl_uint24(const UINT8 *bytes);
+static void cxl_set_uint24(UINT8 *bytes, UINT32 value);
+static json_object *
+cxl_event_record_header_to_ir(const EFI_CXL_EVENT_RECORD_HEADER *header);
+static json_object *cxl_general_media_event_to_ir(
+	const EFI_CXL_GENERAL_MEDIA_EVENT_RECORD *record);
+static json_object *
+cxl_dram_event_to_ir(const EFI_CXL_DRAM_EVENT_RECORD *record);
+static json_object *cxl_memory_module_event_to_ir(
+	const EFI_CXL_MEMORY_MODULE_EVENT_RECORD *record);
+static void ir_cxl_event_record_header_to_cper(
+	json_object *event_log, EFI_CXL_EVENT_RECORD_HEADER *header);
+static void
+ir_cxl_general_media_event_to_cper(json_object *event,
+				   EFI_CXL_GENERAL_MEDIA_EVENT_RECORD *record);
+static void ir_cxl_dram_event_to_cper(json_object *event,
+				      EFI_CXL_DRAM_EVENT_RECORD *record);
+static void
+ir_cxl_memory_module_event_to_cper(json_object *event,
+				   EFI_CXL_MEMORY_MODULE_EVENT_RECORD *record);
+
+//Converts a single CXL component error CPER section into JSON IR, leaving the event log as a raw
+//base64 dump.
 json_object *cper_section_cxl_component_to_ir(void *section)
+{
+	return cxl_component_to_ir(section, CXL_EVENT_RECORD_RAW);
+}
+
+//Converts a single CXL General Media component error CPER section into JSON IR.
+json_object *cper_section_cxl_general_media_to_ir(void *section)
+{
+	return cxl_component_to_ir(section, CXL_EVENT_RECORD_GENERAL_MEDIA);
+}
+
+//Converts a single CXL DRAM component error CPER section into JSON IR.
+json_object *cper_section_cxl_dram_to_ir(void *section)
+{
+	return cxl_component_to_ir(section, CXL_EVENT_RECORD_DRAM);
+}
+
+//Converts a single CXL Memory Module component error CPER section into JSON IR.
+json_object *cper_section_cxl_memory_module_to_ir(void *section)
+{
+	return cxl_component_to_ir(section, CXL_EVENT_RECORD_MEMORY_MODULE);
+}
+
+//Converts a single CXL component error CPER section into JSON IR, decoding the event log into
+//typed fields when it matches the given record layout.
+static json_object *cxl_component_to_ir(void *section, int record_type)
 {
 	EFI_CXL_COMPONENT_EVENT_HEADER *cxl_error =
 		(EFI_CXL_COMPONENT_EVENT_HEADER *)section;
@@ -61,22 +177,36 @@ json_object *cper_section_cxl_component_to_ir(void *section)
 	const char *cur_pos = (const char *)(cxl_error + 1);
 	int remaining_len =
 		cxl_error->Length - sizeof(EFI_CXL_COMPONENT_EVENT_HEADER);
-	if (remaining_len > 0) {
+	if (remaining_len > 0 &&
+	    cxl_event_record_known((const UINT8 *)cur_pos, remaining_len,
+				   record_type)) {
+		//Known layout, decode into typed fields.
+		const void *record = cur_pos;
+		json_object *event_log = cxl_event_record_header_to_ir(record);
+		if (record_type == CXL_EVENT_RECORD_GENERAL_MEDIA) {
+			json_object_object_add(
+				event_log, "generalMediaEvent",
+				cxl_general_media_event_to_ir(record));
+		} else if (record_type == CXL_EVENT_RECORD_DRAM) {
+			json_object_object_add(event_log, "dramEvent",
+					       cxl_dram_event_to_ir(record));
+		} else {
+			json_object_object_add(
+				event_log, "memoryModuleEvent",
+				cxl_memory_module_event_to_ir(record));
+		}
+		json_object_object_add(section_ir, "cxlComponentEventLog",
+				       event_log);
+	} else if (remaining_len > 0) {
+		//Unknown layout, fall back to a raw dump.
 		json_object *event_log = json_object_new_object();
 
-		int32_t encoded_len = 0;
-
-		char *encoded = base64_encode((UINT8 *)cur_pos, remaining_len,
-					      &encoded_len);
-		if (encoded == NULL) {
-			printf("Failed to allocate encode output buffer. \n");
+		json_object *data =
+			base64_blob_to_ir((UINT8 *)cur_pos, remaining_len);
+		if (data == NULL) {
 			return NULL;
 		}
-		json_object_object_add(event_log, "data",
-				       json_object_new_string_len(encoded,
-								  encoded_len));
-
-		free(encoded);
+		json_object_object_add(event_log, "data", data);
 		json_object_object_add(section_ir, "cxlComponentEventLog",
 				       event_log);
 	}
@@ -126,24 +256,481 @@ void ir_section_cxl_component_to_cper(json_object *section, FILE *out)
 	fwrite(section_cper, sizeof(EFI_CXL_COMPONENT_EVENT_HEADER), 1, out);
 	fflush(out);
 
-	//CXL component event log, decoded from base64.
+	//CXL component event log, either decoded from base64 or rebuilt from typed fields.
 	json_object *event_log =
 		json_object_object_get(section, "cxlComponentEventLog");
-	json_object *encoded = json_object_object_get(event_log, "data");
+	json_object *data = json_object_object_get(event_log, "data");
+	json_object *event = NULL;
+	if (data != NULL) {
+		int32_t decoded_len = 0;
+		UINT8 *decoded = ir_to_base64_blob(data, &decoded_len);
+		if (decoded != NULL) {
+			fwrite(decoded, decoded_len, 1, out);
+			fflush(out);
+			free(decoded);
+		}
+	} else if ((event = json_object_object_get(
+			    event_log, "generalMediaEvent")) != NULL) {
+		EFI_CXL_GENERAL_MEDIA_EVENT_RECORD record;
+		memset(&record, 0, sizeof(record));
+		ir_cxl_event_record_header_to_cper(event_log, &record.Header);
+		ir_cxl_general_media_event_to_cper(event, &record);
+		fwrite(&record, sizeof(record), 1, out);
+		fflush(out);
+	} else if ((event = json_object_object_get(event_log, "dramEvent")) !=
+		   NULL) {
+		EFI_CXL_DRAM_EVENT_RECORD record;
+		memset(&record, 0, sizeof(record));
+		ir_cxl_event_record_header_to_cper(event_log, &record.Header);
+		ir_cxl_dram_event_to_cper(event, &record);
+		fwrite(&record, sizeof(record), 1, out);
+		fflush(out);
+	} else if ((event = json_object_object_get(
+			    event_log, "memoryModuleEvent")) != NULL) {
+		EFI_CXL_MEMORY_MODULE_EVENT_RECORD record;
+		memset(&record, 0, sizeof(record));
+		ir_cxl_event_record_header_to_cper(event_log, &record.Header);
+		ir_cxl_memory_module_event_to_cper(event, &record);
+		fwrite(&record, sizeof(record), 1, out);
+		fflush(out);
+	}
 
-	int32_t decoded_len = 0;
+	free(section_cper);
+}
 
-	UINT8 *decoded = base64_decode(json_object_get_string(encoded),
-				       json_object_get_string_len(encoded),
-				       &decoded_len);
+/*
+* Event record helpers.
+*/
 
-	if (decoded == NULL) {
-		printf("Failed to allocate decode output buffer. \n");
-	} else {
-		fwrite(decoded, decoded_len, 1, out);
-		fflush(out);
+//Returns whether the given event log is a complete record of the given layout, with all reserved
+//fields and bits clear. Anything else (including newer revisions using reserved space) is left raw.
+static int cxl_event_record_known(const UINT8 *record, int len,
+				  int record_type)
+{
+	const EFI_CXL_EVENT_RECORD_HEADER *header =
+		(const EFI_CXL_EVENT_RECORD_HEADER *)record;
+	if (record_type == CXL_EVENT_RECORD_RAW ||
+	    len < (int)sizeof(EFI_CXL_EVENT_RECORD_HEADER) ||
+	    (cxl_uint24(header->Flags) & ~0x3F) != 0 ||
+	    !cxl_bytes_zero(header->Reserved, sizeof(header->Reserved))) {
+		return 0;
+	}
+
+	if (record_type == CXL_EVENT_RECORD_GENERAL_MEDIA) {
+		const EFI_CXL_GENERAL_MEDIA_EVENT_RECORD *media =
+			(const EFI_CXL_GENERAL_MEDIA_EVENT_RECORD *)record;
+		return len == sizeof(EFI_CXL_GENERAL_MEDIA_EVENT_RECORD) &&
+		       (media->PhysicalAddress & 0x3C) == 0 &&
+		       (media->MemoryEventDescriptor & ~0x7) == 0 &&
+		       (media->ValidityFlags & ~0xF) == 0 &&
+		       cxl_bytes_zero(media->Reserved, sizeof(media->Reserved));
+	}
+	if (record_type == CXL_EVENT_RECORD_DRAM) {
+		const EFI_CXL_DRAM_EVENT_RECORD *dram =
+			(const EFI_CXL_DRAM_EVENT_RECORD *)record;
+		return len == sizeof(EFI_CXL_DRAM_EVENT_RECORD) &&
+		       (dram->PhysicalAddress & 0x3C) == 0 &&
+		       (dram->MemoryEventDescriptor & ~0x7) == 0 &&
+		       (dram->ValidityFlags & ~0xFF) == 0 &&
+		       cxl_bytes_zero(dram->Reserved, sizeof(dram->Reserved));
+	}
+	const EFI_CXL_MEMORY_MODULE_EVENT_RECORD *module =
+		(const EFI_CXL_MEMORY_MODULE_EVENT_RECORD *)record;
+	return len == sizeof(EFI_CXL_MEMORY_MODULE_EVENT_RECORD) &&
+	       (module->HealthInfo.HealthStatus & ~0x7) == 0 &&
+	       (module->HealthInfo.AdditionalStatus & ~0x3F) == 0 &&
+	       cxl_bytes_zero(module->Reserved, sizeof(module->Reserved));
+}
+
+//Returns whether all of the given bytes are zero.
+static int cxl_bytes_zero(const UINT8 *bytes, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		if (bytes[i] != 0) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+//Reads a little endian 24-bit field.
+static UINT32 cxl_uint24(const UINT8 *bytes)
+{
+	return bytes[0] | (bytes[1] << 8) | ((UINT32)bytes[2] << 16);
+}
+
+//Writes a little endian 24-bit field.
+static void cxl_set_uint24(UINT8 *bytes, UINT32 value)
+{
+	bytes[0] = value & 0xFF;
+	bytes[1] = (value >> 8) & 0xFF;
+	bytes[2] = (value >> 16) & 0xFF;
+}
+
+//Converts the common event record header into a JSON IR event log object.
+static json_object *
+cxl_event_record_header_to_ir(const EFI_CXL_EVENT_RECORD_HEADER *header)
+{
+	json_object *event_log = json_object_new_object();
+	UINT32 flags = cxl_uint24(header->Flags);
+
+	json_object_object_add(event_log, "eventRecordLength",
+			       json_object_new_uint64(header->Length));
+	json_object_object_add(
+		event_log, "eventRecordSeverity",
+		integer_to_readable_pair(flags & 0x3, 4,
+					 CXL_EVENT_RECORD_SEVERITY_KEYS,
+					 CXL_EVENT_RECORD_SEVERITY_VALUES,
+					 "Unknown"));
+	json_object_object_add(
+		event_log, "eventRecordFlags",
+		bitfield_to_ir(flags >> 2, 4,
+			       CXL_EVENT_RECORD_FLAGS_BITFIELD_NAMES));
+	json_object_object_add(event_log, "eventRecordHandle",
+			       json_object_new_uint64(header->Handle));
+	json_object_object_add(event_log, "relatedEventRecordHandle",
+			       json_object_new_uint64(header->RelatedHandle));
+	json_object_object_add(event_log, "eventRecordTimestamp",
+			       json_object_new_uint64(header->Timestamp));
+	json_object_object_add(
+		event_log, "maintenanceOperationClass",
+		json_object_new_uint64(header->MaintenanceOperationClass));
+	return event_log;
+}
+
+//Converts the fields of a General Media event record into JSON IR.
+static json_object *cxl_general_media_event_to_ir(
+	const EFI_CXL_GENERAL_MEDIA_EVENT_RECORD *record)
+{
+	json_object *event = json_object_new_object();
+
+	//Device physical address, with flags held in the low bits.
+	json_object_object_add(
+		event, "physicalAddress",
+		json_object_new_uint64(record->PhysicalAddress & ~0x3FULL));
+	json_object_object_add(
+		event, "physicalAddressFlags",
+		bitfield_to_ir(record->PhysicalAddress, 2,
+			       CXL_PHYSICAL_ADDRESS_FLAGS_BITFIELD_NAMES));
+	json_object_object_add(
+		event, "memoryEventDescriptor",
+		bitfield_to_ir(record->MemoryEventDescriptor, 3,
+			       CXL_MEMORY_EVENT_DESCRIPTOR_BITFIELD_NAMES));
+	json_object_object_add(
+		event, "memoryEventType",
+		integer_to_readable_pair(record->MemoryEventType, 3,
+					 CXL_MEMORY_EVENT_TYPES_KEYS,
+					 CXL_MEMORY_EVENT_TYPES_VALUES,
+					 "Unknown"));
+	json_object_object_add(
+		event, "transactionType",
+		integer_to_readable_pair(record->TransactionType, 7,
+					 CXL_TRANSACTION_TYPES_KEYS,
+					 CXL_TRANSACTION_TYPES_VALUES,
+					 "Unknown"));
+	json_object_object_add(
+		event, "validationBits",
+		bitfield_to_ir(record->ValidityFlags, 4,
+			       CXL_GENERAL_MEDIA_VALID_BITFIELD_NAMES));
+
+	//Location.
+	json_object_object_add(event, "channel",
+			       json_object_new_uint64(record->Channel));
+	json_object_object_add(event, "rank",
+			       json_object_new_uint64(record->Rank));
+	json_object_object_add(
+		event, "device",
+		json_object_new_uint64(cxl_uint24(record->Device)));
+	json_object *component_id = base64_blob_to_ir(
+		record->ComponentId, sizeof(record->ComponentId));
+	if (component_id != NULL) {
+		json_object_object_add(event, "componentIdentifier",
+				       component_id);
+	}
+
+	return event;
+}
+
+//Converts the fields of a DRAM event record into JSON IR.
+static json_object *
+cxl_dram_event_to_ir(const EFI_CXL_DRAM_EVENT_RECORD *record)
+{
+	json_object *event = json_object_new_object();
+
+	//Device physical address, with flags held in the low bits.
+	json_object_object_add(
+		event, "physicalAddress",
+		json_object_new_uint64(record->PhysicalAddress & ~0x3FULL));
+	json_object_object_add(
+		event, "physicalAddressFlags",
+		bitfield_to_ir(record->PhysicalAddress, 2,
+			       CXL_PHYSICAL_ADDRESS_FLAGS_BITFIELD_NAMES));
+	json_object_object_add(
+		event, "memoryEventDescriptor",
+		bitfield_to_ir(record->MemoryEventDescriptor, 3,
+			       CXL_MEMORY_EVENT_DESCRIPTOR_BITFIELD_NAMES));
+	json_object_object_add(
+		event, "memoryEventType",
+		integer_to_readable_pair(record->MemoryEventType, 3,
+					 CXL_MEMORY_EVENT_TYPES_KEYS,
+					 CXL_MEMORY_EVENT_TYPES_VALUES,
+					 "Unknown"));
+	json_object_object_add(
+		event, "transactionType",
+		integer_to_readable_pair(record->TransactionType, 7,
+					 CXL_TRANSACTION_TYPES_KEYS,
+					 CXL_TRANSACTION_TYPES_VALUES,
+					 "Unknown"));
+	json_object_object_add(event, "validationBits",
+			       bitfield_to_ir(record->ValidityFlags, 8,
+					      CXL_DRAM_VALID_BITFIELD_NAMES));
+
+	//Location.
+	json_object_object_add(event, "channel",
+			       json_object_new_uint64(record->Channel));
+	json_object_object_add(event, "rank",
+			       json_object_new_uint64(record->Rank));
+	json_object_object_add(
+		event, "nibbleMask",
+		json_object_new_uint64(cxl_uint24(record->NibbleMask)));
+	json_object_object_add(event, "bankGroup",
+			       json_object_new_uint64(record->BankGroup));
+	json_object_object_add(event, "bank",
+			       json_object_new_uint64(record->Bank));
+	json_object_object_add(event, "row",
+			       json_object_new_uint64(cxl_uint24(record->Row)));
+	json_object_object_add(event, "column",
+			       json_object_new_uint64(record->Column));
+	UINT64 correction_mask[4];
+	memcpy(correction_mask, record->CorrectionMask,
+	       sizeof(correction_mask));
+	json_object_object_add(event, "correctionMask",
+			       uint64_array_to_ir_array(correction_mask, 4));
+
+	return event;
+}
+
+//Converts the fields of a Memory Module event record into JSON IR.
+static json_object *cxl_memory_module_event_to_ir(
+	const EFI_CXL_MEMORY_MODULE_EVENT_RECORD *record)
+{
+	json_object *event = json_object_new_object();
+	json_object_object_add(
+		event, "deviceEventType",
+		integer_to_readable_pair(record->DeviceEventType, 6,
+					 CXL_DEVICE_EVENT_TYPES_KEYS,
+					 CXL_DEVICE_EVENT_TYPES_VALUES,
+					 "Unknown"));
+
+	//Device health information, as reported by the Get Health Info command.
+	const EFI_CXL_HEALTH_INFO *health = &record->HealthInfo;
+	json_object *health_info = json_object_new_object();
+	json_object_object_add(
+		health_info, "healthStatus",
+		bitfield_to_ir(health->HealthStatus, 3,
+			       CXL_HEALTH_STATUS_BITFIELD_NAMES));
+	json_object_object_add(
+		health_info, "mediaStatus",
+		integer_to_readable_pair(health->MediaStatus, 10,
+					 CXL_MEDIA_STATUS_KEYS,
+					 CXL_MEDIA_STATUS_VALUES, "Unknown"));
+
+	json_object *additional_status = json_object_new_object();
+	json_object_object_add(
+		additional_status, "lifeUsed",
+		integer_to_readable_pair(health->AdditionalStatus & 0x3, 3,
+					 CXL_HEALTH_LEVEL_KEYS,
+					 CXL_HEALTH_LEVEL_VALUES, "Unknown"));
+	json_object_object_add(
+		additional_status, "deviceTemperature",
+		integer_to_readable_pair((health->AdditionalStatus >> 2) & 0x3,
+					 3, CXL_HEALTH_LEVEL_KEYS,
+					 CXL_HEALTH_LEVEL_VALUES, "Unknown"));
+	json_object_object_add(
+		additional_status, "errorCountWarnings",
+		bitfield_to_ir(health->AdditionalStatus >> 4, 2,
+			       CXL_ERROR_COUNT_WARNING_BITFIELD_NAMES));
+	json_object_object_add(health_info, "additionalStatus",
+			       additional_status);
+
+	json_object_object_add(health_info, "lifeUsed",
+			       json_object_new_uint64(health->LifeUsed));
+	json_object_object_add(
+		health_info, "deviceTemperature",
+		json_object_new_int(health->DeviceTemperature));
+	json_object_object_add(
+		health_info, "dirtyShutdownCount",
+		json_object_new_uint64(health->DirtyShutdownCount));
+	json_object_object_add(
+		health_info, "correctedVolatileErrorCount",
+		json_object_new_uint64(health->CorrectedVolatileErrorCount));
+	json_object_object_add(
+		health_info, "correctedPersistentErrorCount",
+		json_object_new_uint64(health->CorrectedPersistentErrorCount));
+	json_object_object_add(event, "deviceHealthInformation", health_info);
+
+	return event;
+}
+
+//Converts the common event record header fields of a JSON IR event log into binary.
+static void ir_cxl_event_record_header_to_cper(
+	json_object *event_log, EFI_CXL_EVENT_RECORD_HEADER *header)
+{
+	header->Length = json_object_get_uint64(
+		json_object_object_get(event_log, "eventRecordLength"));
+	UINT32 flags = readable_pair_to_integer(
+			       json_object_object_get(event_log,
+						      "eventRecordSeverity")) &
+		       0x3;
+	flags |= ir_to_bitfield(json_object_object_get(event_log,
+						       "eventRecordFlags"),
+				4, CXL_EVENT_RECORD_FLAGS_BITFIELD_NAMES)
+		 << 2;
+	cxl_set_uint24(header->Flags, flags);
+	header->Handle = json_object_get_uint64(
+		json_object_object_get(event_log, "eventRecordHandle"));
+	header->RelatedHandle = json_object_get_uint64(
+		json_object_object_get(event_log, "relatedEventRecordHandle"));
+	header->Timestamp = json_object_get_uint64(
+		json_object_object_get(event_log, "eventRecordTimestamp"));
+	header->MaintenanceOperationClass = json_object_get_uint64(
+		json_object_object_get(event_log, "maintenanceOperationClass"));
+}
+
+//Converts the fields of a JSON IR General Media event into binary.
+static void
+ir_cxl_general_media_event_to_cper(json_object *event,
+				   EFI_CXL_GENERAL_MEDIA_EVENT_RECORD *record)
+{
+	record->PhysicalAddress =
+		(json_object_get_uint64(
+			 json_object_object_get(event, "physicalAddress")) &
+		 ~0x3FULL) |
+		ir_to_bitfield(
+			json_object_object_get(event, "physicalAddressFlags"),
+			2, CXL_PHYSICAL_ADDRESS_FLAGS_BITFIELD_NAMES);
+	record->MemoryEventDescriptor = ir_to_bitfield(
+		json_object_object_get(event, "memoryEventDescriptor"), 3,
+		CXL_MEMORY_EVENT_DESCRIPTOR_BITFIELD_NAMES);
+	record->MemoryEventType = readable_pair_to_integer(
+		json_object_object_get(event, "memoryEventType"));
+	record->TransactionType = readable_pair_to_integer(
+		json_object_object_get(event, "transactionType"));
+	record->ValidityFlags = ir_to_bitfield(
+		json_object_object_get(event, "validationBits"), 4,
+		CXL_GENERAL_MEDIA_VALID_BITFIELD_NAMES);
+	record->Channel = json_object_get_uint64(
+		json_object_object_get(event, "channel"));
+	record->Rank =
+		json_object_get_uint64(json_object_object_get(event, "rank"));
+	cxl_set_uint24(record->Device,
+		       json_object_get_uint64(
+			       json_object_object_get(event, "device")));
+
+	int32_t decoded_len = 0;
+	UINT8 *decoded = ir_to_base64_blob(
+		json_object_object_get(event, "componentIdentifier"),
+		&decoded_len);
+	if (decoded != NULL) {
+		if (decoded_len > (int32_t)sizeof(record->ComponentId)) {
+			decoded_len = sizeof(record->ComponentId);
+		}
+		memcpy(record->ComponentId, decoded, decoded_len);
 		free(decoded);
 	}
+}
 
-	free(section_cper);
+//Converts the fields of a JSON IR DRAM event into binary.
+static void ir_cxl_dram_event_to_cper(json_object *event,
+				      EFI_CXL_DRAM_EVENT_RECORD *record)
+{
+	record->PhysicalAddress =
+		(json_object_get_uint64(
+			 json_object_object_get(event, "physicalAddress")) &
+		 ~0x3FULL) |
+		ir_to_bitfield(
+			json_object_object_get(event, "physicalAddressFlags"),
+			2, CXL_PHYSICAL_ADDRESS_FLAGS_BITFIELD_NAMES);
+	record->MemoryEventDescriptor = ir_to_bitfield(
+		json_object_object_get(event, "memoryEventDescriptor"), 3,
+		CXL_MEMORY_EVENT_DESCRIPTOR_BITFIELD_NAMES);
+	record->MemoryEventType = readable_pair_to_integer(
+		json_object_object_get(event, "memoryEventType"));
+	record->TransactionType = readable_pair_to_integer(
+		json_object_object_get(event, "transactionType"));
+	record->ValidityFlags = ir_to_bitfield(
+		json_object_object_get(event, "validationBits"), 8,
+		CXL_DRAM_VALID_BITFIELD_NAMES);
+	record->Channel = json_object_get_uint64(
+		json_object_object_get(event, "channel"));
+	record->Rank =
+		json_object_get_uint64(json_object_object_get(event, "rank"));
+	cxl_set_uint24(record->NibbleMask,
+		       json_object_get_uint64(
+			       json_object_object_get(event, "nibbleMask")));
+	record->BankGroup = json_object_get_uint64(
+		json_object_object_get(event, "bankGroup"));
+	record->Bank =
+		json_object_get_uint64(json_object_object_get(event, "bank"));
+	cxl_set_uint24(record->Row,
+		       json_object_get_uint64(
+			       json_object_object_get(event, "row")));
+	record->Column =
+		json_object_get_uint64(json_object_object_get(event, "column"));
+
+	json_object *correction_mask =
+		json_object_object_get(event, "correctionMask");
+	UINT64 masks[4] = { 0 };
+	for (size_t i = 0;
+	     i < 4 && i < json_object_array_length(correction_mask); i++) {
+		masks[i] = json_object_get_uint64(
+			json_object_array_get_idx(correction_mask, i));
+	}
+	memcpy(record->CorrectionMask, masks, sizeof(masks));
+}
+
+//Converts the fields of a JSON IR Memory Module event into binary.
+static void
+ir_cxl_memory_module_event_to_cper(json_object *event,
+				   EFI_CXL_MEMORY_MODULE_EVENT_RECORD *record)
+{
+	record->DeviceEventType = readable_pair_to_integer(
+		json_object_object_get(event, "deviceEventType"));
+
+	json_object *health_info =
+		json_object_object_get(event, "deviceHealthInformation");
+	EFI_CXL_HEALTH_INFO *health = &record->HealthInfo;
+	health->HealthStatus = ir_to_bitfield(
+		json_object_object_get(health_info, "healthStatus"), 3,
+		CXL_HEALTH_STATUS_BITFIELD_NAMES);
+	health->MediaStatus = readable_pair_to_integer(
+		json_object_object_get(health_info, "mediaStatus"));
+
+	json_object *additional_status =
+		json_object_object_get(health_info, "additionalStatus");
+	health->AdditionalStatus =
+		(readable_pair_to_integer(json_object_object_get(
+			 additional_status, "lifeUsed")) &
+		 0x3) |
+		((readable_pair_to_integer(json_object_object_get(
+			  additional_status, "deviceTemperature")) &
+		  0x3)
+		 << 2) |
+		(ir_to_bitfield(json_object_object_get(additional_status,
+						       "errorCountWarnings"),
+				2, CXL_ERROR_COUNT_WARNING_BITFIELD_NAMES)
+		 << 4);
+
+	health->LifeUsed = json_object_get_uint64(
+		json_object_object_get(health_info, "lifeUsed"));
+	health->DeviceTemperature = json_object_get_int(
+		json_object_object_get(health_info, "deviceTemperature"));
+	health->DirtyShutdownCount = json_object_get_uint64(
+		json_object_object_get(health_info, "dirtyShutdownCount"));
+	health->CorrectedVolatileErrorCount =
+		json_object_get_uint64(json_object_object_get(
+			health_info, "correctedVolatileErrorCount"));
+	health->CorrectedPersistentErrorCount =
+		json_object_get_uint64(json_object_object_get(
+			health_info, "correctedPersistentErrorCount"));
 }
@@ -8,12 +8,26 @@ extern "C" {
 #include <json.h>
 #include "../edk/Cper.h"
 
-#define CXL_COMPONENT_ERROR_VALID_BITFIELD_NAMES                               \
-	(const char *[])                                                       \
-	{                                                                      \
-		"deviceIDValid", "deviceSerialValid",                          \
-			"cxlComponentEventLogValid"                            \
-	}
+extern const char *const CXL_COMPONENT_ERROR_VALID_BITFIELD_NAMES[3];
+extern const int CXL_EVENT_RECORD_SEVERITY_KEYS[4];
+extern const char *const CXL_EVENT_RECORD_SEVERITY_VALUES[4];
+extern const char *const CXL_EVENT_RECORD_FLAGS_BITFIELD_NAMES[4];
+extern const char *const CXL_PHYSICAL_ADDRESS_FLAGS_BITFIELD_NAMES[2];
+extern const char *const CXL_MEMORY_EVENT_DESCRIPTOR_BITFIELD_NAMES[3];
+extern const int CXL_MEMORY_EVENT_TYPES_KEYS[3];
+extern const char *const CXL_MEMORY_EVENT_TYPES_VALUES[3];
+extern const int CXL_TRANSACTION_TYPES_KEYS[7];
+extern const char *const CXL_TRANSACTION_TYPES_VALUES[7];
+extern const char *const CXL_GENERAL_MEDIA_VALID_BITFIELD_NAMES[4];
+extern const char *const CXL_DRAM_VALID_BITFIELD_NAMES[8];
+extern const int CXL_DEVICE_EVENT_TYPES_KEYS[6];
+extern const char *const CXL_DEVICE_EVENT_TYPES_VALUES[6];
+extern const char *const CXL_HEALTH_STATUS_BITFIELD_NAMES[3];
+extern const int CXL_MEDIA_STATUS_KEYS[10];
+extern const char *const CXL_MEDIA_STATUS_VALUES[10];
+extern const int CXL_HEALTH_LEVEL_KEYS[3];
+extern const char *const CXL_HEALTH_LEVEL_VALUES[3];
+extern const char *const CXL_ERROR_COUNT_WARNING_BITFIELD_NAMES[2];
 
 ///
 /// CXL Generic Component Error Section
@@ -30,14 +44,81 @@ typedef struct {
 	UINT64 Resv2 : 8;
 } __attribute__((packed, aligned(1))) EFI_CXL_DEVICE_ID_INFO;
 
-typedef struct {
+typedef struct EFI_CXL_COMPONENT_EVENT_HEADER {
 	UINT32 Length;
 	UINT64 ValidBits;
 	EFI_CXL_DEVICE_ID_INFO DeviceId;
 	UINT64 DeviceSerial;
 } __attribute__((packed, aligned(1))) EFI_CXL_COMPONENT_EVENT_HEADER;
 
+///
+/// CXL Component Event Records (CXL 2.0 Section 8.2.9.1). The Event Record Identifier UUID
+/// is not carried in the CPER section, as the section type already identifies the record.
+///
+typedef struct {
+	UINT8 Length;
+	UINT8 Flags[3];
+	UINT16 Handle;
+	UINT16 RelatedHandle;
+	UINT64 Timestamp;
+	UINT8 MaintenanceOperationClass;
+	UINT8 Reserved[15];
+} __attribute__((packed, aligned(1))) EFI_CXL_EVENT_RECORD_HEADER;
+
+typedef struct {
+	EFI_CXL_EVENT_RECORD_HEADER Header;
+	UINT64 PhysicalAddress;
+	UINT8 MemoryEventDescriptor;
+	UINT8 MemoryEventType;
+	UINT8 TransactionType;
+	UINT16 ValidityFlags;
+	UINT8 Channel;
+	UINT8 Rank;
+	UINT8 Device[3];
+	UINT8 ComponentId[16];
+	UINT8 Reserved[46];
+} __attribute__((packed, aligned(1))) EFI_CXL_GENERAL_MEDIA_EVENT_RECORD;
+
+typedef struct {
+	EFI_CXL_EVENT_RECORD_HEADER Header;
+	UINT64 PhysicalAddress;
+	UINT8 MemoryEventDescriptor;
+	UINT8 MemoryEventType;
+	UINT8 TransactionType;
+	UINT16 ValidityFlags;
+	UINT8 Channel;
+	UINT8 Rank;
+	UINT8 NibbleMask[3];
+	UINT8 BankGroup;
+	UINT8 Bank;
+	UINT8 Row[3];
+	UINT16 Column;
+	UINT64 CorrectionMask[4];
+	UINT8 Reserved[23];
+} __attribute__((packed, aligned(1))) EFI_CXL_DRAM_EVENT_RECORD;
+
+typedef struct {
+	UINT8 HealthStatus;
+	UINT8 MediaStatus;
+	UINT8 AdditionalStatus;
+	UINT8 LifeUsed;
+	INT16 DeviceTemperature;
+	UINT32 DirtyShutdownCount;
+	UINT32 CorrectedVolatileErrorCount;
+	UINT32 CorrectedPersistentErrorCount;
+} __attribute__((packed, aligned(1))) EFI_CXL_HEALTH_INFO;
+
+typedef struct {
+	EFI_CXL_EVENT_RECORD_HEADER Header;
+	UINT8 DeviceEventType;
+	EFI_CXL_HEALTH_INFO HealthInfo;
+	UINT8 Reserved[61];
+} __attribute__((packed, aligned(1))) EFI_CXL_MEMORY_MODULE_EVENT_RECORD;
+
 json_object *cper_section_cxl_component_to_ir(void *section);
+json_object *cper_section_cxl_general_media_to_ir(void *section);
+json_object *cper_section_cxl_dram_to_ir(void *section);
+json_object *cper_section_cxl_memory_module_to_ir(void *section);
 void ir_section_cxl_component_to_cper(json_object *section, FILE *out);
 
 #ifdef __cplusplus
@@ -11,6 +11,16 @@
 #include "../cper-utils.h"
 #include "cper-section-cxl-protocol.h"
 
+const char *const CXL_PROTOCOL_ERROR_VALID_BITFIELD_NAMES[7] = {
+	"cxlAgentTypeValid", "cxlAgentAddressValid", "deviceIDValid",
+	"deviceSerialValid", "capabilityStructureValid", "cxlDVSECValid",
+	"cxlErrorLogValid"
+};
+const int CXL_PROTOCOL_ERROR_AGENT_TYPES_KEYS[2] = { 0, 1 };
+const char *const CXL_PROTOCOL_ERROR_AGENT_TYPES_VALUES[2] = {
+	"CXL 1.1 Device", "CXL 1.1 Host Downstream Port"
+};
+
 //Converts a single CXL protocol error CPER section into JSON IR.
 json_object *cper_section_cxl_protocol_to_ir(void *section)
 {
@@ -132,38 +142,22 @@ json_object *cper_section_cxl_protocol_to_ir(void *section)
 	//For CXL 1.1 devices, this is the "CXL DVSEC For Flex Bus Device" structure as in CXL 1.1 spec.
 	//For CXL 1.1 host downstream ports, this is the "CXL DVSEC For Flex Bus Port" structure as in CXL 1.1 spec.
 	const char *cur_pos = (const char *)(cxl_protocol_error + 1);
-	int32_t encoded_len = 0;
-
-	encoded = base64_encode((UINT8 *)cur_pos,
-				cxl_protocol_error->CxlDvsecLength,
-				&encoded_len);
-	if (encoded == NULL) {
+	json_object *dvsec = base64_blob_to_ir(
+		(UINT8 *)cur_pos, cxl_protocol_error->CxlDvsecLength);
+	if (dvsec == NULL) {
 		return NULL;
 	}
-	json_object_object_add(section_ir, "cxlDVSEC",
-			       json_object_new_string_len(encoded,
-							  encoded_len));
-
-	free(encoded);
-
+	json_object_object_add(section_ir, "cxlDVSEC", dvsec);
 	cur_pos += cxl_protocol_error->CxlDvsecLength;
 
 	//CXL Error Log
 	//This is the "CXL RAS Capability Structure" as in CXL 1.1 spec.
-
-	encoded_len = 0;
-	encoded = base64_encode((UINT8 *)cur_pos,
-				cxl_protocol_error->CxlErrorLogLength,
-				&encoded_len);
-
-	if (encoded == NULL) {
-		printf("Failed to allocate encode output buffer. \n");
+	json_object *error_log = base64_blob_to_ir(
+		(UINT8 *)cur_pos, cxl_protocol_error->CxlErrorLogLength);
+	if (error_log == NULL) {
 		return NULL;
 	}
-	json_object_object_add(section_ir, "cxlErrorLog",
-			       json_object_new_string_len(encoded,
-							  encoded_len));
-	free(encoded);
+	json_object_object_add(section_ir, "cxlErrorLog", error_log);
 
 	return section_ir;
 }
@@ -262,31 +256,20 @@ void ir_section_cxl_protocol_to_cper(json_object *section, FILE *out)
 	fflush(out);
 
 	//DVSEC out to stream.
-	json_object *encoded = json_object_object_get(section, "cxlDVSEC");
-
 	int32_t decoded_len = 0;
-
-	decoded = base64_decode(json_object_get_string(encoded),
-				json_object_get_string_len(encoded),
-				&decoded_len);
-	if (decoded == NULL) {
-		printf("Failed to allocate decode output buffer. \n");
-	} else {
+	decoded = ir_to_base64_blob(json_object_object_get(section, "cxlDVSEC"),
+				    &decoded_len);
+	if (decoded != NULL) {
 		fwrite(decoded, decoded_len, 1, out);
 		fflush(out);
 		free(decoded);
 	}
 
 	//Error log out to stream.
-	encoded = json_object_object_get(section, "cxlErrorLog");
 	decoded_len = 0;
-
-	decoded = base64_decode(json_object_get_string(encoded),
-				json_object_get_string_len(encoded),
-				&decoded_len);
-	if (decoded == NULL) {
-		printf("Failed to allocate decode output buffer. \n");
-	} else {
+	decoded = ir_to_base64_blob(
+		json_object_object_get(section, "cxlErrorLog"), &decoded_len);
+	if (decoded != NULL) {
 		fwrite(decoded, decoded_len, 1, out);
 		fflush(out);
 		free(decoded);
@@ -8,23 +8,9 @@ extern "C" {
 #include <json.h>
 #include "../edk/Cper.h"
 
-#define CXL_PROTOCOL_ERROR_VALID_BITFIELD_NAMES                                \
-	(const char *[])                                                       \
-	{                                                                      \
-		"cxlAgentTypeValid", "cxlAgentAddressValid", "deviceIDValid",  \
-			"deviceSerialValid", "capabilityStructureValid",       \
-			"cxlDVSECValid", "cxlErrorLogValid"                    \
-	}
-#define CXL_PROTOCOL_ERROR_AGENT_TYPES_KEYS                                    \
-	(int[])                                                                \
-	{                                                                      \
-		0, 1                                                           \
-	}
-#define CXL_PROTOCOL_ERROR_AGENT_TYPES_VALUES                                  \
-	(const char *[])                                                       \
-	{                                                                      \
-		"CXL 1.1 Device", "CXL 1.1 Host Downstream Port"               \
-	}
+extern const char *const CXL_PROTOCOL_ERROR_VALID_BITFIELD_NAMES[7];
+extern const int CXL_PROTOCOL_ERROR_AGENT_TYPES_KEYS[2];
+extern const char *const CXL_PROTOCOL_ERROR_AGENT_TYPES_VALUES[2];
 #define CXL_PROTOCOL_ERROR_DEVICE_AGENT		      0
 #define CXL_PROTOCOL_ERROR_HOST_DOWNSTREAM_PORT_AGENT 1
 
@@ -56,7 +42,7 @@ typedef union {
 	UINT64 PortRcrbBaseAddress; //Active when the agent is a CXL1.1 host downstream port in CxlAgentType.
 } EFI_CXL_AGENT_ADDRESS;
 
-typedef struct {
+typedef struct EFI_CXL_PROTOCOL_ERROR_DATA {
 	UINT64 ValidBits;
 	UINT64 CxlAgentType;
 	EFI_CXL_AGENT_ADDRESS CxlAgentAddress;
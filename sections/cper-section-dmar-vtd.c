@@ -12,6 +12,11 @@
 #include "../cper-utils.h"
 #include "cper-section-dmar-vtd.h"
 
+const int VTD_FAULT_RECORD_TYPES_KEYS[2] = { 0, 1 };
+const char *const VTD_FAULT_RECORD_TYPES_VALUES[2] = {
+	"Write Request", "Read/AtomicOp Request"
+};
+
 //Converts a single VT-d specific DMAr CPER section into JSON IR.
 json_object *cper_section_dmar_vtd_to_ir(void *section)
 {
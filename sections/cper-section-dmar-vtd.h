@@ -8,16 +8,8 @@ extern "C" {
 #include <json.h>
 #include "../edk/Cper.h"
 
-#define VTD_FAULT_RECORD_TYPES_KEYS                                            \
-	(int[])                                                                \
-	{                                                                      \
-		0, 1                                                           \
-	}
-#define VTD_FAULT_RECORD_TYPES_VALUES                                          \
-	(const char *[])                                                       \
-	{                                                                      \
-		"Write Request", "Read/AtomicOp Request"                       \
-	}
+extern const int VTD_FAULT_RECORD_TYPES_KEYS[2];
+extern const char *const VTD_FAULT_RECORD_TYPES_VALUES[2];
 
 typedef struct {
 	UINT64 Resv1 : 12;
@@ -10,6 +10,12 @@
 #include "../cper-utils.h"
 #include "cper-section-firmware.h"
 
+const int FIRMWARE_ERROR_RECORD_TYPES_KEYS[3] = { 0, 1, 2 };
+const char *const FIRMWARE_ERROR_RECORD_TYPES_VALUES[3] = {
+	"IPF SAL Error Record", "SOC Firmware Error Record (Type1 Legacy)",
+	"SOC Firmware Error Record (Type2)"
+};
+
 //Converts a single firmware CPER section into JSON IR.
 json_object *cper_section_firmware_to_ir(void *section)
 {
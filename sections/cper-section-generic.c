@@ -12,6 +12,31 @@
 #include "../cper-utils.h"
 #include "cper-section-generic.h"
 
+const int GENERIC_PROC_TYPES_KEYS[3] = { 0, 1, 2 };
+const char *const GENERIC_PROC_TYPES_VALUES[3] = { "IA32/X64", "IA64", "ARM" };
+const int GENERIC_ISA_TYPES_KEYS[5] = { 0, 1, 2, 3, 4 };
+const char *const GENERIC_ISA_TYPES_VALUES[5] = {
+	"IA32", "IA64", "X64", "ARM A32/T32", "ARM A64"
+};
+const int GENERIC_ERROR_TYPES_KEYS[5] = { 0, 1, 2, 4, 8 };
+const char *const GENERIC_ERROR_TYPES_VALUES[5] = {
+	"Unknown", "Cache Error", "TLB Error", "Bus Error",
+	"Micro-Architectural Error"
+};
+const int GENERIC_OPERATION_TYPES_KEYS[4] = { 0, 1, 2, 3 };
+const char *const GENERIC_OPERATION_TYPES_VALUES[4] = {
+	"Unknown or Generic", "Data Read", "Data Write", "Instruction Execution"
+};
+const char *const GENERIC_VALIDATION_BITFIELD_NAMES[13] = {
+	"processorTypeValid", "processorISAValid", "processorErrorTypeValid",
+	"operationValid", "flagsValid", "levelValid", "cpuVersionValid",
+	"cpuBrandInfoValid", "cpuIDValid", "targetAddressValid",
+	"requestorIDValid", "responderIDValid", "instructionIPValid"
+};
+const char *const GENERIC_FLAGS_BITFIELD_NAMES[4] = {
+	"restartable", "preciseIP", "overflow", "corrected"
+};
+
 //Converts the given processor-generic CPER section into JSON IR.
 json_object *cper_section_generic_to_ir(void *section)
 {
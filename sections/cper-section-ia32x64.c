@@ -7,11 +7,69 @@
 
 #include <stdio.h>
 #include <json.h>
-#include "base64.h"
 #include "../edk/Cper.h"
 #include "../cper-utils.h"
 #include "cper-section-ia32x64.h"
 
+const char *const IA32X64_PROCESSOR_ERROR_VALID_BITFIELD_NAMES[5] = {
+	"checkInfoValid", "targetAddressIDValid", "requestorIDValid",
+	"responderIDValid", "instructionPointerValid"
+};
+const char *const IA32X64_CHECK_INFO_VALID_BITFIELD_NAMES[11] = {
+	"transactionTypeValid", "operationValid", "levelValid",
+	"processorContextCorruptValid", "uncorrectedValid", "preciseIPValid",
+	"restartableIPValid", "overflowValid", "participationTypeValid",
+	"timedOutValid", "addressSpaceValid"
+};
+const char *const IA32X64_CHECK_INFO_MS_CHECK_VALID_BITFIELD_NAMES[6] = {
+	"errorTypeValid", "processorContextCorruptValid", "uncorrectedValid",
+	"preciseIPValid", "restartableIPValid", "overflowValid"
+};
+const int IA32X64_CHECK_INFO_TRANSACTION_TYPES_KEYS[3] = { 0, 1, 2 };
+const char *const IA32X64_CHECK_INFO_TRANSACTION_TYPES_VALUES[3] = {
+	"Instruction", "Data Access", "Generic"
+};
+const int IA32X64_CHECK_INFO_OPERATION_TYPES_KEYS[9] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8
+};
+const char *const IA32X64_CHECK_INFO_OPERATION_TYPES_VALUES[9] = {
+	"Generic Error", "Generic Read", "Generic Write", "Data Read",
+	"Data Write", "Instruction Fetch", "Prefetch", "Eviction", "Snoop"
+};
+const int IA32X64_BUS_CHECK_INFO_PARTICIPATION_TYPES_KEYS[4] = { 0, 1, 2, 3 };
+const char *const IA32X64_BUS_CHECK_INFO_PARTICIPATION_TYPES_VALUES[4] = {
+	"Local processor originated request",
+	"Local processor responded to request", "Local processor observed",
+	"Generic"
+};
+const int IA32X64_BUS_CHECK_INFO_ADDRESS_SPACE_TYPES_KEYS[4] = { 0, 1, 2, 3 };
+const char *const IA32X64_BUS_CHECK_INFO_ADDRESS_SPACE_TYPES_VALUES[4] = {
+	"Memory Access", "Reserved", "I/O", "Other Transaction"
+};
+const int IA32X64_MS_CHECK_INFO_ERROR_TYPES_KEYS[6] = { 0, 1, 2, 3, 4, 5 };
+const char *const IA32X64_MS_CHECK_INFO_ERROR_TYPES_VALUES[6] = {
+	"No Error", "Unclassified", "Microcode ROM Parity Error",
+	"External Error", "FRC Error", "Internal Unclassified"
+};
+const int IA32X64_REGISTER_CONTEXT_TYPES_KEYS[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+const char *const IA32X64_REGISTER_CONTEXT_TYPES_VALUES[8] = {
+	"Unclassified Data", "MSR Registers", "32-bit Mode Execution Context",
+	"64-bit Mode Execution Context", "FXSave Context",
+	"32-bit Mode Debug Registers", "64-bit Mode Debug Registers",
+	"Memory Mapper Registers"
+};
+const char *const IA32X64_IA32_REGISTER_NAMES[25] = {
+	"eax", "ebx", "ecx", "edx", "esi", "edi", "ebp", "esp", "cs", "ds",
+	"ss", "es", "fs", "gs", "eflags", "eip", "cr0", "cr1", "cr2", "cr3",
+	"cr4", "gdtr", "idtr", "ldtr", "tr"
+};
+const char *const IA32X64_X64_REGISTER_NAMES[36] = {
+	"rax", "rbx", "rcx", "rdx", "rsi", "rdi", "rbp", "rsp", "r8", "r9",
+	"r10", "r11", "r12", "r13", "r14", "r15", "cs", "ds", "ss", "es", "fs",
+	"gs", "rflags", "eip", "cr0", "cr1", "cr2", "cr3", "cr4", "cr8",
+	"gdtr_0", "gdtr_1", "idtr_0", "idtr_1", "ldtr", "tr"
+};
+
 //Private pre-definitions.
 json_object *cper_ia32x64_processor_error_info_to_ir(
 	EFI_IA32_X64_PROCESS_ERROR_INFO *error_info);
@@ -390,18 +448,11 @@ json_object *cper_ia32x64_processor_context_info_to_ir(
 		//No parseable data, just dump as base64 and shift the head to the next item.
 		*cur_pos = (void *)(context_info + 1);
 
-		int32_t encoded_len = 0;
-		char *encoded = base64_encode((UINT8 *)*cur_pos,
-					      context_info->ArraySize,
-					      &encoded_len);
-		if (encoded == NULL) {
-			printf("Failed to allocate encode output buffer. \n");
-		} else {
+		json_object *data = base64_blob_to_ir((UINT8 *)*cur_pos,
+						      context_info->ArraySize);
+		if (data != NULL) {
 			register_array = json_object_new_object();
-			json_object_object_add(register_array, "data",
-					       json_object_new_string_len(
-						       encoded, encoded_len));
-			free(encoded);
+			json_object_object_add(register_array, "data", data);
 		}
 
 		*cur_pos =
@@ -417,144 +468,39 @@ json_object *cper_ia32x64_processor_context_info_to_ir(
 json_object *
 cper_ia32x64_register_32bit_to_ir(EFI_CONTEXT_IA32_REGISTER_STATE *registers)
 {
-	json_object *ia32_registers = json_object_new_object();
-	json_object_object_add(ia32_registers, "eax",
-			       json_object_new_uint64(registers->Eax));
-	json_object_object_add(ia32_registers, "ebx",
-			       json_object_new_uint64(registers->Ebx));
-	json_object_object_add(ia32_registers, "ecx",
-			       json_object_new_uint64(registers->Ecx));
-	json_object_object_add(ia32_registers, "edx",
-			       json_object_new_uint64(registers->Edx));
-	json_object_object_add(ia32_registers, "esi",
-			       json_object_new_uint64(registers->Esi));
-	json_object_object_add(ia32_registers, "edi",
-			       json_object_new_uint64(registers->Edi));
-	json_object_object_add(ia32_registers, "ebp",
-			       json_object_new_uint64(registers->Ebp));
-	json_object_object_add(ia32_registers, "esp",
-			       json_object_new_uint64(registers->Esp));
-	json_object_object_add(ia32_registers, "cs",
-			       json_object_new_uint64(registers->Cs));
-	json_object_object_add(ia32_registers, "ds",
-			       json_object_new_uint64(registers->Ds));
-	json_object_object_add(ia32_registers, "ss",
-			       json_object_new_uint64(registers->Ss));
-	json_object_object_add(ia32_registers, "es",
-			       json_object_new_uint64(registers->Es));
-	json_object_object_add(ia32_registers, "fs",
-			       json_object_new_uint64(registers->Fs));
-	json_object_object_add(ia32_registers, "gs",
-			       json_object_new_uint64(registers->Gs));
-	json_object_object_add(ia32_registers, "eflags",
-			       json_object_new_uint64(registers->Eflags));
-	json_object_object_add(ia32_registers, "eip",
-			       json_object_new_uint64(registers->Eip));
-	json_object_object_add(ia32_registers, "cr0",
-			       json_object_new_uint64(registers->Cr0));
-	json_object_object_add(ia32_registers, "cr1",
-			       json_object_new_uint64(registers->Cr1));
-	json_object_object_add(ia32_registers, "cr2",
-			       json_object_new_uint64(registers->Cr2));
-	json_object_object_add(ia32_registers, "cr3",
-			       json_object_new_uint64(registers->Cr3));
-	json_object_object_add(ia32_registers, "cr4",
-			       json_object_new_uint64(registers->Cr4));
-	json_object_object_add(
-		ia32_registers, "gdtr",
-		json_object_new_uint64(registers->Gdtr[0] +
-				       ((UINT64)registers->Gdtr[1] << 32)));
-	json_object_object_add(
-		ia32_registers, "idtr",
-		json_object_new_uint64(registers->Idtr[0] +
-				       ((UINT64)registers->Idtr[1] << 32)));
-	json_object_object_add(ia32_registers, "ldtr",
-			       json_object_new_uint64(registers->Ldtr));
-	json_object_object_add(ia32_registers, "tr",
-			       json_object_new_uint64(registers->Tr));
-
-	return ia32_registers;
+	//The register state is not uniform in width, so widen each register first.
+	//GDTR and IDTR are output as single 64-bit values.
+	UINT64 values[25] = {
+		registers->Eax, registers->Ebx, registers->Ecx, registers->Edx,
+		registers->Esi, registers->Edi, registers->Ebp, registers->Esp,
+		registers->Cs, registers->Ds, registers->Ss, registers->Es,
+		registers->Fs, registers->Gs, registers->Eflags, registers->Eip,
+		registers->Cr0, registers->Cr1, registers->Cr2, registers->Cr3,
+		registers->Cr4,
+		registers->Gdtr[0] + ((UINT64)registers->Gdtr[1] << 32),
+		registers->Idtr[0] + ((UINT64)registers->Idtr[1] << 32),
+		registers->Ldtr, registers->Tr
+	};
+	return uniform_struct64_to_ir(values, 25, IA32X64_IA32_REGISTER_NAMES);
 }
 
 //Converts a single CPER x64 register state into JSON IR format.
 json_object *
 cper_ia32x64_register_64bit_to_ir(EFI_CONTEXT_X64_REGISTER_STATE *registers)
 {
-	json_object *x64_registers = json_object_new_object();
-	json_object_object_add(x64_registers, "rax",
-			       json_object_new_uint64(registers->Rax));
-	json_object_object_add(x64_registers, "rbx",
-			       json_object_new_uint64(registers->Rbx));
-	json_object_object_add(x64_registers, "rcx",
-			       json_object_new_uint64(registers->Rcx));
-	json_object_object_add(x64_registers, "rdx",
-			       json_object_new_uint64(registers->Rdx));
-	json_object_object_add(x64_registers, "rsi",
-			       json_object_new_uint64(registers->Rsi));
-	json_object_object_add(x64_registers, "rdi",
-			       json_object_new_uint64(registers->Rdi));
-	json_object_object_add(x64_registers, "rbp",
-			       json_object_new_uint64(registers->Rbp));
-	json_object_object_add(x64_registers, "rsp",
-			       json_object_new_uint64(registers->Rsp));
-	json_object_object_add(x64_registers, "r8",
-			       json_object_new_uint64(registers->R8));
-	json_object_object_add(x64_registers, "r9",
-			       json_object_new_uint64(registers->R9));
-	json_object_object_add(x64_registers, "r10",
-			       json_object_new_uint64(registers->R10));
-	json_object_object_add(x64_registers, "r11",
-			       json_object_new_uint64(registers->R11));
-	json_object_object_add(x64_registers, "r12",
-			       json_object_new_uint64(registers->R12));
-	json_object_object_add(x64_registers, "r13",
-			       json_object_new_uint64(registers->R13));
-	json_object_object_add(x64_registers, "r14",
-			       json_object_new_uint64(registers->R14));
-	json_object_object_add(x64_registers, "r15",
-			       json_object_new_uint64(registers->R15));
-	json_object_object_add(x64_registers, "cs",
-			       json_object_new_int(registers->Cs));
-	json_object_object_add(x64_registers, "ds",
-			       json_object_new_int(registers->Ds));
-	json_object_object_add(x64_registers, "ss",
-			       json_object_new_int(registers->Ss));
-	json_object_object_add(x64_registers, "es",
-			       json_object_new_int(registers->Es));
-	json_object_object_add(x64_registers, "fs",
-			       json_object_new_int(registers->Fs));
-	json_object_object_add(x64_registers, "gs",
-			       json_object_new_int(registers->Gs));
-	json_object_object_add(x64_registers, "rflags",
-			       json_object_new_uint64(registers->Rflags));
-	json_object_object_add(x64_registers, "eip",
-			       json_object_new_uint64(registers->Rip));
-	json_object_object_add(x64_registers, "cr0",
-			       json_object_new_uint64(registers->Cr0));
-	json_object_object_add(x64_registers, "cr1",
-			       json_object_new_uint64(registers->Cr1));
-	json_object_object_add(x64_registers, "cr2",
-			       json_object_new_uint64(registers->Cr2));
-	json_object_object_add(x64_registers, "cr3",
-			       json_object_new_uint64(registers->Cr3));
-	json_object_object_add(x64_registers, "cr4",
-			       json_object_new_uint64(registers->Cr4));
-	json_object_object_add(x64_registers, "cr8",
-			       json_object_new_uint64(registers->Cr8));
-	json_object_object_add(x64_registers, "gdtr_0",
-			       json_object_new_uint64(registers->Gdtr[0]));
-	json_object_object_add(x64_registers, "gdtr_1",
-			       json_object_new_uint64(registers->Gdtr[1]));
-	json_object_object_add(x64_registers, "idtr_0",
-			       json_object_new_uint64(registers->Idtr[0]));
-	json_object_object_add(x64_registers, "idtr_1",
-			       json_object_new_uint64(registers->Idtr[1]));
-	json_object_object_add(x64_registers, "ldtr",
-			       json_object_new_int(registers->Ldtr));
-	json_object_object_add(x64_registers, "tr",
-			       json_object_new_int(registers->Tr));
-
-	return x64_registers;
+	UINT64 values[36] = {
+		registers->Rax, registers->Rbx, registers->Rcx, registers->Rdx,
+		registers->Rsi, registers->Rdi, registers->Rbp, registers->Rsp,
+		registers->R8, registers->R9, registers->R10, registers->R11,
+		registers->R12, registers->R13, registers->R14, registers->R15,
+		registers->Cs, registers->Ds, registers->Ss, registers->Es,
+		registers->Fs, registers->Gs, registers->Rflags, registers->Rip,
+		registers->Cr0, registers->Cr1, registers->Cr2, registers->Cr3,
+		registers->Cr4, registers->Cr8, registers->Gdtr[0],
+		registers->Gdtr[1], registers->Idtr[0], registers->Idtr[1],
+		registers->Ldtr, registers->Tr
+	};
+	return uniform_struct64_to_ir(values, 36, IA32X64_X64_REGISTER_NAMES);
 }
 
 //////////////////
@@ -815,15 +761,11 @@ void ir_ia32x64_context_info_to_cper(json_object *context_info, FILE *out)
 		ir_ia32x64_x64_registers_to_cper(register_array, out);
 	} else {
 		//Unknown/structure is not defined.
-		json_object *encoded =
-			json_object_object_get(register_array, "data");
 		int32_t decoded_len = 0;
-		const char *j_string = json_object_get_string(encoded);
-		int j_size = json_object_get_string_len(encoded);
-		UINT8 *decoded = base64_decode(j_string, j_size, &decoded_len);
-		if (decoded == NULL) {
-			printf("Failed to allocate decode output buffer. \n");
-		} else {
+		UINT8 *decoded = ir_to_base64_blob(
+			json_object_object_get(register_array, "data"),
+			&decoded_len);
+		if (decoded != NULL) {
 			fwrite(decoded, decoded_len, 1, out);
 			fflush(out);
 			free(decoded);
@@ -837,65 +779,42 @@ void ir_ia32x64_context_info_to_cper(json_object *context_info, FILE *out)
 //Converts a single CPER-JSON IA32 register array into CPER binary, outputting to the given stream.
 void ir_ia32x64_ia32_registers_to_cper(json_object *registers, FILE *out)
 {
+	UINT64 values[25];
+	ir_to_uniform_struct64(registers, values, 25,
+			       IA32X64_IA32_REGISTER_NAMES);
+
 	EFI_CONTEXT_IA32_REGISTER_STATE register_state;
-	register_state.Eax = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "eax"));
-	register_state.Ebx = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "ebx"));
-	register_state.Ecx = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "ecx"));
-	register_state.Edx = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "edx"));
-	register_state.Esi = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "esi"));
-	register_state.Edi = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "edi"));
-	register_state.Ebp = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "ebp"));
-	register_state.Esp = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "esp"));
-	register_state.Cs = (UINT16)json_object_get_uint64(
-		json_object_object_get(registers, "cs"));
-	register_state.Ds = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "ds"));
-	register_state.Ss = (UINT16)json_object_get_uint64(
-		json_object_object_get(registers, "ss"));
-	register_state.Es = (UINT16)json_object_get_uint64(
-		json_object_object_get(registers, "es"));
-	register_state.Fs = (UINT16)json_object_get_uint64(
-		json_object_object_get(registers, "fs"));
-	register_state.Gs = (UINT16)json_object_get_uint64(
-		json_object_object_get(registers, "gs"));
-	register_state.Eflags = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "eflags"));
-	register_state.Eip = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "eip"));
-	register_state.Cr0 = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "cr0"));
-	register_state.Cr1 = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "cr1"));
-	register_state.Cr2 = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "cr2"));
-	register_state.Cr3 = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "cr3"));
-	register_state.Cr4 = (UINT32)json_object_get_uint64(
-		json_object_object_get(registers, "cr4"));
+	register_state.Eax = (UINT32)values[0];
+	register_state.Ebx = (UINT32)values[1];
+	register_state.Ecx = (UINT32)values[2];
+	register_state.Edx = (UINT32)values[3];
+	register_state.Esi = (UINT32)values[4];
+	register_state.Edi = (UINT32)values[5];
+	register_state.Ebp = (UINT32)values[6];
+	register_state.Esp = (UINT32)values[7];
+	register_state.Cs = (UINT16)values[8];
+	register_state.Ds = (UINT16)values[9];
+	register_state.Ss = (UINT16)values[10];
+	register_state.Es = (UINT16)values[11];
+	register_state.Fs = (UINT16)values[12];
+	register_state.Gs = (UINT16)values[13];
+	register_state.Eflags = (UINT32)values[14];
+	register_state.Eip = (UINT32)values[15];
+	register_state.Cr0 = (UINT32)values[16];
+	register_state.Cr1 = (UINT32)values[17];
+	register_state.Cr2 = (UINT32)values[18];
+	register_state.Cr3 = (UINT32)values[19];
+	register_state.Cr4 = (UINT32)values[20];
 
 	//64-bit registers are split into two 32-bit parts.
-	UINT64 gdtr = json_object_get_uint64(
-		json_object_object_get(registers, "gdtr"));
-	register_state.Gdtr[0] = gdtr & 0xFFFFFFFF;
-	register_state.Gdtr[1] = gdtr >> 32;
-	UINT64 idtr = json_object_get_uint64(
-		json_object_object_get(registers, "idtr"));
-	register_state.Idtr[0] = idtr & 0xFFFFFFFF;
-	register_state.Idtr[1] = idtr >> 32;
+	register_state.Gdtr[0] = values[21] & 0xFFFFFFFF;
+	register_state.Gdtr[1] = values[21] >> 32;
+	register_state.Idtr[0] = values[22] & 0xFFFFFFFF;
+	register_state.Idtr[1] = values[22] >> 32;
 
 	//16-bit registers.
-	register_state.Ldtr = (UINT16)json_object_get_uint64(
-		json_object_object_get(registers, "ldtr"));
-	register_state.Tr = (UINT16)json_object_get_uint64(
-		json_object_object_get(registers, "tr"));
+	register_state.Ldtr = (UINT16)values[23];
+	register_state.Tr = (UINT16)values[24];
 
 	//Write out to stream.
 	fwrite(&register_state, sizeof(EFI_CONTEXT_IA32_REGISTER_STATE), 1,
@@ -906,80 +825,48 @@ void ir_ia32x64_ia32_registers_to_cper(json_object *registers, FILE *out)
 //Converts a single CPER-JSON x64 register array into CPER binary, outputting to the given stream.
 void ir_ia32x64_x64_registers_to_cper(json_object *registers, FILE *out)
 {
+	UINT64 values[36];
+	ir_to_uniform_struct64(registers, values, 36,
+			       IA32X64_X64_REGISTER_NAMES);
+
 	EFI_CONTEXT_X64_REGISTER_STATE register_state;
-	register_state.Rax = json_object_get_uint64(
-		json_object_object_get(registers, "rax"));
-	register_state.Rbx = json_object_get_uint64(
-		json_object_object_get(registers, "rbx"));
-	register_state.Rcx = json_object_get_uint64(
-		json_object_object_get(registers, "rcx"));
-	register_state.Rdx = json_object_get_uint64(
-		json_object_object_get(registers, "rdx"));
-	register_state.Rsi = json_object_get_uint64(
-		json_object_object_get(registers, "rsi"));
-	register_state.Rdi = json_object_get_uint64(
-		json_object_object_get(registers, "rdi"));
-	register_state.Rbp = json_object_get_uint64(
-		json_object_object_get(registers, "rbp"));
-	register_state.Rsp = json_object_get_uint64(
-		json_object_object_get(registers, "rsp"));
-	register_state.R8 =
-		json_object_get_uint64(json_object_object_get(registers, "r8"));
-	register_state.R9 =
-		json_object_get_uint64(json_object_object_get(registers, "r9"));
-	register_state.R10 = json_object_get_uint64(
-		json_object_object_get(registers, "r10"));
-	register_state.R11 = json_object_get_uint64(
-		json_object_object_get(registers, "r11"));
-	register_state.R12 = json_object_get_uint64(
-		json_object_object_get(registers, "r12"));
-	register_state.R13 = json_object_get_uint64(
-		json_object_object_get(registers, "r13"));
-	register_state.R14 = json_object_get_uint64(
-		json_object_object_get(registers, "r14"));
-	register_state.R15 = json_object_get_uint64(
-		json_object_object_get(registers, "r15"));
-	register_state.Cs = (UINT16)json_object_get_int(
-		json_object_object_get(registers, "cs"));
-	register_state.Ds = (UINT16)json_object_get_int(
-		json_object_object_get(registers, "ds"));
-	register_state.Ss = (UINT16)json_object_get_int(
-		json_object_object_get(registers, "ss"));
-	register_state.Es = (UINT16)json_object_get_int(
-		json_object_object_get(registers, "es"));
-	register_state.Fs = (UINT16)json_object_get_int(
-		json_object_object_get(registers, "fs"));
-	register_state.Gs = (UINT16)json_object_get_int(
-		json_object_object_get(registers, "gs"));
+	register_state.Rax = values[0];
+	register_state.Rbx = values[1];
+	register_state.Rcx = values[2];
+	register_state.Rdx = values[3];
+	register_state.Rsi = values[4];
+	register_state.Rdi = values[5];
+	register_state.Rbp = values[6];
+	register_state.Rsp = values[7];
+	register_state.R8 = values[8];
+	register_state.R9 = values[9];
+	register_state.R10 = values[10];
+	register_state.R11 = values[11];
+	register_state.R12 = values[12];
+	register_state.R13 = values[13];
+	register_state.R14 = values[14];
+	register_state.R15 = values[15];
+	register_state.Cs = (UINT16)values[16];
+	register_state.Ds = (UINT16)values[17];
+	register_state.Ss = (UINT16)values[18];
+	register_state.Es = (UINT16)values[19];
+	register_state.Fs = (UINT16)values[20];
+	register_state.Gs = (UINT16)values[21];
 	register_state.Resv1 = 0;
-	register_state.Rflags = json_object_get_uint64(
-		json_object_object_get(registers, "rflags"));
-	register_state.Rip = json_object_get_uint64(
-		json_object_object_get(registers, "eip"));
-	register_state.Cr0 = json_object_get_uint64(
-		json_object_object_get(registers, "cr0"));
-	register_state.Cr1 = json_object_get_uint64(
-		json_object_object_get(registers, "cr1"));
-	register_state.Cr2 = json_object_get_uint64(
-		json_object_object_get(registers, "cr2"));
-	register_state.Cr3 = json_object_get_uint64(
-		json_object_object_get(registers, "cr3"));
-	register_state.Cr4 = json_object_get_uint64(
-		json_object_object_get(registers, "cr4"));
-	register_state.Cr8 = json_object_get_uint64(
-		json_object_object_get(registers, "cr8"));
-	register_state.Gdtr[0] = json_object_get_uint64(
-		json_object_object_get(registers, "gdtr_0"));
-	register_state.Gdtr[1] = json_object_get_uint64(
-		json_object_object_get(registers, "gdtr_1"));
-	register_state.Idtr[0] = json_object_get_uint64(
-		json_object_object_get(registers, "idtr_0"));
-	register_state.Idtr[1] = json_object_get_uint64(
-		json_object_object_get(registers, "idtr_1"));
-	register_state.Ldtr = (UINT16)json_object_get_int(
-		json_object_object_get(registers, "ldtr"));
-	register_state.Tr = (UINT16)json_object_get_int(
-		json_object_object_get(registers, "tr"));
+	register_state.Rflags = values[22];
+	register_state.Rip = values[23];
+	register_state.Cr0 = values[24];
+	register_state.Cr1 = values[25];
+	register_state.Cr2 = values[26];
+	register_state.Cr3 = values[27];
+	register_state.Cr4 = values[28];
+	register_state.Cr8 = values[29];
+	register_state.Gdtr[0] = values[30];
+	register_state.Gdtr[1] = values[31];
+	register_state.Idtr[0] = values[32];
+	register_state.Idtr[1] = values[33];
+	register_state.Ldtr = (UINT16)values[34];
+	register_state.Tr = (UINT16)values[35];
 
 	//Write out to stream.
 	fwrite(&register_state, sizeof(EFI_CONTEXT_X64_REGISTER_STATE), 1, out);
@@ -8,98 +8,23 @@ extern "C" {
 #include <json.h>
 #include "../edk/Cper.h"
 
-#define IA32X64_PROCESSOR_ERROR_VALID_BITFIELD_NAMES                           \
-	(const char *[])                                                       \
-	{                                                                      \
-		"checkInfoValid", "targetAddressIDValid", "requestorIDValid",  \
-			"responderIDValid", "instructionPointerValid"          \
-	}
-#define IA32X64_CHECK_INFO_VALID_BITFIELD_NAMES                                \
-	(const char *[])                                                       \
-	{                                                                      \
-		"transactionTypeValid", "operationValid", "levelValid",        \
-			"processorContextCorruptValid", "uncorrectedValid",    \
-			"preciseIPValid", "restartableIPValid",                \
-			"overflowValid", "participationTypeValid",             \
-			"timedOutValid", "addressSpaceValid"                   \
-	}
-#define IA32X64_CHECK_INFO_MS_CHECK_VALID_BITFIELD_NAMES                       \
-	(const char *[])                                                       \
-	{                                                                      \
-		"errorTypeValid", "processorContextCorruptValid",              \
-			"uncorrectedValid", "preciseIPValid",                  \
-			"restartableIPValid", "overflowValid"                  \
-	}
-#define IA32X64_CHECK_INFO_TRANSACTION_TYPES_KEYS                              \
-	(int[])                                                                \
-	{                                                                      \
-		0, 1, 2                                                        \
-	}
-#define IA32X64_CHECK_INFO_TRANSACTION_TYPES_VALUES                            \
-	(const char *[])                                                       \
-	{                                                                      \
-		"Instruction", "Data Access", "Generic"                        \
-	}
-#define IA32X64_CHECK_INFO_OPERATION_TYPES_KEYS                                \
-	(int[])                                                                \
-	{                                                                      \
-		0, 1, 2, 3, 4, 5, 6, 7, 8                                      \
-	}
-#define IA32X64_CHECK_INFO_OPERATION_TYPES_VALUES                              \
-	(const char *[])                                                       \
-	{                                                                      \
-		"Generic Error", "Generic Read", "Generic Write", "Data Read", \
-			"Data Write", "Instruction Fetch", "Prefetch",         \
-			"Eviction", "Snoop"                                    \
-	}
-#define IA32X64_BUS_CHECK_INFO_PARTICIPATION_TYPES_KEYS                        \
-	(int[])                                                                \
-	{                                                                      \
-		0, 1, 2, 3                                                     \
-	}
-#define IA32X64_BUS_CHECK_INFO_PARTICIPATION_TYPES_VALUES                      \
-	(const char *[])                                                       \
-	{                                                                      \
-		"Local processor originated request",                          \
-			"Local processor responded to request",                \
-			"Local processor observed", "Generic"                  \
-	}
-#define IA32X64_BUS_CHECK_INFO_ADDRESS_SPACE_TYPES_KEYS                        \
-	(int[])                                                                \
-	{                                                                      \
-		0, 1, 2, 3                                                     \
-	}
-#define IA32X64_BUS_CHECK_INFO_ADDRESS_SPACE_TYPES_VALUES                      \
-	(const char *[])                                                       \
-	{                                                                      \
-		"Memory Access", "Reserved", "I/O", "Other Transaction"        \
-	}
-#define IA32X64_MS_CHECK_INFO_ERROR_TYPES_KEYS                                 \
-	(int[])                                                                \
-	{                                                                      \
-		0, 1, 2, 3, 4, 5                                               \
-	}
-#define IA32X64_MS_CHECK_INFO_ERROR_TYPES_VALUES                               \
-	(const char *[])                                                       \
-	{                                                                      \
-		"No Error", "Unclassified", "Microcode ROM Parity Error",      \
-			"External Error", "FRC Error", "Internal Unclassified" \
-	}
-#define IA32X64_REGISTER_CONTEXT_TYPES_KEYS                                    \
-	(int[])                                                                \
-	{                                                                      \
-		0, 1, 2, 3, 4, 5, 6, 7                                         \
-	}
-#define IA32X64_REGISTER_CONTEXT_TYPES_VALUES                                  \
-	(const char *[])                                                       \
-	{                                                                      \
-		"Unclassified Data", "MSR Registers",                          \
-			"32-bit Mode Execution Context",                       \
-			"64-bit Mode Execution Context", "FXSave Context",     \
-			"32-bit Mode Debug Registers",                         \
-			"64-bit Mode Debug Registers",                         \
-			"Memory Mapper Registers"                              \
-	}
+extern const char *const IA32X64_PROCESSOR_ERROR_VALID_BITFIELD_NAMES[5];
+extern const char *const IA32X64_CHECK_INFO_VALID_BITFIELD_NAMES[11];
+extern const char *const IA32X64_CHECK_INFO_MS_CHECK_VALID_BITFIELD_NAMES[6];
+extern const int IA32X64_CHECK_INFO_TRANSACTION_TYPES_KEYS[3];
+extern const char *const IA32X64_CHECK_INFO_TRANSACTION_TYPES_VALUES[3];
+extern const int IA32X64_CHECK_INFO_OPERATION_TYPES_KEYS[9];
+extern const char *const IA32X64_CHECK_INFO_OPERATION_TYPES_VALUES[9];
+extern const int IA32X64_BUS_CHECK_INFO_PARTICIPATION_TYPES_KEYS[4];
+extern const char *const IA32X64_BUS_CHECK_INFO_PARTICIPATION_TYPES_VALUES[4];
+extern const int IA32X64_BUS_CHECK_INFO_ADDRESS_SPACE_TYPES_KEYS[4];
+extern const char *const IA32X64_BUS_CHECK_INFO_ADDRESS_SPACE_TYPES_VALUES[4];
+extern const int IA32X64_MS_CHECK_INFO_ERROR_TYPES_KEYS[6];
+extern const char *const IA32X64_MS_CHECK_INFO_ERROR_TYPES_VALUES[6];
+extern const int IA32X64_REGISTER_CONTEXT_TYPES_KEYS[8];
+extern const char *const IA32X64_REGISTER_CONTEXT_TYPES_VALUES[8];
+extern const char *const IA32X64_IA32_REGISTER_NAMES[25];
+extern const char *const IA32X64_X64_REGISTER_NAMES[36];
 
 typedef struct {
 	UINT64 Eax;
@@ -10,6 +10,14 @@
 #include "../cper-utils.h"
 #include "cper-section-ipf.h"
 
+const char *const IPF_MOD_ERROR_VALID_BITFIELD_NAMES[5] = {
+	"checkInfoValid", "requestorIdentifierValid",
+	"responderIdentifierValid", "targetIdentifierValid", "preciseIPValid"
+};
+const char *const IPF_PSI_STATIC_INFO_VALID_BITFIELD_NAMES[6] = {
+	"minstateValid", "brValid", "crValid", "arValid", "rrValid", "frValid"
+};
+
 json_object *cper_ipf_mod_error_read_array(EFI_IPF_MOD_ERROR_INFO **cur_error,
 					   int num_to_read);
 json_object *cper_ipf_mod_error_to_ir(EFI_IPF_MOD_ERROR_INFO *mod_error);
@@ -8,19 +8,8 @@ extern "C" {
 #include <json.h>
 #include "../edk/Cper.h"
 
-#define IPF_MOD_ERROR_VALID_BITFIELD_NAMES                                     \
-	(const char *[])                                                       \
-	{                                                                      \
-		"checkInfoValid", "requestorIdentifierValid",                  \
-			"responderIdentifierValid", "targetIdentifierValid",   \
-			"preciseIPValid"                                       \
-	}
-#define IPF_PSI_STATIC_INFO_VALID_BITFIELD_NAMES                               \
-	(const char *[])                                                       \
-	{                                                                      \
-		"minstateValid", "brValid", "crValid", "arValid", "rrValid",   \
-			"frValid"                                              \
-	}
+extern const char *const IPF_MOD_ERROR_VALID_BITFIELD_NAMES[5];
+extern const char *const IPF_PSI_STATIC_INFO_VALID_BITFIELD_NAMES[6];
 
 ///
 /// IPF Error Record Section
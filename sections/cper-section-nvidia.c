@@ -7,6 +7,7 @@
 #include <string.h>
 #include <json.h>
 #include "../edk/Cper.h"
+#include "../cper-parse.h"
 #include "../cper-utils.h"
 #include "cper-section-nvidia.h"
 
@@ -37,14 +38,26 @@ json_object *cper_section_nvidia_to_ir(void *section)
 		json_object_new_uint64(nvidia_error->InstanceBase));
 
 	// Registers (Address Value pairs).
+	//When packed, these are a flat array of alternating addresses and values rather than objects.
+	EFI_NVIDIA_REGISTER_DATA *registers =
+		(EFI_NVIDIA_REGISTER_DATA *)(nvidia_error + 1);
+	int packed = cper_ir_get_flags() & CPER_IR_FLAG_PACKED_REGISTERS;
 	json_object *regarr = json_object_new_array();
-	UINT64 *regPtr = &nvidia_error->InstanceBase;
 	for (int i = 0; i < nvidia_error->NumberRegs; i++) {
+		if (packed) {
+			json_object_array_add(
+				regarr,
+				json_object_new_uint64(registers[i].Address));
+			json_object_array_add(
+				regarr, json_object_new_uint64(registers[i].Value));
+			continue;
+		}
 		json_object *reg = json_object_new_object();
-		json_object_object_add(reg, "address",
-				       json_object_new_uint64(*++regPtr));
+		json_object_object_add(
+			reg, "address",
+			json_object_new_uint64(registers[i].Address));
 		json_object_object_add(reg, "value",
-				       json_object_new_uint64(*++regPtr));
+				       json_object_new_uint64(registers[i].Value));
 		json_object_array_add(regarr, reg);
 	}
 	json_object_object_add(section_ir, "registers", regarr);
@@ -57,6 +70,25 @@ void ir_section_nvidia_to_cper(json_object *section, FILE *out)
 {
 	json_object *regarr = json_object_object_get(section, "registers");
 	int numRegs = json_object_array_length(regarr);
+	int packed = numRegs > 0 &&
+		     json_object_is_type(json_object_array_get_idx(regarr, 0),
+					 json_type_int);
+	if (packed) {
+		//Packed registers are address/value pairs, so must be of even length.
+		if (numRegs % 2 != 0) {
+			printf("Invalid NVIDIA section: packed register array has odd length %d.\n",
+			       numRegs);
+			return;
+		}
+		numRegs /= 2;
+	}
+	int numberRegs = json_object_get_int(
+		json_object_object_get(section, "numberRegs"));
+	if (numRegs != numberRegs) {
+		printf("Invalid NVIDIA section: %d registers given, but numberRegs is %d.\n",
+		       numRegs, numberRegs);
+		return;
+	}
 
 	size_t section_sz =
 		sizeof(EFI_NVIDIA_ERROR_DATA) + (numRegs * 2 * sizeof(UINT64));
@@ -79,18 +111,25 @@ void ir_section_nvidia_to_cper(json_object *section, FILE *out)
 		json_object_object_get(section, "severity"));
 	section_cper->Socket =
 		json_object_get_int(json_object_object_get(section, "socket"));
-	section_cper->NumberRegs = json_object_get_int(
-		json_object_object_get(section, "numberRegs"));
+	section_cper->NumberRegs = numberRegs;
 	section_cper->InstanceBase = json_object_get_uint64(
 		json_object_object_get(section, "instanceBase"));
 
-	// Registers (Address Value pairs).
-	UINT64 *regPtr = &section_cper->InstanceBase;
+	// Registers (Address Value pairs), either as objects or a packed array.
+	EFI_NVIDIA_REGISTER_DATA *registers =
+		(EFI_NVIDIA_REGISTER_DATA *)(section_cper + 1);
 	for (int i = 0; i < numRegs; i++) {
+		if (packed) {
+			registers[i].Address = json_object_get_uint64(
+				json_object_array_get_idx(regarr, i * 2));
+			registers[i].Value = json_object_get_uint64(
+				json_object_array_get_idx(regarr, i * 2 + 1));
+			continue;
+		}
 		json_object *reg = json_object_array_get_idx(regarr, i);
-		*++regPtr = json_object_get_uint64(
+		registers[i].Address = json_object_get_uint64(
 			json_object_object_get(reg, "address"));
-		*++regPtr = json_object_get_uint64(
+		registers[i].Value = json_object_get_uint64(
 			json_object_object_get(reg, "value"));
 	}
 
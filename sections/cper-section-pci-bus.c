@@ -11,6 +11,19 @@
 #include "../cper-utils.h"
 #include "cper-section-pci-bus.h"
 
+const char *const PCI_BUS_ERROR_VALID_BITFIELD_NAMES[9] = {
+	"errorStatusValid", "errorTypeValid", "busIDValid", "busAddressValid",
+	"busDataValid", "commandValid", "requestorIDValid", "completerIDValid",
+	"targetIDValid"
+};
+const int PCI_BUS_ERROR_TYPES_KEYS[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+const char *const PCI_BUS_ERROR_TYPES_VALUES[8] = {
+	"Unknown/OEM Specific Error", "Data Parity Error", "System Error",
+	"Master Abort", "Bus Timeout/No Device Present (No DEVSEL#)",
+	"Master Data Parity Error", "Address Parity Error",
+	"Command Parity Error"
+};
+
 //Converts a single PCI/PCI-X bus CPER section into JSON IR.
 json_object *cper_section_pci_bus_to_ir(void *section)
 {
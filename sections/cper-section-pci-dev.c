@@ -10,6 +10,11 @@
 #include "../cper-utils.h"
 #include "cper-section-pci-dev.h"
 
+const char *const PCI_DEV_ERROR_VALID_BITFIELD_NAMES[5] = {
+	"errorStatusValid", "idInfoValid", "memoryNumberValid", "ioNumberValid",
+	"registerDataPairsValid"
+};
+
 //Converts a single PCI/PCI-X device CPER section into JSON IR.
 json_object *cper_section_pci_dev_to_ir(void *section)
 {
@@ -8,12 +8,7 @@ extern "C" {
 #include <json.h>
 #include "../edk/Cper.h"
 
-#define PCI_DEV_ERROR_VALID_BITFIELD_NAMES                                     \
-	(const char *[])                                                       \
-	{                                                                      \
-		"errorStatusValid", "idInfoValid", "memoryNumberValid",        \
-			"ioNumberValid", "registerDataPairsValid"              \
-	}
+extern const char *const PCI_DEV_ERROR_VALID_BITFIELD_NAMES[5];
 
 ///
 /// PCI/PCI-X Device Error Section
@@ -29,7 +24,7 @@ typedef struct {
 	UINT64 Reserved : 40;
 } EFI_PCI_PCIX_DEVICE_ID_INFO;
 
-typedef struct {
+typedef struct EFI_PCI_PCIX_DEVICE_ERROR_DATA {
 	UINT64 ValidFields;
 	EFI_GENERIC_ERROR_STATUS ErrorStatus;
 	EFI_PCI_PCIX_DEVICE_ID_INFO IdInfo;
@@ -12,6 +12,21 @@
 #include "../cper-utils.h"
 #include "cper-section-pcie.h"
 
+const char *const PCIE_ERROR_VALID_BITFIELD_NAMES[8] = {
+	"portTypeValid", "versionValid", "commandStatusValid", "deviceIDValid",
+	"deviceSerialNumberValid", "bridgeControlStatusValid",
+	"capabilityStructureStatusValid", "aerInfoValid"
+};
+const int PCIE_ERROR_PORT_TYPES_KEYS[9] = { 0, 1, 4, 5, 6, 7, 8, 9, 10 };
+const char *const PCIE_ERROR_PORT_TYPES_VALUES[9] = {
+	"PCI Express End Point", "Legacy PCI End Point Device", "Root Port",
+	"Upstream Switch Port", "Downstream Switch Port",
+	"PCI Express to PCI/PCI-X Bridge",
+	"PCI/PCI-X Bridge to PCI Express Bridge",
+	"Root Complex Integrated Endpoint Device",
+	"Root Complex Event Collector"
+};
+
 //Converts a single PCIe CPER section into JSON IR.
 json_object *cper_section_pcie_to_ir(void *section)
 {
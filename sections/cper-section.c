@@ -55,12 +55,14 @@ CPER_SECTION_DEFINITION section_definitions[] = {
 	{ &gEfiCxlProtocolErrorSectionGuid, "CXL Protocol Error",
 	  cper_section_cxl_protocol_to_ir, ir_section_cxl_protocol_to_cper },
 	{ &gEfiCxlGeneralMediaErrorSectionGuid,
-	  "CXL General Media Component Error", cper_section_cxl_component_to_ir,
+	  "CXL General Media Component Error",
+	  cper_section_cxl_general_media_to_ir,
 	  ir_section_cxl_component_to_cper },
 	{ &gEfiCxlDramEventErrorSectionGuid, "CXL DRAM Component Error",
-	  cper_section_cxl_component_to_ir, ir_section_cxl_component_to_cper },
+	  cper_section_cxl_dram_to_ir, ir_section_cxl_component_to_cper },
 	{ &gEfiCxlMemoryModuleErrorSectionGuid,
-	  "CXL Memory Module Component Error", cper_section_cxl_component_to_ir,
+	  "CXL Memory Module Component Error",
+	  cper_section_cxl_memory_module_to_ir,
 	  ir_section_cxl_component_to_cper },
 	{ &gEfiCxlPhysicalSwitchErrorSectionGuid,
 	  "CXL Physical Switch Component Error",
@@ -0,0 +1,539 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "edk/Cper.h"
+#include "cper-utils.h"
+#include "sections/cper-section-pci-dev.h"
+#include "aggregate/cper-aggregate-memory.h"
+#include "aggregate/cper-aggregate-nvidia.h"
+#include "aggregate/cper-aggregate-pcie.h"
+#include "aggregate/cper-suppress.h"
+#include "aggregate/cper-threshold.h"
+#include "test-utils.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+//Generates a single section record of the given type, outputting the raw buffer.
+static void generate_aggregate_record(const char *type, char **buf,
+				      size_t *size)
+{
+	FILE *record = generate_record_memstream(&type, 1, buf, size, 0);
+	fclose(record);
+}
+
+//Returns a writable pointer to the first section body within a generated record.
+static void *first_section(char *buf)
+{
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(buf +
+						 sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
+	return buf + descriptor->SectionOffset;
+}
+
+//Sets the record timestamp and the first section's severity.
+static void set_record_metadata(char *buf, const char *timestamp,
+				UINT32 severity)
+{
+	EFI_COMMON_ERROR_RECORD_HEADER *header =
+		(EFI_COMMON_ERROR_RECORD_HEADER *)buf;
+	header->ValidationBits |= 0x2;
+	string_to_timestamp(&header->TimeStamp, timestamp);
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(header + 1);
+	descriptor->Severity = severity;
+}
+
+TEST(MemoryAggregator, CountsPerLocation)
+{
+	char *buf;
+	size_t size;
+	generate_aggregate_record("memory", &buf, &size);
+	EFI_PLATFORM_MEMORY_ERROR_DATA *memory =
+		(EFI_PLATFORM_MEMORY_ERROR_DATA *)first_section(buf);
+
+	//Only the physical address and node are valid.
+	memory->ValidFields = 0x2 | 0x8;
+	memory->PhysicalAddress = 0x12345678;
+	memory->Node = 3;
+
+	cper_memory_aggregator aggregator;
+	ASSERT_TRUE(cper_memory_aggregator_init(&aggregator, 0));
+
+	//Three errors on the same page, one on another.
+	set_record_metadata(buf, "2024-01-01T00:00:10.000", 2);
+	EXPECT_EQ(cper_memory_aggregator_add_record(&aggregator, buf, size), 1);
+	set_record_metadata(buf, "2024-01-01T00:00:05.000", 2);
+	memory->PhysicalAddress = 0x12345FFF;
+	EXPECT_EQ(cper_memory_aggregator_add_record(&aggregator, buf, size), 1);
+	set_record_metadata(buf, "2024-01-01T00:00:20.000", 0);
+	EXPECT_EQ(cper_memory_aggregator_add_record(&aggregator, buf, size), 1);
+	memory->PhysicalAddress = 0x22345678;
+	EXPECT_EQ(cper_memory_aggregator_add_record(&aggregator, buf, size), 1);
+
+	json_object *snapshot = cper_memory_aggregator_to_ir(&aggregator);
+	EXPECT_EQ(json_object_get_uint64(
+			  json_object_object_get(snapshot, "totalSections")),
+		  4u);
+	json_object *entries = json_object_object_get(snapshot, "entries");
+	ASSERT_EQ(json_object_array_length(entries), 2u);
+
+	int found = 0;
+	for (size_t i = 0; i < 2; i++) {
+		json_object *entry = json_object_array_get_idx(entries, i);
+		if (json_object_get_uint64(json_object_object_get(
+			    entry, "physicalPageAddress")) != 0x12345000) {
+			continue;
+		}
+		found = 1;
+		EXPECT_EQ(json_object_get_int(
+				  json_object_object_get(entry, "node")),
+			  3);
+		EXPECT_TRUE(json_object_object_get(entry, "row") == NULL);
+		EXPECT_EQ(json_object_get_uint64(
+				  json_object_object_get(entry, "count")),
+			  3u);
+		json_object *severities =
+			json_object_object_get(entry, "severities");
+		EXPECT_EQ(json_object_get_int(json_object_object_get(
+				  severities, "corrected")),
+			  2);
+		EXPECT_EQ(json_object_get_int(json_object_object_get(
+				  severities, "recoverable")),
+			  1);
+		EXPECT_EQ(json_object_get_int64(json_object_object_get(
+				  entry, "lastTimestampEpoch")) -
+				  json_object_get_int64(json_object_object_get(
+					  entry, "firstTimestampEpoch")),
+			  15);
+	}
+	EXPECT_TRUE(found);
+
+	json_object_put(snapshot);
+	cper_memory_aggregator_free(&aggregator);
+	free(buf);
+}
+
+TEST(MemoryAggregator, Memory2AndLimits)
+{
+	char *buf;
+	size_t size;
+	generate_aggregate_record("memory2", &buf, &size);
+	EFI_PLATFORM_MEMORY2_ERROR_DATA *memory =
+		(EFI_PLATFORM_MEMORY2_ERROR_DATA *)first_section(buf);
+	memory->ValidFields = 0x100;
+
+	//Only one location fits, the second is dropped.
+	cper_memory_aggregator aggregator;
+	ASSERT_TRUE(cper_memory_aggregator_init(&aggregator, 1));
+	memory->Row = 1;
+	EXPECT_EQ(cper_memory_aggregator_add_record(&aggregator, buf, size), 1);
+	memory->Row = 2;
+	EXPECT_EQ(cper_memory_aggregator_add_record(&aggregator, buf, size), 1);
+	memory->Row = 1;
+	EXPECT_EQ(cper_memory_aggregator_add_record(&aggregator, buf, size), 1);
+
+	json_object *snapshot = cper_memory_aggregator_to_ir(&aggregator);
+	EXPECT_EQ(json_object_get_int(
+			  json_object_object_get(snapshot, "droppedSections")),
+		  1);
+	json_object *entries = json_object_object_get(snapshot, "entries");
+	ASSERT_EQ(json_object_array_length(entries), 1u);
+	json_object *entry = json_object_array_get_idx(entries, 0);
+	EXPECT_EQ(json_object_get_int(json_object_object_get(entry, "row")), 1);
+	EXPECT_EQ(json_object_get_int(json_object_object_get(entry, "count")),
+		  2);
+	json_object_put(snapshot);
+
+	//Non-memory and invalid records are not consumed.
+	cper_memory_aggregator_reset(&aggregator);
+	EXPECT_EQ(cper_memory_aggregator_add_record(&aggregator, buf, 16), -1);
+	char *pcie_buf;
+	size_t pcie_size;
+	generate_aggregate_record("pcie", &pcie_buf, &pcie_size);
+	EXPECT_EQ(cper_memory_aggregator_add_record(&aggregator, pcie_buf,
+						    pcie_size),
+		  0);
+	EXPECT_EQ(aggregator.table.count, 0u);
+
+	cper_memory_aggregator_free(&aggregator);
+	free(pcie_buf);
+	free(buf);
+}
+
+TEST(MemoryAggregator, ManyLocations)
+{
+	char *buf;
+	size_t size;
+	generate_aggregate_record("memory", &buf, &size);
+	EFI_PLATFORM_MEMORY_ERROR_DATA *memory =
+		(EFI_PLATFORM_MEMORY_ERROR_DATA *)first_section(buf);
+	memory->ValidFields = 0x100 | 0x200;
+
+	//Enough distinct locations to grow the table several times, each seen twice.
+	cper_memory_aggregator aggregator;
+	ASSERT_TRUE(cper_memory_aggregator_init(&aggregator, 0));
+	for (int pass = 0; pass < 2; pass++) {
+		for (UINT16 row = 0; row < 5000; row++) {
+			memory->Row = row;
+			memory->Column = row % 7;
+			cper_memory_aggregator_add_record(&aggregator, buf,
+							  size);
+		}
+	}
+	EXPECT_EQ(aggregator.table.count, 5000u);
+	EXPECT_EQ(aggregator.total_sections, 10000u);
+
+	json_object *snapshot = cper_memory_aggregator_to_ir(&aggregator);
+	json_object *entries = json_object_object_get(snapshot, "entries");
+	ASSERT_EQ(json_object_array_length(entries), 5000u);
+	for (size_t i = 0; i < 5000; i++) {
+		EXPECT_EQ(json_object_get_int(json_object_object_get(
+				  json_object_array_get_idx(entries, i),
+				  "count")),
+			  2);
+	}
+	json_object_put(snapshot);
+	cper_memory_aggregator_free(&aggregator);
+	free(buf);
+}
+
+//Finds the aggregated entry for the given bus and device in a PCIe aggregator snapshot.
+static json_object *find_pcie_entry(json_object *snapshot, int bus, int device)
+{
+	json_object *entries = json_object_object_get(snapshot, "entries");
+	for (size_t i = 0; i < json_object_array_length(entries); i++) {
+		json_object *entry = json_object_array_get_idx(entries, i);
+		json_object *entry_bus = json_object_object_get(entry, "bus");
+		json_object *entry_device =
+			json_object_object_get(entry, "device");
+		if (entry_bus != NULL && json_object_get_int(entry_bus) == bus &&
+		    (device < 0 ? entry_device == NULL :
+				  (entry_device != NULL &&
+				   json_object_get_int(entry_device) == device))) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+TEST(PcieAggregator, AerBitsPerFunction)
+{
+	char *buf;
+	size_t size;
+	generate_aggregate_record("pcie", &buf, &size);
+	EFI_PCIE_ERROR_DATA *pcie = (EFI_PCIE_ERROR_DATA *)first_section(buf);
+
+	//Device ID and AER information valid.
+	pcie->ValidFields = 0x8 | 0x80;
+	pcie->DevBridge.Segment = 1;
+	pcie->DevBridge.PrimaryOrDeviceBus = 0x3a;
+	pcie->DevBridge.Device = 2;
+	pcie->DevBridge.Function = 1;
+	memset(pcie->AerInfo.PcieAer, 0, sizeof(pcie->AerInfo.PcieAer));
+	UINT32 uncorrectable_status = (1U << 12) | (1U << 14);
+	UINT32 correctable_status = 1U << 0;
+	UINT32 correctable_mask = 1U << 13;
+	memcpy(pcie->AerInfo.PcieAer + 0x04, &uncorrectable_status, 4);
+	memcpy(pcie->AerInfo.PcieAer + 0x10, &correctable_status, 4);
+	memcpy(pcie->AerInfo.PcieAer + 0x14, &correctable_mask, 4);
+
+	cper_pcie_aer aer;
+	ASSERT_TRUE(cper_pcie_aer_decode(pcie, &aer));
+	EXPECT_EQ(aer.uncorrectable_status, uncorrectable_status);
+	EXPECT_EQ(aer.correctable_status, correctable_status);
+	EXPECT_EQ(aer.correctable_mask, correctable_mask);
+
+	cper_pcie_aggregator aggregator;
+	ASSERT_TRUE(cper_pcie_aggregator_init(&aggregator, 0));
+	EXPECT_EQ(cper_pcie_aggregator_add_record(&aggregator, buf, size), 1);
+	EXPECT_EQ(cper_pcie_aggregator_add_record(&aggregator, buf, size), 1);
+
+	//Same function without AER information.
+	pcie->ValidFields = 0x8;
+	EXPECT_EQ(cper_pcie_aggregator_add_record(&aggregator, buf, size), 1);
+
+	//A different function.
+	pcie->DevBridge.Device = 3;
+	EXPECT_EQ(cper_pcie_aggregator_add_record(&aggregator, buf, size), 1);
+
+	json_object *snapshot = cper_pcie_aggregator_to_ir(&aggregator);
+	EXPECT_EQ(json_object_array_length(
+			  json_object_object_get(snapshot, "entries")),
+		  2u);
+	json_object *entry = find_pcie_entry(snapshot, 0x3a, 2);
+	ASSERT_TRUE(entry != NULL);
+	EXPECT_EQ(json_object_get_int(json_object_object_get(entry, "segment")),
+		  1);
+	EXPECT_EQ(json_object_get_int(json_object_object_get(entry, "function")),
+		  1);
+	EXPECT_EQ(json_object_get_int(json_object_object_get(entry, "count")),
+		  3);
+
+	json_object *aer_ir = json_object_object_get(entry, "aer");
+	ASSERT_TRUE(aer_ir != NULL);
+	EXPECT_EQ(json_object_get_int(json_object_object_get(aer_ir, "sections")),
+		  2);
+	json_object *uncorrectable =
+		json_object_object_get(aer_ir, "uncorrectableErrors");
+	ASSERT_EQ(json_object_array_length(uncorrectable), 2u);
+	json_object *poisoned = json_object_array_get_idx(uncorrectable, 0);
+	EXPECT_EQ(json_object_get_int(json_object_object_get(poisoned, "bit")),
+		  12);
+	EXPECT_STREQ(json_object_get_string(
+			     json_object_object_get(poisoned, "name")),
+		     "Poisoned TLP Received");
+	EXPECT_EQ(json_object_get_int(json_object_object_get(poisoned, "count")),
+		  2);
+	json_object *correctable =
+		json_object_object_get(aer_ir, "correctableErrors");
+	ASSERT_EQ(json_object_array_length(correctable), 1u);
+	EXPECT_STREQ(json_object_get_string(json_object_object_get(
+			     json_object_array_get_idx(correctable, 0), "name")),
+		     "Receiver Error");
+	EXPECT_EQ(json_object_get_uint64(json_object_object_get(
+			  aer_ir, "lastCorrectableMask")),
+		  correctable_mask);
+
+	//The second function carries no AER counters.
+	entry = find_pcie_entry(snapshot, 0x3a, 3);
+	ASSERT_TRUE(entry != NULL);
+	EXPECT_TRUE(json_object_object_get(entry, "aer") == NULL);
+
+	json_object_put(snapshot);
+	cper_pcie_aggregator_free(&aggregator);
+	free(buf);
+}
+
+TEST(PcieAggregator, PciBusAndDevice)
+{
+	const char *types[3] = { "pcibus", "pcidev", "memory" };
+	char *buf;
+	size_t size;
+	FILE *record = generate_record_memstream(types, 3, &buf, &size, 0);
+	fclose(record);
+
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptors =
+		(EFI_ERROR_SECTION_DESCRIPTOR
+			 *)(buf + sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
+	EFI_PCI_PCIX_BUS_ERROR_DATA *bus =
+		(EFI_PCI_PCIX_BUS_ERROR_DATA *)(buf +
+						descriptors[0].SectionOffset);
+	bus->ValidFields = 0x4;
+	bus->BusId = (2 << 8) | 0x10;
+	EFI_PCI_PCIX_DEVICE_ERROR_DATA *dev =
+		(EFI_PCI_PCIX_DEVICE_ERROR_DATA *)(buf +
+						   descriptors[1].SectionOffset);
+	dev->ValidFields = 0x2;
+	dev->IdInfo.SegmentNumber = 2;
+	dev->IdInfo.BusNumber = 0x10;
+	dev->IdInfo.DeviceNumber = 4;
+	dev->IdInfo.FunctionNumber = 0;
+
+	//The bus-only address and full device address are separate entries, memory is skipped.
+	cper_pcie_aggregator aggregator;
+	ASSERT_TRUE(cper_pcie_aggregator_init(&aggregator, 0));
+	EXPECT_EQ(cper_pcie_aggregator_add_record(&aggregator, buf, size), 2);
+	json_object *snapshot = cper_pcie_aggregator_to_ir(&aggregator);
+	json_object *bus_entry = find_pcie_entry(snapshot, 0x10, -1);
+	ASSERT_TRUE(bus_entry != NULL);
+	EXPECT_EQ(json_object_get_int(
+			  json_object_object_get(bus_entry, "segment")),
+		  2);
+	json_object *dev_entry = find_pcie_entry(snapshot, 0x10, 4);
+	ASSERT_TRUE(dev_entry != NULL);
+	EXPECT_EQ(json_object_get_int(json_object_object_get(dev_entry, "count")),
+		  1);
+
+	json_object_put(snapshot);
+	cper_pcie_aggregator_free(&aggregator);
+	free(buf);
+}
+
+TEST(NvidiaAggregator, CountsPerInstance)
+{
+	char *buf;
+	size_t size;
+	generate_aggregate_record("nvidia", &buf, &size);
+	EFI_NVIDIA_ERROR_DATA *nvidia =
+		(EFI_NVIDIA_ERROR_DATA *)first_section(buf);
+	memset(nvidia->Signature, 0, sizeof(nvidia->Signature));
+	strcpy(nvidia->Signature, "DCC-ECC");
+	nvidia->Socket = 1;
+	nvidia->ErrorType = 4;
+
+	cper_nvidia_aggregator aggregator;
+	ASSERT_TRUE(cper_nvidia_aggregator_init(&aggregator, 2));
+
+	//Three storms on instance 7, one on instance 8, then a third instance that does not fit.
+	set_record_metadata(buf, "2024-01-01T00:00:10.000", 0);
+	nvidia->ErrorInstance = 7;
+	for (int i = 0; i < 3; i++) {
+		EXPECT_EQ(cper_nvidia_aggregator_add_record(&aggregator, buf,
+							    size),
+			  1);
+	}
+	nvidia->ErrorInstance = 8;
+	EXPECT_EQ(cper_nvidia_aggregator_add_record(&aggregator, buf, size), 1);
+	nvidia->ErrorInstance = 9;
+	EXPECT_EQ(cper_nvidia_aggregator_add_record(&aggregator, buf, size), 1);
+	EXPECT_EQ(cper_nvidia_aggregator_add_record(&aggregator, buf, 4), -1);
+
+	json_object *snapshot = cper_nvidia_aggregator_to_ir(&aggregator);
+	EXPECT_EQ(json_object_get_uint64(
+			  json_object_object_get(snapshot, "totalSections")),
+		  5u);
+	EXPECT_EQ(json_object_get_uint64(
+			  json_object_object_get(snapshot, "droppedSections")),
+		  1u);
+	json_object *entries = json_object_object_get(snapshot, "entries");
+	ASSERT_EQ(json_object_array_length(entries), 2u);
+	for (size_t i = 0; i < 2; i++) {
+		json_object *entry = json_object_array_get_idx(entries, i);
+		json_object *signature =
+			json_object_object_get(entry, "signature");
+		EXPECT_STREQ(json_object_get_string(signature), "DCC-ECC");
+		EXPECT_EQ(json_object_get_int(
+				  json_object_object_get(entry, "socket")),
+			  1);
+		EXPECT_EQ(json_object_get_int(
+				  json_object_object_get(entry, "errorType")),
+			  4);
+		int instance = json_object_get_int(
+			json_object_object_get(entry, "errorInstance"));
+		EXPECT_EQ(json_object_get_int(
+				  json_object_object_get(entry, "count")),
+			  instance == 7 ? 3 : 1);
+	}
+
+	json_object_put(snapshot);
+	cper_nvidia_aggregator_free(&aggregator);
+	free(buf);
+}
+
+static void collect_threshold_event(const cper_threshold_event *event,
+				    void *context)
+{
+	((std::vector<cper_threshold_event> *)context)->push_back(*event);
+}
+
+TEST(ThresholdEngine, SlidingWindowPerFru)
+{
+	char *buf;
+	size_t size;
+	generate_aggregate_record("memory", &buf, &size);
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(buf +
+						 sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
+	descriptor->SecValidMask = 0x3;
+	memset(&descriptor->FruId, 0, sizeof(EFI_GUID));
+	memset(descriptor->FruString, 0, sizeof(descriptor->FruString));
+	strcpy(descriptor->FruString, "DIMM A0");
+
+	//Three corrected memory errors within a minute, for any FRU.
+	cper_threshold_rule rule = {};
+	rule.section_type = gEfiPlatformMemoryErrorSectionGuid;
+	rule.severity = 2;
+	rule.threshold = 3;
+	rule.window = 60;
+	std::vector<cper_threshold_event> events;
+	cper_threshold_engine engine;
+	ASSERT_TRUE(cper_threshold_engine_init(&engine, &rule, 1, 4,
+					       collect_threshold_event,
+					       &events));
+
+	//Crosses on the third error, then stays quiet while above the threshold.
+	const char *times[4] = { "2024-01-01T00:00:00.000",
+				 "2024-01-01T00:00:10.000",
+				 "2024-01-01T00:00:20.000",
+				 "2024-01-01T00:00:25.000" };
+	for (int i = 0; i < 4; i++) {
+		set_record_metadata(buf, times[i], 2);
+		EXPECT_EQ(cper_threshold_engine_add_record(&engine, buf, size),
+			  i == 2 ? 1 : 0);
+	}
+	ASSERT_EQ(events.size(), 1u);
+	EXPECT_EQ(events[0].count, 3u);
+	EXPECT_STREQ(events[0].fru_string, "DIMM A0");
+	json_object *event_ir = cper_threshold_event_to_ir(&events[0]);
+	EXPECT_EQ(json_object_get_int(
+			  json_object_object_get(event_ir, "timestampEpoch")),
+		  1704067220);
+	json_object_put(event_ir);
+
+	//Other severities and FRUs are counted separately.
+	set_record_metadata(buf, "2024-01-01T00:00:30.000", 1);
+	EXPECT_EQ(cper_threshold_engine_add_record(&engine, buf, size), 0);
+	descriptor->FruId.Data1 = 1;
+	set_record_metadata(buf, "2024-01-01T00:00:30.000", 2);
+	EXPECT_EQ(cper_threshold_engine_add_record(&engine, buf, size), 0);
+
+	//Once the earlier errors leave the window, the first FRU can cross again.
+	descriptor->FruId.Data1 = 0;
+	set_record_metadata(buf, "2024-01-01T00:05:00.000", 2);
+	EXPECT_EQ(cper_threshold_engine_add_record(&engine, buf, size), 0);
+	EXPECT_EQ(cper_threshold_engine_add_record(&engine, buf, size), 0);
+	EXPECT_EQ(cper_threshold_engine_add_record(&engine, buf, size), 1);
+	EXPECT_EQ(events.size(), 2u);
+	EXPECT_EQ(engine.dropped_sections, 0u);
+
+	cper_threshold_engine_free(&engine);
+	free(buf);
+}
+
+TEST(Suppressor, TokenBucketsAndSummary)
+{
+	char *buf;
+	size_t size;
+	generate_aggregate_record("memory", &buf, &size);
+	EFI_COMMON_ERROR_RECORD_HEADER *header =
+		(EFI_COMMON_ERROR_RECORD_HEADER *)buf;
+	header->ErrorSeverity = 2;
+	set_record_metadata(buf, "2024-01-01T00:00:00.000", 2);
+
+	//Two corrected records at once, then one per second, summarised every minute.
+	cper_suppress_policy policy = { 1, 2, 60 };
+	cper_suppressor suppressor;
+	ASSERT_TRUE(cper_suppressor_init(&suppressor, &policy, 0));
+
+	json_object *ir = cper_suppressor_to_ir(&suppressor, buf, size, 0);
+	EXPECT_NE(ir, nullptr);
+	json_object_put(ir);
+	EXPECT_EQ(cper_suppressor_check(&suppressor, buf, size, 0),
+		  CPER_SUPPRESS_DECODE);
+	EXPECT_EQ(cper_suppressor_to_ir(&suppressor, buf, size, 500), nullptr);
+	EXPECT_EQ(cper_suppressor_check(&suppressor, buf, size, 1000),
+		  CPER_SUPPRESS_DECODE);
+	EXPECT_EQ(cper_suppressor_check(&suppressor, buf, size, 1000),
+		  CPER_SUPPRESS_SUPPRESSED);
+	EXPECT_EQ(cper_suppressor_check(&suppressor, buf, 4, 1000),
+		  CPER_SUPPRESS_INVALID);
+
+	//Fatal and recoverable severities are never suppressed.
+	header->ErrorSeverity = 1;
+	EXPECT_EQ(cper_suppressor_check(&suppressor, buf, size, 1000),
+		  CPER_SUPPRESS_BYPASS);
+	header->ErrorSeverity = 2;
+	set_record_metadata(buf, "2024-01-01T00:00:00.000", 0);
+	EXPECT_EQ(cper_suppressor_check(&suppressor, buf, size, 1000),
+		  CPER_SUPPRESS_BYPASS);
+	EXPECT_EQ(suppressor.bypassed_records, 2u);
+
+	//The summary is only due after the interval, and covers each suppressed record once.
+	EXPECT_EQ(cper_suppressor_poll(&suppressor, 59999), nullptr);
+	json_object *summary = cper_suppressor_poll(&suppressor, 60000);
+	ASSERT_NE(summary, nullptr);
+	EXPECT_EQ(json_object_get_int(json_object_object_get(
+			  summary, "suppressedRecords")),
+		  2);
+	json_object *entries = json_object_object_get(summary, "entries");
+	ASSERT_EQ(json_object_array_length(entries), 1u);
+	EXPECT_EQ(json_object_get_int(json_object_object_get(
+			  json_object_array_get_idx(entries, 0), "suppressed")),
+		  2);
+	json_object_put(summary);
+	EXPECT_EQ(cper_suppressor_poll(&suppressor, 120000), nullptr);
+
+	cper_suppressor_free(&suppressor);
+	free(buf);
+}
@@ -0,0 +1,226 @@
+/**
+ * Allocation accounting tests. malloc() and friends are interposed for this executable, so that the
+ * allocation count, bytes allocated and peak live heap of decoding and encoding each section type
+ * can be measured, and checked against the budgets in alloc-budgets.json.
+ *
+ * Budgets are upper bounds, not expected values: they carry enough headroom that differences in
+ * glibc or json-c versions between build environments do not fail the test, so only substantial
+ * regressions do. To deliberately update the budgets, run with CPER_ALLOC_BUDGET_OUT set to an
+ * output path. The measured values (plus headroom) are written there, to replace
+ * alloc-budgets.json in review.
+ **/
+
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <json.h>
+#include "edk/Cper.h"
+#include "cper-parse.h"
+#include "generator/cper-generate.h"
+#include "generator/sections/gen-section.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+//Seed that every measured record is generated from.
+#define ALLOC_SEED 48
+
+//Headroom added over measured values when writing out new budgets, in percent.
+#define ALLOC_BUDGET_HEADROOM 50
+
+//Minimum headroom over each measured count, bytes and peak, so that the small measurements of
+//encoding still allow for some variation.
+static const size_t ALLOC_BUDGET_MIN_HEADROOM[3] = { 4, 512, 512 };
+
+//glibc's own allocator entry points, which the interposed functions forward to.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t num, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+}
+
+//Allocations made while accounting is enabled.
+typedef struct {
+	size_t count;
+	size_t bytes;
+	size_t live;
+	size_t peak;
+} alloc_stats;
+
+static int alloc_accounting = 0;
+static alloc_stats alloc_current;
+
+//Records an allocation of the given block, if accounting is enabled.
+static void alloc_record(void *ptr, size_t requested)
+{
+	if (!alloc_accounting || ptr == NULL) {
+		return;
+	}
+	alloc_current.count++;
+	alloc_current.bytes += requested;
+	alloc_current.live += malloc_usable_size(ptr);
+	if (alloc_current.live > alloc_current.peak) {
+		alloc_current.peak = alloc_current.live;
+	}
+}
+
+//Records the release of the given block, if accounting is enabled.
+static void alloc_release(void *ptr)
+{
+	if (!alloc_accounting || ptr == NULL) {
+		return;
+	}
+
+	//Blocks allocated before accounting started are released without going negative.
+	size_t size = malloc_usable_size(ptr);
+	alloc_current.live -= size < alloc_current.live ? size :
+							  alloc_current.live;
+}
+
+extern "C" {
+void *malloc(size_t size)
+{
+	void *ptr = __libc_malloc(size);
+	alloc_record(ptr, size);
+	return ptr;
+}
+
+void *calloc(size_t num, size_t size)
+{
+	void *ptr = __libc_calloc(num, size);
+	alloc_record(ptr, num * size);
+	return ptr;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	alloc_release(ptr);
+	void *result = __libc_realloc(ptr, size);
+	alloc_record(result, size);
+	return result;
+}
+
+void free(void *ptr)
+{
+	alloc_release(ptr);
+	__libc_free(ptr);
+}
+}
+
+static void alloc_start(void)
+{
+	alloc_current = {};
+	alloc_accounting = 1;
+}
+
+static alloc_stats alloc_stop(void)
+{
+	alloc_accounting = 0;
+	return alloc_current;
+}
+
+//Measures decoding and encoding a record with a single section of the given type.
+static void measure_section(const char *type, alloc_stats *decode,
+			    alloc_stats *encode)
+{
+	//Generate the record.
+	cper_generator_context context;
+	cper_generator_seed(&context, ALLOC_SEED);
+	char *record;
+	size_t record_size;
+	FILE *stream = open_memstream(&record, &record_size);
+	char *types[1] = { const_cast<char *>(type) };
+	generate_cper_record_with_context(&context, types, 1, stream);
+	fclose(stream);
+
+	//Streams are unbuffered, so that only the library's own allocations are counted.
+	stream = fmemopen(record, record_size, "r");
+	setvbuf(stream, NULL, _IONBF, 0);
+	alloc_start();
+	json_object *ir = cper_to_ir(stream);
+	*decode = alloc_stop();
+	fclose(stream);
+	ASSERT_NE(ir, nullptr) << type;
+
+	char *encoded = (char *)malloc(record_size * 2);
+	stream = fmemopen(encoded, record_size * 2, "w");
+	setvbuf(stream, NULL, _IONBF, 0);
+	alloc_start();
+	ir_to_cper(ir, stream);
+	*encode = alloc_stop();
+	fclose(stream);
+
+	free(encoded);
+	json_object_put(ir);
+	free(record);
+}
+
+//Checks one measurement against its budget, returning the measurement as a new budget.
+static json_object *check_budget(const char *type, const char *operation,
+				 const alloc_stats *stats, json_object *budget)
+{
+	const char *names[3] = { "count", "bytes", "peak" };
+	size_t values[3] = { stats->count, stats->bytes, stats->peak };
+	json_object *measured = json_object_new_object();
+	for (int i = 0; i < 3; i++) {
+		json_object *limit = json_object_object_get(budget, names[i]);
+		if (limit == NULL) {
+			ADD_FAILURE() << "No " << operation << " " << names[i]
+				      << " budget for section type '" << type
+				      << "' in alloc-budgets.json.";
+		} else {
+			EXPECT_LE(values[i],
+				  (size_t)json_object_get_uint64(limit))
+				<< "Section type '" << type << "' " << operation
+				<< " " << names[i] << " exceeds its budget.";
+		}
+		size_t headroom = values[i] * ALLOC_BUDGET_HEADROOM / 100;
+		if (headroom < ALLOC_BUDGET_MIN_HEADROOM[i]) {
+			headroom = ALLOC_BUDGET_MIN_HEADROOM[i];
+		}
+		json_object_object_add(
+			measured, names[i],
+			json_object_new_uint64(values[i] + headroom));
+	}
+	return measured;
+}
+
+TEST(AllocationBudgets, DecodeAndEncode)
+{
+	json_object *budgets = json_object_from_file(CPER_ALLOC_BUDGET_FILE);
+	ASSERT_NE(budgets, nullptr) << "Failed to read alloc-budgets.json.";
+	json_object *updated = json_object_new_object();
+
+	printf("%-24s %10s %10s %10s %10s %10s %10s\n", "section",
+	       "dec count", "dec bytes", "dec peak", "enc count", "enc bytes",
+	       "enc peak");
+	for (size_t i = 0; i < generator_definitions_len; i++) {
+		const char *type = generator_definitions[i].ShortName;
+		alloc_stats decode;
+		alloc_stats encode;
+		measure_section(type, &decode, &encode);
+		printf("%-24s %10zu %10zu %10zu %10zu %10zu %10zu\n", type,
+		       decode.count, decode.bytes, decode.peak, encode.count,
+		       encode.bytes, encode.peak);
+
+		json_object *budget = json_object_object_get(budgets, type);
+		json_object *measured = json_object_new_object();
+		json_object_object_add(
+			measured, "decode",
+			check_budget(type, "decode", &decode,
+				     json_object_object_get(budget, "decode")));
+		json_object_object_add(
+			measured, "encode",
+			check_budget(type, "encode", &encode,
+				     json_object_object_get(budget, "encode")));
+		json_object_object_add(updated, type, measured);
+	}
+
+	const char *out = getenv("CPER_ALLOC_BUDGET_OUT");
+	if (out != NULL) {
+		json_object_to_file_ext(out, updated, JSON_C_TO_STRING_PRETTY);
+	}
+	json_object_put(updated);
+	json_object_put(budgets);
+}
@@ -0,0 +1,38 @@
+#include "edk/Cper.h"
+#include "cper-utils.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+TEST(GuidToString, Good)
+{
+	EFI_GUID guid = { 0xe19e3d16,
+			  0xbc11,
+			  0x11e4,
+			  { 0x9c, 0xaa, 0xc2, 0x05, 0x1d, 0x5d, 0x46, 0xb0 } };
+	char out[GUID_STRING_LENGTH];
+	guid_to_string(out, &guid);
+	ASSERT_STREQ(out, "e19e3d16-bc11-11e4-9caac2051d5d46b0");
+}
+
+TEST(StringToGuid, Good)
+{
+	EFI_GUID guid = {};
+	string_to_guid(&guid, "E19E3D16-bc11-11e4-9CAAc2051d5d46b0");
+	EXPECT_EQ(guid.Data1, 0xe19e3d16u);
+	EXPECT_EQ(guid.Data2, 0xbc11);
+	EXPECT_EQ(guid.Data3, 0x11e4);
+	EXPECT_EQ(guid.Data4[0], 0x9c);
+	EXPECT_EQ(guid.Data4[7], 0xb0);
+}
+
+TEST(StringToGuid, Bad)
+{
+	EFI_GUID guid = { 0x12345678, 0, 0, { 0 } };
+	string_to_guid(&guid, "e19e3d16-bc11-11e4-9caac2051d5d46");
+	string_to_guid(&guid, "e19e3d16-bc11-11e4-9caac2051d5d46b0ff");
+	string_to_guid(&guid, "e19e3d16_bc11-11e4-9caac2051d5d46b0");
+	string_to_guid(&guid, "e19e3d1g-bc11-11e4-9caac2051d5d46b0");
+	EXPECT_EQ(guid.Data1, 0x12345678u);
+	EXPECT_EQ(guid.Data2, 0);
+}
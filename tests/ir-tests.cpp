@@ -5,19 +5,126 @@
  **/
 
 #include <cctype>
+#include <initializer_list>
+#include <set>
+#include <string>
 #include "gtest/gtest.h"
 #include "test-utils.hpp"
 #include <json.h>
 #include "../cper-parse.h"
+#include "../cper-cache.h"
+#include "../cper-view.h"
+#include "../cper-utils.h"
 #include "../json-schema.h"
 #include "../generator/cper-generate.h"
+#include "../generator/cper-generate-adversarial.h"
+#include "../generator/cper-generate-ir.h"
+#include "../generator/cper-generate-profile.h"
 #include "../sections/cper-section.h"
+#include "../sections/cper-section-arm.h"
+#include "../sections/cper-section-cxl-component.h"
+#include "../sections/cper-section-nvidia.h"
 #include "../generator/sections/gen-section.h"
 
 /*
 * Test templates.
 */
 
+//Sets the calling thread's IR flags for the lifetime of the guard, restoring the previous flags on
+//destruction, so that a failed assertion cannot leak flags into later tests.
+struct ScopedIRFlags {
+	unsigned int saved;
+	explicit ScopedIRFlags(unsigned int flags)
+		: saved(cper_ir_get_flags())
+	{
+		cper_ir_set_flags(flags);
+	}
+	~ScopedIRFlags()
+	{
+		cper_ir_set_flags(saved);
+	}
+};
+
+//Returns the path of the given schema file, relative to the directory of the specification.
+static std::string spec_path(const char *file)
+{
+	std::string spec = LIBCPER_JSON_SPEC;
+	return spec.substr(0, spec.find_last_of('/') + 1) + file;
+}
+
+//Validates against the compact profile of the specification for the lifetime of the guard.
+struct ScopedCompactValidation {
+	ScopedCompactValidation()
+	{
+		validate_schema_compact_enable();
+	}
+	~ScopedCompactValidation()
+	{
+		validate_schema_compact_disable();
+	}
+};
+
+//Validates section IR against the section schema for the type given in its descriptor.
+static void expect_section_schema_valid(json_object *descriptor,
+					json_object *section)
+{
+	json_object *type = json_object_object_get(
+		json_object_object_get(descriptor, "sectionType"), "data");
+	ASSERT_NE(type, nullptr);
+	EFI_GUID guid;
+	string_to_guid(&guid, json_object_get_string(type));
+	std::string schema = std::string("sections/") +
+			     cper_ir_generator_section_schema(&guid);
+	std::string spec = spec_path(schema.c_str());
+	char error_message[JSON_ERROR_MSG_MAX_LEN] = { 0 };
+	EXPECT_EQ(validate_schema_from_file(spec.c_str(), section,
+					    error_message),
+		  1)
+		<< schema << ": " << error_message;
+}
+
+//Validates the header, section descriptors and sections of a full log or single section IR each
+//against their own schema. The root schema only checks that its referenced files exist, so is no
+//substitute.
+static void expect_record_schemas_valid(json_object *ir)
+{
+	char error_message[JSON_ERROR_MSG_MAX_LEN] = { 0 };
+	std::string header_spec = spec_path("cper-json-header.json");
+	std::string descriptor_spec =
+		spec_path("cper-json-section-descriptor.json");
+	json_object *descriptor =
+		json_object_object_get(ir, "sectionDescriptor");
+	if (descriptor != NULL) {
+		EXPECT_EQ(validate_schema_from_file(descriptor_spec.c_str(),
+						    descriptor, error_message),
+			  1)
+			<< error_message;
+		expect_section_schema_valid(
+			descriptor, json_object_object_get(ir, "section"));
+		return;
+	}
+
+	json_object *header = json_object_object_get(ir, "header");
+	EXPECT_EQ(validate_schema_from_file(header_spec.c_str(), header,
+					    error_message),
+		  1)
+		<< error_message;
+	json_object *descriptors =
+		json_object_object_get(ir, "sectionDescriptors");
+	json_object *sections = json_object_object_get(ir, "sections");
+	ASSERT_EQ(json_object_array_length(descriptors),
+		  json_object_array_length(sections));
+	for (size_t i = 0; i < json_object_array_length(sections); i++) {
+		descriptor = json_object_array_get_idx(descriptors, i);
+		EXPECT_EQ(validate_schema_from_file(descriptor_spec.c_str(),
+						    descriptor, error_message),
+			  1)
+			<< error_message;
+		expect_section_schema_valid(
+			descriptor, json_object_array_get_idx(sections, i));
+	}
+}
+
 //Tests a single randomly generated CPER section of the given type to ensure CPER-JSON IR validity.
 void cper_log_section_ir_test(const char *section_name, int single_section)
 {
@@ -37,10 +144,11 @@ void cper_log_section_ir_test(const char *section_name, int single_section)
 	fclose(record);
 	free(buf);
 
-	//Validate against schema.
+	//Validate against the root schema, then each part against its own schema.
 	char error_message[JSON_ERROR_MSG_MAX_LEN] = { 0 };
 	int valid =
 		validate_schema_from_file(LIBCPER_JSON_SPEC, ir, error_message);
+	expect_record_schemas_valid(ir);
 	json_object_put(ir);
 	ASSERT_TRUE(valid)
 		<< "IR validation test failed (single section mode = "
@@ -103,6 +211,72 @@ void cper_log_section_dual_binary_test(const char *section_name)
 	cper_log_section_binary_test(section_name, 1);
 }
 
+//Checks that lazily encoded base64 IR serialises identically to eagerly encoded IR, and still
+//round-trips to identical binary.
+void cper_log_section_lazy_base64_test(const char *section_name)
+{
+	//Generate CPER record for the given type.
+	char *buf;
+	size_t size;
+	FILE *record = generate_record_memstream(&section_name, 1, &buf, &size,
+						 0);
+
+	//Convert to IR both eagerly and lazily.
+	json_object *eager_ir = cper_to_ir(record);
+	rewind(record);
+	json_object *lazy_ir = cper_to_ir_ex(record, CPER_IR_FLAG_LAZY_BASE64);
+	fclose(record);
+
+	//Serialised output must be identical.
+	std::string eager_str = json_object_to_json_string_ext(
+		eager_ir, JSON_C_TO_STRING_PLAIN);
+	std::string lazy_str = json_object_to_json_string_ext(
+		lazy_ir, JSON_C_TO_STRING_PLAIN);
+	ASSERT_EQ(eager_str, lazy_str)
+		<< "Lazy base64 IR did not match eagerly encoded IR.";
+
+	//Lazy IR must convert back to the original binary.
+	char *cper_buf;
+	size_t cper_buf_size;
+	FILE *stream = open_memstream(&cper_buf, &cper_buf_size);
+	ir_to_cper(lazy_ir, stream);
+	size_t cper_len = ftell(stream);
+	fclose(stream);
+	ASSERT_GE(size, cper_len);
+	ASSERT_EQ(memcmp(buf, cper_buf, cper_len), 0)
+		<< "Binary output from lazy base64 IR was not identical to input.";
+
+	//Once materialised, payloads must read back as regular strings.
+	cper_ir_materialise(lazy_ir);
+	ASSERT_TRUE(json_object_equal(eager_ir, lazy_ir))
+		<< "Materialised lazy base64 IR did not match eagerly encoded IR.";
+
+	//Free everything up.
+	free(buf);
+	free(cper_buf);
+	json_object_put(eager_ir);
+	json_object_put(lazy_ir);
+}
+
+//Tests randomly generated CPER sections of a given type in the compact IR profile, for both IR
+//validity and binary round-trip equality.
+void cper_log_section_compact_test(const char *section_name)
+{
+	ScopedIRFlags flags(CPER_IR_FLAG_COMPACT);
+	ScopedCompactValidation validation;
+	cper_log_section_dual_ir_test(section_name);
+	cper_log_section_dual_binary_test(section_name);
+}
+
+//Tests randomly generated CPER sections of a given type with packed register arrays, for both IR
+//validity and binary round-trip equality.
+void cper_log_section_packed_registers_test(const char *section_name)
+{
+	ScopedIRFlags flags(CPER_IR_FLAG_PACKED_REGISTERS);
+	cper_log_section_dual_ir_test(section_name);
+	cper_log_section_dual_binary_test(section_name);
+}
+
 /*
 * Non-single section assertions.
 */
@@ -135,6 +309,876 @@ TEST(CompileTimeAssertions, ShortcodeNoSpaces)
 	}
 }
 
+//Header tests.
+TEST(HeaderTests, TimestampEpoch)
+{
+	//Generate a record and convert with the epoch timestamp enabled.
+	const char *section_name = "generic";
+	char *buf;
+	size_t size;
+	FILE *record =
+		generate_record_memstream(&section_name, 1, &buf, &size, 0);
+	json_object *ir = cper_to_ir_ex(record, CPER_IR_FLAG_TIMESTAMP_EPOCH);
+	fclose(record);
+	free(buf);
+
+	//Generated records always carry a timestamp, so the epoch must be present and the header valid.
+	json_object *header = json_object_object_get(ir, "header");
+	ASSERT_NE(json_object_object_get(header, "timestampEpoch"), nullptr);
+	std::string header_spec = spec_path("cper-json-header.json");
+	char error_message[JSON_ERROR_MSG_MAX_LEN] = { 0 };
+	EXPECT_EQ(validate_schema_from_file(header_spec.c_str(), header,
+					    error_message),
+		  1)
+		<< "IR validation test failed with message: " << error_message;
+
+	//The header schema types the epoch as an integer.
+	json_object_object_add(header, "timestampEpoch",
+			       json_object_new_string("0"));
+	EXPECT_EQ(validate_schema_from_file(header_spec.c_str(), header,
+					    error_message),
+		  0);
+	json_object_put(ir);
+}
+
+//Generator tests.
+static std::string generate_seeded_record(cper_generator_context *context,
+					  const char **types, UINT16 num_types)
+{
+	char *buf;
+	size_t size;
+	FILE *stream = open_memstream(&buf, &size);
+	generate_cper_record_with_context(context, const_cast<char **>(types),
+					  num_types, stream);
+	fclose(stream);
+	std::string record(buf, size);
+	free(buf);
+	return record;
+}
+
+TEST(GeneratorTests, SeededReproducible)
+{
+	const char *types[4] = { "arm", "ia32x64", "pcie", "nvidia" };
+	cper_generator_context first;
+	cper_generator_context second;
+	cper_generator_seed(&first, 42);
+	cper_generator_seed(&second, 42);
+
+	//The same seed gives the same sequence of records, and consecutive records differ.
+	std::string record = generate_seeded_record(&first, types, 4);
+	EXPECT_EQ(record, generate_seeded_record(&second, types, 4));
+	EXPECT_NE(record, generate_seeded_record(&first, types, 4));
+
+	//A different seed gives a different record.
+	cper_generator_seed(&second, 43);
+	EXPECT_NE(record, generate_seeded_record(&second, types, 4));
+
+	//Generated records are still valid.
+	FILE *stream = fmemopen((void *)record.data(), record.size(), "r");
+	json_object *ir = cper_to_ir(stream);
+	fclose(stream);
+	char error_message[JSON_ERROR_MSG_MAX_LEN] = { 0 };
+	int valid =
+		validate_schema_from_file(LIBCPER_JSON_SPEC, ir, error_message);
+	json_object_put(ir);
+	EXPECT_TRUE(valid) << error_message;
+}
+
+TEST(GeneratorTests, BufferMatchesStream)
+{
+	const char *types[5] = { "arm", "ia32x64", "pcie", "nvidia",
+				 "unknown" };
+	cper_generator_context stream_context;
+	cper_generator_context buf_context;
+	for (UINT64 seed = 0; seed < 32; seed++) {
+		cper_generator_seed(&stream_context, seed);
+		cper_generator_seed(&buf_context, seed);
+
+		//Records generated into a buffer match those generated to a stream.
+		std::string record =
+			generate_seeded_record(&stream_context, types, 5);
+		std::string buf(record.size() + 64, '\0');
+		size_t len = generate_cper_record_buf(
+			&buf_context, const_cast<char **>(types), 5, buf.data(),
+			buf.size());
+		ASSERT_EQ(len, record.size());
+		EXPECT_EQ(record, buf.substr(0, len));
+	}
+
+	//Records that do not fit return the length required.
+	cper_generator_seed(&stream_context, 7);
+	cper_generator_seed(&buf_context, 7);
+	std::string record = generate_seeded_record(&stream_context, types, 5);
+	std::string small(record.size() / 2, '\0');
+	EXPECT_EQ(generate_cper_record_buf(&buf_context,
+					   const_cast<char **>(types), 5,
+					   small.data(), small.size()),
+		  record.size());
+}
+
+//Schema driven IR generator tests.
+TEST(GeneratorTests, SchemaDrivenIR)
+{
+	cper_ir_generator generator;
+	ASSERT_TRUE(cper_ir_generator_init(&generator, LIBCPER_JSON_SPEC));
+	cper_generator_context context;
+	cper_generator_context again;
+	cper_generator_seed(&context, 11);
+	cper_generator_seed(&again, 11);
+
+	for (int i = 0; i < 100; i++) {
+		json_object *ir =
+			cper_ir_generator_generate(&generator, &context);
+		ASSERT_NE(ir, nullptr);
+
+		//Documents are schema valid, and reproducible from the seed.
+		expect_record_schemas_valid(ir);
+		json_object *repeat =
+			cper_ir_generator_generate(&generator, &again);
+		EXPECT_TRUE(json_object_equal(ir, repeat));
+		json_object_put(repeat);
+
+		//Documents can be encoded, though field values are arbitrary.
+		char *buf;
+		size_t size;
+		FILE *stream = open_memstream(&buf, &size);
+		if (json_object_object_get(ir, "sectionDescriptors") != NULL) {
+			ir_to_cper(ir, stream);
+		} else {
+			ir_single_section_to_cper(ir, stream);
+		}
+		fclose(stream);
+		EXPECT_GT(size, 0u);
+		free(buf);
+		json_object_put(ir);
+	}
+	cper_ir_generator_free(&generator);
+}
+
+//Encodes a section with the converter of the given section definition.
+static std::string
+schema_section_to_cper(const CPER_SECTION_DEFINITION *definition,
+		       json_object *section)
+{
+	char *buf;
+	size_t size;
+	FILE *stream = open_memstream(&buf, &size);
+	definition->ToCPER(section, stream);
+	fclose(stream);
+	std::string result(buf, size);
+	free(buf);
+	return result;
+}
+
+TEST(GeneratorTests, SchemaDrivenSections)
+{
+	cper_ir_generator generator;
+	ASSERT_TRUE(cper_ir_generator_init(&generator, LIBCPER_JSON_SPEC));
+	cper_generator_context context;
+	cper_generator_seed(&context, 12);
+
+	int memory_sections = 0;
+	for (int i = 0; i < 200; i++) {
+		json_object *ir =
+			cper_ir_generator_generate(&generator, &context);
+		ASSERT_NE(ir, nullptr);
+		json_object *descriptors =
+			json_object_object_get(ir, "sectionDescriptors");
+		if (descriptors == NULL) {
+			json_object_put(ir);
+			continue;
+		}
+
+		//One section per descriptor, as counted in the header.
+		json_object *sections = json_object_object_get(ir, "sections");
+		size_t len = json_object_array_length(descriptors);
+		ASSERT_EQ(json_object_array_length(sections), len);
+		EXPECT_EQ(json_object_get_uint64(json_object_object_get(
+				  json_object_object_get(ir, "header"),
+				  "sectionCount")),
+			  len);
+
+		//Descriptors name the type of their section, so every section matches the schema
+		//for that type, and platform memory sections round trip through the platform memory
+		//converters.
+		for (size_t j = 0; j < len; j++) {
+			json_object *descriptor =
+				json_object_array_get_idx(descriptors, j);
+			expect_section_schema_valid(
+				descriptor,
+				json_object_array_get_idx(sections, j));
+			json_object *section_type = json_object_object_get(
+				descriptor, "sectionType");
+			EFI_GUID guid;
+			string_to_guid(&guid,
+				       json_object_get_string(
+					       json_object_object_get(
+						       section_type, "data")));
+			if (!guid_equal(&guid,
+					&gEfiPlatformMemoryErrorSectionGuid)) {
+				continue;
+			}
+			memory_sections++;
+			json_object *type_name =
+				json_object_object_get(section_type, "type");
+			EXPECT_STREQ(json_object_get_string(type_name),
+				     "Platform Memory");
+
+			json_object *section =
+				json_object_array_get_idx(sections, j);
+			const CPER_SECTION_DEFINITION *definition = NULL;
+			for (size_t k = 0; k < section_definitions_len; k++) {
+				if (guid_equal(section_definitions[k].Guid,
+					       &guid)) {
+					definition = &section_definitions[k];
+				}
+			}
+			ASSERT_NE(definition, nullptr);
+			std::string encoded =
+				schema_section_to_cper(definition, section);
+			ASSERT_EQ(encoded.size(),
+				  sizeof(EFI_PLATFORM_MEMORY_ERROR_DATA));
+			json_object *decoded =
+				definition->ToIR(encoded.data());
+			ASSERT_NE(decoded, nullptr);
+			EXPECT_EQ(schema_section_to_cper(definition, decoded),
+				  encoded);
+			json_object_put(decoded);
+		}
+		json_object_put(ir);
+	}
+	EXPECT_GT(memory_sections, 0);
+	cper_ir_generator_free(&generator);
+}
+
+//Adversarial record shape tests.
+TEST(GeneratorTests, AdversarialShapes)
+{
+	for (size_t i = 0; i < cper_adversarial_shapes_len; i++) {
+		const cper_adversarial_shape *shape =
+			&cper_adversarial_shapes[i];
+		cper_generator_context context;
+		cper_generator_seed(&context, 5);
+
+		//Records are complete, whatever their sections declare.
+		char *buf;
+		size_t size;
+		FILE *stream = open_memstream(&buf, &size);
+		ASSERT_TRUE(generate_adversarial_record(&context, shape->Name,
+							stream));
+		fclose(stream);
+		ASSERT_GE(size, sizeof(EFI_COMMON_ERROR_RECORD_HEADER))
+			<< shape->Name;
+		EFI_COMMON_ERROR_RECORD_HEADER *header =
+			(EFI_COMMON_ERROR_RECORD_HEADER *)buf;
+		EXPECT_EQ(header->SignatureStart,
+			  (UINT32)EFI_ERROR_RECORD_SIGNATURE_START)
+			<< shape->Name;
+		EXPECT_EQ(header->RecordLength, size) << shape->Name;
+		EXPECT_GE(header->SectionCount, 1) << shape->Name;
+
+		//Records are reproducible from the seed.
+		char *again;
+		size_t again_size;
+		cper_generator_seed(&context, 5);
+		stream = open_memstream(&again, &again_size);
+		shape->Generate(&context, stream);
+		fclose(stream);
+		ASSERT_EQ(size, again_size) << shape->Name;
+		EXPECT_EQ(memcmp(buf, again, size), 0) << shape->Name;
+		free(again);
+		free(buf);
+	}
+
+	//Undefined shapes are rejected.
+	cper_generator_context context;
+	cper_generator_seed(&context, 5);
+	FILE *stream = fopen("/dev/null", "w");
+	EXPECT_FALSE(generate_adversarial_record(&context, "nonexistent",
+						 stream));
+	fclose(stream);
+}
+
+//Workload profile tests.
+TEST(GeneratorTests, WorkloadProfile)
+{
+	json_object *ir = json_tokener_parse(
+		"{\"sections\": {\"memory\": 3, \"pcie\": 1},"
+		" \"sectionCounts\": {\"1\": 1, \"2\": 1},"
+		" \"severities\": {\"corrected\": 1},"
+		" \"fruCount\": 4, \"duplicateRate\": 0.5}");
+	cper_generator_profile profile;
+	ASSERT_TRUE(cper_generator_profile_from_ir(&profile, ir));
+	json_object_put(ir);
+
+	std::set<UINT64> hashes;
+	std::set<std::string> frus;
+	const int records = 200;
+	for (int i = 0; i < records; i++) {
+		std::string record(0x10000, '\0');
+		size_t len = generate_profile_record_buf(
+			&profile, 42, i, record.data(), record.size());
+		ASSERT_GT(len, 0u);
+		ASSERT_LE(len, record.size());
+
+		//Records depend only on the seed and index.
+		std::string again(len, '\0');
+		EXPECT_EQ(generate_profile_record_buf(&profile, 42, i,
+						      again.data(), len),
+			  len);
+		EXPECT_EQ(record.substr(0, len), again);
+
+		//Sections follow the profile's severities and FRU set.
+		cper_record_view view;
+		ASSERT_TRUE(cper_record_view_init(&view, record.data(), len));
+		EXPECT_EQ(cper_record_view_severity(&view),
+			  (UINT32)EFI_GENERIC_ERROR_CORRECTED);
+		for (UINT16 s = 0; s < cper_record_view_section_count(&view);
+		     s++) {
+			const EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+				cper_record_view_descriptor(&view, s);
+			EXPECT_EQ(descriptor->Severity,
+				  (UINT32)EFI_GENERIC_ERROR_CORRECTED);
+			frus.insert(std::string(
+				(const char *)descriptor->FruString));
+		}
+
+		UINT64 hash;
+		ASSERT_TRUE(cper_record_hash(record.data(), len, &hash));
+		hashes.insert(hash);
+	}
+	EXPECT_LE(frus.size(), 4u);
+	EXPECT_LT(hashes.size(), (size_t)records * 3 / 4);
+	EXPECT_GT(hashes.size(), (size_t)records / 4);
+	cper_generator_profile_free(&profile);
+
+	//Unknown section types are rejected.
+	ir = json_tokener_parse("{\"sections\": {\"nonexistent\": 1}}");
+	EXPECT_FALSE(cper_generator_profile_from_ir(&profile, ir));
+	json_object_put(ir);
+}
+
+//Register array sizes of the ARM context structures the generator creates, by context type.
+static const UINT32 ARM_GENERATED_REGISTER_SIZES[9] = { 64,  96,  64, 8, 256,
+							136, 120, 80, 10 };
+
+//Walks the error and context structures of a generated ARM section, outputting the number of
+//context structures and the length of the vendor specific info that follows them. The generator
+//clears the section's structure counts along with its reserved bytes, so structures are recognised
+//by their own headers instead.
+static void arm_section_shape(const EFI_ARM_ERROR_RECORD *arm,
+			      UINT16 *context_count, size_t *vendor_len)
+{
+	const UINT8 *pos = (const UINT8 *)(arm + 1);
+	const UINT8 *end = (const UINT8 *)arm + arm->SectionLength;
+	const EFI_ARM_ERROR_INFORMATION_ENTRY *error_info =
+		(const EFI_ARM_ERROR_INFORMATION_ENTRY *)pos;
+	while (pos + sizeof(*error_info) <= end && error_info->Version == 0 &&
+	       error_info->Length == sizeof(*error_info)) {
+		pos += sizeof(*error_info);
+		error_info = (const EFI_ARM_ERROR_INFORMATION_ENTRY *)pos;
+	}
+
+	*context_count = 0;
+	const EFI_ARM_CONTEXT_INFORMATION_HEADER *header =
+		(const EFI_ARM_CONTEXT_INFORMATION_HEADER *)pos;
+	while (pos + sizeof(*header) <= end) {
+		UINT16 type = header->RegisterContextType;
+		if (type >= 9 || header->RegisterArraySize !=
+					 ARM_GENERATED_REGISTER_SIZES[type]) {
+			break;
+		}
+		pos += sizeof(*header) + header->RegisterArraySize;
+		header = (const EFI_ARM_CONTEXT_INFORMATION_HEADER *)pos;
+		(*context_count)++;
+	}
+	*vendor_len = end - pos;
+}
+
+TEST(GeneratorTests, WorkloadProfileShape)
+{
+	json_object *ir = json_tokener_parse(
+		"{\"sections\": {\"arm\": 1, \"unknown\": 1},"
+		" \"armContextCounts\": {\"1\": 1, \"5\": 1},"
+		" \"vendorBlobSizes\": {\"16\": 3, \"4096\": 1}}");
+	cper_generator_profile profile;
+	ASSERT_TRUE(cper_generator_profile_from_ir(&profile, ir));
+	json_object_put(ir);
+
+	//ARM context counts and vendor blob sizes are only drawn from the profile.
+	std::set<UINT16> context_counts;
+	std::set<size_t> arm_blob_sizes;
+	std::set<size_t> unknown_blob_sizes;
+	for (int i = 0; i < 100; i++) {
+		std::string record(0x10000, '\0');
+		size_t len = generate_profile_record_buf(
+			&profile, 7, i, record.data(), record.size());
+		ASSERT_GT(len, 0u);
+		ASSERT_LE(len, record.size());
+		cper_record_view view;
+		ASSERT_TRUE(cper_record_view_init(&view, record.data(), len));
+		const EFI_ARM_ERROR_RECORD *arm =
+			cper_record_view_arm(&view, 0);
+		if (arm == NULL) {
+			UINT32 length = 0;
+			ASSERT_NE(cper_record_view_section(&view, 0, &length),
+				  nullptr);
+			unknown_blob_sizes.insert(length);
+			continue;
+		}
+		UINT16 context_count;
+		size_t vendor_len;
+		arm_section_shape(arm, &context_count, &vendor_len);
+		context_counts.insert(context_count);
+		arm_blob_sizes.insert(vendor_len);
+	}
+	EXPECT_EQ(context_counts, (std::set<UINT16>{ 1, 5 }));
+	EXPECT_EQ(arm_blob_sizes, (std::set<size_t>{ 16, 4096 }));
+	EXPECT_EQ(unknown_blob_sizes, (std::set<size_t>{ 16, 4096 }));
+	cper_generator_profile_free(&profile);
+
+	//Values outside each distribution's range, and all zero weights, are rejected.
+	const char *invalid[3] = {
+		"{\"sections\": {\"arm\": 1}, \"armContextCounts\": {\"0\": 1}}",
+		"{\"sections\": {\"arm\": 1}, \"vendorBlobSizes\": {\"0\": 1}}",
+		"{\"sections\": {\"arm\": 1}, \"sectionCounts\": {\"2\": 0}}"
+	};
+	for (const char *json : invalid) {
+		ir = json_tokener_parse(json);
+		EXPECT_FALSE(cper_generator_profile_from_ir(&profile, ir))
+			<< json;
+		json_object_put(ir);
+	}
+}
+
+//Section cache tests.
+static json_object *cached_record_to_ir(char *buf, size_t size)
+{
+	FILE *record = fmemopen(buf, size, "r");
+	json_object *ir = cper_to_ir(record);
+	fclose(record);
+	return ir;
+}
+
+TEST(SectionCacheTests, RepeatedSections)
+{
+	const char *section_name = "memory";
+	char *buf;
+	size_t size;
+	FILE *record =
+		generate_record_memstream(&section_name, 1, &buf, &size, 0);
+	fclose(record);
+	ASSERT_TRUE(cper_section_cache_enable(1));
+
+	//A repeat of the same section, even with a different header, is served from the cache as an
+	//equal but unshared copy.
+	json_object *first = cached_record_to_ir(buf, size);
+	((EFI_COMMON_ERROR_RECORD_HEADER *)buf)->RecordID++;
+	json_object *second = cached_record_to_ir(buf, size);
+	json_object *section = json_object_array_get_idx(
+		json_object_object_get(first, "sections"), 0);
+	json_object *second_section = json_object_array_get_idx(
+		json_object_object_get(second, "sections"), 0);
+	EXPECT_NE(section, second_section);
+	EXPECT_TRUE(json_object_equal(section, second_section));
+
+	//Modifying one record's section leaves the cache, and so later hits, unchanged.
+	json_object_object_add(second_section, "modified",
+			       json_object_new_boolean(1));
+	json_object *third = cached_record_to_ir(buf, size);
+	json_object *third_section = json_object_array_get_idx(
+		json_object_object_get(third, "sections"), 0);
+	EXPECT_EQ(json_object_object_get(third_section, "modified"), nullptr);
+	EXPECT_TRUE(json_object_equal(section, third_section));
+	json_object_object_del(second_section, "modified");
+	json_object_put(first);
+	json_object_put(third);
+
+	//The shared IR still converts back to the original record.
+	char *cper_buf;
+	size_t cper_size;
+	FILE *stream = open_memstream(&cper_buf, &cper_size);
+	ir_to_cper(second, stream);
+	fclose(stream);
+	ASSERT_EQ(cper_size, size);
+	EXPECT_EQ(memcmp(cper_buf, buf, size), 0);
+	free(cper_buf);
+	json_object_put(second);
+
+	//Changed section bytes or IR flags miss, evicting the only entry.
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(buf +
+						 sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
+	buf[descriptor->SectionOffset + descriptor->SectionLength - 1] ^= 0x1;
+	json_object_put(cached_record_to_ir(buf, size));
+	{
+		ScopedIRFlags flags(CPER_IR_FLAG_COMPACT);
+		json_object_put(cached_record_to_ir(buf, size));
+	}
+
+	cper_section_cache_stats stats;
+	cper_section_cache_get_stats(&stats);
+	EXPECT_EQ(stats.hits, 2u);
+	EXPECT_EQ(stats.misses, 3u);
+	EXPECT_EQ(stats.evictions, 2u);
+	EXPECT_EQ(stats.entries, 1u);
+	cper_section_cache_disable();
+	free(buf);
+}
+
+TEST(SectionCacheTests, LazyPayloadsUnshared)
+{
+	//Seeded, so that the unknown section is never empty.
+	const char *section_name = "unknown";
+	cper_generator_context context;
+	cper_generator_seed(&context, 38);
+	std::string record = generate_seeded_record(&context, &section_name, 1);
+	ScopedIRFlags flags(CPER_IR_FLAG_LAZY_BASE64);
+	ASSERT_TRUE(cper_section_cache_enable(1));
+
+	//Materialising one record's lazy payload does not materialise a cache hit's copy.
+	json_object *first = cached_record_to_ir(record.data(), record.size());
+	json_object *second =
+		cached_record_to_ir(record.data(), record.size());
+	ASSERT_NE(first, nullptr);
+	ASSERT_NE(second, nullptr);
+	cper_ir_materialise(first);
+	json_object *first_data = json_object_object_get(
+		json_object_array_get_idx(
+			json_object_object_get(first, "sections"), 0),
+		"data");
+	json_object *second_data = json_object_object_get(
+		json_object_array_get_idx(
+			json_object_object_get(second, "sections"), 0),
+		"data");
+	ASSERT_NE(second_data, nullptr);
+	EXPECT_GT(json_object_get_string_len(first_data), 0);
+	EXPECT_EQ(json_object_get_string_len(second_data), 0);
+
+	//The still lazy copy serialises to the same payload.
+	EXPECT_STREQ(json_object_to_json_string(first_data),
+		     json_object_to_json_string(second_data));
+	cper_section_cache_stats stats;
+	cper_section_cache_get_stats(&stats);
+	EXPECT_EQ(stats.hits, 1u);
+
+	json_object_put(first);
+	json_object_put(second);
+	cper_section_cache_disable();
+}
+
+//Compact profile tests.
+TEST(CompactTests, RawIntegers)
+{
+	//Generate a record and convert in the compact profile.
+	const char *section_name = "memory";
+	char *buf;
+	size_t size;
+	FILE *record =
+		generate_record_memstream(&section_name, 1, &buf, &size, 0);
+	json_object *ir = cper_to_ir_ex(record, CPER_IR_FLAG_COMPACT);
+	fclose(record);
+	free(buf);
+
+	//Bitfields, enumerated values and revisions should be raw integers.
+	json_object *header = json_object_object_get(ir, "header");
+	json_object *section =
+		json_object_array_get_idx(json_object_object_get(ir, "sections"), 0);
+	EXPECT_TRUE(json_object_is_type(
+		json_object_object_get(header, "revision"), json_type_int));
+	EXPECT_TRUE(json_object_is_type(
+		json_object_object_get(header, "validationBits"),
+		json_type_int));
+	EXPECT_TRUE(json_object_is_type(
+		json_object_object_get(section, "memoryErrorType"),
+		json_type_int));
+
+	//Compact headers are only valid under the compact profile of the header schema.
+	std::string header_spec = spec_path("cper-json-header.json");
+	char error_message[JSON_ERROR_MSG_MAX_LEN] = { 0 };
+	EXPECT_EQ(validate_schema_from_file(header_spec.c_str(), header,
+					    error_message),
+		  0);
+	{
+		ScopedCompactValidation validation;
+		EXPECT_EQ(validate_schema_from_file(header_spec.c_str(), header,
+						    error_message),
+			  1)
+			<< error_message;
+	}
+	json_object_put(ir);
+}
+TEST(CompactTests, AllSections)
+{
+	for (size_t i = 0; i < generator_definitions_len; i++) {
+		cper_log_section_compact_test(
+			generator_definitions[i].ShortName);
+	}
+}
+
+//Packed register array tests.
+
+//Checks that a section's packed register array is checked by its section schema: the section is
+//valid as decoded, and invalid once a register is no longer an integer.
+static void expect_packed_registers_checked(json_object *section,
+					    json_object *registers,
+					    const char *schema)
+{
+	ASSERT_TRUE(json_object_is_type(registers, json_type_array));
+	ASSERT_GT(json_object_array_length(registers), 0u);
+	ASSERT_TRUE(json_object_is_type(
+		json_object_array_get_idx(registers, 0), json_type_int));
+	std::string spec = spec_path(schema);
+	char error_message[JSON_ERROR_MSG_MAX_LEN] = { 0 };
+	EXPECT_EQ(validate_schema_from_file(spec.c_str(), section,
+					    error_message),
+		  1)
+		<< error_message;
+	json_object_array_put_idx(registers, 0, json_object_new_string("0"));
+	EXPECT_EQ(validate_schema_from_file(spec.c_str(), section,
+					    error_message),
+		  0);
+}
+
+TEST(PackedRegisterTests, IA32x64Arrays)
+{
+	//Generated context structure types are random (and the generator reseeds per record), so
+	//swap the generated section body for one holding a known IA32 and x64 register state.
+	const char *section_name = "ia32x64";
+	char *buf;
+	size_t size;
+	FILE *generated = generate_record_memstream(&section_name, 1, &buf,
+						    &size, 0);
+	fclose(generated);
+
+	size_t context_header = sizeof(EFI_IA32_X64_PROCESSOR_CONTEXT_INFO);
+	size_t section_size = sizeof(EFI_IA32_X64_PROCESSOR_ERROR_RECORD) +
+			      context_header +
+			      sizeof(EFI_CONTEXT_IA32_REGISTER_STATE) +
+			      context_header +
+			      sizeof(EFI_CONTEXT_X64_REGISTER_STATE);
+	size_t prefix_size = sizeof(EFI_COMMON_ERROR_RECORD_HEADER) +
+			     sizeof(EFI_ERROR_SECTION_DESCRIPTOR);
+	char *record_buf = (char *)calloc(1, prefix_size + section_size);
+	memcpy(record_buf, buf, prefix_size);
+	free(buf);
+
+	EFI_COMMON_ERROR_RECORD_HEADER *header =
+		(EFI_COMMON_ERROR_RECORD_HEADER *)record_buf;
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(header + 1);
+	header->RecordLength = prefix_size + section_size;
+	descriptor->SectionOffset = prefix_size;
+	descriptor->SectionLength = section_size;
+
+	//No error structures, two context structures.
+	UINT8 *section = (UINT8 *)record_buf + prefix_size;
+	*(UINT64 *)section = 2 << 8;
+	UINT8 *cur_pos = section + sizeof(EFI_IA32_X64_PROCESSOR_ERROR_RECORD);
+	EFI_IA32_X64_PROCESSOR_CONTEXT_INFO *context =
+		(EFI_IA32_X64_PROCESSOR_CONTEXT_INFO *)cur_pos;
+	context->RegisterType = EFI_REG_CONTEXT_TYPE_IA32;
+	context->ArraySize = sizeof(EFI_CONTEXT_IA32_REGISTER_STATE);
+	cur_pos += context_header;
+	((EFI_CONTEXT_IA32_REGISTER_STATE *)cur_pos)->Eax = 0x1234;
+	cur_pos += sizeof(EFI_CONTEXT_IA32_REGISTER_STATE);
+	context = (EFI_IA32_X64_PROCESSOR_CONTEXT_INFO *)cur_pos;
+	context->RegisterType = EFI_REG_CONTEXT_TYPE_X64;
+	context->ArraySize = sizeof(EFI_CONTEXT_X64_REGISTER_STATE);
+	cur_pos += context_header;
+	((EFI_CONTEXT_X64_REGISTER_STATE *)cur_pos)->Rax = 0x5678;
+
+	FILE *record = fmemopen(record_buf, prefix_size + section_size, "r");
+	json_object *ir = cper_to_ir_ex(record, CPER_IR_FLAG_PACKED_REGISTERS);
+	fclose(record);
+	free(record_buf);
+	ASSERT_TRUE(ir != NULL);
+
+	json_object *contexts = json_object_object_get(
+		json_object_array_get_idx(json_object_object_get(ir,
+								 "sections"),
+					  0),
+		"processorContextInfo");
+	ASSERT_EQ(json_object_array_length(contexts), 2u);
+	size_t expected_lengths[2] = { 25, 36 };
+	UINT64 expected_first[2] = { 0x1234, 0x5678 };
+	for (size_t i = 0; i < 2; i++) {
+		json_object *registers = json_object_object_get(
+			json_object_array_get_idx(contexts, i),
+			"registerArray");
+		ASSERT_TRUE(json_object_is_type(registers, json_type_array));
+		EXPECT_EQ(json_object_array_length(registers),
+			  expected_lengths[i]);
+		EXPECT_EQ(json_object_get_uint64(
+				  json_object_array_get_idx(registers, 0)),
+			  expected_first[i]);
+	}
+
+	//Packed arrays are checked against the register lists in the schema's "$defs".
+	json_object *section_ir = json_object_array_get_idx(
+		json_object_object_get(ir, "sections"), 0);
+	std::string section_spec =
+		spec_path("sections/cper-ia32x64-processor.json");
+	char error_message[JSON_ERROR_MSG_MAX_LEN] = { 0 };
+	EXPECT_EQ(validate_schema_from_file(section_spec.c_str(), section_ir,
+					    error_message),
+		  1)
+		<< error_message;
+	json_object_array_del_idx(
+		json_object_object_get(json_object_array_get_idx(contexts, 0),
+				       "registerArray"),
+		0, 1);
+	EXPECT_EQ(validate_schema_from_file(section_spec.c_str(), section_ir,
+					    error_message),
+		  0);
+	json_object_put(ir);
+}
+TEST(PackedRegisterTests, ArmArrays)
+{
+	//Generated ARM sections carry no context structures, so swap the generated section body for
+	//one holding a known AArch32 and AArch64 register state.
+	const char *section_name = "arm";
+	char *buf;
+	size_t size;
+	FILE *generated = generate_record_memstream(&section_name, 1, &buf,
+						    &size, 0);
+	fclose(generated);
+
+	size_t context_header = sizeof(EFI_ARM_CONTEXT_INFORMATION_HEADER);
+	size_t section_size = sizeof(EFI_ARM_ERROR_RECORD) + context_header +
+			      sizeof(EFI_ARM_V8_AARCH32_GPR) + context_header +
+			      sizeof(EFI_ARM_V8_AARCH64_GPR);
+	size_t prefix_size = sizeof(EFI_COMMON_ERROR_RECORD_HEADER) +
+			     sizeof(EFI_ERROR_SECTION_DESCRIPTOR);
+	char *record_buf = (char *)calloc(1, prefix_size + section_size);
+	memcpy(record_buf, buf, prefix_size);
+	free(buf);
+
+	EFI_COMMON_ERROR_RECORD_HEADER *header =
+		(EFI_COMMON_ERROR_RECORD_HEADER *)record_buf;
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(header + 1);
+	header->RecordLength = prefix_size + section_size;
+	descriptor->SectionOffset = prefix_size;
+	descriptor->SectionLength = section_size;
+
+	//No error structures, two context structures.
+	EFI_ARM_ERROR_RECORD *arm =
+		(EFI_ARM_ERROR_RECORD *)(record_buf + prefix_size);
+	arm->ContextInfoNum = 2;
+	arm->SectionLength = section_size;
+	UINT8 *cur_pos = (UINT8 *)(arm + 1);
+	EFI_ARM_CONTEXT_INFORMATION_HEADER *context =
+		(EFI_ARM_CONTEXT_INFORMATION_HEADER *)cur_pos;
+	context->RegisterContextType = EFI_ARM_CONTEXT_TYPE_AARCH32_GPR;
+	context->RegisterArraySize = sizeof(EFI_ARM_V8_AARCH32_GPR);
+	cur_pos += context_header;
+	((EFI_ARM_V8_AARCH32_GPR *)cur_pos)->R0 = 0x1234;
+	cur_pos += sizeof(EFI_ARM_V8_AARCH32_GPR);
+	context = (EFI_ARM_CONTEXT_INFORMATION_HEADER *)cur_pos;
+	context->RegisterContextType = EFI_ARM_CONTEXT_TYPE_AARCH64_GPR;
+	context->RegisterArraySize = sizeof(EFI_ARM_V8_AARCH64_GPR);
+
+	FILE *record = fmemopen(record_buf, prefix_size + section_size, "r");
+	json_object *ir = cper_to_ir_ex(record, CPER_IR_FLAG_PACKED_REGISTERS);
+	fclose(record);
+	free(record_buf);
+	ASSERT_NE(ir, nullptr);
+
+	//Both packed arrays are checked against the register lists in the schema's "$defs".
+	json_object *section = json_object_array_get_idx(
+		json_object_object_get(ir, "sections"), 0);
+	json_object *contexts = json_object_object_get(section, "contextInfo");
+	ASSERT_EQ(json_object_array_length(contexts), 2u);
+	for (size_t i = 0; i < 2; i++) {
+		json_object *registers = json_object_object_get(
+			json_object_array_get_idx(contexts, i),
+			"registerArray");
+		expect_packed_registers_checked(
+			section, registers, "sections/cper-arm-processor.json");
+		json_object_array_put_idx(registers, 0,
+					  json_object_new_int(0));
+	}
+	json_object_put(ir);
+}
+TEST(PackedRegisterTests, IA32x64RoundTrip)
+{
+	cper_log_section_packed_registers_test("ia32x64");
+}
+TEST(PackedRegisterTests, ArmRoundTrip)
+{
+	cper_log_section_packed_registers_test("arm");
+}
+TEST(PackedRegisterTests, NvidiaRoundTrip)
+{
+	cper_log_section_packed_registers_test("nvidia");
+}
+TEST(PackedRegisterTests, NvidiaArrays)
+{
+	//Seeded, so that the section has registers.
+	const char *section_name = "nvidia";
+	cper_generator_context context;
+	cper_generator_seed(&context, 31);
+	std::string record = generate_seeded_record(&context, &section_name, 1);
+	FILE *stream = fmemopen(record.data(), record.size(), "r");
+	json_object *ir = cper_to_ir_ex(stream, CPER_IR_FLAG_PACKED_REGISTERS);
+	fclose(stream);
+	ASSERT_NE(ir, nullptr);
+
+	json_object *section = json_object_array_get_idx(
+		json_object_object_get(ir, "sections"), 0);
+	expect_packed_registers_checked(
+		section, json_object_object_get(section, "registers"),
+		"sections/cper-nvidia.json");
+	json_object_put(ir);
+}
+
+//Encodes an NVIDIA section with the given packed registers and register count, returning the
+//number of bytes written.
+static size_t nvidia_packed_encode(json_object *section,
+				   std::initializer_list<UINT64> registers,
+				   int number_regs)
+{
+	json_object *regarr = json_object_new_array();
+	for (UINT64 value : registers) {
+		json_object_array_add(regarr, json_object_new_uint64(value));
+	}
+	json_object_object_add(section, "registers", regarr);
+	json_object_object_add(section, "numberRegs",
+			       json_object_new_int(number_regs));
+
+	char *buf;
+	size_t size;
+	FILE *stream = open_memstream(&buf, &size);
+	ir_section_nvidia_to_cper(section, stream);
+	fclose(stream);
+	free(buf);
+	return size;
+}
+
+TEST(PackedRegisterTests, NvidiaInvalidRegisters)
+{
+	const char *section_name = "nvidia";
+	char *buf;
+	size_t size;
+	FILE *record =
+		generate_record_memstream(&section_name, 1, &buf, &size, 1);
+	json_object *ir = cper_single_section_to_ir_ex(
+		record, CPER_IR_FLAG_PACKED_REGISTERS);
+	fclose(record);
+	free(buf);
+	ASSERT_NE(ir, nullptr);
+	json_object *section = json_object_object_get(ir, "section");
+
+	//Odd length packed arrays and register count mismatches write nothing.
+	EXPECT_EQ(nvidia_packed_encode(section, { 1, 2, 3 }, 1), 0u);
+	EXPECT_EQ(nvidia_packed_encode(section, { 1, 2, 3, 4 }, 3), 0u);
+	EXPECT_EQ(nvidia_packed_encode(section, { 1, 2, 3, 4 }, 2),
+		  sizeof(EFI_NVIDIA_ERROR_DATA) +
+			  2 * sizeof(EFI_NVIDIA_REGISTER_DATA));
+	json_object_put(ir);
+}
+
 /*
 * Single section tests.
 */
@@ -172,6 +1216,10 @@ TEST(ArmTests, BinaryEqual)
 {
 	cper_log_section_dual_binary_test("arm");
 }
+TEST(ArmTests, LazyBase64Equal)
+{
+	cper_log_section_lazy_base64_test("arm");
+}
 
 //Memory tests.
 TEST(MemoryTests, IRValid)
@@ -272,6 +1320,10 @@ TEST(CCIXPERTests, BinaryEqual)
 {
 	cper_log_section_dual_binary_test("ccixper");
 }
+TEST(CCIXPERTests, LazyBase64Equal)
+{
+	cper_log_section_lazy_base64_test("ccixper");
+}
 
 //CXL Protocol tests.
 TEST(CXLProtocolTests, IRValid)
@@ -282,6 +1334,10 @@ TEST(CXLProtocolTests, BinaryEqual)
 {
 	cper_log_section_dual_binary_test("cxlprotocol");
 }
+TEST(CXLProtocolTests, LazyBase64Equal)
+{
+	cper_log_section_lazy_base64_test("cxlprotocol");
+}
 
 //CXL Component tests.
 TEST(CXLComponentTests, IRValid)
@@ -292,6 +1348,133 @@ TEST(CXLComponentTests, BinaryEqual)
 {
 	cper_log_section_dual_binary_test("cxlcomponent-media");
 }
+TEST(CXLComponentTests, LazyBase64Equal)
+{
+	cper_log_section_lazy_base64_test("cxlcomponent-media");
+}
+TEST(CXLComponentTests, DramBinaryEqual)
+{
+	cper_log_section_dual_ir_test("cxlcomponent-dram");
+	cper_log_section_dual_binary_test("cxlcomponent-dram");
+}
+TEST(CXLComponentTests, MemoryModuleBinaryEqual)
+{
+	cper_log_section_dual_ir_test("cxlcomponent-memory");
+	cper_log_section_dual_binary_test("cxlcomponent-memory");
+}
+TEST(CXLComponentTests, RawEventLogBinaryEqual)
+{
+	cper_log_section_dual_ir_test("cxlcomponent-mld");
+	cper_log_section_dual_binary_test("cxlcomponent-mld");
+}
+TEST(CXLComponentTests, TypedEventRecord)
+{
+	const char *section_name = "cxlcomponent-media";
+	char *buf;
+	size_t size;
+	FILE *record = generate_record_memstream(&section_name, 1, &buf, &size,
+						 0);
+	fclose(record);
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(buf +
+						 sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
+	EFI_CXL_GENERAL_MEDIA_EVENT_RECORD *event =
+		(EFI_CXL_GENERAL_MEDIA_EVENT_RECORD
+			 *)(buf + descriptor->SectionOffset +
+			    sizeof(EFI_CXL_COMPONENT_EVENT_HEADER));
+	event->PhysicalAddress = 0x123440 | 0x1;
+	event->MemoryEventType = 0;
+	event->TransactionType = 1;
+	event->ValidityFlags = 0x3;
+	event->Channel = 2;
+	event->Rank = 1;
+
+	//Known layouts are decoded into typed fields.
+	record = fmemopen(buf, size, "r");
+	json_object *ir = cper_to_ir(record);
+	fclose(record);
+	json_object *event_log = json_object_object_get(
+		json_object_array_get_idx(json_object_object_get(ir,
+								 "sections"),
+					  0),
+		"cxlComponentEventLog");
+	EXPECT_TRUE(json_object_object_get(event_log, "data") == NULL);
+	json_object *media =
+		json_object_object_get(event_log, "generalMediaEvent");
+	ASSERT_TRUE(media != NULL);
+	EXPECT_EQ(json_object_get_uint64(
+			  json_object_object_get(media, "physicalAddress")),
+		  0x123440u);
+	EXPECT_TRUE(json_object_get_boolean(json_object_object_get(
+		json_object_object_get(media, "physicalAddressFlags"),
+		"volatile")));
+	EXPECT_STREQ(json_object_get_string(json_object_object_get(
+			     json_object_object_get(media, "transactionType"),
+			     "name")),
+		     "Host Read");
+	EXPECT_EQ(json_object_get_int(json_object_object_get(media, "channel")),
+		  2);
+	json_object_put(ir);
+
+	//Reserved space in use (e.g. a newer record revision) falls back to a raw dump.
+	event->Reserved[0] = 1;
+	record = fmemopen(buf, size, "r");
+	ir = cper_to_ir(record);
+	fclose(record);
+	event_log = json_object_object_get(
+		json_object_array_get_idx(json_object_object_get(ir,
+								 "sections"),
+					  0),
+		"cxlComponentEventLog");
+	EXPECT_TRUE(json_object_object_get(event_log, "data") != NULL);
+	EXPECT_TRUE(json_object_object_get(event_log, "generalMediaEvent") ==
+		    NULL);
+	json_object_put(ir);
+	free(buf);
+}
+
+//NVIDIA tests.
+TEST(NVIDIATests, IRValid)
+{
+	cper_log_section_dual_ir_test("nvidia");
+}
+TEST(NVIDIATests, BinaryEqual)
+{
+	cper_log_section_dual_binary_test("nvidia");
+}
+TEST(NVIDIATests, EmptyRegisters)
+{
+	const char *section_name = "nvidia";
+	char *buf;
+	size_t size;
+	FILE *record =
+		generate_record_memstream(&section_name, 1, &buf, &size, 1);
+	json_object *ir = cper_single_section_to_ir(record);
+	fclose(record);
+	free(buf);
+	ASSERT_NE(ir, nullptr);
+
+	//A section without registers is valid.
+	json_object *section = json_object_object_get(ir, "section");
+	json_object_object_add(section, "numberRegs", json_object_new_int(0));
+	json_object_object_add(section, "registers", json_object_new_array());
+	std::string spec = spec_path("sections/cper-nvidia.json");
+	char error_message[JSON_ERROR_MSG_MAX_LEN] = { 0 };
+	EXPECT_EQ(validate_schema_from_file(spec.c_str(), section,
+					    error_message),
+		  1)
+		<< error_message;
+	json_object_put(ir);
+
+	//An empty array matches both the object pair and packed forms, so the forms must be
+	//"anyOf" rather than "oneOf" for other validators to accept it.
+	json_object *schema = json_object_from_file(spec.c_str());
+	json_object *registers = json_object_object_get(
+		json_object_object_get(schema, "properties"), "registers");
+	EXPECT_EQ(json_object_object_get(registers, "oneOf"), nullptr);
+	EXPECT_NE(json_object_object_get(registers, "anyOf"), nullptr);
+	json_object_put(schema);
+}
 
 //Unknown section tests.
 TEST(UnknownSectionTests, IRValid)
@@ -302,6 +1485,10 @@ TEST(UnknownSectionTests, BinaryEqual)
 {
 	cper_log_section_dual_binary_test("unknown");
 }
+TEST(UnknownSectionTests, LazyBase64Equal)
+{
+	cper_log_section_lazy_base64_test("unknown");
+}
 
 //Entrypoint for the testing program.
 int main()
@@ -0,0 +1,271 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <json.h>
+#include "edk/Cper.h"
+#include "cper-parse.h"
+#include "cper-metrics.h"
+#include "generator/cper-generate.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+//Seed that every record is generated from, so that unknown sections are never empty.
+#define METRICS_SEED 50
+
+//Generates a full record with the given section types.
+static std::string metrics_record(const char **types, UINT16 num_types)
+{
+	cper_generator_context context;
+	cper_generator_seed(&context, METRICS_SEED);
+	char *buf;
+	size_t size;
+	FILE *stream = open_memstream(&buf, &size);
+	generate_cper_record_with_context(&context, const_cast<char **>(types),
+					  num_types, stream);
+	fclose(stream);
+	std::string result(buf, size);
+	free(buf);
+	return result;
+}
+
+static json_object *metrics_decode(std::string &record)
+{
+	FILE *stream = fmemopen(record.data(), record.size(), "r");
+	json_object *ir = cper_to_ir(stream);
+	fclose(stream);
+	return ir;
+}
+
+//Returns the counters for the section type with the given GUID, or for unknown sections if NULL.
+static const cper_section_metrics *metrics_section(const cper_metrics *metrics,
+						   const EFI_GUID *guid)
+{
+	for (size_t i = 0; i < metrics->sections_len; i++) {
+		if (metrics->sections[i].guid == guid) {
+			return &metrics->sections[i];
+		}
+	}
+	return NULL;
+}
+
+static UINT64 metrics_latency_count(const cper_section_metrics *section)
+{
+	UINT64 count = 0;
+	for (size_t i = 0; i < CPER_METRICS_LATENCY_BUCKETS; i++) {
+		count += section->decode_latency[i];
+	}
+	return count;
+}
+
+TEST(Metrics, DecodeAndEncode)
+{
+	const char *types[2] = { "arm", "unknown" };
+	std::string record = metrics_record(types, 2);
+
+	cper_metrics before;
+	ASSERT_TRUE(cper_metrics_snapshot(&before));
+	json_object *ir = metrics_decode(record);
+	ASSERT_NE(ir, nullptr);
+	char *encoded;
+	size_t encoded_size;
+	FILE *stream = open_memstream(&encoded, &encoded_size);
+	ir_to_cper(ir, stream);
+	fclose(stream);
+	json_object_put(ir);
+	cper_metrics after;
+	ASSERT_TRUE(cper_metrics_snapshot(&after));
+
+	//Record level counters.
+	EXPECT_EQ(after.records_decoded - before.records_decoded, 1u);
+	EXPECT_EQ(after.records_encoded - before.records_encoded, 1u);
+	EXPECT_EQ(after.bytes_in - before.bytes_in, record.size());
+	EXPECT_EQ(after.bytes_out - before.bytes_out, encoded_size);
+	EXPECT_EQ(after.unknown_sections_decoded -
+			  before.unknown_sections_decoded,
+		  1u);
+	EXPECT_EQ(after.unknown_sections_encoded -
+			  before.unknown_sections_encoded,
+		  1u);
+	EXPECT_GT(after.base64_bytes, before.base64_bytes);
+	free(encoded);
+
+	//Section counters, including the latency histogram.
+	const cper_section_metrics *arm_before =
+		metrics_section(&before, &gEfiArmProcessorErrorSectionGuid);
+	const cper_section_metrics *arm_after =
+		metrics_section(&after, &gEfiArmProcessorErrorSectionGuid);
+	ASSERT_NE(arm_after, nullptr);
+	EXPECT_EQ(arm_after->decoded - arm_before->decoded, 1u);
+	EXPECT_EQ(arm_after->encoded - arm_before->encoded, 1u);
+	EXPECT_GT(arm_after->decode_ns, arm_before->decode_ns);
+	EXPECT_EQ(metrics_latency_count(arm_after) -
+			  metrics_latency_count(arm_before),
+		  1u);
+	const cper_section_metrics *unknown_after =
+		metrics_section(&after, NULL);
+	ASSERT_NE(unknown_after, nullptr);
+	EXPECT_EQ(unknown_after->decoded -
+			  metrics_section(&before, NULL)->decoded,
+		  1u);
+
+	cper_metrics_free(&before);
+	cper_metrics_free(&after);
+}
+
+TEST(Metrics, Reset)
+{
+	const char *types[2] = { "arm", "unknown" };
+	std::string record = metrics_record(types, 2);
+
+	//After a reset, one round trip gives exact counts.
+	cper_metrics_reset();
+	json_object *ir = metrics_decode(record);
+	ASSERT_NE(ir, nullptr);
+	char *encoded;
+	size_t encoded_size;
+	FILE *stream = open_memstream(&encoded, &encoded_size);
+	ir_to_cper(ir, stream);
+	fclose(stream);
+	json_object_put(ir);
+	free(encoded);
+	cper_metrics metrics;
+	ASSERT_TRUE(cper_metrics_snapshot(&metrics));
+
+	EXPECT_EQ(metrics.records_decoded, 1u);
+	EXPECT_EQ(metrics.records_encoded, 1u);
+	EXPECT_EQ(metrics.bytes_in, record.size());
+	EXPECT_EQ(metrics.unknown_sections_decoded, 1u);
+	EXPECT_EQ(metrics.unknown_sections_encoded, 1u);
+	for (size_t i = 0; i < CPER_METRICS_FAILURE_COUNT; i++) {
+		EXPECT_EQ(metrics.failures[i], 0u);
+	}
+	const cper_section_metrics *arm =
+		metrics_section(&metrics, &gEfiArmProcessorErrorSectionGuid);
+	ASSERT_NE(arm, nullptr);
+	EXPECT_EQ(arm->decoded, 1u);
+	EXPECT_EQ(arm->encoded, 1u);
+	EXPECT_EQ(metrics_latency_count(arm), 1u);
+	cper_metrics_free(&metrics);
+
+	//Resetting again clears the round trip's counts.
+	cper_metrics_reset();
+	ASSERT_TRUE(cper_metrics_snapshot(&metrics));
+	EXPECT_EQ(metrics.records_decoded, 0u);
+	EXPECT_EQ(metrics.bytes_in, 0u);
+	EXPECT_EQ(metrics.unknown_sections_decoded, 0u);
+	cper_metrics_free(&metrics);
+}
+
+TEST(Metrics, Failures)
+{
+	const char *types[1] = { "memory" };
+	std::string record = metrics_record(types, 1);
+	cper_metrics before;
+	ASSERT_TRUE(cper_metrics_snapshot(&before));
+
+	std::string short_header = record.substr(0, 16);
+	EXPECT_EQ(metrics_decode(short_header), nullptr);
+	std::string bad_signature = record;
+	bad_signature[0] = 'X';
+	EXPECT_EQ(metrics_decode(bad_signature), nullptr);
+	std::string short_descriptor =
+		record.substr(0, sizeof(EFI_COMMON_ERROR_RECORD_HEADER) + 8);
+	EXPECT_EQ(metrics_decode(short_descriptor), nullptr);
+
+	cper_metrics after;
+	ASSERT_TRUE(cper_metrics_snapshot(&after));
+	EXPECT_EQ(after.failures[CPER_METRICS_FAILURE_SHORT_HEADER] -
+			  before.failures[CPER_METRICS_FAILURE_SHORT_HEADER],
+		  1u);
+	EXPECT_EQ(after.failures[CPER_METRICS_FAILURE_BAD_SIGNATURE] -
+			  before.failures[CPER_METRICS_FAILURE_BAD_SIGNATURE],
+		  1u);
+	EXPECT_EQ(
+		after.failures[CPER_METRICS_FAILURE_SHORT_DESCRIPTOR] -
+			before.failures[CPER_METRICS_FAILURE_SHORT_DESCRIPTOR],
+		1u);
+	EXPECT_EQ(after.records_decoded, before.records_decoded);
+	EXPECT_STREQ(cper_metrics_failure_name(
+			     CPER_METRICS_FAILURE_SHORT_HEADER),
+		     "short_header");
+	cper_metrics_free(&before);
+	cper_metrics_free(&after);
+}
+
+TEST(Metrics, FailedSection)
+{
+	const char *types[1] = { "cxlcomponent-pswitch" };
+	std::string record = metrics_record(types, 1);
+
+	//An event log length too large to encode fails the section's decode.
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(record.data() +
+						 sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
+	UINT32 length = 0x7FFFFF00;
+	memcpy(record.data() + descriptor->SectionOffset, &length,
+	       sizeof(length));
+
+	cper_metrics before;
+	ASSERT_TRUE(cper_metrics_snapshot(&before));
+	json_object *ir = metrics_decode(record);
+	ASSERT_NE(ir, nullptr);
+	EXPECT_EQ(json_object_array_get_idx(
+			  json_object_object_get(ir, "sections"), 0),
+		  nullptr);
+	json_object_put(ir);
+	cper_metrics after;
+	ASSERT_TRUE(cper_metrics_snapshot(&after));
+
+	//The failure is counted, but not as a decoded section or a latency sample.
+	EXPECT_EQ(after.failures[CPER_METRICS_FAILURE_SECTION_DECODE] -
+			  before.failures[CPER_METRICS_FAILURE_SECTION_DECODE],
+		  1u);
+	const cper_section_metrics *switch_before = metrics_section(
+		&before, &gEfiCxlPhysicalSwitchErrorSectionGuid);
+	const cper_section_metrics *switch_after = metrics_section(
+		&after, &gEfiCxlPhysicalSwitchErrorSectionGuid);
+	ASSERT_NE(switch_after, nullptr);
+	EXPECT_EQ(switch_after->decoded, switch_before->decoded);
+	EXPECT_EQ(switch_after->decode_ns, switch_before->decode_ns);
+	EXPECT_EQ(metrics_latency_count(switch_after),
+		  metrics_latency_count(switch_before));
+	cper_metrics_free(&before);
+	cper_metrics_free(&after);
+}
+
+TEST(Metrics, ExitedThreads)
+{
+	const char *types[1] = { "pcie" };
+	std::string record = metrics_record(types, 1);
+	cper_metrics before;
+	ASSERT_TRUE(cper_metrics_snapshot(&before));
+
+	//Counts from threads that have since exited are kept.
+	std::thread decoder([&record]() {
+		for (int i = 0; i < 3; i++) {
+			json_object_put(metrics_decode(record));
+		}
+	});
+	decoder.join();
+
+	cper_metrics after;
+	ASSERT_TRUE(cper_metrics_snapshot(&after));
+	EXPECT_EQ(after.records_decoded - before.records_decoded, 3u);
+	EXPECT_EQ(metrics_section(&after, &gEfiPcieErrorSectionGuid)->decoded -
+			  metrics_section(&before, &gEfiPcieErrorSectionGuid)
+				  ->decoded,
+		  3u);
+	cper_metrics_free(&before);
+	cper_metrics_free(&after);
+}
+
+TEST(Metrics, LatencyBounds)
+{
+	EXPECT_EQ(cper_metrics_latency_bound(0), 1024u);
+	EXPECT_EQ(cper_metrics_latency_bound(1), 2048u);
+	EXPECT_EQ(cper_metrics_latency_bound(CPER_METRICS_LATENCY_BUCKETS - 1),
+		  UINT64_MAX);
+}
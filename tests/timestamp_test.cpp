@@ -0,0 +1,55 @@
+#include "edk/Cper.h"
+#include "cper-utils.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+TEST(TimestampToString, Good)
+{
+	EFI_ERROR_TIME_STAMP timestamp = {};
+	timestamp.Century = 0x20;
+	timestamp.Year = 0x24;
+	timestamp.Month = 0x02;
+	timestamp.Day = 0x29;
+	timestamp.Hours = 0x13;
+	timestamp.Minutes = 0x05;
+	timestamp.Seconds = 0x59;
+	char out[TIMESTAMP_LENGTH];
+	timestamp_to_string(out, &timestamp);
+	ASSERT_STREQ(out, "2024-02-29T13:05:59.000");
+}
+
+TEST(StringToTimestamp, Good)
+{
+	EFI_ERROR_TIME_STAMP timestamp = {};
+	string_to_timestamp(&timestamp, "2024-2-29T13:05:59.000");
+	EXPECT_EQ(timestamp.Century, 0x20);
+	EXPECT_EQ(timestamp.Year, 0x24);
+	EXPECT_EQ(timestamp.Month, 0x02);
+	EXPECT_EQ(timestamp.Day, 0x29);
+	EXPECT_EQ(timestamp.Hours, 0x13);
+	EXPECT_EQ(timestamp.Minutes, 0x05);
+	EXPECT_EQ(timestamp.Seconds, 0x59);
+}
+
+TEST(StringToTimestamp, Bad)
+{
+	EFI_ERROR_TIME_STAMP timestamp = {};
+	timestamp.Year = 0x99;
+	string_to_timestamp(&timestamp, "224-02-29T13:05:59.000");
+	string_to_timestamp(&timestamp, "2024-02-29 13:05:59.000");
+	string_to_timestamp(&timestamp, "2024-02-29T13:05");
+	EXPECT_EQ(timestamp.Year, 0x99);
+	EXPECT_EQ(timestamp.Month, 0);
+}
+
+TEST(TimestampToEpoch, Good)
+{
+	EFI_ERROR_TIME_STAMP timestamp = {};
+	string_to_timestamp(&timestamp, "1970-01-01T00:00:00.000");
+	EXPECT_EQ(timestamp_to_epoch(&timestamp), 0);
+	string_to_timestamp(&timestamp, "2024-02-29T13:05:59.000");
+	EXPECT_EQ(timestamp_to_epoch(&timestamp), 1709211959);
+	string_to_timestamp(&timestamp, "1969-12-31T23:59:59.000");
+	EXPECT_EQ(timestamp_to_epoch(&timestamp), -1);
+}
@@ -0,0 +1,265 @@
+#include <cstdio>
+#include <cstring>
+#include "edk/Cper.h"
+#include "cper-parse.h"
+#include "cper-view.h"
+#include "test-utils.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+//Generates a record with the given section types, outputting the raw buffer and its IR.
+static json_object *generate_view_record(const char **types, UINT16 num_types,
+					 char **buf, size_t *size)
+{
+	FILE *record =
+		generate_record_memstream(types, num_types, buf, size, 0);
+	json_object *ir = cper_to_ir(record);
+	fclose(record);
+	return ir;
+}
+
+static json_object *ir_section(json_object *ir, int index)
+{
+	return json_object_array_get_idx(json_object_object_get(ir, "sections"),
+					 index);
+}
+
+static int ir_valid(json_object *section, const char *field)
+{
+	return json_object_get_boolean(json_object_object_get(
+		json_object_object_get(section, "validationBits"), field));
+}
+
+TEST(RecordView, Header)
+{
+	const char *types[2] = { "memory", "pcie" };
+	char *buf;
+	size_t size;
+	json_object *ir = generate_view_record(types, 2, &buf, &size);
+
+	cper_record_view view;
+	ASSERT_TRUE(cper_record_view_init(&view, buf, size));
+	json_object *header = json_object_object_get(ir, "header");
+	EXPECT_EQ(cper_record_view_section_count(&view), 2u);
+	EXPECT_EQ(cper_record_view_severity(&view),
+		  (UINT32)json_object_get_int(json_object_object_get(
+			  json_object_object_get(header, "severity"),
+			  "code")));
+	EXPECT_EQ(cper_record_view_record_id(&view),
+		  json_object_get_uint64(
+			  json_object_object_get(header, "recordID")));
+	EXPECT_TRUE(cper_record_view_section_type(&view, 0) != NULL);
+	EXPECT_TRUE(cper_record_view_descriptor(&view, 2) == NULL);
+	EXPECT_TRUE(cper_record_view_section(&view, 2, NULL) == NULL);
+
+	json_object_put(ir);
+	free(buf);
+}
+
+TEST(RecordView, TypedSections)
+{
+	const char *types[3] = { "memory", "pcie", "arm" };
+	char *buf;
+	size_t size;
+	json_object *ir = generate_view_record(types, 3, &buf, &size);
+
+	cper_record_view view;
+	ASSERT_TRUE(cper_record_view_init(&view, buf, size));
+
+	//Sections only resolve as their own type.
+	EXPECT_TRUE(cper_record_view_memory(&view, 0) != NULL);
+	EXPECT_TRUE(cper_record_view_pcie(&view, 0) == NULL);
+	EXPECT_TRUE(cper_record_view_pcie(&view, 1) != NULL);
+	EXPECT_TRUE(cper_record_view_arm(&view, 2) != NULL);
+	EXPECT_TRUE(cper_record_view_memory2(&view, 2) == NULL);
+
+	//Memory physical address.
+	json_object *memory = ir_section(ir, 0);
+	UINT64 address = 0;
+	int address_valid =
+		cper_record_view_memory_physical_address(&view, 0, &address);
+	EXPECT_EQ(address_valid, ir_valid(memory, "physicalAddressValid"));
+	if (address_valid) {
+		EXPECT_EQ(address,
+			  json_object_get_uint64(json_object_object_get(
+				  memory, "physicalAddress")));
+	}
+
+	//PCIe BDF.
+	json_object *pcie = ir_section(ir, 1);
+	json_object *device_id = json_object_object_get(pcie, "deviceID");
+	cper_view_bdf bdf = {};
+	int bdf_valid = cper_record_view_pcie_bdf(&view, 1, &bdf);
+	EXPECT_EQ(bdf_valid, ir_valid(pcie, "deviceIDValid"));
+	if (bdf_valid) {
+		EXPECT_EQ(bdf.segment,
+			  json_object_get_int(json_object_object_get(
+				  device_id, "segmentNumber")));
+		EXPECT_EQ(bdf.bus,
+			  json_object_get_int(json_object_object_get(
+				  device_id, "primaryOrDeviceBusNumber")));
+		EXPECT_EQ(bdf.device,
+			  json_object_get_int(json_object_object_get(
+				  device_id, "deviceNumber")));
+		EXPECT_EQ(bdf.function,
+			  json_object_get_int(json_object_object_get(
+				  device_id, "functionNumber")));
+	}
+
+	//ARM MPIDR.
+	json_object *arm = ir_section(ir, 2);
+	UINT64 mpidr = 0;
+	int mpidr_valid = cper_record_view_arm_mpidr(&view, 2, &mpidr);
+	EXPECT_EQ(mpidr_valid, ir_valid(arm, "mpidrValid"));
+	if (mpidr_valid) {
+		EXPECT_EQ(mpidr, json_object_get_uint64(json_object_object_get(
+					 arm, "mpidrEl1")));
+	}
+
+	json_object_put(ir);
+	free(buf);
+}
+
+TEST(RecordView, Bounds)
+{
+	const char *types[1] = { "memory" };
+	char *buf;
+	size_t size;
+	json_object *ir = generate_view_record(types, 1, &buf, &size);
+	json_object_put(ir);
+
+	cper_record_view view;
+	EXPECT_FALSE(cper_record_view_init(&view, NULL, size));
+	EXPECT_FALSE(cper_record_view_init(
+		&view, buf, sizeof(EFI_COMMON_ERROR_RECORD_HEADER) - 1));
+
+	//Descriptors must be within the buffer.
+	EXPECT_FALSE(cper_record_view_init(
+		&view, buf, sizeof(EFI_COMMON_ERROR_RECORD_HEADER) + 1));
+
+	//Sections are checked when accessed.
+	size_t descriptors_end = sizeof(EFI_COMMON_ERROR_RECORD_HEADER) +
+				 sizeof(EFI_ERROR_SECTION_DESCRIPTOR);
+	ASSERT_TRUE(cper_record_view_init(&view, buf, descriptors_end));
+	EXPECT_TRUE(cper_record_view_descriptor(&view, 0) != NULL);
+	EXPECT_TRUE(cper_record_view_section(&view, 0, NULL) == NULL);
+	EXPECT_TRUE(cper_record_view_memory(&view, 0) == NULL);
+
+	//Bad signature.
+	buf[0] = 'X';
+	EXPECT_FALSE(cper_record_view_init(&view, buf, size));
+	free(buf);
+}
+
+//Generates an NVIDIA record, replacing its registers with the given ones.
+static char *generate_nvidia_record(const EFI_NVIDIA_REGISTER_DATA *registers,
+				    UINT8 count, size_t *size)
+{
+	const char *types[1] = { "nvidia" };
+	char *buf;
+	json_object *ir = generate_view_record(types, 1, &buf, size);
+	json_object_put(ir);
+
+	UINT32 length = sizeof(EFI_NVIDIA_ERROR_DATA) +
+			count * sizeof(EFI_NVIDIA_REGISTER_DATA);
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(buf +
+						 sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
+	*size = descriptor->SectionOffset + length;
+	buf = (char *)realloc(buf, *size);
+
+	EFI_COMMON_ERROR_RECORD_HEADER *header =
+		(EFI_COMMON_ERROR_RECORD_HEADER *)buf;
+	descriptor = (EFI_ERROR_SECTION_DESCRIPTOR *)(header + 1);
+	descriptor->SectionLength = length;
+	header->RecordLength = *size;
+
+	EFI_NVIDIA_ERROR_DATA *nvidia =
+		(EFI_NVIDIA_ERROR_DATA *)(buf + descriptor->SectionOffset);
+	nvidia->NumberRegs = count;
+	memcpy(nvidia + 1, registers, count * sizeof(EFI_NVIDIA_REGISTER_DATA));
+	return buf;
+}
+
+TEST(RecordView, NvidiaRegisters)
+{
+	const EFI_NVIDIA_REGISTER_DATA registers[5] = {
+		{ 0x30, 3 }, { 0x10, 1 }, { 0x50, 5 }, { 0x10, 11 }, { 0x20, 2 }
+	};
+	size_t size;
+	char *buf = generate_nvidia_record(registers, 5, &size);
+
+	cper_record_view view;
+	ASSERT_TRUE(cper_record_view_init(&view, buf, size));
+	UINT16 count = 0;
+	const EFI_NVIDIA_REGISTER_DATA *raw =
+		cper_record_view_nvidia_registers(&view, 0, &count);
+	ASSERT_TRUE(raw != NULL);
+	EXPECT_EQ(count, 5u);
+	EXPECT_EQ(raw[2].Address, 0x50u);
+
+	//Linear and indexed lookups agree, and both return the first of duplicate addresses.
+	cper_view_nvidia_registers index;
+	ASSERT_TRUE(cper_record_view_nvidia_index(&view, 0, &index));
+	for (int i = 0; i < 5; i++) {
+		UINT64 linear = 0;
+		UINT64 indexed = 0;
+		EXPECT_TRUE(cper_record_view_nvidia_register(
+			&view, 0, registers[i].Address, &linear));
+		EXPECT_TRUE(cper_view_nvidia_find_register(
+			&index, registers[i].Address, &indexed));
+		EXPECT_EQ(linear, indexed);
+	}
+	UINT64 value = 0;
+	EXPECT_TRUE(cper_view_nvidia_find_register(&index, 0x10, &value));
+	EXPECT_EQ(value, 1u);
+	EXPECT_FALSE(cper_view_nvidia_find_register(&index, 0x40, &value));
+	EXPECT_FALSE(cper_view_nvidia_find_register(&index, 0x60, &value));
+	EXPECT_FALSE(cper_record_view_nvidia_register(&view, 0, 0x40, &value));
+
+	//Register counts beyond the section are rejected.
+	EFI_ERROR_SECTION_DESCRIPTOR *descriptor =
+		(EFI_ERROR_SECTION_DESCRIPTOR *)(buf +
+						 sizeof(EFI_COMMON_ERROR_RECORD_HEADER));
+	((EFI_NVIDIA_ERROR_DATA *)(buf + descriptor->SectionOffset))
+		->NumberRegs = 6;
+	EXPECT_TRUE(cper_record_view_nvidia_registers(&view, 0, &count) ==
+		    NULL);
+	EXPECT_FALSE(cper_record_view_nvidia_index(&view, 0, &index));
+	free(buf);
+}
+
+TEST(RecordView, ContentHash)
+{
+	const char *types[2] = { "memory", "pcie" };
+	char *buf;
+	size_t size;
+	json_object *ir = generate_view_record(types, 2, &buf, &size);
+	json_object_put(ir);
+
+	UINT64 original = 0;
+	ASSERT_TRUE(cper_record_hash(buf, size, &original));
+
+	//Volatile header fields do not change the hash.
+	EFI_COMMON_ERROR_RECORD_HEADER *header =
+		(EFI_COMMON_ERROR_RECORD_HEADER *)buf;
+	header->RecordID++;
+	header->TimeStamp.Seconds++;
+	header->PersistenceInfo++;
+	UINT64 hash = 0;
+	ASSERT_TRUE(cper_record_hash(buf, size, &hash));
+	EXPECT_EQ(hash, original);
+
+	//Any other header or section content does.
+	header->Flags ^= 0x1;
+	ASSERT_TRUE(cper_record_hash(buf, size, &hash));
+	EXPECT_NE(hash, original);
+	header->Flags ^= 0x1;
+	buf[size - 1] ^= 0x1;
+	ASSERT_TRUE(cper_record_hash(buf, size, &hash));
+	EXPECT_NE(hash, original);
+
+	EXPECT_FALSE(cper_record_hash(buf, 4, &hash));
+	free(buf);
+}